@@ -183,10 +183,26 @@ namespace {
 	{
 		CHECK_ERR( _var_vkGetDeviceProcAddr != &Dummy_vkGetDeviceProcAddr );
 
-		const auto	Load =	[device] (OUT auto& outResult, const char *procName, auto dummy)
+		return LoadDevice( device, _var_vkGetDeviceProcAddr, OUT table );
+	}
+	
+/*
+=================================================
+	LoadDevice
+----
+	functions are requested from custom 'getProcAddr',
+	used to load layers or mock functions for testing.
+	Function that is not found is replaced by dummy.
+=================================================
+*/
+	bool VulkanLoader::LoadDevice (VkDevice device, PFN_vkGetDeviceProcAddr getProcAddr, OUT VulkanDeviceFnTable &table)
+	{
+		CHECK_ERR( getProcAddr );
+
+		const auto	Load =	[device, getProcAddr] (OUT auto& outResult, const char *procName, auto dummy)
 							{
 								using FN = decltype(dummy);
-								FN	result = BitCast<FN>( vkGetDeviceProcAddr( device, procName ));
+								FN	result = BitCast<FN>( getProcAddr( device, procName ));
 								outResult = result ? result : dummy;
 							};
 
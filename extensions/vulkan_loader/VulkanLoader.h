@@ -112,6 +112,7 @@ namespace FGC
 			static void  Unload ();
 		
 		ND_ static bool  LoadDevice (VkDevice device, OUT VulkanDeviceFnTable &table);
+		ND_ static bool  LoadDevice (VkDevice device, PFN_vkGetDeviceProcAddr getProcAddr, OUT VulkanDeviceFnTable &table);
 			static void  ResetDevice (OUT VulkanDeviceFnTable &table);
 		
 			static void  SetupInstanceBackwardCompatibility (uint version);
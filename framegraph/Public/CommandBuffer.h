@@ -23,6 +23,7 @@
 #include "framegraph/Public/DrawCommandBuffer.h"
 #include "framegraph/Public/RenderPassDesc.h"
 #include "framegraph/Public/CommandBufferPtr.h"
+#include "framegraph/Public/ReadbackFuture.h"
 #include "framegraph/Public/FGEnums.h"
 
 namespace FG
@@ -37,12 +38,20 @@ namespace FG
 		EQueueType		queueType	= EQueueType::Graphics;
 		EDebugFlags		debugFlags	= Default;
 		StringView		name;
+		EPipelineMissPolicy	pipelineMissPolicy	= EPipelineMissPolicy::Block;	// used when pipeline instance is not created yet, see 'IFrameGraph::PrewarmPipeline'
+		bool			optimizeBarriers	= false;	// move resource transitions between tasks to merge pipeline barriers, use split barriers where possible
+		bool			reorderTasks		= false;	// process independent tasks with the same resource states and pipeline together
+		bool			mergeRenderPasses	= false;	// merge consecutive render passes with shared render targets into subpasses
 		
 				 CommandBufferDesc () {}
 		explicit CommandBufferDesc (EQueueType type) : queueType{type} {}
 
 		CommandBufferDesc&  SetDebugFlags (EDebugFlags value)	{ debugFlags = value;  return *this; }
 		CommandBufferDesc&  SetDebugName (StringView value)		{ name = value;  return *this; }
+		CommandBufferDesc&  SetPipelineMissPolicy (EPipelineMissPolicy value)	{ pipelineMissPolicy = value;  return *this; }
+		CommandBufferDesc&  SetOptimizeBarriers (bool value = true)		{ optimizeBarriers = value;  return *this; }
+		CommandBufferDesc&  SetReorderTasks (bool value = true)			{ reorderTasks = value;  return *this; }
+		CommandBufferDesc&  SetMergeRenderPasses (bool value = true)	{ mergeRenderPasses = value;  return *this; }
 	};
 
 
@@ -87,6 +96,14 @@ namespace FG
 		// Buffer may be in immutable or mutable state, immutable state disables barrier placement that increases performance on CPU.
 		virtual void		AcquireBuffer (RawBufferID id, bool makeMutable) = 0;
 
+		// Create image that exists only inside this command buffer, it will be released when command buffer completes execution.
+		// Memory is allocated in 'Execute' and may be shared with other transient resources whose lifetimes don't overlap,
+		// so image content is undefined before the first use. Image can't be used in other command buffers.
+		ND_ virtual RawImageID	CreateTransientImage (const ImageDesc &desc, StringView dbgName = Default) = 0;
+		
+		// Create buffer that exists only inside this command buffer, same rules as for transient image.
+		ND_ virtual RawBufferID	CreateTransientBuffer (const BufferDesc &desc, StringView dbgName = Default) = 0;
+
 	// tasks //
 		virtual Task		AddTask (const SubmitRenderPass &) = 0;
 		virtual Task		AddTask (const DispatchCompute &) = 0;
@@ -111,6 +128,11 @@ namespace FG
 		virtual Task		AddTask (const BuildRayTracingScene &) = 0;
 		virtual Task		AddTask (const TraceRays &) = 0;
 		virtual Task		AddTask (const CustomTask &) = 0;
+
+		// Read data into the persistent staging memory, callback is optional.
+		// Data stays valid until the last reference to the 'result' is released.
+		virtual Task		AddTask (const ReadBuffer &, OUT ReadbackFuture &result) = 0;
+		virtual Task		AddTask (const ReadImage &, OUT ReadbackFuture &result) = 0;
 		
 		// Begin secondary command buffer recording.
 		//ND_ virtual CommandBuffer  BeginSecondary () = 0;		// TODO
@@ -57,16 +57,26 @@ namespace FG
 
 	// render pass
 	static constexpr unsigned	FG_MaxRenderPassSubpasses	= 8;
+	static constexpr unsigned	FG_MinDrawTasksPerSecondaryCmdBuf	= 64;	// render pass with less draw tasks will be recorded inline
+	static constexpr unsigned	FG_MaxSecondaryCmdBuffers	= 8;	// per render pass, also limits number of recording threads
 
 	// pipeline
 	static constexpr unsigned	FG_MaxPushConstants			= 8;
 	static constexpr unsigned	FG_MaxPushConstantsSize		= 128;	// bytes
 	static constexpr unsigned	FG_MaxSpecConstants			= 8;
 	static constexpr unsigned	FG_DebugDescriptorSet		= FG_MaxDescriptorSets-1;
+	static constexpr unsigned	FG_PipelinePrewarmThreads	= 2;	// threads for background pipeline compilation
 
 	// queue
 	static constexpr unsigned	FG_MaxQueueFamilies			= 32;
 
+	// resource manager, default limits, see 'VulkanDeviceInfo::ResourcePoolLimits'
+	static constexpr unsigned	FG_MaxImages				= 32 << 10;
+	static constexpr unsigned	FG_MaxBuffers				= 32 << 10;
+	static constexpr unsigned	FG_MaxMemoryObjects			= 63 << 10;
+	static constexpr unsigned	FG_MaxCachedObjects			=  4 << 10;
+	static constexpr unsigned	FG_MaxRayTracingObjects		=  8 << 10;
+
 	// task
 	static constexpr unsigned	FG_MaxTaskDependencies		= 8;
 	static constexpr unsigned	FG_MaxCopyRegions			= 8;
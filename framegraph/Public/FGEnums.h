@@ -12,6 +12,7 @@ namespace FG
 		LogTasks						= 1 << 0,	// 
 		LogBarriers						= 1 << 1,	//
 		LogResourceUsage				= 1 << 2,	// 
+		ReorderStatistic				= 1 << 3,	// compare default and reordered task order, see 'RenderingStatistics::reorderedTasks'
 
 		VisTasks						= 1 << 10,
 		VisDrawTasks					= 1 << 11,
@@ -42,4 +43,13 @@ namespace FG
 	FG_BIT_OPERATORS( EDebugFlags );
 
 
+	enum class EPipelineMissPolicy : uint
+	{
+		Block,			// wait for background compilation or create pipeline during recording
+		SkipDraw,		// skip draw call while pipeline is compiled on background thread
+		Compatible,		// use pipeline created for compatible render pass, otherwise same as 'Block'
+		Unknown		= ~0u,
+	};
+
+
 }	// FG
@@ -47,8 +47,13 @@ namespace FG
 			uint		descriptorBinds				= 0;
 			uint		pushConstants				= 0;
 			uint		pipelineBarriers			= 0;
+			uint		splitBarriers				= 0;	// set/wait event pairs, see 'CommandBufferDesc::optimizeBarriers'
 			uint		transferOps					= 0;
 
+			uint		reorderedTasks				= 0;	// tasks that are moved by 'CommandBufferDesc::reorderTasks', requires 'EDebugFlags::ReorderStatistic'
+			int			barriersSavedByReorder		= 0;	// estimated, negative value means that reordering is worse than default order
+			int			pipelineBindsSavedByReorder	= 0;	// estimated
+
 			uint		indexBufferBindings			= 0;
 			uint		vertexBufferBindings		= 0;
 			uint		drawCalls					= 0;
@@ -65,12 +70,19 @@ namespace FG
 			uint		traceRaysCalls				= 0;
 			uint		buildASCalls				= 0;
 
+			uint		secondaryCmdBuffers			= 0;	// recorded in parallel for render passes with 'useSecondaryCmdbuf'
+			uint		skippedDrawCalls			= 0;	// pipeline is not compiled yet, see 'EPipelineMissPolicy::SkipDraw'
+			uint		skippedBindings				= 0;	// redundant pipeline, descriptor set, buffer and dynamic state commands that are not recorded
+			uint		mergedRenderPasses			= 0;	// render passes that are recorded as subpasses, see 'CommandBufferDesc::mergeRenderPasses'
+
 			// for command buffers
 			Nanoseconds	gpuTime						{0};	// for (currentFrame - ringBufferSize)
 			Nanoseconds	cpuTime						{0};	// for (currentFrame - ringBufferSize)
 
 			Nanoseconds submitingTime				{0};
 			Nanoseconds waitingTime					{0};
+
+			void Merge (const RenderingStatistics &);
 		};
 
 		struct ResourceStatistics
@@ -78,12 +90,55 @@ namespace FG
 			uint		newGraphicsPipelineCount	= 0;
 			uint		newComputePipelineCount		= 0;
 			uint		newRayTracingPipelineCount	= 0;
+
+			uint		pipelineCacheHits			= 0;	// graphics pipeline instance was found
+			uint		pipelineCacheMisses			= 0;	// graphics pipeline instance is not created or compilation is not complete
+			uint		compatiblePipelineHits		= 0;	// pipeline for compatible render pass is used, see 'EPipelineMissPolicy::Compatible'
+			uint		prewarmedPipelineCount		= 0;	// pipelines compiled on background thread, included in 'newGraphicsPipelineCount'
+
+			uint		deferredDescriptorSets		= 0;	// descriptor sets created while recording and updated in single batch
+
+			uint		transientResources			= 0;	// images and buffers created by 'CreateTransientImage/Buffer'
+			BytesU		transientMemoryRequired;			// sum of transient resource sizes
+			BytesU		transientMemoryAllocated;			// memory actually allocated for transient resources after aliasing
+			uint		transientHeapAllocations	= 0;	// new device memory allocations, other heaps are reused from completed batches
+
+			BytesU		stagingMemoryAllocated;				// host visible memory of staging ring buffers and dedicated staging buffers
+			BytesU		stagingMemoryUsed;					// staging memory used by command batches that are not complete yet
+			BytesU		stagingMemoryHighWater;				// max used staging memory since previous 'GetStatistics' call
+			uint		stagingOverflowBuffers		= 0;	// dedicated buffers for transfers that don't fit into the ring buffer
+		};
+
+		struct MemoryStatistics
+		{
+			struct Heap
+			{
+				BytesU		size;
+				BytesU		budget;			// how much memory process can allocate, equal to 'size' if 'VK_EXT_memory_budget' is not supported
+				BytesU		usage;			// memory allocated by process including other APIs, 0 if 'VK_EXT_memory_budget' is not supported
+				BytesU		allocated;		// memory blocks allocated by framegraph
+				bool		deviceLocal	= false;
+			};
+
+			struct Pool
+			{
+				MemPoolID	id;
+				BytesU		budget;			// 0 - unlimited
+				BytesU		allocated;		// size of all memory blocks
+				BytesU		used;			// size of all allocations
+				uint		blockCount		= 0;
+				uint		allocationCount	= 0;
+			};
+
+			FixedArray< Heap, 16 >	heaps;	// snapshot at the time of 'GetStatistics' call
+			Array< Pool >			pools;
 		};
 
 		struct Statistics
 		{
 			RenderingStatistics		renderer;
 			ResourceStatistics		resources;
+			MemoryStatistics		memory;
 
 			void Merge (const Statistics &);
 		};
@@ -106,6 +161,7 @@ namespace FG
 			bool	samplerMirrorClamp				: 1;	// for EAddressMode::MirrorClampToEdge.
 			bool	descriptorIndexing				: 1;	// PipelineResources::***::elementCount can be set in runtime.
 			bool	drawIndirectCount				: 1;	// DrawVerticesIndirectCount, DrawIndexedIndirectCount can be used.
+			bool	timelineSemaphore				: 1;	// submitted batches are tracked by per queue timeline semaphores instead of fences.
 			bool	swapchain						: 1;	// CreateSwapchain() can be used.
 			bool	meshShaderNV					: 1;	// CreatePipeline(MeshPipelineDesc), DrawMeshes*** can be used.
 			bool	rayTracingNV					: 1;	// CreatePipeline(RayTracingPipelineDesc), CreateRayTracingGeometry(), CreateRayTracingScene(), CreateRayTracingShaderTable(),
@@ -178,6 +234,10 @@ namespace FG
 		ND_ virtual RTGeometryID	CreateRayTracingGeometry (const RayTracingGeometryDesc &desc, const MemoryDesc &mem = Default, StringView dbgName = Default) = 0;
 		ND_ virtual RTSceneID		CreateRayTracingScene (const RayTracingSceneDesc &desc, const MemoryDesc &mem = Default, StringView dbgName = Default) = 0;
 		ND_ virtual RTShaderTableID	CreateRayTracingShaderTable (StringView dbgName = Default) = 0;
+
+			// Creates named memory pool, resources are allocated from this pool if 'MemoryDesc::poolId' is equal to 'id'.
+			// Pool must be created before the resources and is destroyed in 'Deinitialize'.
+			virtual bool			CreateMemoryPool (const MemPoolID &id, const MemoryPoolDesc &desc) = 0;
 			virtual bool			InitPipelineResources (RawGPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) = 0;
 			virtual bool			InitPipelineResources (RawCPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) = 0;
 			virtual bool			InitPipelineResources (RawMPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) = 0;
@@ -193,6 +253,20 @@ namespace FG
 			virtual bool			CachePipelineResources (INOUT PipelineResources &resources) = 0;
 			virtual void			ReleaseResource (INOUT PipelineResources &resources) = 0;
 
+			// Returns pipeline cache with header that contains device and driver info, can be saved to file.
+			// Pipeline caches of command buffers are merged into the global cache after 'Execute' and in 'Deinitialize'.
+			virtual bool			SerializePipelineCache (OUT Array<uint8_t> &data) = 0;
+
+			// Loads pipeline cache, returns 'false' if data is invalid or was created for another device or driver version.
+			virtual bool			DeserializePipelineCache (ArrayView<uint8_t> data) = 0;
+
+			// Compiles graphics pipeline instance on background thread to avoid hitches when pipeline is used for the first time.
+			// 'renderPass' is used to get attachment formats and load/store operations, it must be the same as in 'ICommandBuffer::CreateRenderPass'.
+			// 'renderState' must contain render pass states with overrides from draw task, 'Viewport' and 'Scissor' dynamic states are always added.
+			// See 'EPipelineMissPolicy' for how draw tasks are recorded while compilation is not complete.
+			virtual bool			PrewarmPipeline (RawGPipelineID pipeline, const RenderPassDesc &renderPass, const RenderState &renderState,
+													 const VertexInputState &vertexInput, EPipelineDynamicState dynamicState = Default) = 0;
+
 			// Release reference to resource, Returns 'true' if resource has been deleted.
 			// See synchronization requirements on top of this file.
 			virtual bool			ReleaseResource (INOUT GPipelineID &id) = 0;
@@ -125,6 +125,8 @@ namespace _fg_hidden_
 		ColorBuffers_t			colorBuffers;
 		DynamicStates			dynamicStates;
 		DebugMode				debugMode;
+		uint8_t					sortLayer		= 0;	// used if 'RenderPassDesc::sortDrawTasks' is enabled, tasks in lower layer are drawn first
+		uint16_t				sortDepth		= 0;	// tasks with same layer, pipeline and resources are sorted by depth
 			
 
 	// methods
@@ -162,6 +164,8 @@ namespace _fg_hidden_
 		TaskType&  SetRasterizerDiscard (bool value);
 		TaskType&  SetFrontFaceCCW (bool value);
 
+		TaskType&  SetSortKey (uint layer, uint depth = 0);
+
 		template <typename ValueType>
 		TaskType&  AddPushConstant (const PushConstantID &id, const ValueType &value)	{ return AddPushConstant( id, AddressOf(value), SizeOf<ValueType> ); }
 		TaskType&  AddPushConstant (const PushConstantID &id, const void *ptr, BytesU size);
@@ -859,6 +863,15 @@ namespace _fg_hidden_
 		return static_cast<TaskType &>( *this );
 	}
 
+	template <typename TaskType>
+	inline TaskType&  BaseDrawCall<TaskType>::SetSortKey (uint layer, uint depth)
+	{
+		ASSERT( layer <= 0xFF and depth <= 0xFFFF );
+		sortLayer = uint8_t(layer);
+		sortDepth = uint16_t(depth);
+		return static_cast<TaskType &>( *this );
+	}
+
 	template <typename TaskType>
 	inline TaskType&  BaseDrawCall<TaskType>::AddPushConstant (const PushConstantID &id, const void *ptr, BytesU size)
 	{
@@ -664,10 +664,22 @@ namespace FG
 	struct UpdateBuffer final : _fg_hidden_::BaseTask<UpdateBuffer>
 	{
 	// types
+		// writes 'size' bytes of source data starting from 'offset' directly to the staging memory,
+		// called from 'AddTask' one or more times with ranges in ascending order.
+		using Writer_t	= std::function< void (void *dst, BytesU offset, BytesU size) >;
+
 		struct Region
 		{
 			BytesU				offset;
 			ArrayView<uint8_t>	data;
+			Writer_t			writer;		// used instead of 'data'
+			BytesU				writerSize;
+
+			Region () {}
+			Region (BytesU offset, ArrayView<uint8_t> data) : offset{offset}, data{data} {}
+			Region (BytesU offset, Writer_t &&writer, BytesU size) : offset{offset}, writer{std::move(writer)}, writerSize{size} {}
+
+			ND_ BytesU  Size () const	{ return writer ? writerSize : ArraySizeOf(data); }
 		};
 		using Regions_t	= FixedArray< Region, FG_MaxCopyRegions >;
 
@@ -718,6 +730,14 @@ namespace FG
 			regions.emplace_back( bufferOffset, ArrayView{ Cast<uint8_t>(ptr), size_t(size) });
 			return *this;
 		}
+
+		template <typename FN>
+		UpdateBuffer&  AddWriter (FN &&fn, BytesU size, BytesU bufferOffset = 0_b)
+		{
+			ASSERT( size > 0 );
+			regions.emplace_back( bufferOffset, Writer_t{ std::forward<FN>(fn) }, size );
+			return *this;
+		}
 	};
 
 
@@ -764,6 +784,12 @@ namespace FG
 	//
 	struct UpdateImage final : _fg_hidden_::BaseTask<UpdateImage>
 	{
+	// types
+		// writes 'size' bytes of source data starting from 'offset' directly to the staging memory,
+		// source data layout is defined by 'dataRowPitch' and 'dataSlicePitch',
+		// called from 'AddTask' one or more times with ranges in ascending order.
+		using Writer_t	= UpdateBuffer::Writer_t;
+
 	// variables
 		RawImageID			dstImage;
 		int3				imageOffset;
@@ -774,6 +800,7 @@ namespace FG
 		BytesU				dataSlicePitch;
 		EImageAspect		aspectMask	= EImageAspect::Color;	// must only have a single bit set
 		ArrayView<uint8_t>	data;
+		Writer_t			writer;		// used instead of 'data'
 
 		
 	// methods
@@ -836,6 +863,23 @@ namespace FG
 		{
 			return SetData( ArrayView<uint8_t>{ Cast<uint8_t>(ptr), count*sizeof(T) }, dimension, rowPitch, slicePitch );
 		}
+
+		template <typename FN>
+		UpdateImage&  SetWriter (FN &&fn, const uint2 &dimension, BytesU rowPitch = 0_b)
+		{
+			return SetWriter( std::forward<FN>(fn), uint3( dimension.x, dimension.y, 0 ), rowPitch );
+		}
+
+		template <typename FN>
+		UpdateImage&  SetWriter (FN &&fn, const uint3 &dimension, BytesU rowPitch = 0_b, BytesU slicePitch = 0_b)
+		{
+			writer			= std::forward<FN>(fn);
+			data			= ArrayView<uint8_t>{};
+			imageSize		= dimension;
+			dataRowPitch	= rowPitch;
+			dataSlicePitch	= slicePitch;
+			return *this;
+		}
 	};
 
 
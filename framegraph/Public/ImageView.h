@@ -26,6 +26,7 @@ namespace FG
 		using LoadRGBA32fFun_t	= void (*) (ArrayView<T>, OUT RGBA32f &);
 		using LoadRGBA32uFun_t	= void (*) (ArrayView<T>, OUT RGBA32u &);
 		using LoadRGBA32iFun_t	= void (*) (ArrayView<T>, OUT RGBA32i &);
+		using LoadRowF4Fun_t	= void (*) (const T *, OUT RGBA32f *, size_t);
 
 
 	// variables
@@ -39,6 +40,7 @@ namespace FG
 		LoadRGBA32fFun_t	_loadF4			= null;
 		LoadRGBA32uFun_t	_loadU4			= null;
 		LoadRGBA32iFun_t	_loadI4			= null;
+		LoadRowF4Fun_t		_loadRowF4		= null;		// vectorized version of '_loadF4', may be null
 
 
 	// methods
@@ -115,6 +117,25 @@ namespace FG
 			return _loadI4( GetPixel( point ), OUT col );
 		}
 
+
+		// Decodes whole row, 'dst' must contain at least 'Dimension().x' elements.
+		// Result is bit-exact with 'Load' for each pixel, common formats use SIMD implementation.
+		// RGBA8 is 'RGBA32f * 256' clamped to [0, 255], so 8 bit UNorm formats are copied without changes.
+		bool  LoadRow (uint y, uint z, OUT RGBA32f *dst) const;
+		bool  LoadRow (uint y, uint z, OUT RGBA8u *dst) const;
+
+		// Decodes region row by row, result is tightly packed.
+		bool  ConvertRegion (const uint3 &offset, const uint3 &size, OUT Array<RGBA32f> &dst) const;
+		bool  ConvertRegion (const uint3 &offset, const uint3 &size, OUT Array<RGBA8u> &dst) const;
+
+	private:
+		bool  _LoadRow (ArrayView<T> row, size_t count, OUT RGBA32f *dst) const;
+		bool  _LoadRow (ArrayView<T> row, size_t count, OUT RGBA8u *dst) const;
+
+		template <typename ColorType>
+		bool  _ConvertRegion (const uint3 &offset, const uint3 &size, OUT Array<ColorType> &dst) const;
+
+	public:
 		/*void Load (const uint3 &point, OUT RGBA32f &col) const
 		{
 			ASSERT( _isFloatFormat );
@@ -30,4 +30,28 @@ namespace FG
 	};
 
 
+
+	//
+	// Memory Pool Description
+	//
+
+	struct MemoryPoolDesc
+	{
+	// variables
+		EMemoryType				memType			= EMemoryType::Default;
+		EMemoryPoolAlgorithm	algorithm		= EMemoryPoolAlgorithm::Default;
+		BytesU					blockSize;					// 0 - default block size, see 'FG_VkDevicePageSizeMb'
+		uint					minBlockCount	= 0;		// blocks that are allocated when pool created and never released
+		uint					maxBlockCount	= 0;		// 0 - unlimited
+		BytesU					budget;						// 0 - unlimited, allocation fails if pool usage exceeds this value
+		uint					memTypeBits		= 0;		// 0 - any, otherwise memory type is selected from 'memoryTypeBits' of resources that will be allocated in pool
+
+	// methods
+		MemoryPoolDesc () {}
+		
+		MemoryPoolDesc (EMemoryType memType, EMemoryPoolAlgorithm algorithm, BytesU blockSize, uint maxBlockCount = 0, BytesU budget = 0_b) :
+			memType{memType}, algorithm{algorithm}, blockSize{blockSize}, maxBlockCount{maxBlockCount}, budget{budget} {}
+	};
+
+
 }	// FG
@@ -0,0 +1,48 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Result of 'ReadBuffer' or 'ReadImage' task, see 'ICommandBuffer::AddTask'.
+
+	Data is read into persistent host-cached staging memory that is not recycled when the command batch completes,
+	memory is released when the last reference to the future is released, so data can be processed later without copying.
+	All futures must be released before frame graph deinitialization.
+
+	Thread safe:	yes
+*/
+
+#pragma once
+
+#include "framegraph/Public/ImageView.h"
+
+namespace FG
+{
+
+	//
+	// Readback Future interface
+	//
+
+	class IReadbackFuture : public std::enable_shared_from_this<IReadbackFuture>
+	{
+	// interface
+	public:
+		virtual ~IReadbackFuture () {}
+
+		// Returns 'true' if data is available, doesn't block.
+		ND_ virtual bool		IsReady () const = 0;
+
+		// Submits command buffer if needed and blocks until data is available or timeout expired.
+		// Returns 'false' on timeout or if command buffer has not been executed yet.
+			virtual bool		Wait (Nanoseconds timeout) = 0;
+
+		// Returns data of the 'ReadBuffer' task, view is empty if data is not ready.
+		// View is valid while future is alive.
+		ND_ virtual BufferView	GetBuffer () const = 0;
+
+		// Returns data of the 'ReadImage' task, view is empty if data is not ready.
+		// View is valid while future is alive.
+		ND_ virtual ImageView	GetImage () const = 0;
+	};
+
+	using ReadbackFuture = SharedPtr< IReadbackFuture >;
+
+
+}	// FG
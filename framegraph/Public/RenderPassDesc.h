@@ -61,7 +61,9 @@ namespace FG
 		PipelineResourceSet			perPassResources;	// this resources will be added for all draw tasks
 
 
-		//bool						useSecondaryCmdbuf	= false;	// CPU optimization
+		bool						useSecondaryCmdbuf	= false;	// (optimization) record draw tasks into secondary command buffers on multiple threads
+		bool						sortDrawTasks		= false;	// (optimization) sort draw tasks by layer, pipeline, resources and depth to minimize state changes,
+																	// draw order is changed, so use layers for tasks that depend on order (blending)
 
 		//bool						parallelExecution	= true;		// (optimization) if 'false' all draw and compute tasks will be executed in initial order
 		//bool						canBeMerged			= true;		// (optimization) g-buffer render passes can be merged, but don't merge conditional passes
@@ -156,6 +158,9 @@ namespace FG
 		RenderPassDesc&  SetAlphaToOneEnabled (bool value);
 
 		RenderPassDesc&  SetShadingRateImage (RawImageID image, ImageLayer layer = Default, MipmapLevel level = Default);
+
+		RenderPassDesc&  SetSecondaryCmdbufEnabled (bool value);
+		RenderPassDesc&  SetDrawTaskSortingEnabled (bool value);
 		
 		RenderPassDesc&  AddResources (const DescriptorSetID &id, const PipelineResources *res);
 		RenderPassDesc&  AddResources (const DescriptorSetID &id, PipelineResources &res)	{ return AddResources( id, &res ); }
@@ -533,6 +538,28 @@ namespace FG
 		return *this;
 	}
 	
+/*
+=================================================
+	SetSecondaryCmdbufEnabled
+=================================================
+*/
+	inline RenderPassDesc&  RenderPassDesc::SetSecondaryCmdbufEnabled (bool value)
+	{
+		useSecondaryCmdbuf = value;
+		return *this;
+	}
+	
+/*
+=================================================
+	SetDrawTaskSortingEnabled
+=================================================
+*/
+	inline RenderPassDesc&  RenderPassDesc::SetDrawTaskSortingEnabled (bool value)
+	{
+		sortDrawTasks = value;
+		return *this;
+	}
+	
 /*
 =================================================
 	AddResources
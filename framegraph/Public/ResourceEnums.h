@@ -57,6 +57,14 @@ namespace FG
 	FG_BIT_OPERATORS( EMemoryType );
 
 
+	enum class EMemoryPoolAlgorithm : uint8_t
+	{
+		Default,		// general purpose allocator, resources can be allocated and freed in any order
+		Linear,			// fast allocation, memory is reused only when resources are freed in FIFO or LIFO order
+		Buddy,			// block sizes are power of two, low fragmentation for resources with similar sizes
+	};
+
+
 	enum class EBufferUsage : uint
 	{
 		TransferSrc			= 1 << 0,
@@ -0,0 +1,134 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Spreads image and buffer uploads across frames.
+
+	Requests are sorted by priority and split into chunks (rows of a mipmap or a range of a buffer),
+	'Update' schedules chunks until the per-frame byte budget is exhausted.
+	Uploads are recorded to the 'EQueueType::AsyncTransfer' command buffer if the resource was created
+	with 'EQueueUsage::AsyncTransfer', such resources use concurrent sharing so queue family ownership transfer is not required,
+	other resources are uploaded on the graphics queue.
+	Command buffer that uses streamed resources must be passed to 'Update' so it waits for the transfer on the GPU.
+
+	Thread safe:	yes, but 'Update' must not be called concurrently.
+*/
+
+#pragma once
+
+#include "framegraph/Public/FrameGraph.h"
+
+namespace FG
+{
+
+	//
+	// Streaming Manager
+	//
+
+	class StreamingManager final
+	{
+	// types
+	public:
+		enum class RequestID : uint64_t { Unknown = 0 };
+
+		// called from 'Update' when all data of the request has been uploaded on the GPU
+		using Callback_t	= std::function< void () >;
+
+		struct Config
+		{
+			BytesU		budgetPerFrame		= 8_Mb;		// max size of data scheduled in a single 'Update' call
+			BytesU		maxChunkSize		= 1_Mb;		// large requests are split into chunks
+			uint		maxBatchesInFlight	= 3;		// 'Update' doesn't schedule new uploads until the oldest batch is complete
+		};
+
+		struct ImageRequest
+		{
+			RawImageID			image;
+			MipmapLevel			baseMipmap;
+			uint				mipmapCount	= 1;
+			ImageLayer			arrayLayer;
+			EImageAspect		aspectMask	= EImageAspect::Color;
+			Array<uint8_t>		data;					// all mipmaps starting from 'baseMipmap', each mipmap has minimal row and slice pitch, see 'UpdateImage'
+			int					priority	= 0;		// requests with greater priority are scheduled first
+			Callback_t			onComplete;
+
+			ImageRequest () {}
+			ImageRequest (RawImageID image, MipmapLevel baseMipmap, uint mipmapCount, Array<uint8_t> &&data) :
+				image{image}, baseMipmap{baseMipmap}, mipmapCount{mipmapCount}, data{std::move(data)} {}
+
+			ImageRequest&  SetLayer (ImageLayer value)			{ arrayLayer = value;  return *this; }
+			ImageRequest&  SetAspect (EImageAspect value)		{ aspectMask = value;  return *this; }
+			ImageRequest&  SetPriority (int value)				{ priority = value;  return *this; }
+			ImageRequest&  SetCallback (Callback_t &&value)		{ onComplete = std::move(value);  return *this; }
+		};
+
+		struct BufferRequest
+		{
+			RawBufferID			buffer;
+			BytesU				offset;
+			Array<uint8_t>		data;
+			int					priority	= 0;		// requests with greater priority are scheduled first
+			Callback_t			onComplete;
+
+			BufferRequest () {}
+			BufferRequest (RawBufferID buffer, BytesU offset, Array<uint8_t> &&data) :
+				buffer{buffer}, offset{offset}, data{std::move(data)} {}
+
+			BufferRequest&  SetPriority (int value)				{ priority = value;  return *this; }
+			BufferRequest&  SetCallback (Callback_t &&value)	{ onComplete = std::move(value);  return *this; }
+		};
+
+	private:
+		struct Request;
+		using Requests_t	= Array< UniquePtr< Request >>;
+
+		struct InFlight
+		{
+			FixedArray< CommandBuffer, 2 >	cmdBuffers;
+			Requests_t						completed;		// requests whose last chunk was recorded to these command buffers
+		};
+		using InFlight_t	= Deque< InFlight >;
+
+
+	// variables
+	private:
+		FrameGraph				_frameGraph;
+		const Config			_config;
+		EQueueType				_transferQueue	= EQueueType::Graphics;
+
+		Mutex					_pendingGuard;
+		Requests_t				_pending;		// sorted by priority
+		BytesU					_pendingSize;
+		uint64_t				_requestCounter	= 0;
+
+		InFlight_t				_inFlight;		// accessed only in 'Update'
+
+
+	// methods
+	public:
+		explicit StreamingManager (const FrameGraph &fg, const Config &cfg = Default);
+		~StreamingManager ();
+
+		ND_ RequestID  Upload (ImageRequest);
+		ND_ RequestID  Upload (BufferRequest);
+
+		// Retires completed uploads and records new uploads within the budget.
+		// 'dependent' command buffer must be in recording state, it will wait for uploads on the GPU.
+			bool  Update (const CommandBuffer &dependent = Default);
+
+		// Waits until all scheduled uploads are complete, pending requests are discarded.
+			void  Release ();
+
+		ND_ BytesU	PendingSize ();
+		ND_ size_t	InFlightCount ()	const	{ return _inFlight.size(); }
+
+	private:
+		ND_ RequestID  _AddRequest (UniquePtr<Request> &&);
+
+		bool  _RecordImage (Request &, const CommandBuffer &cmd, INOUT BytesU &budget, OUT bool &complete) const;
+		bool  _RecordBuffer (Request &, const CommandBuffer &cmd, INOUT BytesU &budget, OUT bool &complete) const;
+
+		void  _RetireCompleted ();
+		void  _ReleaseRequests (INOUT Requests_t &, bool complete);
+	};
+
+
+}	// FG
@@ -54,6 +54,19 @@ namespace FG
 		};
 		using Queues_t = FixedArray< QueueInfo, 8 >;
 
+		// receives function that releases completed batch and calls 'ReadBuffer', 'ReadImage' and shader debug callbacks
+		using CallbackExecutor_t = std::function< void (std::function< void () > &&) >;
+
+		// max number of resources of each type, 0 - use default value from 'Config.h'
+		struct ResourcePoolLimits
+		{
+			uint				images				= 0;
+			uint				buffers				= 0;
+			uint				memoryObjects		= 0;
+			uint				cachedObjects		= 0;	// samplers, pipelines, layouts, render passes, framebuffers, pipeline resources
+			uint				rayTracingObjects	= 0;
+		};
+
 	// variables
 		InstanceVk_t		instance			= null;
 		PhysicalDeviceVk_t	physicalDevice		= null;
@@ -62,6 +75,10 @@ namespace FG
 
 		BytesU				maxStagingBufferMemory	= ~0_b;	// you can limit max size of host visible memory that may be used by FrameGraph, by default used max available size.
 		BytesU				stagingBufferSize		= 0_b;	// max size of single staging buffer (needed for tests), 0 - auto
+		ResourcePoolLimits	resourcePoolLimits;
+
+		bool				useCompletionThread		= false;	// completed batches are released on separate thread instead of 'Flush' and 'Wait***' calls
+		CallbackExecutor_t	callbackExecutor;					// only for completion thread, if empty then callbacks are called on completion thread
 	};
 
 
@@ -15,8 +15,13 @@ namespace FG
 		dst.descriptorBinds				+= src.descriptorBinds;
 		dst.pushConstants				+= src.pushConstants;
 		dst.pipelineBarriers			+= src.pipelineBarriers;
+		dst.splitBarriers				+= src.splitBarriers;
 		dst.transferOps					+= src.transferOps;
 
+		dst.reorderedTasks				+= src.reorderedTasks;
+		dst.barriersSavedByReorder		+= src.barriersSavedByReorder;
+		dst.pipelineBindsSavedByReorder	+= src.pipelineBindsSavedByReorder;
+
 		dst.indexBufferBindings			+= src.indexBufferBindings;
 		dst.vertexBufferBindings		+= src.vertexBufferBindings;
 		dst.drawCalls					+= src.drawCalls;
@@ -33,6 +38,11 @@ namespace FG
 		dst.traceRaysCalls				+= src.traceRaysCalls;
 		dst.buildASCalls				+= src.buildASCalls;
 
+		dst.secondaryCmdBuffers			+= src.secondaryCmdBuffers;
+		dst.skippedDrawCalls			+= src.skippedDrawCalls;
+		dst.skippedBindings				+= src.skippedBindings;
+		dst.mergedRenderPasses			+= src.mergedRenderPasses;
+
 		dst.gpuTime						+= src.gpuTime;
 		dst.cpuTime						+= src.cpuTime;
 	}
@@ -47,6 +57,23 @@ namespace FG
 		dst.newComputePipelineCount		+= src.newComputePipelineCount;
 		dst.newGraphicsPipelineCount	+= src.newGraphicsPipelineCount;
 		dst.newRayTracingPipelineCount	+= src.newRayTracingPipelineCount;
+
+		dst.pipelineCacheHits			+= src.pipelineCacheHits;
+		dst.pipelineCacheMisses			+= src.pipelineCacheMisses;
+		dst.compatiblePipelineHits		+= src.compatiblePipelineHits;
+		dst.prewarmedPipelineCount		+= src.prewarmedPipelineCount;
+		dst.deferredDescriptorSets		+= src.deferredDescriptorSets;
+
+		dst.transientResources			+= src.transientResources;
+		dst.transientMemoryRequired		+= src.transientMemoryRequired;
+		dst.transientMemoryAllocated	+= src.transientMemoryAllocated;
+		dst.transientHeapAllocations	+= src.transientHeapAllocations;
+
+		// staging memory statistics is a snapshot
+		dst.stagingMemoryAllocated		 = Max( dst.stagingMemoryAllocated, src.stagingMemoryAllocated );
+		dst.stagingMemoryUsed			 = Max( dst.stagingMemoryUsed, src.stagingMemoryUsed );
+		dst.stagingMemoryHighWater		 = Max( dst.stagingMemoryHighWater, src.stagingMemoryHighWater );
+		dst.stagingOverflowBuffers		+= src.stagingOverflowBuffers;
 	}
 
 /*
@@ -54,10 +81,19 @@ namespace FG
 	Merge
 =================================================
 */
+	void IFrameGraph::RenderingStatistics::Merge (const RenderingStatistics &newStat)
+	{
+		MergeRenderStatistic( newStat, INOUT *this );
+	}
+
 	void IFrameGraph::Statistics::Merge (const Statistics &newStat)
 	{
 		MergeRenderStatistic( newStat.renderer, INOUT this->renderer );
 		MergeResourceStatistic( newStat.resources, INOUT this->resources );
+
+		// memory statistics is a snapshot, so use latest
+		if ( newStat.memory.heaps.size() or newStat.memory.pools.size() )
+			this->memory = newStat.memory;
 	}
 
 
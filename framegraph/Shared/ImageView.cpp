@@ -2,6 +2,21 @@
 
 #include "Public/ImageView.h"
 
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and (_M_IX86_FP >= 2))
+#	include <emmintrin.h>
+#	define FG_IMAGEVIEW_SSE2
+#endif
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define FG_IMAGEVIEW_AVX2
+#endif
+
+#if defined(__ARM_NEON) or defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define FG_IMAGEVIEW_NEON
+#endif
+
 namespace FG
 {
 namespace {
@@ -263,6 +278,419 @@ namespace {
 		result.a = 1.0f;
 	}
 
+/*
+=================================================
+	StoreR
+----
+	writes (x, 0, 0, 0) for each of 4 values
+=================================================
+*/
+#if defined(FG_IMAGEVIEW_SSE2)
+	forceinline void StoreR (__m128 value, OUT float *dst)
+	{
+		const __m128	zero = _mm_setzero_ps();
+
+		_mm_storeu_ps( dst +  0, _mm_move_ss( zero, value ));
+		_mm_storeu_ps( dst +  4, _mm_move_ss( zero, _mm_shuffle_ps( value, value, _MM_SHUFFLE(1,1,1,1) )));
+		_mm_storeu_ps( dst +  8, _mm_move_ss( zero, _mm_shuffle_ps( value, value, _MM_SHUFFLE(2,2,2,2) )));
+		_mm_storeu_ps( dst + 12, _mm_move_ss( zero, _mm_shuffle_ps( value, value, _MM_SHUFFLE(3,3,3,3) )));
+	}
+
+#elif defined(FG_IMAGEVIEW_NEON)
+	forceinline void StoreR (float32x4_t value, OUT float *dst)
+	{
+		const float32x4_t	zero = vdupq_n_f32( 0.0f );
+
+		vst4q_f32( dst, float32x4x4_t{{ value, zero, zero, zero }});
+	}
+#endif
+
+/*
+=================================================
+	HalfToFloat
+----
+	same as 'HalfBits::ToFloat' for 4 values in low 16 bits
+=================================================
+*/
+#if defined(FG_IMAGEVIEW_AVX2)
+	forceinline __m256 HalfToFloat (__m256i h)
+	{
+		const __m256i	s = _mm256_slli_epi32( _mm256_and_si256( h, _mm256_set1_epi32( 0x8000 )), 16 );
+		const __m256i	e = _mm256_slli_epi32( _mm256_add_epi32( _mm256_and_si256( _mm256_srli_epi32( h, 10 ), _mm256_set1_epi32( 0x1F )), _mm256_set1_epi32( 127 - 15 )), 23 );
+		const __m256i	m = _mm256_slli_epi32( _mm256_and_si256( h, _mm256_set1_epi32( 0x3FF )), 23 - 10 );
+
+		return _mm256_castsi256_ps( _mm256_or_si256( _mm256_or_si256( s, e ), m ));
+	}
+#endif
+#if defined(FG_IMAGEVIEW_SSE2)
+	forceinline __m128 HalfToFloat (__m128i h)
+	{
+		const __m128i	s = _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x8000 )), 16 );
+		const __m128i	e = _mm_slli_epi32( _mm_add_epi32( _mm_and_si128( _mm_srli_epi32( h, 10 ), _mm_set1_epi32( 0x1F )), _mm_set1_epi32( 127 - 15 )), 23 );
+		const __m128i	m = _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x3FF )), 23 - 10 );
+
+		return _mm_castsi128_ps( _mm_or_si128( _mm_or_si128( s, e ), m ));
+	}
+
+#elif defined(FG_IMAGEVIEW_NEON)
+	forceinline float32x4_t HalfToFloat (uint32x4_t h)
+	{
+		const uint32x4_t	s = vshlq_n_u32( vandq_u32( h, vdupq_n_u32( 0x8000 )), 16 );
+		const uint32x4_t	e = vshlq_n_u32( vaddq_u32( vandq_u32( vshrq_n_u32( h, 10 ), vdupq_n_u32( 0x1F )), vdupq_n_u32( 127 - 15 )), 23 );
+		const uint32x4_t	m = vshlq_n_u32( vandq_u32( h, vdupq_n_u32( 0x3FF )), 23 - 10 );
+
+		return vreinterpretq_f32_u32( vorrq_u32( vorrq_u32( s, e ), m ));
+	}
+#endif
+
+/*
+=================================================
+	LoadRow_UNorm8x4
+----
+	same as 'ReadUNorm<8,8,8,8>' for each pixel
+=================================================
+*/
+	static void LoadRow_UNorm8x4 (const ImageView::T *src, OUT RGBA32f *dst, const size_t count)
+	{
+		float*	out	= dst->data();
+		size_t	i	= 0;
+
+	#if defined(FG_IMAGEVIEW_AVX2)
+		const __m256	scale = _mm256_set1_ps( 1.0f / 256.0f );
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*4 ));
+
+			_mm256_storeu_ps( out + i*4 + 0, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( v )), scale ));
+			_mm256_storeu_ps( out + i*4 + 8, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_srli_si128( v, 8 ))), scale ));
+		}
+
+	#elif defined(FG_IMAGEVIEW_SSE2)
+		const __m128	scale	= _mm_set1_ps( 1.0f / 256.0f );
+		const __m128i	zero	= _mm_setzero_si128();
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	v	= _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*4 ));
+			const __m128i	lo	= _mm_unpacklo_epi8( v, zero );
+			const __m128i	hi	= _mm_unpackhi_epi8( v, zero );
+
+			_mm_storeu_ps( out + i*4 +  0, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero )), scale ));
+			_mm_storeu_ps( out + i*4 +  4, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero )), scale ));
+			_mm_storeu_ps( out + i*4 +  8, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero )), scale ));
+			_mm_storeu_ps( out + i*4 + 12, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero )), scale ));
+		}
+
+	#elif defined(FG_IMAGEVIEW_NEON)
+		const float		scale = 1.0f / 256.0f;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const uint8x16_t	v	= vld1q_u8( src + i*4 );
+			const uint16x8_t	lo	= vmovl_u8( vget_low_u8( v ));
+			const uint16x8_t	hi	= vmovl_u8( vget_high_u8( v ));
+
+			vst1q_f32( out + i*4 +  0, vmulq_n_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ))), scale ));
+			vst1q_f32( out + i*4 +  4, vmulq_n_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ))), scale ));
+			vst1q_f32( out + i*4 +  8, vmulq_n_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ))), scale ));
+			vst1q_f32( out + i*4 + 12, vmulq_n_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ))), scale ));
+		}
+	#endif
+
+		for (; i < count; ++i) {
+			ReadUNorm<8,8,8,8>( ArrayView<ImageView::T>{ src + i*4, 4 }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	LoadRow_Half4
+----
+	same as 'ReadFloat<16,16,16,16>' for each pixel
+=================================================
+*/
+	static void LoadRow_Half4 (const ImageView::T *src, OUT RGBA32f *dst, const size_t count)
+	{
+		float*	out	= dst->data();
+		size_t	i	= 0;
+
+	#if defined(FG_IMAGEVIEW_AVX2)
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	v0 = _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*8 + 0 ));
+			const __m128i	v1 = _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*8 + 16 ));
+
+			_mm256_storeu_ps( out + i*4 + 0, HalfToFloat( _mm256_cvtepu16_epi32( v0 )));
+			_mm256_storeu_ps( out + i*4 + 8, HalfToFloat( _mm256_cvtepu16_epi32( v1 )));
+		}
+
+	#elif defined(FG_IMAGEVIEW_SSE2)
+		const __m128i	zero = _mm_setzero_si128();
+
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m128i	v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*8 ));
+
+			_mm_storeu_ps( out + i*4 + 0, HalfToFloat( _mm_unpacklo_epi16( v, zero )));
+			_mm_storeu_ps( out + i*4 + 4, HalfToFloat( _mm_unpackhi_epi16( v, zero )));
+		}
+
+	#elif defined(FG_IMAGEVIEW_NEON)
+		for (; i + 2 <= count; i += 2)
+		{
+			const uint16x8_t	v = vld1q_u16( reinterpret_cast<const uint16_t *>( src + i*8 ));
+
+			vst1q_f32( out + i*4 + 0, HalfToFloat( vmovl_u16( vget_low_u16( v ))));
+			vst1q_f32( out + i*4 + 4, HalfToFloat( vmovl_u16( vget_high_u16( v ))));
+		}
+	#endif
+
+		for (; i < count; ++i) {
+			ReadFloat<16,16,16,16>( ArrayView<ImageView::T>{ src + i*8, 8 }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	LoadRow_Float_11_11_10
+----
+	same as 'ReadFloat_11_11_10' for each pixel
+=================================================
+*/
+	static void LoadRow_Float_11_11_10 (const ImageView::T *src, OUT RGBA32f *dst, const size_t count)
+	{
+		float*	out	= dst->data();
+		size_t	i	= 0;
+
+	#if defined(FG_IMAGEVIEW_SSE2)
+		const __m128i	exp_bias	= _mm_set1_epi32( 127 - 15 );
+		const __m128i	mask5		= _mm_set1_epi32( 0x1F );
+		const __m128i	mask6		= _mm_set1_epi32( 0x3F );
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	v	= _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*4 ));
+
+			const __m128i	r_e	= _mm_srli_epi32( v, 27 );
+			const __m128i	r_m	= _mm_and_si128( _mm_srli_epi32( v, 21 ), mask6 );
+			const __m128i	g_e	= _mm_and_si128( _mm_srli_epi32( v, 16 ), mask5 );
+			const __m128i	g_m	= _mm_and_si128( _mm_srli_epi32( v, 10 ), mask6 );
+			const __m128i	b_e	= _mm_and_si128( _mm_srli_epi32( v, 5 ), mask5 );
+			const __m128i	b_m	= _mm_and_si128( v, mask5 );
+
+			__m128	r = _mm_castsi128_ps( _mm_or_si128( _mm_slli_epi32( _mm_add_epi32( r_e, exp_bias ), 23 ), _mm_slli_epi32( r_m, 23-6 )));
+			__m128	g = _mm_castsi128_ps( _mm_or_si128( _mm_slli_epi32( _mm_add_epi32( g_e, exp_bias ), 23 ), _mm_slli_epi32( g_m, 23-6 )));
+			__m128	b = _mm_castsi128_ps( _mm_or_si128( _mm_slli_epi32( _mm_add_epi32( b_e, exp_bias ), 23 ), _mm_slli_epi32( b_m, 23-5 )));
+			__m128	a = _mm_set1_ps( 1.0f );
+
+			_MM_TRANSPOSE4_PS( r, g, b, a );
+
+			_mm_storeu_ps( out + i*4 +  0, r );
+			_mm_storeu_ps( out + i*4 +  4, g );
+			_mm_storeu_ps( out + i*4 +  8, b );
+			_mm_storeu_ps( out + i*4 + 12, a );
+		}
+
+	#elif defined(FG_IMAGEVIEW_NEON)
+		const uint32x4_t	exp_bias	= vdupq_n_u32( 127 - 15 );
+		const uint32x4_t	mask5		= vdupq_n_u32( 0x1F );
+		const uint32x4_t	mask6		= vdupq_n_u32( 0x3F );
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const uint32x4_t	v	= vld1q_u32( reinterpret_cast<const uint32_t *>( src + i*4 ));
+
+			const uint32x4_t	r_e	= vshrq_n_u32( v, 27 );
+			const uint32x4_t	r_m	= vandq_u32( vshrq_n_u32( v, 21 ), mask6 );
+			const uint32x4_t	g_e	= vandq_u32( vshrq_n_u32( v, 16 ), mask5 );
+			const uint32x4_t	g_m	= vandq_u32( vshrq_n_u32( v, 10 ), mask6 );
+			const uint32x4_t	b_e	= vandq_u32( vshrq_n_u32( v, 5 ), mask5 );
+			const uint32x4_t	b_m	= vandq_u32( v, mask5 );
+
+			float32x4x4_t	rgba;
+			rgba.val[0] = vreinterpretq_f32_u32( vorrq_u32( vshlq_n_u32( vaddq_u32( r_e, exp_bias ), 23 ), vshlq_n_u32( r_m, 23-6 )));
+			rgba.val[1] = vreinterpretq_f32_u32( vorrq_u32( vshlq_n_u32( vaddq_u32( g_e, exp_bias ), 23 ), vshlq_n_u32( g_m, 23-6 )));
+			rgba.val[2] = vreinterpretq_f32_u32( vorrq_u32( vshlq_n_u32( vaddq_u32( b_e, exp_bias ), 23 ), vshlq_n_u32( b_m, 23-5 )));
+			rgba.val[3] = vdupq_n_f32( 1.0f );
+
+			vst4q_f32( out + i*4, rgba );
+		}
+	#endif
+
+		for (; i < count; ++i) {
+			ReadFloat_11_11_10( ArrayView<ImageView::T>{ src + i*4, 4 }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	LoadRow_Float1
+----
+	same as 'ReadFloat<32,0,0,0>' for each pixel
+=================================================
+*/
+	static void LoadRow_Float1 (const ImageView::T *src, OUT RGBA32f *dst, const size_t count)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_IMAGEVIEW_SSE2)
+		for (; i + 4 <= count; i += 4) {
+			StoreR( _mm_loadu_ps( reinterpret_cast<const float *>( src + i*4 )), OUT dst[i].data() );
+		}
+	#elif defined(FG_IMAGEVIEW_NEON)
+		for (; i + 4 <= count; i += 4) {
+			StoreR( vld1q_f32( reinterpret_cast<const float *>( src + i*4 )), OUT dst[i].data() );
+		}
+	#endif
+
+		for (; i < count; ++i) {
+			ReadFloat<32,0,0,0>( ArrayView<ImageView::T>{ src + i*4, 4 }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	LoadRow_UNorm16x1
+----
+	same as 'ReadUNorm<16,0,0,0>' for each pixel
+=================================================
+*/
+	static void LoadRow_UNorm16x1 (const ImageView::T *src, OUT RGBA32f *dst, const size_t count)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_IMAGEVIEW_SSE2)
+		const __m128	scale	= _mm_set1_ps( 1.0f / 65536.0f );
+		const __m128i	zero	= _mm_setzero_si128();
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	v = _mm_loadl_epi64( reinterpret_cast<const __m128i *>( src + i*2 ));
+
+			StoreR( _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( v, zero )), scale ), OUT dst[i].data() );
+		}
+	#elif defined(FG_IMAGEVIEW_NEON)
+		for (; i + 4 <= count; i += 4)
+		{
+			const uint16x4_t	v = vld1_u16( reinterpret_cast<const uint16_t *>( src + i*2 ));
+
+			StoreR( vmulq_n_f32( vcvtq_f32_u32( vmovl_u16( v )), 1.0f / 65536.0f ), OUT dst[i].data() );
+		}
+	#endif
+
+		for (; i < count; ++i) {
+			ReadUNorm<16,0,0,0>( ArrayView<ImageView::T>{ src + i*2, 2 }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	LoadRow_UNorm24x1
+----
+	same as 'ReadUNorm<24,0,0,0>' for each 32 bit pixel
+=================================================
+*/
+	static void LoadRow_UNorm24x1 (const ImageView::T *src, OUT RGBA32f *dst, const size_t count)
+	{
+		size_t	i = 0;
+
+	#if defined(FG_IMAGEVIEW_SSE2)
+		const __m128	scale	= _mm_set1_ps( 1.0f / 16777216.0f );
+		const __m128i	mask	= _mm_set1_epi32( 0xFFFFFF );
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	v = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i*4 )), mask );
+
+			StoreR( _mm_mul_ps( _mm_cvtepi32_ps( v ), scale ), OUT dst[i].data() );
+		}
+	#elif defined(FG_IMAGEVIEW_NEON)
+		for (; i + 4 <= count; i += 4)
+		{
+			const uint32x4_t	v = vandq_u32( vld1q_u32( reinterpret_cast<const uint32_t *>( src + i*4 )), vdupq_n_u32( 0xFFFFFF ));
+
+			StoreR( vmulq_n_f32( vcvtq_f32_u32( v ), 1.0f / 16777216.0f ), OUT dst[i].data() );
+		}
+	#endif
+
+		for (; i < count; ++i) {
+			ReadUNorm<24,0,0,0>( ArrayView<ImageView::T>{ src + i*4, 4 }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	ToUNorm8
+----
+	NaN is converted to 0
+=================================================
+*/
+	forceinline uint8_t ToUNorm8 (float value)
+	{
+		const float	v = value * 256.0f;
+		return uint8_t( v > 0.0f ? (v < 255.0f ? v : 255.0f) : 0.0f );
+	}
+
+/*
+=================================================
+	ConvertToRGBA8
+----
+	same as 'ToUNorm8' for each component
+=================================================
+*/
+	static void ConvertToRGBA8 (const RGBA32f *src, OUT RGBA8u *dst, const size_t count)
+	{
+		const float*	in	= src->data();
+		uint8_t*		out	= dst->data();
+		size_t			i	= 0;
+
+	#if defined(FG_IMAGEVIEW_SSE2)
+		const __m128	scale	= _mm_set1_ps( 256.0f );
+		const __m128	zero	= _mm_setzero_ps();
+		const __m128	max_val	= _mm_set1_ps( 255.0f );
+
+		// 'max' returns second operand if one of them is NaN
+		const auto	Convert = [&] (const float *ptr) {
+			return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( ptr ), scale ), zero ), max_val ));
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i	c01 = _mm_packs_epi32( Convert( in + i*4 +  0 ), Convert( in + i*4 +  4 ));
+			const __m128i	c23 = _mm_packs_epi32( Convert( in + i*4 +  8 ), Convert( in + i*4 + 12 ));
+
+			_mm_storeu_si128( reinterpret_cast<__m128i *>( out + i*4 ), _mm_packus_epi16( c01, c23 ));
+		}
+
+	#elif defined(FG_IMAGEVIEW_NEON)
+		const float32x4_t	zero	= vdupq_n_f32( 0.0f );
+		const float32x4_t	max_val	= vdupq_n_f32( 255.0f );
+
+		// 'vmaxq_f32' returns NaN, so use compare and select
+		const auto	Convert = [&] (const float *ptr) {
+			const float32x4_t	v = vmulq_n_f32( vld1q_f32( ptr ), 256.0f );
+			return vmovn_u32( vcvtq_u32_f32( vminq_f32( vbslq_f32( vcgtq_f32( v, zero ), v, zero ), max_val )));
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const uint8x8_t		c01 = vmovn_u16( vcombine_u16( Convert( in + i*4 + 0 ), Convert( in + i*4 +  4 )));
+			const uint8x8_t		c23 = vmovn_u16( vcombine_u16( Convert( in + i*4 + 8 ), Convert( in + i*4 + 12 )));
+
+			vst1q_u8( out + i*4, vcombine_u8( c01, c23 ));
+		}
+	#endif
+
+		for (; i < count; ++i)
+		{
+			dst[i].r = ToUNorm8( src[i].r );
+			dst[i].g = ToUNorm8( src[i].g );
+			dst[i].b = ToUNorm8( src[i].b );
+			dst[i].a = ToUNorm8( src[i].a );
+		}
+	}
+
 /*
 =================================================
 	constructor
@@ -360,6 +788,7 @@ namespace {
 								   null);
 				_loadI4			= &ReadInt<8,8,8,8>;
 				_loadU4			= &ReadUInt<8,8,8,8>;
+				_loadRowF4		= (_loadF4 == &ReadUNorm<8,8,8,8> ? &LoadRow_UNorm8x4 : null);
 				break;
 
 			case EPixelFormat::R16_SNorm :
@@ -371,6 +800,7 @@ namespace {
 				_loadF4			= (_format == EPixelFormat::R16_SNorm ? &ReadSNorm<16,0,0,0> : _format == EPixelFormat::R16_UNorm ? &ReadUNorm<16,0,0,0> : null);
 				_loadI4			= &ReadInt<16,0,0,0>;
 				_loadU4			= &ReadUInt<16,0,0,0>;
+				_loadRowF4		= (_format == EPixelFormat::R16_UNorm ? &LoadRow_UNorm16x1 : null);
 				break;
 
 			case EPixelFormat::RG16_SNorm :
@@ -467,18 +897,21 @@ namespace {
 				ASSERT( aspect == Default or aspect == EImageAspect::Color );
 				_bitsPerPixel	= 4*16;
 				_loadF4			= &ReadFloat<16,16,16,16>;
+				_loadRowF4		= &LoadRow_Half4;
 				break;
 
 			case EPixelFormat::RGB_11_11_10F :
 				ASSERT( aspect == Default or aspect == EImageAspect::Color );
 				_bitsPerPixel	= 11 + 11 + 10;
 				_loadF4			= &ReadFloat_11_11_10;
+				_loadRowF4		= &LoadRow_Float_11_11_10;
 				break;
 
 			case EPixelFormat::R32F :
 				ASSERT( aspect == Default or aspect == EImageAspect::Color );
 				_bitsPerPixel	= 1*32;
 				_loadF4			= &ReadFloat<32,0,0,0>;
+				_loadRowF4		= &LoadRow_Float1;
 				break;
 
 			case EPixelFormat::RG32F :
@@ -499,18 +932,42 @@ namespace {
 				_loadF4			= &ReadFloat<32,32,32,32>;
 				break;
 
+			// depth aspect in buffer has 16 or 32 bits per texel, depth value is stored in the red channel
 			case EPixelFormat::Depth16 :
+			case EPixelFormat::Depth16_Stencil8	:
 			case EPixelFormat::Depth24 :
+			case EPixelFormat::Depth24_Stencil8 :
 			case EPixelFormat::Depth32F :
+			case EPixelFormat::Depth32F_Stencil8 :
+				if ( aspect == EImageAspect::Stencil )
+				{
+					ASSERT( _format == EPixelFormat::Depth16_Stencil8 or _format == EPixelFormat::Depth24_Stencil8 or _format == EPixelFormat::Depth32F_Stencil8 );
+					_bitsPerPixel	= 8;
+					_loadI4			= &ReadInt<8,0,0,0>;
+					_loadU4			= &ReadUInt<8,0,0,0>;
+					break;
+				}
 				ASSERT( aspect == Default or aspect == EImageAspect::Depth );
-				ASSERT(false);
-				break;
 
-			case EPixelFormat::Depth16_Stencil8	:
-			case EPixelFormat::Depth24_Stencil8 :
-			case EPixelFormat::Depth32F_Stencil8 :
-				ASSERT( aspect == Default or aspect == EImageAspect::Depth or aspect == EImageAspect::Stencil );
-				ASSERT(false);
+				if ( _format == EPixelFormat::Depth16 or _format == EPixelFormat::Depth16_Stencil8 )
+				{
+					_bitsPerPixel	= 16;
+					_loadF4			= &ReadUNorm<16,0,0,0>;
+					_loadRowF4		= &LoadRow_UNorm16x1;
+				}
+				else
+				if ( _format == EPixelFormat::Depth24 or _format == EPixelFormat::Depth24_Stencil8 )
+				{
+					_bitsPerPixel	= 32;
+					_loadF4			= &ReadUNorm<24,0,0,0>;
+					_loadRowF4		= &LoadRow_UNorm24x1;
+				}
+				else
+				{
+					_bitsPerPixel	= 32;
+					_loadF4			= &ReadFloat<32,0,0,0>;
+					_loadRowF4		= &LoadRow_Float1;
+				}
 				break;
 
 			case EPixelFormat::sRGB8 :
@@ -596,4 +1053,101 @@ namespace {
 		END_ENUM_CHECKS();
 	}
 
+/*
+=================================================
+	LoadRow
+=================================================
+*/
+	bool  ImageView::LoadRow (uint y, uint z, OUT RGBA32f *dst) const
+	{
+		return _LoadRow( GetRow( y, z ), _dimension.x, OUT dst );
+	}
+
+	bool  ImageView::LoadRow (uint y, uint z, OUT RGBA8u *dst) const
+	{
+		return _LoadRow( GetRow( y, z ), _dimension.x, OUT dst );
+	}
+
+/*
+=================================================
+	_LoadRow
+=================================================
+*/
+	bool  ImageView::_LoadRow (ArrayView<T> row, size_t count, OUT RGBA32f *dst) const
+	{
+		CHECK_ERR( dst and _loadF4 );
+		ASSERT( row.size() >= (count * _bitsPerPixel + 7) / 8 );
+
+		if ( _loadRowF4 )
+		{
+			_loadRowF4( row.data(), OUT dst, count );
+			return true;
+		}
+
+		for (size_t x = 0; x < count; ++x) {
+			_loadF4( row.section( (x * _bitsPerPixel) / 8, (_bitsPerPixel + 7) / 8 ), OUT dst[x] );
+		}
+		return true;
+	}
+
+	bool  ImageView::_LoadRow (ArrayView<T> row, size_t count, OUT RGBA8u *dst) const
+	{
+		CHECK_ERR( dst and _loadF4 );
+
+		// same result as conversion from float
+		if ( _loadF4 == &ReadUNorm<8,8,8,8> )
+		{
+			ASSERT( row.size() >= count * sizeof(*dst) );
+			std::memcpy( OUT dst, row.data(), count * sizeof(*dst) );
+			return true;
+		}
+
+		StaticArray< RGBA32f, 64 >	temp;
+
+		for (size_t x = 0; x < count; x += temp.size())
+		{
+			const size_t	cnt = Min( count - x, temp.size() );
+
+			CHECK_ERR( _LoadRow( row.section( (x * _bitsPerPixel) / 8, UMax ), cnt, OUT temp.data() ));
+			ConvertToRGBA8( temp.data(), OUT dst + x, cnt );
+		}
+		return true;
+	}
+
+/*
+=================================================
+	ConvertRegion
+=================================================
+*/
+	bool  ImageView::ConvertRegion (const uint3 &offset, const uint3 &size, OUT Array<RGBA32f> &dst) const
+	{
+		return _ConvertRegion( offset, size, OUT dst );
+	}
+
+	bool  ImageView::ConvertRegion (const uint3 &offset, const uint3 &size, OUT Array<RGBA8u> &dst) const
+	{
+		return _ConvertRegion( offset, size, OUT dst );
+	}
+
+	template <typename ColorType>
+	bool  ImageView::_ConvertRegion (const uint3 &offset, const uint3 &size, OUT Array<ColorType> &dst) const
+	{
+		CHECK_ERR(All( offset + size <= _dimension ));
+
+		dst.resize( size_t(size.x) * size.y * size.z );
+
+		ColorType*	ptr = dst.data();
+
+		for (uint z = 0; z < size.z; ++z)
+		for (uint y = 0; y < size.y; ++y)
+		{
+			const auto	row = GetRow( offset.y + y, offset.z + z ).section( (offset.x * _bitsPerPixel) / 8, UMax );
+
+			CHECK_ERR( _LoadRow( row, size.x, OUT ptr ));
+			ptr += size.x;
+		}
+		return true;
+	}
+
+
 }	// FG
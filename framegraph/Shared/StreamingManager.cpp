@@ -0,0 +1,394 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Public/StreamingManager.h"
+#include "Shared/EnumUtils.h"
+
+namespace FG
+{
+
+	//
+	// Request
+	//
+	struct StreamingManager::Request
+	{
+		RequestID		id;
+		int				priority		= 0;
+		EQueueType		queue			= Default;
+		Array<uint8_t>	data;
+		BytesU			dataOffset;					// size of recorded data
+		Callback_t		onComplete;
+
+		// buffer
+		BufferID		buffer;						// strong reference, released when upload is complete
+		BytesU			bufferOffset;
+
+		// image
+		ImageID			image;						// strong reference, released when upload is complete
+		uint3			dimension;					// dimension of the base mipmap
+		uint			baseMipmap		= 0;
+		uint			mipmapCount		= 0;
+		ImageLayer		arrayLayer;
+		EImageAspect	aspectMask		= Default;
+		uint2			blockDim;
+		uint			bitsPerBlock	= 0;
+
+		// current position
+		uint			mipmap			= 0;
+		uint			slice			= 0;
+		uint			row				= 0;
+	};
+//-----------------------------------------------------------------------------
+
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	StreamingManager::StreamingManager (const FrameGraph &fg, const Config &cfg) :
+		_frameGraph{ fg },
+		_config{ Max( cfg.budgetPerFrame, 1_Kb ), Clamp( cfg.maxChunkSize, 1_Kb, Max( cfg.budgetPerFrame, 1_Kb )), Max( cfg.maxBatchesInFlight, 1u )}
+	{
+		CHECK( _frameGraph );
+
+		if ( AllBits( _frameGraph->GetAvilableQueues(), EQueueUsage::AsyncTransfer ))
+			_transferQueue = EQueueType::AsyncTransfer;
+	}
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	StreamingManager::~StreamingManager ()
+	{
+		Release();
+	}
+
+/*
+=================================================
+	Upload (image)
+=================================================
+*/
+	StreamingManager::RequestID  StreamingManager::Upload (ImageRequest src)
+	{
+		CHECK_ERR( _frameGraph->IsResourceAlive( src.image ));
+		CHECK_ERR( src.mipmapCount > 0 and src.data.size() );
+
+		ImageDesc const&	desc	 = _frameGraph->GetDescription( src.image );
+		auto const&			fmt_info = EPixelFormat_GetInfo( desc.format );
+
+		CHECK_ERR( src.baseMipmap.Get() + src.mipmapCount <= desc.maxLevel.Get() );
+		CHECK_ERR( src.arrayLayer < desc.arrayLayers );
+
+		auto	req = MakeUnique<Request>();
+		req->priority		= src.priority;
+		req->queue			= (AllBits( desc.queues, EQueueUsage::AsyncTransfer ) ? _transferQueue : EQueueType::Graphics);
+		req->data			= std::move(src.data);
+		req->onComplete		= std::move(src.onComplete);
+		req->image			= _frameGraph->AcquireResource( src.image );
+		req->dimension		= Max( desc.dimension, 1u );
+		req->baseMipmap		= src.baseMipmap.Get();
+		req->mipmapCount	= src.mipmapCount;
+		req->arrayLayer		= src.arrayLayer;
+		req->aspectMask		= src.aspectMask;
+		req->blockDim		= fmt_info.blockSize;
+		req->bitsPerBlock	= src.aspectMask != EImageAspect::Stencil ? fmt_info.bitsPerBlock : fmt_info.bitsPerBlock2;
+
+		CHECK_ERR( req->bitsPerBlock > 0 );
+		return _AddRequest( std::move(req) );
+	}
+
+/*
+=================================================
+	Upload (buffer)
+=================================================
+*/
+	StreamingManager::RequestID  StreamingManager::Upload (BufferRequest src)
+	{
+		CHECK_ERR( _frameGraph->IsResourceAlive( src.buffer ));
+		CHECK_ERR( src.data.size() );
+
+		BufferDesc const&	desc = _frameGraph->GetDescription( src.buffer );
+		CHECK_ERR( src.offset + ArraySizeOf(src.data) <= desc.size );
+
+		auto	req = MakeUnique<Request>();
+		req->priority		= src.priority;
+		req->queue			= (AllBits( desc.queues, EQueueUsage::AsyncTransfer ) ? _transferQueue : EQueueType::Graphics);
+		req->data			= std::move(src.data);
+		req->onComplete		= std::move(src.onComplete);
+		req->buffer			= _frameGraph->AcquireResource( src.buffer );
+		req->bufferOffset	= src.offset;
+
+		return _AddRequest( std::move(req) );
+	}
+
+/*
+=================================================
+	_AddRequest
+=================================================
+*/
+	StreamingManager::RequestID  StreamingManager::_AddRequest (UniquePtr<Request> &&req)
+	{
+		EXLOCK( _pendingGuard );
+
+		req->id = RequestID(++_requestCounter);
+		_pendingSize += ArraySizeOf(req->data);
+
+		// keep order of requests with the same priority
+		auto	iter = std::upper_bound( _pending.begin(), _pending.end(), req->priority,
+										 [] (int priority, const UniquePtr<Request> &rhs) { return priority > rhs->priority; });
+
+		return (*_pending.insert( iter, std::move(req) ))->id;
+	}
+
+/*
+=================================================
+	Update
+=================================================
+*/
+	bool  StreamingManager::Update (const CommandBuffer &dependent)
+	{
+		_RetireCompleted();
+
+		if ( _inFlight.size() >= _config.maxBatchesInFlight )
+			return true;
+
+		// [0] - transfer queue, [1] - graphics queue for resources that are not shared with transfer queue
+		StaticArray< CommandBuffer, 2 >	cmd_buffers;
+		const EQueueType				queues[] = { _transferQueue, EQueueType::Graphics };
+		InFlight						batch;
+		Requests_t						failed;
+		BytesU							budget	= _config.budgetPerFrame;
+
+		{
+			EXLOCK( _pendingGuard );
+
+			for (auto iter = _pending.begin(); iter != _pending.end() and budget > 0_b;)
+			{
+				Request&	req		= **iter;
+				auto&		cmd		= cmd_buffers[ req.queue == _transferQueue ? 0 : 1 ];
+				const auto	old		= budget;
+				bool		complete = false;
+
+				if ( not cmd )
+				{
+					cmd = _frameGraph->Begin( CommandBufferDesc{ req.queue }.SetDebugName( "Streaming" ));
+					CHECK_ERR( cmd );
+				}
+
+				const bool	ok = (req.image ? _RecordImage( req, cmd, INOUT budget, OUT complete ) :
+											  _RecordBuffer( req, cmd, INOUT budget, OUT complete ));
+
+				_pendingSize -= (old - budget);
+
+				if ( not ok )
+				{
+					_pendingSize -= (ArraySizeOf(req.data) - req.dataOffset);
+					failed.push_back( std::move(*iter) );
+					iter = _pending.erase( iter );
+					continue;
+				}
+
+				if ( not complete )
+					break;	// budget is exhausted
+
+				batch.completed.push_back( std::move(*iter) );
+				iter = _pending.erase( iter );
+			}
+		}
+
+		_ReleaseRequests( INOUT failed, false );
+
+		EQueueUsage		flush_queues = Default;
+
+		for (size_t i = 0; i < cmd_buffers.size(); ++i)
+		{
+			auto&	cmd = cmd_buffers[i];
+			if ( not cmd )
+				continue;
+
+			CHECK_ERR( _frameGraph->Execute( INOUT cmd ));
+
+			if ( dependent )
+				CHECK( dependent->AddDependency( cmd ));
+
+			flush_queues |= EQueueUsage(1u << uint(queues[i]));
+			batch.cmdBuffers.push_back( cmd );
+		}
+
+		if ( batch.cmdBuffers.empty() )
+		{
+			ASSERT( batch.completed.empty() );
+			return true;
+		}
+
+		// submit immediately, so upload may be overlapped with rendering
+		CHECK( _frameGraph->Flush( flush_queues ));
+
+		_inFlight.push_back( std::move(batch) );
+		return true;
+	}
+
+/*
+=================================================
+	_RecordImage
+=================================================
+*/
+	bool  StreamingManager::_RecordImage (Request &req, const CommandBuffer &cmd, INOUT BytesU &budget, OUT bool &complete) const
+	{
+		const bool	is_first	= (budget == _config.budgetPerFrame);
+		const uint	block_h		= req.blockDim.y;
+
+		complete = false;
+
+		for (; req.mipmap < req.mipmapCount;)
+		{
+			const uint		mip			= req.mipmap + req.baseMipmap;
+			const uint3		dim			= Max( uint3{ req.dimension.x >> mip, req.dimension.y >> mip, req.dimension.z >> mip }, 1u );
+
+			// same pitches as in 'UpdateImage' with zero 'dataRowPitch' and 'dataSlicePitch'
+			const BytesU	row_pitch	= BytesU(dim.x * req.bitsPerBlock + req.blockDim.x-1) / (req.blockDim.x * 8);
+
+			// chunk contains whole rows of blocks
+			const uint		max_rows	= uint(Min( _config.maxChunkSize, budget ) / row_pitch) * block_h;
+			const uint		rows		= Min( max_rows > 0 ? max_rows : (is_first ? block_h : 0u), dim.y - req.row );
+
+			if ( rows == 0 )
+				return true;	// budget is exhausted
+
+			const BytesU	size		= (rows * row_pitch + block_h-1) / block_h;
+
+			CHECK_ERR( req.dataOffset + size <= ArraySizeOf(req.data) );
+
+			UpdateImage		task;
+			task.SetImage( req.image, int3{ 0, int(req.row), int(req.slice) }, MipmapLevel{mip} );
+			task.SetData( ArrayView<uint8_t>{ req.data.data() + size_t(req.dataOffset), size_t(size) }, uint2{ dim.x, rows }, row_pitch );
+			task.arrayLayer	= req.arrayLayer;
+			task.aspectMask	= req.aspectMask;
+
+			CHECK_ERR( cmd->AddTask( task ));
+
+			req.dataOffset	+= size;
+			req.row			+= rows;
+			budget			 = size < budget ? budget - size : 0_b;
+
+			if ( req.row >= dim.y )
+			{
+				req.row = 0;
+				if ( ++req.slice >= dim.z )
+				{
+					req.slice = 0;
+					++req.mipmap;
+				}
+			}
+		}
+
+		ASSERT( req.dataOffset == ArraySizeOf(req.data) );
+		complete = true;
+		return true;
+	}
+
+/*
+=================================================
+	_RecordBuffer
+=================================================
+*/
+	bool  StreamingManager::_RecordBuffer (Request &req, const CommandBuffer &cmd, INOUT BytesU &budget, OUT bool &complete) const
+	{
+		const BytesU	total = ArraySizeOf(req.data);
+
+		for (; req.dataOffset < total;)
+		{
+			const BytesU	size = Min( total - req.dataOffset, _config.maxChunkSize, budget );
+
+			if ( size == 0_b )
+				break;	// budget is exhausted
+
+			CHECK_ERR( cmd->AddTask( UpdateBuffer{ req.buffer, req.bufferOffset + req.dataOffset,
+												   ArrayView<uint8_t>{ req.data.data() + size_t(req.dataOffset), size_t(size) }}));
+			req.dataOffset	+= size;
+			budget			-= size;
+		}
+
+		complete = (req.dataOffset == total);
+		return true;
+	}
+
+/*
+=================================================
+	_RetireCompleted
+----
+	batches are complete in submission order, so stop at the first incomplete batch
+=================================================
+*/
+	void  StreamingManager::_RetireCompleted ()
+	{
+		for (; _inFlight.size();)
+		{
+			auto&	batch = _inFlight.front();
+
+			if ( not _frameGraph->Wait( batch.cmdBuffers, Nanoseconds{0} ))
+				break;
+
+			_ReleaseRequests( INOUT batch.completed, true );
+			_inFlight.pop_front();
+		}
+	}
+
+/*
+=================================================
+	_ReleaseRequests
+=================================================
+*/
+	void  StreamingManager::_ReleaseRequests (INOUT Requests_t &requests, bool complete)
+	{
+		for (auto& req : requests)
+		{
+			if ( req->image )
+				_frameGraph->ReleaseResource( req->image );
+
+			if ( req->buffer )
+				_frameGraph->ReleaseResource( req->buffer );
+
+			if ( complete and req->onComplete )
+				req->onComplete();
+		}
+		requests.clear();
+	}
+
+/*
+=================================================
+	Release
+=================================================
+*/
+	void  StreamingManager::Release ()
+	{
+		if ( not _frameGraph )
+			return;
+
+		for (auto& batch : _inFlight)
+		{
+			CHECK( _frameGraph->Wait( batch.cmdBuffers ));
+			_ReleaseRequests( INOUT batch.completed, true );
+		}
+		_inFlight.clear();
+
+		EXLOCK( _pendingGuard );
+		_ReleaseRequests( INOUT _pending, false );
+		_pendingSize = 0_b;
+	}
+
+/*
+=================================================
+	PendingSize
+=================================================
+*/
+	BytesU  StreamingManager::PendingSize ()
+	{
+		EXLOCK( _pendingGuard );
+		return _pendingSize;
+	}
+
+
+}	// FG
@@ -320,6 +320,21 @@ namespace FG
 		_accessForRead.clear();
 	}
 
+/*
+=================================================
+	DiscardState
+----
+	content is not needed anymore, skip transition to the default state.
+=================================================
+*/
+	void VLocalBuffer::DiscardState () const
+	{
+		ASSERT( _pendingAccesses.empty() and "you must commit all pending states before discarding" );
+
+		_accessForWrite.clear();
+		_accessForRead.clear();
+	}
+
 /*
 =================================================
 	CommitBarrier
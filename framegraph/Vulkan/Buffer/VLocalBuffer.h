@@ -77,6 +77,7 @@ namespace FG
 		void SetInitialState (bool immutable) const;
 		void AddPendingState (const BufferState &state) const;
 		void ResetState (ExeOrderIndex index, VBarrierManager &barrierMngr, Ptr<VLocalDebugger> debugger) const;
+		void DiscardState () const;
 		void CommitBarrier (VBarrierManager &barrierMngr, Ptr<VLocalDebugger> debugger) const;
 
 		ND_ bool				IsCreated ()	const	{ return _bufferData != null; }
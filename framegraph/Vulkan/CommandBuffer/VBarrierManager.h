@@ -43,7 +43,7 @@ namespace FG
 		}
 
 
-		void Commit (const VDevice &dev, VkCommandBuffer cmd)
+		bool Commit (const VDevice &dev, VkCommandBuffer cmd)
 		{
 			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 
@@ -54,11 +54,13 @@ namespace FG
 										  uint(_bufferBarriers.size()), _bufferBarriers.data(),
 										  uint(_imageBarriers.size()), _imageBarriers.data() );
 				ClearBarriers();
+				return true;
 			}
+			return false;
 		}
 		
 
-		void ForceCommit (const VDevice &dev, VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
+		bool ForceCommit (const VDevice &dev, VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
 		{
 			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 
@@ -72,7 +74,27 @@ namespace FG
 										  uint(_bufferBarriers.size()), _bufferBarriers.data(),
 										  uint(_imageBarriers.size()), _imageBarriers.data() );
 				ClearBarriers();
+				return true;
 			}
+			return false;
+		}
+
+
+		// second half of the split barrier, 'srcStage' must be same as in 'vkCmdSetEvent'
+		bool CommitWaitEvent (const VDevice &dev, VkCommandBuffer cmd, VkEvent event, VkPipelineStageFlags srcStage)
+		{
+			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
+
+			if ( mem_count or _bufferBarriers.size() or _imageBarriers.size() )
+			{
+				dev.vkCmdWaitEvents( cmd, 1, &event, srcStage, _dstStageMask,
+									 mem_count, &_memoryBarrier,
+									 uint(_bufferBarriers.size()), _bufferBarriers.data(),
+									 uint(_imageBarriers.size()), _imageBarriers.data() );
+				ClearBarriers();
+				return true;
+			}
+			return false;
 		}
 
 
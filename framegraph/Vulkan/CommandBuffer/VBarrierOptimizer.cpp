@@ -0,0 +1,196 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VBarrierOptimizer.h"
+#include "stl/Algorithms/StringUtils.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	Optimize
+----
+	'tasks' must be in execution order.
+	All usages of the same resource in one task are moved together,
+	if resource is used in different states then transition can't be moved.
+=================================================
+*/
+	bool  VBarrierOptimizer::Optimize (ArrayView<Task> tasks, ArrayView<Usage> usages, bool allowSplit, OUT Result &result)
+	{
+		struct LastUse
+		{
+			uint		task;
+			uint64_t	state;
+			bool		isWrite;
+		};
+
+		struct Interval
+		{
+			uint		first;		// earliest task where transition can be recorded
+			uint		last;		// consumer task
+			uint		usage;
+			uint		producer;	// previous task that used this resource
+		};
+
+		result = Result{};
+		result.barrierPoint.resize( usages.size(), UMax );
+		result.splitProducer.resize( usages.size(), UMax );
+
+		HashMap< void const*, LastUse >	last_use;
+		Array< Interval >				intervals;
+		uint							lower_bound	= 0;
+
+		const auto	ForEachInGroup = [tasks, usages] (uint taskIndex, uint usageIndex, auto&& fn)
+		{
+			auto&	task = tasks[taskIndex];
+			for (uint j = usageIndex, end = task.firstUsage + task.usageCount; j < end; ++j)
+			{
+				if ( usages[j].resource == usages[usageIndex].resource )
+					fn( j );
+			}
+		};
+
+		// find intervals where transitions can be recorded
+		for (uint i = 0; i < tasks.size(); ++i)
+		{
+			auto&	task = tasks[i];
+			CHECK_ERR( size_t(task.firstUsage) + task.usageCount <= usages.size() );
+
+			if ( task.opaque )
+			{
+				lower_bound = i+1;
+				continue;
+			}
+
+			if ( task.fence )
+				lower_bound = i;
+
+			bool		has_transitions	= false;
+			const uint	end				= task.firstUsage + task.usageCount;
+
+			for (uint u = task.firstUsage; u < end; ++u)
+			{
+				auto&	usage		= usages[u];
+				bool	processed	= false;
+				bool	pinned		= false;
+				bool	is_write	= false;
+
+				for (uint j = task.firstUsage; j < u; ++j) {
+					processed |= (usages[j].resource == usage.resource);
+				}
+				if ( processed )
+					continue;
+
+				ForEachInGroup( i, u, [&] (uint j) {
+						pinned   |= (usages[j].state != usage.state);
+						is_write |= usages[j].isWrite;
+					});
+
+				auto		iter		= last_use.find( usage.resource );
+				const bool	has_prev	= (iter != last_use.end());
+				const bool	required	= (not has_prev or pinned or is_write or iter->second.isWrite or iter->second.state != usage.state);
+
+				if ( required )
+				{
+					Interval	range;
+					range.first		= (pinned ? i : Max( lower_bound, (has_prev ? iter->second.task + 1 : 0u) ));
+					range.last		= i;
+					range.usage		= u;
+					range.producer	= (has_prev ? iter->second.task : UMax);
+
+					intervals.push_back( range );
+					has_transitions = true;
+				}
+
+				// next use of the pinned resource always requires transition
+				last_use.insert_or_assign( usage.resource, LastUse{ i, usage.state, (is_write or pinned) });
+			}
+
+			result.barriersBefore += uint(has_transitions);
+		}
+
+		// intervals are sorted by consumer index, so greedy algorithm gives minimal number of barriers
+		Array< Pair< uint, uint >>	points;		// task index and first interval
+
+		for (size_t k = 0; k < intervals.size(); ++k)
+		{
+			auto&	range = intervals[k];
+
+			if ( points.empty() or range.first > points.back().first )
+				points.emplace_back( range.last, uint(k) );
+
+			ForEachInGroup( range.last, range.usage, [&result, p = points.back().first] (uint j) { result.barrierPoint[j] = p; });
+		}
+
+		// barrier with single transition may be replaced by split barrier
+		for (size_t k = 0; k < points.size(); ++k)
+		{
+			const uint	first	= points[k].second;
+			const uint	last	= uint(k+1 < points.size() ? points[k+1].second : intervals.size());
+			auto&		range	= intervals[first];
+
+			if ( allowSplit							and
+				 last - first == 1					and
+				 range.producer != UMax				and
+				 range.first == range.producer + 1	and		// no opaque tasks between producer and consumer
+				 range.last - range.producer >= SplitDistance )
+			{
+				ForEachInGroup( range.last, range.usage, [&result, p = range.producer] (uint j) { result.splitProducer[j] = p; });
+				++result.splitBarriers;
+			}
+		}
+
+		result.barriersAfter = uint(points.size()) - result.splitBarriers;
+		return true;
+	}
+
+/*
+=================================================
+	DumpToString
+=================================================
+*/
+	void  VBarrierOptimizer::DumpToString (ArrayView<Task> tasks, const Result &result, OUT String &str)
+	{
+		const auto	DumpUsages = [&result, &str] (StringView name, const auto &pred)
+		{
+			bool	empty = true;
+
+			for (size_t u = 0; u < result.barrierPoint.size(); ++u)
+			{
+				if ( not pred( u ))
+					continue;
+
+				if ( empty )
+					str << ' ' << name << ": ";
+				else
+					str << ", ";
+
+				str << ToString( u );
+				empty = false;
+			}
+			return not empty;
+		};
+
+		str.clear();
+		str << "barriers: " << ToString( result.barriersBefore ) << " -> " << ToString( result.barriersAfter )
+			<< ", split: " << ToString( result.splitBarriers ) << '\n';
+
+		for (size_t t = 0; t < tasks.size(); ++t)
+		{
+			const size_t	len = str.length();
+			str << "  [" << ToString( t ) << "]" << (tasks[t].opaque ? " opaque" : "") << (tasks[t].fence ? " fence" : "");
+
+			bool	changed = tasks[t].opaque or tasks[t].fence;
+			changed |= DumpUsages( "wait", [&] (size_t u) { return result.barrierPoint[u] == t and result.splitProducer[u] != UMax; });
+			changed |= DumpUsages( "barrier", [&] (size_t u) { return result.barrierPoint[u] == t and result.splitProducer[u] == UMax; });
+			changed |= DumpUsages( "signal", [&] (size_t u) { return result.splitProducer[u] == t; });
+
+			if ( changed )
+				str << '\n';
+			else
+				str.resize( len );
+		}
+	}
+
+
+}	// FG
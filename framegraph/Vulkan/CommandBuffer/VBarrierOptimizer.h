@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Moves resource transitions across scheduled tasks to minimize number of pipeline barriers.
+	Transition for task 'i' may be recorded anywhere after the previous use of the resource,
+	so each transition is an interval of tasks, and the minimal set of barriers is
+	the minimal set of points that stabs all intervals (greedy by right endpoint).
+	If a barrier contains only one transition and producer is far from consumer
+	then split barrier (set event / wait event) is used instead.
+*/
+
+#pragma once
+
+#include "VCommon.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Barrier Optimizer
+	//
+
+	class VBarrierOptimizer final
+	{
+	// types
+	public:
+		struct Usage
+		{
+			void const*		resource	= null;
+			uint64_t		state		= 0;		// resource state and image layout, transition is required if state is changed
+			bool			isWrite		= false;
+		};
+
+		struct Task
+		{
+			uint			firstUsage	= 0;		// index in usage array
+			uint			usageCount	= 0;
+			bool			opaque		= false;	// resource usage is unknown, transitions can not be moved across this task
+			bool			fence		= false;	// task starts with memory aliasing barrier, transitions can not be moved above it
+		};
+
+		struct Result
+		{
+			Array<uint>		barrierPoint;			// for each usage: index of task before which transition is recorded
+			Array<uint>		splitProducer;			// for each usage: index of task after which event is set, 'UMax' if pipeline barrier is used
+			uint			barriersBefore	= 0;	// number of pipeline barriers when each task records its own transitions
+			uint			barriersAfter	= 0;
+			uint			splitBarriers	= 0;
+		};
+
+		static constexpr uint	SplitDistance	= 4;	// minimal number of tasks between producer and consumer to use split barrier
+
+
+	// methods
+	public:
+		static bool  Optimize (ArrayView<Task> tasks, ArrayView<Usage> usages, bool allowSplit, OUT Result &result);
+		static void  DumpToString (ArrayView<Task> tasks, const Result &result, OUT String &str);
+	};
+
+
+}	// FG
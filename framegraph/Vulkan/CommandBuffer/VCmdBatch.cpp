@@ -2,6 +2,7 @@
 
 #include "VCmdBatch.h"
 #include "VFrameGraph.h"
+#include "VReadbackFuture.h"
 
 namespace FG
 {
@@ -47,11 +48,16 @@ namespace FG
 		ASSERT( GetState() == EState::Initial );
 
 		ASSERT( _dependencies.empty() );
+		ASSERT( _dependents.empty() and _waitCount == 0 );
 		ASSERT( _batch.commands.empty() );
+		ASSERT( _batch.secondaryCommands.empty() );
+		ASSERT( _batch.pools.empty() );
 		ASSERT( _batch.signalSemaphores.empty() );
 		ASSERT( _batch.waitSemaphores.empty() );
+		ASSERT( _batch.signalValues.empty() and _batch.waitValues.empty() );
 		ASSERT( _staging.hostToDevice.empty() );
 		ASSERT( _staging.deviceToHost.empty() );
+		ASSERT( _staging.readback.empty() );
 		ASSERT( _staging.onBufferLoadedEvents.empty() );
 		ASSERT( _staging.onImageLoadedEvents.empty() );
 		ASSERT( _resourcesToRelease.empty() );
@@ -65,7 +71,8 @@ namespace FG
 
 		if ( auto queue = _frameGraph.FindQueue( type ))
 		{
-			_supportsQuery = AnyBits( queue->familyFlags, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT );
+			_supportsQuery = AnyBits( queue->familyFlags, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT ) and
+							 (_indexInPool < VFrameGraph::MaxQueryBatches);
 		}
 
 		_state.store( EState::Initial, memory_order_relaxed );
@@ -98,13 +105,14 @@ namespace FG
 	SignalSemaphore
 =================================================
 */
-	void  VCmdBatch::SignalSemaphore (VkSemaphore sem)
+	void  VCmdBatch::SignalSemaphore (VkSemaphore sem, uint64_t timelineValue)
 	{
 		EXLOCK( _drCheck );
 		ASSERT( GetState() < EState::Submitted );
 		CHECK_ERRV( _batch.signalSemaphores.size() < _batch.signalSemaphores.capacity() );
 
 		_batch.signalSemaphores.push_back( sem );
+		_batch.signalValues.push_back( timelineValue );
 	}
 	
 /*
@@ -112,13 +120,14 @@ namespace FG
 	WaitSemaphore
 =================================================
 */
-	void  VCmdBatch::WaitSemaphore (VkSemaphore sem, VkPipelineStageFlags stage)
+	void  VCmdBatch::WaitSemaphore (VkSemaphore sem, VkPipelineStageFlags stage, uint64_t timelineValue)
 	{
 		EXLOCK( _drCheck );
 		ASSERT( GetState() < EState::Submitted );
 		CHECK_ERRV( _batch.waitSemaphores.size() < _batch.waitSemaphores.capacity() );
 
 		_batch.waitSemaphores.push_back( sem, stage );
+		_batch.waitValues.push_back( timelineValue );
 	}
 	
 /*
@@ -144,6 +153,35 @@ namespace FG
 		_batch.commands.push_back( cmd, pool );
 	}
 	
+/*
+=================================================
+	AddSecondaryCommandBuffer
+=================================================
+*/
+	void  VCmdBatch::AddSecondaryCommandBuffer (VkCommandBuffer cmd, const VCommandPool *pool)
+	{
+		EXLOCK( _drCheck );
+		ASSERT( GetState() < EState::Submitted );
+
+		_batch.secondaryCommands.emplace_back( cmd, pool );
+	}
+	
+/*
+=================================================
+	AddCommandPool
+----
+	batch owns the pool until it is complete
+=================================================
+*/
+	void  VCmdBatch::AddCommandPool (VCommandPoolManager::Pool *pool)
+	{
+		EXLOCK( _drCheck );
+		ASSERT( GetState() == EState::Recording );
+		CHECK_ERRV( _batch.pools.size() < _batch.pools.capacity() );
+
+		_batch.pools.push_back( pool );
+	}
+	
 /*
 =================================================
 	AddDependency
@@ -177,6 +215,21 @@ namespace FG
 
 		_readyToDelete.push_back({ type, handle });
 	}
+	
+/*
+=================================================
+	AddTransientHeap
+----
+	heap may be reused by another batch when this batch completes.
+=================================================
+*/
+	void  VCmdBatch::AddTransientHeap (const TransientHeap &heap)
+	{
+		EXLOCK( _drCheck );
+		ASSERT( GetState() == EState::Recording );
+
+		_transientHeaps.push_back( heap );
+	}
 
 /*
 =================================================
@@ -258,12 +311,31 @@ namespace FG
 	OnBaked
 =================================================
 */
-	bool  VCmdBatch::OnBaked (INOUT ResourceMap_t &resources)
+	bool  VCmdBatch::OnBaked (const ResourceMap_t &resources)
 	{
 		EXLOCK( _drCheck );
 		_SetState( EState::Backed );
 
-		std::swap( _resourcesToRelease, resources );
+		// map memory is discarded together with command buffer allocator, so copy to the flat array
+		ASSERT( _resourcesToRelease.empty() );
+		_resourcesToRelease.reserve( resources.size() );
+
+		for (auto& item : resources) {
+			_resourcesToRelease.emplace_back( item.first, item.second );
+		}
+
+		// recording is complete, return unused tail of the staging blocks to the ring buffers
+		auto&	sm = _frameGraph.GetResourceManager().GetStagingBufferManager();
+
+		for (auto& sb : _staging.hostToDevice) {
+			sb.capacity = sm.Shrink( sb.index, sb.size, sb.capacity );
+		}
+		for (auto& sb : _staging.deviceToHost) {
+			sb.capacity = sm.Shrink( sb.index, sb.size, sb.capacity );
+		}
+		for (auto& sb : _staging.readback) {
+			sb.capacity = sm.Shrink( sb.index, sb.size, sb.capacity );
+		}
 		return true;
 	}
 	
@@ -279,6 +351,71 @@ namespace FG
 		_SetState( EState::Ready );
 		return true;
 	}
+	
+/*
+=================================================
+	WaitForDependencies
+----
+	adds batch to the dependents of each dependency that is not ready yet,
+	returns 'true' if batch can be submitted now.
+	Batch in the same queue must be ready, batch in another queue must be submitted.
+=================================================
+*/
+	bool  VCmdBatch::WaitForDependencies ()
+	{
+		EXLOCK( _drCheck );
+		ASSERT( GetState() == EState::Backed );
+		ASSERT( _waitCount == 0 );
+
+		for (auto& dep : _dependencies)
+		{
+			const auto	min_state = (dep->GetQueueType() == _queueType ? EState::Ready : EState::Submitted);
+
+			if ( dep->GetState() >= min_state )
+				continue;
+
+			dep->_dependents.push_back( this );
+			++_waitCount;
+		}
+		return _waitCount == 0;
+	}
+	
+/*
+=================================================
+	ReleaseDependents
+----
+	in 'Ready' state releases dependents from the same queue,
+	in 'Submitted' state releases all dependents.
+=================================================
+*/
+	void  VCmdBatch::ReleaseDependents (OUT Appendable<VCmdBatchPtr> readyBatches)
+	{
+		EXLOCK( _drCheck );
+		
+		const bool	submitted	= (GetState() == EState::Submitted);
+		size_t		count		= 0;
+
+		ASSERT( submitted or GetState() == EState::Ready );
+
+		for (size_t i = 0; i < _dependents.size(); ++i)
+		{
+			auto&	batch = _dependents[i];
+
+			// keep batches from other queues until this batch is submitted
+			if ( not submitted and batch->_queueType != _queueType )
+			{
+				if ( count != i )
+					_dependents[count] = std::move(batch);
+				++count;
+				continue;
+			}
+
+			ASSERT( batch->_waitCount > 0 );
+			if ( --batch->_waitCount == 0 )
+				readyBatches.push_back( std::move(batch) );
+		}
+		_dependents.resize( count );
+	}
 
 /*
 =================================================
@@ -299,6 +436,25 @@ namespace FG
 		submitInfo.pWaitDstStageMask	= _batch.waitSemaphores.get<1>().data();
 		submitInfo.waitSemaphoreCount	= uint(_batch.waitSemaphores.size());
 
+		// values for binary semaphores are ignored
+		#ifdef VK_KHR_timeline_semaphore
+		const auto	IsTimeline = [] (uint64_t value) { return value > 0; };
+
+		if ( std::any_of( _batch.signalValues.begin(), _batch.signalValues.end(), IsTimeline ) or
+			 std::any_of( _batch.waitValues.begin(), _batch.waitValues.end(), IsTimeline ))
+		{
+			auto&	info = _batch.timelineInfo;
+			info = {};
+			info.sType						= VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+			info.signalSemaphoreValueCount	= uint(_batch.signalValues.size());
+			info.pSignalSemaphoreValues		= _batch.signalValues.data();
+			info.waitSemaphoreValueCount	= uint(_batch.waitValues.size());
+			info.pWaitSemaphoreValues		= _batch.waitValues.data();
+
+			submitInfo.pNext = &info;
+		}
+		#endif
+
 
 		// flush mapped memory before submitting
 		FixedArray<VkMappedMemoryRange, 32>		regions;
@@ -319,8 +475,8 @@ namespace FG
 			reg.sType	= VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
 			reg.pNext	= null;
 			reg.memory	= buf.mem;
-			reg.offset	= VkDeviceSize(buf.memOffset);
-			reg.size	= VkDeviceSize(buf.size);
+			reg.offset	= VkDeviceSize(buf.memOffset + buf.offset);
+			reg.size	= VkDeviceSize(buf.capacity);
 		}
 		
 		if ( regions.size() )
@@ -406,9 +562,24 @@ namespace FG
 				pool->RecyclePrimary( _batch.commands.get<0>()[i] );
 		}
 
+		for (auto& cmd : _batch.secondaryCommands)
+		{
+			if ( cmd.second )
+				cmd.second->RecycleSecondary( cmd.first );
+		}
+
+		// command buffers will be reset with pool
+		for (auto* pool : _batch.pools) {
+			_frameGraph.GetCommandPoolManager().Release( pool );
+		}
+
 		_batch.commands.clear();
+		_batch.secondaryCommands.clear();
+		_batch.pools.clear();
 		_batch.signalSemaphores.clear();
 		_batch.waitSemaphores.clear();
+		_batch.signalValues.clear();
+		_batch.waitValues.clear();
 	}
 
 /*
@@ -418,18 +589,19 @@ namespace FG
 */
 	void  VCmdBatch::_FinalizeStagingBuffers (const VDevice &dev)
 	{
-		using T = BufferView::value_type;
+		using T				= BufferView::value_type;
+		using ReadbackRefs	= FixedArray< SharedPtr<VReadbackMemory>, decltype(_staging.readback)::capacity() >;
 		
 		FixedArray<VkMappedMemoryRange, 32>		regions;
+		auto&									sm		= _frameGraph.GetResourceManager().GetStagingBufferManager();
 
-		// map device-to-host staging buffers
-		for (auto& buf : _staging.deviceToHost)
+		const auto	MapAndInvalidate = [&] (StagingBuffer &buf)
 		{
 			// buffer may be recreated on defragmentation pass, so we need to obtain actual pointer every frame
 			CHECK( _MapMemory( INOUT buf ));
 			
 			if ( buf.isCoherent )
-				continue;
+				return;
 
 			// invalidate non-cocherent memory before reading
 			if ( regions.size() == regions.capacity() )
@@ -442,10 +614,38 @@ namespace FG
 			reg.sType	= VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
 			reg.pNext	= null;
 			reg.memory	= buf.mem;
-			reg.offset	= VkDeviceSize(buf.memOffset);
-			reg.size	= VkDeviceSize(buf.size);
+			reg.offset	= VkDeviceSize(buf.memOffset + buf.offset);
+			reg.size	= VkDeviceSize(buf.capacity);
+		};
+
+		// map device-to-host staging buffers
+		for (auto& buf : _staging.deviceToHost) {
+			MapAndInvalidate( buf );
+		}
+
+		// readback blocks are released when the last future that references it is released
+		ReadbackRefs	readback_mem;
+		for (auto& buf : _staging.readback)
+		{
+			MapAndInvalidate( buf );
+			readback_mem.push_back( MakeShared<VReadbackMemory>( sm, buf.bufferId, buf.capacity, buf.index ));
 		}
 
+		const auto	SetFutureData = [&] (VReadbackFuture &future, auto &parts, ArrayView<ArrayView<T>> data)
+		{
+			VReadbackFuture::MemoryRefs_t	refs;
+
+			for (auto& part : parts)
+			{
+				const size_t	idx = size_t(part.buffer - _staging.readback.data());
+				ASSERT( idx < readback_mem.size() );
+
+				if ( std::find( refs.begin(), refs.end(), readback_mem[idx] ) == refs.end() )
+					refs.push_back( readback_mem[idx] );
+			}
+			future.SetData( data, std::move(refs) );
+		};
+
 		if ( regions.size() )
 			VK_CALL( dev.vkInvalidateMappedMemoryRanges( dev.GetVkDevice(), uint(regions.size()), regions.data() ));
 
@@ -466,7 +666,11 @@ namespace FG
 
 			ASSERT( total_size == ev.totalSize );
 
-			ev.callback( BufferView{data_parts} );
+			if ( ev.callback )
+				ev.callback( BufferView{data_parts} );
+
+			if ( ev.future )
+				SetFutureData( *ev.future, ev.parts, data_parts );
 		}
 		_staging.onBufferLoadedEvents.clear();
 		
@@ -487,24 +691,29 @@ namespace FG
 
 			ASSERT( total_size == ev.totalSize );
 
-			ev.callback( ImageView{ data_parts, ev.imageSize, ev.rowPitch, ev.slicePitch, ev.format, ev.aspect });
+			if ( ev.callback )
+				ev.callback( ImageView{ data_parts, ev.imageSize, ev.rowPitch, ev.slicePitch, ev.format, ev.aspect });
+
+			if ( ev.future )
+				SetFutureData( *ev.future, ev.parts, data_parts );
 		}
 		_staging.onImageLoadedEvents.clear();
 
 
 		// release resources
 		{
-			auto&	rm = _frameGraph.GetResourceManager();
-
 			for (auto& sb : _staging.hostToDevice) {
-				rm.ReleaseStagingBuffer( sb.index );
+				sm.Release( sb.index, sb.bufferId, sb.capacity );
 			}
 			_staging.hostToDevice.clear();
 
 			for (auto& sb : _staging.deviceToHost) {
-				rm.ReleaseStagingBuffer( sb.index );
+				sm.Release( sb.index, sb.bufferId, sb.capacity );
 			}
 			_staging.deviceToHost.clear();
+
+			// ownership is transfered to the futures
+			_staging.readback.clear();
 		}
 	}
 
@@ -520,10 +729,7 @@ namespace FG
 
 		auto&	rm  = _frameGraph.GetResourceManager();
 
-		// release descriptor sets
-		for (auto& ds : _shaderDebugger.descCache) {
-			rm.GetDescriptorManager().DeallocDescriptorSet( ds.second );
-		}
+		// descriptor sets are allocated from transient pools, see '_ReleaseResources'
 		_shaderDebugger.descCache.clear();
 
 		// process shader debug output
@@ -650,6 +856,14 @@ namespace FG
 			}
 		}
 		_resourcesToRelease.clear();
+
+		// free all transient descriptor sets
+		rm.GetDescriptorManager().ReleaseTransientPools( _transientDescPools );
+		_transientDescPools.clear();
+
+		// transient resources are released above, so memory is not used anymore
+		rm.ReleaseTransientHeaps( _transientHeaps );
+		_transientHeaps.clear();
 	}
 	
 /*
@@ -810,8 +1024,7 @@ namespace FG
 		ASSERT( blockAlign > 0_b and offsetAlign > 0_b );
 		ASSERT( dstMinSize == AlignToSmaller( dstMinSize, blockAlign ));
 
-		auto&			staging_buffers = _staging.hostToDevice;
-		const BytesU	stagingbuf_size	= _frameGraph.GetResourceManager().GetHostWriteBufferSize();
+		auto&	staging_buffers = _staging.hostToDevice;
 
 		// search in existing
 		StagingBuffer*	suitable		= null;
@@ -820,7 +1033,7 @@ namespace FG
 
 		for (auto& buf : staging_buffers)
 		{
-			const BytesU	off	= AlignToLarger( buf.size, offsetAlign );
+			const BytesU	off	= AlignToLarger( buf.offset + buf.size, offsetAlign ) - buf.offset;
 			const BytesU	av	= off < buf.capacity ? AlignToSmaller( buf.capacity - off, blockAlign ) : 0_b;
 
 			if ( av >= srcRequiredSize )
@@ -842,34 +1055,29 @@ namespace FG
 			suitable = max_available;
 		}
 
-		// allocate new buffer
+		// allocate new block
 		if ( not suitable )
 		{
-			ASSERT( dstMinSize < stagingbuf_size );
 			CHECK_ERR( staging_buffers.size() < staging_buffers.capacity() );
 
-			VResourceManager&	rm = _frameGraph.GetResourceManager();
-			
-			RawBufferID			buf_id;
-			StagingBufferIdx	buf_idx;
-			CHECK_ERR( rm.CreateStagingBuffer( EBufferUsage::TransferSrc, OUT buf_id, OUT buf_idx ));
+			// block offset may be not a multiple of 'offsetAlign', so reserve space for alignment
+			VStagingBufferManager::Block	block;
+			CHECK_ERR( _frameGraph.GetResourceManager().GetStagingBufferManager().Allocate(
+							_queueType, VStagingBufferManager::EDirection::HostToDevice, srcRequiredSize + offsetAlign, dstMinSize + offsetAlign, OUT block ));
 
-			RawMemoryID		mem_id = rm.GetResource( buf_id )->GetMemoryID();
-			CHECK_ERR( mem_id );
-
-			staging_buffers.push_back({ buf_idx, buf_id, mem_id, stagingbuf_size });
-
-			suitable = &staging_buffers.back();
+			suitable = &staging_buffers.emplace_back( block );
 			CHECK( _MapMemory( *suitable ));
 		}
 
 		// write data to buffer
-		dstOffset	= AlignToLarger( suitable->size, offsetAlign );
-		outSize		= Min( AlignToSmaller( suitable->capacity - dstOffset, blockAlign ), srcRequiredSize );
+		const BytesU	local_off = AlignToLarger( suitable->offset + suitable->size, offsetAlign ) - suitable->offset;
+
+		dstOffset	= suitable->offset + local_off;
+		outSize		= Min( AlignToSmaller( suitable->capacity - local_off, blockAlign ), srcRequiredSize );
 		dstBuffer	= suitable->bufferId;
 		mappedPtr	= suitable->mappedPtr + dstOffset;
 
-		suitable->size = dstOffset + outSize;
+		suitable->size = local_off + outSize;
 		return true;
 	}
 	
@@ -878,15 +1086,16 @@ namespace FG
 	_AddPendingLoad
 =================================================
 */
-	bool  VCmdBatch::_AddPendingLoad (const BytesU srcRequiredSize, const BytesU blockAlign, const BytesU offsetAlign, const BytesU dstMinSize,
+	bool  VCmdBatch::_AddPendingLoad (const BytesU srcRequiredSize, const BytesU blockAlign, const BytesU offsetAlign, const BytesU dstMinSize, bool persistent,
 									  OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range)
 	{
+		using EDirection = VStagingBufferManager::EDirection;
+
 		ASSERT( blockAlign > 0_b and offsetAlign > 0_b );
 		ASSERT( dstMinSize == AlignToSmaller( dstMinSize, blockAlign ));
 
-		auto&			staging_buffers = _staging.deviceToHost;
-		const BytesU	stagingbuf_size	= _frameGraph.GetResourceManager().GetHostReadBufferSize();
-		
+		auto&		staging_buffers = persistent ? _staging.readback : _staging.deviceToHost;
+		const auto	direction		= persistent ? EDirection::Readback : EDirection::DeviceToHost;
 
 		// search in existing
 		StagingBuffer*	suitable		= null;
@@ -895,8 +1104,8 @@ namespace FG
 
 		for (auto& buf : staging_buffers)
 		{
-			const BytesU	off	= AlignToLarger( buf.size, offsetAlign );
-			const BytesU	av	= AlignToSmaller( buf.capacity - off, blockAlign );
+			const BytesU	off	= AlignToLarger( buf.offset + buf.size, offsetAlign ) - buf.offset;
+			const BytesU	av	= off < buf.capacity ? AlignToSmaller( buf.capacity - off, blockAlign ) : 0_b;
 
 			if ( av >= srcRequiredSize )
 			{
@@ -917,36 +1126,29 @@ namespace FG
 			suitable = max_available;
 		}
 
-		// allocate new buffer
+		// allocate new block
 		if ( not suitable )
 		{
-			ASSERT( dstMinSize < stagingbuf_size );
 			CHECK_ERR( staging_buffers.size() < staging_buffers.capacity() );
-			
-			VResourceManager&	rm = _frameGraph.GetResourceManager();
-			
-			RawBufferID			buf_id;
-			StagingBufferIdx	buf_idx;
-			CHECK_ERR( rm.CreateStagingBuffer( EBufferUsage::TransferDst, OUT buf_id, OUT buf_idx ));
-			
-			RawMemoryID		mem_id = rm.GetResource( buf_id )->GetMemoryID();
-			CHECK_ERR( mem_id );
-
-			// TODO: make immutable because read after write happens after waiting for fences and it implicitly make changes visible to the host
 
-			staging_buffers.push_back({ buf_idx, buf_id, mem_id, stagingbuf_size });
+			// block offset may be not a multiple of 'offsetAlign', so reserve space for alignment
+			VStagingBufferManager::Block	block;
+			CHECK_ERR( _frameGraph.GetResourceManager().GetStagingBufferManager().Allocate(
+							_queueType, direction, srcRequiredSize + offsetAlign, dstMinSize + offsetAlign, OUT block ));
 
-			suitable = &staging_buffers.back();
+			suitable = &staging_buffers.emplace_back( block );
 			CHECK( _MapMemory( *suitable ));
 		}
 		
 		// write data to buffer
+		const BytesU	local_off = AlignToLarger( suitable->offset + suitable->size, offsetAlign ) - suitable->offset;
+
 		range.buffer	= suitable;
-		range.offset	= AlignToLarger( suitable->size, offsetAlign );
-		range.size		= Min( AlignToSmaller( suitable->capacity - range.offset, blockAlign ), srcRequiredSize );
+		range.offset	= suitable->offset + local_off;
+		range.size		= Min( AlignToSmaller( suitable->capacity - local_off, blockAlign ), srcRequiredSize );
 		dstBuffer		= suitable->bufferId;
 
-		suitable->size = range.offset + range.size;
+		suitable->size = local_off + range.size;
 		return true;
 	}
 	
@@ -955,7 +1157,7 @@ namespace FG
 	AddPendingLoad
 =================================================
 */
-	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize,
+	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize, bool persistent,
 									 OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range)
 	{
 		EXLOCK( _drCheck );
@@ -963,7 +1165,7 @@ namespace FG
 		// skip blocks less than 1/N of data size
 		const BytesU	min_size = (srcTotalSize + MaxBufferParts-1) / MaxBufferParts;
 
-		return _AddPendingLoad( srcTotalSize - srcOffset, 1_b, 16_b, min_size, OUT dstBuffer, OUT range );
+		return _AddPendingLoad( srcTotalSize - srcOffset, 1_b, 16_b, min_size, persistent, OUT dstBuffer, OUT range );
 	}
 
 /*
@@ -974,7 +1176,7 @@ namespace FG
 	bool  VCmdBatch::AddDataLoadedEvent (OnBufferDataLoadedEvent &&ev)
 	{
 		EXLOCK( _drCheck );
-		CHECK_ERR( ev.callback and not ev.parts.empty() );
+		CHECK_ERR( (ev.callback or ev.future) and not ev.parts.empty() );
 
 		_staging.onBufferLoadedEvents.push_back( std::move(ev) );
 		return true;
@@ -985,7 +1187,7 @@ namespace FG
 	AddPendingLoad
 =================================================
 */
-	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize, const BytesU srcPitch,
+	bool  VCmdBatch::AddPendingLoad (const BytesU srcOffset, const BytesU srcTotalSize, const BytesU srcPitch, bool persistent,
 									 OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range)
 	{
 		EXLOCK( _drCheck );
@@ -993,7 +1195,7 @@ namespace FG
 		// skip blocks less than 1/N of total data size
 		const BytesU	min_size = Max( (srcTotalSize + MaxImageParts-1) / MaxImageParts, srcPitch );
 
-		return _AddPendingLoad( srcTotalSize - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT range );
+		return _AddPendingLoad( srcTotalSize - srcOffset, srcPitch, 16_b, min_size, persistent, OUT dstBuffer, OUT range );
 	}
 
 /*
@@ -1004,7 +1206,7 @@ namespace FG
 	bool  VCmdBatch::AddDataLoadedEvent (OnImageDataLoadedEvent &&ev)
 	{
 		EXLOCK( _drCheck );
-		CHECK_ERR( ev.callback and not ev.parts.empty() );
+		CHECK_ERR( (ev.callback or ev.future) and not ev.parts.empty() );
 
 		_staging.onImageLoadedEvents.push_back( std::move(ev) );
 		return true;
@@ -1394,6 +1596,41 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	_AllocTransientDescriptorSet
+----
+	descriptor set is valid until batch completes,
+	pools are owned by batch so allocation doesn't require synchronization.
+=================================================
+*/
+	bool  VCmdBatch::_AllocTransientDescriptorSet (VkDescriptorSetLayout layout, OUT VkDescriptorSet &descSet)
+	{
+		auto&	dev		= _frameGraph.GetDevice();
+		auto&	ds_mngr	= _frameGraph.GetResourceManager().GetDescriptorManager();
+
+		VkDescriptorSetAllocateInfo		info = {};
+		info.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		info.descriptorSetCount	= 1;
+		info.pSetLayouts		= &layout;
+
+		if ( _transientDescPools.size() )
+		{
+			info.descriptorPool = _transientDescPools.back();
+
+			if ( dev.vkAllocateDescriptorSets( dev.GetVkDevice(), &info, OUT &descSet ) == VK_SUCCESS )
+				return true;
+		}
+
+		info.descriptorPool = ds_mngr.AcquireTransientPool();
+		CHECK_ERR( info.descriptorPool );
+
+		_transientDescPools.push_back( info.descriptorPool );
+
+		VK_CHECK( dev.vkAllocateDescriptorSets( dev.GetVkDevice(), &info, OUT &descSet ));
+		return true;
+	}
+
 /*
 =================================================
 	_AllocDescriptorSet
@@ -1413,17 +1650,14 @@ namespace FG
 
 		if ( iter != _shaderDebugger.descCache.end() )
 		{
-			descSet = iter->second.first;
+			descSet = iter->second;
 			return true;
 		}
 
 		// allocate descriptor set
 		{
-			VDescriptorSetLayout::DescriptorSet	ds;
-			CHECK_ERR( rm.GetDescriptorManager().AllocDescriptorSet( layout->Handle(), OUT ds ));
-
-			descSet = ds.first;
-			_shaderDebugger.descCache.insert_or_assign( {storageBuffer, layout_id}, ds );
+			CHECK_ERR( _AllocTransientDescriptorSet( layout->Handle(), OUT descSet ));
+			_shaderDebugger.descCache.insert_or_assign( {storageBuffer, layout_id}, descSet );
 		}
 
 		// update descriptor set
@@ -6,13 +6,14 @@
 #include "framegraph/Public/FrameGraph.h"
 #include "VDescriptorSetLayout.h"
 #include "VLocalDebugger.h"
-#include "VCommandPool.h"
+#include "VCommandPoolManager.h"
+#include "VStagingBufferManager.h"
 #include "stl/Containers/FixedTupleArray.h"
+#include "stl/Containers/FlatHashMap.h"
 
 namespace FG
 {
-	enum class StagingBufferIdx : uint {};
-
+	class VReadbackFuture;
 
 
 	//
@@ -107,7 +108,8 @@ namespace FG
 			}
 		};
 		
-		using ResourceMap_t		= std::unordered_map< Resource, uint, ResourceHash >;		// TODO: custom allocator
+		using ResourceMap_t		= FlatHashMap< Resource, uint, ResourceHash, std::equal_to<Resource>, StdLinearAllocator< Pair< const Resource, uint >>>;	// allocated in command buffer
+		using ResourceArray_t	= Array< Pair< Resource, uint >>;
 
 
 		//---------------------------------------------------------------------------
@@ -121,11 +123,12 @@ namespace FG
 		// variables
 			RawBufferID			bufferId;
 			RawMemoryID			memoryId;
-			BytesU				capacity;
-			BytesU				size;
+			BytesU				offset;						// block offset in the buffer
+			BytesU				capacity;					// block size
+			BytesU				size;						// used size, relative to the block offset
 			StagingBufferIdx	index;
 			
-			void *				mappedPtr	= null;
+			void *				mappedPtr	= null;			// points to the beginning of the buffer
 			BytesU				memOffset;					// can be used to flush memory ranges
 			VkDeviceMemory		mem			= VK_NULL_HANDLE;
 			bool				isCoherent	= false;
@@ -133,8 +136,8 @@ namespace FG
 		// methods
 			StagingBuffer () {}
 
-			StagingBuffer (StagingBufferIdx idx, RawBufferID buf, RawMemoryID mem, BytesU capacity) :
-				bufferId{std::move(buf)}, memoryId{mem}, capacity{capacity}, index{idx} {}
+			explicit StagingBuffer (const VStagingBufferManager::Block &block) :
+				bufferId{block.bufferId}, memoryId{block.memoryId}, offset{block.offset}, capacity{block.size}, index{block.index} {}
 
 			ND_ bool	IsFull ()	const	{ return size >= capacity; }
 			ND_ bool	Empty ()	const	{ return size == 0_b; }
@@ -153,9 +156,11 @@ namespace FG
 
 			using DataParts_t	= FixedArray< Range, MaxBufferParts >;
 			using Callback_t	= ReadBuffer::Callback_t;
+			using Future_t		= SharedPtr< VReadbackFuture >;
 			
 		// variables
 			Callback_t		callback;
+			Future_t		future;		// if not null then data is in the readback staging buffers
 			DataParts_t		parts;
 			BytesU			totalSize;
 
@@ -171,9 +176,11 @@ namespace FG
 			using Range			= OnBufferDataLoadedEvent::Range;
 			using DataParts_t	= FixedArray< Range, MaxImageParts >;
 			using Callback_t	= ReadImage::Callback_t;
+			using Future_t		= OnBufferDataLoadedEvent::Future_t;
 
 		// variables
 			Callback_t		callback;
+			Future_t		future;		// if not null then data is in the readback staging buffers
 			DataParts_t		parts;
 			BytesU			totalSize;
 			uint3			imageSize;
@@ -223,7 +230,7 @@ namespace FG
 
 		using StorageBuffers_t		= Array< StorageBuffer >;
 		using DebugModes_t			= Array< DebugMode >;
-		using DescriptorCache_t		= HashMap< Pair<RawBufferID, RawDescriptorSetLayoutID>, VDescriptorSetLayout::DescriptorSet >;
+		using DescriptorCache_t		= HashMap< Pair<RawBufferID, RawDescriptorSetLayoutID>, VkDescriptorSet >;
 		using ShaderDebugCallback_t	= IFrameGraph::ShaderDebugCallback_t;
 		
 
@@ -239,10 +246,22 @@ namespace FG
 
 		static constexpr uint		MaxBatchItems = 8;
 		using CmdBuffers_t			= FixedTupleArray< MaxBatchItems, VkCommandBuffer, VCommandPool const* >;
+		using SecondaryCmdBuffers_t	= Array<Pair< VkCommandBuffer, VCommandPool const* >>;
 		using SignalSemaphores_t	= FixedArray< VkSemaphore, MaxBatchItems >;
 		using WaitSemaphores_t		= FixedTupleArray< MaxBatchItems, VkSemaphore, VkPipelineStageFlags >;
+		using SemaphoreValues_t		= FixedArray< uint64_t, MaxBatchItems >;		// 0 for binary semaphore
+		using CmdPools_t			= FixedArray< VCommandPoolManager::Pool *, FG_MaxSecondaryCmdBuffers + 1 >;
 		
 		using VkResourceArray_t		= Array<Pair< VkObjectType, uint64_t >>;
+		using DescriptorPools_t		= Array< VkDescriptorPool >;
+
+		struct TransientHeap
+		{
+			VkDeviceMemory	memory			= VK_NULL_HANDLE;
+			BytesU			size;
+			uint			memTypeIndex	= UMax;
+		};
+		using TransientHeaps_t		= Array< TransientHeap >;
 
 		using Statistic_t			= IFrameGraph::Statistics;
 
@@ -268,6 +287,8 @@ namespace FG
 		EQueueType							_queueType			= Default;
 
 		Dependencies_t						_dependencies;
+		Array< VCmdBatchPtr >				_dependents;		// batches that are waiting for this batch, protected by queue lock in VFrameGraph
+		uint								_waitCount			= 0;	// number of dependencies that are not ready yet, protected by queue lock in VFrameGraph
 		bool								_submitImmediately	= false;
 		bool								_supportsQuery		= false;
 		bool								_dbgQueueSync		= false;
@@ -275,22 +296,32 @@ namespace FG
 		// command batch data
 		struct {
 			CmdBuffers_t						commands;
+			SecondaryCmdBuffers_t				secondaryCommands;	// executed inside primary command buffers, only for recycling
 			SignalSemaphores_t					signalSemaphores;
 			WaitSemaphores_t					waitSemaphores;
+			SemaphoreValues_t					signalValues;
+			SemaphoreValues_t					waitValues;
+			CmdPools_t							pools;			// released when batch is complete
+			#ifdef VK_KHR_timeline_semaphore
+			VkTimelineSemaphoreSubmitInfoKHR	timelineInfo;
+			#endif
 		}									_batch;
 
 		// staging buffers
 		struct {
-			FixedArray< StagingBuffer, 8 >		hostToDevice;	// CPU write, GPU read
-			FixedArray< StagingBuffer, 8 >		deviceToHost;	// CPU read, GPU write
+			FixedArray< StagingBuffer, 16 >		hostToDevice;	// CPU write, GPU read
+			FixedArray< StagingBuffer, 16 >		deviceToHost;	// CPU read, GPU write
+			FixedArray< StagingBuffer, 16 >		readback;		// CPU read, GPU write, owned by readback futures when batch is complete
 			Array< OnBufferDataLoadedEvent >	onBufferLoadedEvents;
 			Array< OnImageDataLoadedEvent >		onImageLoadedEvents;
 		}									_staging;
 
 		// resources
-		ResourceMap_t						_resourcesToRelease;
+		ResourceArray_t						_resourcesToRelease;
 		Swapchains_t						_swapchains;
 		VkResourceArray_t					_readyToDelete;
+		DescriptorPools_t					_transientDescPools;	// reset when batch completes
+		TransientHeaps_t					_transientHeaps;		// returned to resource manager when batch completes
 
 		// shader debugger
 		struct {
@@ -324,18 +355,23 @@ namespace FG
 		bool  OnBegin (const CommandBufferDesc &);
 		void  OnBeginRecording (VkCommandBuffer cmd);
 		void  OnEndRecording (VkCommandBuffer cmd);
-		bool  OnBaked (INOUT ResourceMap_t &);
+		bool  OnBaked (const ResourceMap_t &);
 		bool  OnReadyToSubmit ();
+		bool  WaitForDependencies ();
+		void  ReleaseDependents (OUT Appendable<VCmdBatchPtr> readyBatches);
 		bool  BeforeSubmit (OUT VkSubmitInfo &);
 		bool  AfterSubmit (OUT Appendable<VSwapchain const*>, VSubmitted *);
 		bool  OnComplete (VDebugger &, const ShaderDebugCallback_t &, INOUT Statistic_t &);
 
-		void  SignalSemaphore (VkSemaphore sem);
-		void  WaitSemaphore (VkSemaphore sem, VkPipelineStageFlags stage);
+		void  SignalSemaphore (VkSemaphore sem, uint64_t timelineValue = 0);
+		void  WaitSemaphore (VkSemaphore sem, VkPipelineStageFlags stage, uint64_t timelineValue = 0);
 		void  PushFrontCommandBuffer (VkCommandBuffer, const VCommandPool *);
 		void  PushBackCommandBuffer (VkCommandBuffer, const VCommandPool *);
+		void  AddSecondaryCommandBuffer (VkCommandBuffer, const VCommandPool *);
+		void  AddCommandPool (VCommandPoolManager::Pool *);
 		void  AddDependency (VCmdBatch *);
 		void  DestroyPostponed (VkObjectType type, uint64_t handle);
+		void  AddTransientHeap (const TransientHeap &heap);
 	
 
 		// shader debugger //
@@ -353,8 +389,8 @@ namespace FG
 		// staging buffer //
 		bool  GetWritable (const BytesU srcRequiredSize, const BytesU blockAlign, const BytesU offsetAlign, const BytesU dstMinSize,
 							OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &outSize, OUT void* &mappedPtr);
-		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range);
-		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, BytesU srcPitch, OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range);
+		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, bool persistent, OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range);
+		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, BytesU srcPitch, bool persistent, OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range);
 		bool  AddDataLoadedEvent (OnImageDataLoadedEvent &&);
 		bool  AddDataLoadedEvent (OnBufferDataLoadedEvent &&);
 
@@ -378,6 +414,7 @@ namespace FG
 		void  _BeginShaderDebugger (VkCommandBuffer cmd);
 		void  _EndShaderDebugger (VkCommandBuffer cmd);
 		bool  _AllocStorage (INOUT DebugMode &, BytesU);
+		bool  _AllocTransientDescriptorSet (VkDescriptorSetLayout layout, OUT VkDescriptorSet &descSet);
 		bool  _AllocDescriptorSet (EShaderDebugMode debugMode, EShaderStages stages,
 								   RawBufferID storageBuffer, BytesU size, OUT VkDescriptorSet &descSet);
 		void  _ParseDebugOutput (const ShaderDebugCallback_t &cb);
@@ -385,7 +422,7 @@ namespace FG
 
 
 		// staging buffer //
-		bool  _AddPendingLoad (const BytesU srcRequiredSize, const BytesU blockAlign, const BytesU offsetAlign, const BytesU dstMinSize,
+		bool  _AddPendingLoad (const BytesU srcRequiredSize, const BytesU blockAlign, const BytesU offsetAlign, const BytesU dstMinSize, bool persistent,
 							   OUT RawBufferID &dstBuffer, OUT OnBufferDataLoadedEvent::Range &range);
 		bool  _MapMemory (INOUT StagingBuffer &) const;
 		void  _FinalizeStagingBuffers (const VDevice &);
@@ -0,0 +1,386 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VCmdStateTracker.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	VCmdStateTracker::VCmdStateTracker (const VulkanDeviceFn &fn, VkCommandBuffer cmd, Statistic_t &stat) :
+		_cmdBuffer{ cmd }, _stat{ stat }
+	{
+		VulkanDeviceFn_Init( fn );
+	}
+
+/*
+=================================================
+	BindPipeline
+=================================================
+*/
+	bool  VCmdStateTracker::BindPipeline (VkPipelineBindPoint bindPoint, VkPipeline pipeline)
+	{
+		const uint	index	= _BindPointIndex( bindPoint );
+		auto&		state	= _bindPoints[index];
+
+		if ( state.pipeline == pipeline )
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		state.pipeline = pipeline;
+		vkCmdBindPipeline( _cmdBuffer, bindPoint, pipeline );
+
+		switch ( index ) {
+			case 0 :	_stat.graphicsPipelineBindings ++;		break;
+			case 1 :	_stat.computePipelineBindings ++;		break;
+			case 2 :	_stat.rayTracingPipelineBindings ++;	break;
+		}
+
+		// stencil states may be static in new pipeline
+		if ( index == 0 )
+		{
+			_stencilCompareMask.validFaces	= 0;
+			_stencilWriteMask.validFaces	= 0;
+			_stencilReference.validFaces	= 0;
+		}
+		return true;
+	}
+
+/*
+=================================================
+	BindDescriptorSets
+----
+	command is skipped only if all sets in range were bound by the same command with the same dynamic offsets,
+	otherwise dynamic offsets may be distributed between sets in a different way.
+=================================================
+*/
+	bool  VCmdStateTracker::BindDescriptorSets (VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint firstSet,
+												ArrayView<VkDescriptorSet> descriptorSets, ArrayView<uint> dynamicOffsets)
+	{
+		if ( descriptorSets.empty() )
+			return false;
+
+		auto&		state		= _bindPoints[ _BindPointIndex( bindPoint )];
+		const uint	count		= uint(descriptorSets.size());
+		const bool	trackable	= (firstSet + count <= state.descriptorSets.size() and dynamicOffsets.size() <= DynamicOffsets_t::capacity());
+
+		if ( trackable and state.layout == layout )
+		{
+			bool	equal = true;
+
+			for (uint i = 0; equal and i < count; ++i)
+			{
+				auto&	ds = state.descriptorSets[ firstSet + i ];
+				equal = (ds.set == descriptorSets[i] and ds.firstSet == firstSet and ds.setCount == count and
+						 ArrayView<uint>{ds.dynamicOffsets} == dynamicOffsets);
+			}
+
+			if ( equal )
+			{
+				_stat.skippedBindings ++;
+				return false;
+			}
+		}
+
+		// layout may be incompatible, so all sets are invalidated
+		if ( state.layout != layout )
+		{
+			state.layout = layout;
+			for (auto& ds : state.descriptorSets) {
+				ds = Default;
+			}
+		}
+
+		if ( trackable )
+		{
+			for (uint i = 0; i < count; ++i)
+			{
+				auto&	ds		= state.descriptorSets[ firstSet + i ];
+				ds.set			= descriptorSets[i];
+				ds.firstSet		= firstSet;
+				ds.setCount		= count;
+				ds.dynamicOffsets.assign( dynamicOffsets.begin(), dynamicOffsets.end() );
+			}
+		}
+		else
+			state.layout = VK_NULL_HANDLE;
+
+		vkCmdBindDescriptorSets( _cmdBuffer, bindPoint, layout, firstSet, count, descriptorSets.data(), uint(dynamicOffsets.size()), dynamicOffsets.data() );
+		_stat.descriptorBinds ++;
+		return true;
+	}
+
+/*
+=================================================
+	BindVertexBuffers
+=================================================
+*/
+	bool  VCmdStateTracker::BindVertexBuffers (uint firstBinding, ArrayView<VkBuffer> buffers, ArrayView<VkDeviceSize> offsets)
+	{
+		ASSERT( buffers.size() == offsets.size() );
+
+		if ( buffers.empty() )
+			return false;
+
+		const uint	count	= uint(buffers.size());
+		bool		equal	= (firstBinding + count <= _vertexBuffers.size());
+
+		for (uint i = 0; equal and i < count; ++i)
+		{
+			const uint	b = firstBinding + i;
+			equal = ((_vertexBufferMask & (1u << b)) and _vertexBuffers[b] == buffers[i] and _vertexOffsets[b] == offsets[i]);
+		}
+
+		if ( equal )
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		for (uint i = 0; i < count and firstBinding + i < _vertexBuffers.size(); ++i)
+		{
+			const uint	b = firstBinding + i;
+			_vertexBuffers[b]	 = buffers[i];
+			_vertexOffsets[b]	 = offsets[i];
+			_vertexBufferMask	|= (1u << b);
+		}
+
+		vkCmdBindVertexBuffers( _cmdBuffer, firstBinding, count, buffers.data(), offsets.data() );
+		_stat.vertexBufferBindings ++;
+		return true;
+	}
+
+/*
+=================================================
+	BindIndexBuffer
+=================================================
+*/
+	bool  VCmdStateTracker::BindIndexBuffer (VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+	{
+		if ( _indexBuffer		== buffer	and
+			 _indexBufferOffset	== offset	and
+			 _indexType			== indexType )
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		_indexBuffer		= buffer;
+		_indexBufferOffset	= offset;
+		_indexType			= indexType;
+
+		vkCmdBindIndexBuffer( _cmdBuffer, buffer, offset, indexType );
+		_stat.indexBufferBindings ++;
+		return true;
+	}
+
+/*
+=================================================
+	SetViewports
+=================================================
+*/
+	bool  VCmdStateTracker::SetViewports (uint firstViewport, ArrayView<VkViewport> viewports)
+	{
+		if ( viewports.empty() )
+			return false;
+
+		const uint	count	= uint(viewports.size());
+		bool		equal	= (firstViewport + count <= _viewports.size());
+
+		for (uint i = 0; equal and i < count; ++i)
+		{
+			const uint	v = firstViewport + i;
+			equal = ((_viewportMask & (1u << v)) and std::memcmp( &_viewports[v], &viewports[i], sizeof(VkViewport) ) == 0);
+		}
+
+		if ( equal )
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		for (uint i = 0; i < count and firstViewport + i < _viewports.size(); ++i)
+		{
+			const uint	v = firstViewport + i;
+			_viewports[v]	 = viewports[i];
+			_viewportMask	|= (1u << v);
+		}
+
+		vkCmdSetViewport( _cmdBuffer, firstViewport, count, viewports.data() );
+		_stat.dynamicStateChanges ++;
+		return true;
+	}
+
+/*
+=================================================
+	SetScissors
+=================================================
+*/
+	bool  VCmdStateTracker::SetScissors (uint firstScissor, ArrayView<VkRect2D> scissors)
+	{
+		if ( scissors.empty() )
+			return false;
+
+		const uint	count	= uint(scissors.size());
+		bool		equal	= (firstScissor + count <= _scissors.size());
+
+		for (uint i = 0; equal and i < count; ++i)
+		{
+			const uint		s	= firstScissor + i;
+			auto&			lhs	= _scissors[s];
+			auto&			rhs	= scissors[i];
+			equal = ((_scissorMask & (1u << s))				and
+					 lhs.offset.x		== rhs.offset.x		and
+					 lhs.offset.y		== rhs.offset.y		and
+					 lhs.extent.width	== rhs.extent.width	and
+					 lhs.extent.height	== rhs.extent.height);
+		}
+
+		if ( equal )
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		for (uint i = 0; i < count and firstScissor + i < _scissors.size(); ++i)
+		{
+			const uint	s = firstScissor + i;
+			_scissors[s]	 = scissors[i];
+			_scissorMask	|= (1u << s);
+		}
+
+		vkCmdSetScissor( _cmdBuffer, firstScissor, count, scissors.data() );
+		_stat.dynamicStateChanges ++;
+		return true;
+	}
+
+/*
+=================================================
+	SetStencilCompareMask
+=================================================
+*/
+	bool  VCmdStateTracker::SetStencilCompareMask (VkStencilFaceFlags faceMask, uint value)
+	{
+		if ( not _UpdateStencil( INOUT _stencilCompareMask, faceMask, value ))
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		vkCmdSetStencilCompareMask( _cmdBuffer, faceMask, value );
+		_stat.dynamicStateChanges ++;
+		return true;
+	}
+
+/*
+=================================================
+	SetStencilWriteMask
+=================================================
+*/
+	bool  VCmdStateTracker::SetStencilWriteMask (VkStencilFaceFlags faceMask, uint value)
+	{
+		if ( not _UpdateStencil( INOUT _stencilWriteMask, faceMask, value ))
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		vkCmdSetStencilWriteMask( _cmdBuffer, faceMask, value );
+		_stat.dynamicStateChanges ++;
+		return true;
+	}
+
+/*
+=================================================
+	SetStencilReference
+=================================================
+*/
+	bool  VCmdStateTracker::SetStencilReference (VkStencilFaceFlags faceMask, uint value)
+	{
+		if ( not _UpdateStencil( INOUT _stencilReference, faceMask, value ))
+		{
+			_stat.skippedBindings ++;
+			return false;
+		}
+
+		vkCmdSetStencilReference( _cmdBuffer, faceMask, value );
+		_stat.dynamicStateChanges ++;
+		return true;
+	}
+
+/*
+=================================================
+	Invalidate
+----
+	call it after 'vkCmdExecuteCommands' and after commands recorded by user.
+=================================================
+*/
+	void  VCmdStateTracker::Invalidate ()
+	{
+		for (auto& bp : _bindPoints) {
+			bp = Default;
+		}
+
+		_vertexBufferMask	= 0;
+		_indexBuffer		= VK_NULL_HANDLE;
+		_indexBufferOffset	= UMax;
+		_indexType			= VK_INDEX_TYPE_MAX_ENUM;
+		_viewportMask		= 0;
+		_scissorMask		= 0;
+
+		_stencilCompareMask.validFaces	= 0;
+		_stencilWriteMask.validFaces	= 0;
+		_stencilReference.validFaces	= 0;
+	}
+
+/*
+=================================================
+	_BindPointIndex
+=================================================
+*/
+	inline uint  VCmdStateTracker::_BindPointIndex (VkPipelineBindPoint bindPoint)
+	{
+		switch ( bindPoint )
+		{
+			case VK_PIPELINE_BIND_POINT_GRAPHICS :			return 0;
+			case VK_PIPELINE_BIND_POINT_COMPUTE :			return 1;
+			#ifdef VK_NV_ray_tracing
+			case VK_PIPELINE_BIND_POINT_RAY_TRACING_NV :	return 2;
+			#endif
+			default :										break;
+		}
+		RETURN_ERR( "unknown pipeline bind point", 0u );
+	}
+
+/*
+=================================================
+	_UpdateStencil
+----
+	returns 'true' if value is changed for any face.
+=================================================
+*/
+	inline bool  VCmdStateTracker::_UpdateStencil (INOUT StencilValue &state, VkStencilFaceFlags faceMask, uint value)
+	{
+		bool	changed = false;
+
+		for (uint face = 0; face < state.value.size(); ++face)
+		{
+			const uint	bit = (1u << face);
+			if ( not (faceMask & bit) )
+				continue;
+
+			changed |= (not (state.validFaces & bit) or state.value[face] != value);
+
+			state.value[face]	 = value;
+			state.validFaces	|= bit;
+		}
+		return changed;
+	}
+
+
+}	// FG
@@ -0,0 +1,105 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Shadow copy of the command buffer state.
+	Bound pipelines, descriptor sets, vertex and index buffers and dynamic states are tracked,
+	command that doesn't change the state is not recorded and is counted in 'skippedBindings'.
+	State must be invalidated after any command that was recorded bypassing this tracker.
+*/
+
+#pragma once
+
+#include "VCommon.h"
+#include "framegraph/Public/FrameGraph.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Command Buffer State Tracker
+	//
+
+	class VCmdStateTracker final : public VulkanDeviceFn
+	{
+	// types
+	public:
+		using Statistic_t	= IFrameGraph::RenderingStatistics;
+
+	private:
+		using DynamicOffsets_t	= FixedArray< uint, FG_MaxBufferDynamicOffsets >;
+
+		struct DescriptorSetState
+		{
+			VkDescriptorSet		set			= VK_NULL_HANDLE;
+			uint				firstSet	= UMax;		// range and dynamic offsets of the command that bound this set
+			uint				setCount	= 0;
+			DynamicOffsets_t	dynamicOffsets;
+		};
+
+		struct BindPointState
+		{
+			VkPipeline			pipeline	= VK_NULL_HANDLE;
+			VkPipelineLayout	layout		= VK_NULL_HANDLE;
+			StaticArray< DescriptorSetState, FG_MaxDescriptorSets >	descriptorSets;
+		};
+
+		struct StencilValue
+		{
+			StaticArray< uint, 2 >	value		= {};	// front, back
+			uint					validFaces	= 0;	// VkStencilFaceFlags
+		};
+
+		static constexpr uint	BindPointCount	= 3;	// graphics, compute, ray tracing
+
+
+	// variables
+	private:
+		const VkCommandBuffer		_cmdBuffer;
+		Statistic_t &				_stat;
+
+		BindPointState				_bindPoints [BindPointCount];
+
+		StaticArray< VkBuffer, FG_MaxVertexBuffers >		_vertexBuffers;
+		StaticArray< VkDeviceSize, FG_MaxVertexBuffers >	_vertexOffsets;
+		uint												_vertexBufferMask	= 0;
+
+		VkBuffer					_indexBuffer		= VK_NULL_HANDLE;
+		VkDeviceSize				_indexBufferOffset	= UMax;
+		VkIndexType					_indexType			= VK_INDEX_TYPE_MAX_ENUM;
+
+		StaticArray< VkViewport, FG_MaxViewports >			_viewports;
+		StaticArray< VkRect2D, FG_MaxViewports >			_scissors;
+		uint												_viewportMask		= 0;
+		uint												_scissorMask		= 0;
+
+		StencilValue				_stencilCompareMask;
+		StencilValue				_stencilWriteMask;
+		StencilValue				_stencilReference;
+
+
+	// methods
+	public:
+		VCmdStateTracker (const VulkanDeviceFn &fn, VkCommandBuffer cmd, Statistic_t &stat);
+
+		bool  BindPipeline (VkPipelineBindPoint bindPoint, VkPipeline pipeline);
+		bool  BindDescriptorSets (VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint firstSet,
+								  ArrayView<VkDescriptorSet> descriptorSets, ArrayView<uint> dynamicOffsets);
+		bool  BindVertexBuffers (uint firstBinding, ArrayView<VkBuffer> buffers, ArrayView<VkDeviceSize> offsets);
+		bool  BindIndexBuffer (VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType);
+
+		bool  SetViewports (uint firstViewport, ArrayView<VkViewport> viewports);
+		bool  SetScissors (uint firstScissor, ArrayView<VkRect2D> scissors);
+		bool  SetStencilCompareMask (VkStencilFaceFlags faceMask, uint value);
+		bool  SetStencilWriteMask (VkStencilFaceFlags faceMask, uint value);
+		bool  SetStencilReference (VkStencilFaceFlags faceMask, uint value);
+
+		void  Invalidate ();
+
+		ND_ VkCommandBuffer  Handle () const	{ return _cmdBuffer; }
+
+	private:
+		ND_ static uint  _BindPointIndex (VkPipelineBindPoint bindPoint);
+		ND_ static bool  _UpdateStencil (INOUT StencilValue &state, VkStencilFaceFlags faceMask, uint value);
+	};
+
+
+}	// FG
@@ -2,6 +2,9 @@
 
 #include "VCommandBuffer.h"
 #include "VTaskGraph.hpp"
+#include "VTransientMemoryAllocator.h"
+#include "VSubpassMerger.h"
+#include "VReadbackFuture.h"
 
 namespace FG
 {
@@ -11,7 +14,7 @@ namespace {
 	static constexpr auto	RayTracingBit	= EQueueUsage::Graphics | EQueueUsage::AsyncCompute;
 	static constexpr auto	TransferBit		= EQueueUsage::Graphics | EQueueUsage::AsyncCompute | EQueueUsage::AsyncTransfer;
 
-	static constexpr auto	CmdDebugFlags	= EDebugFlags::FullBarrier | EDebugFlags::QueueSync;
+	static constexpr auto	CmdDebugFlags	= EDebugFlags::FullBarrier | EDebugFlags::QueueSync | EDebugFlags::ReorderStatistic;
 }
 	
 /*
@@ -40,10 +43,8 @@ namespace {
 		EXLOCK( _drCheck );
 		CHECK( _state == EState::Initial );
 
-		for (auto& q : _perQueue) {
-			q.Destroy( GetDevice() );
-		}
-		_perQueue.clear();
+		_instance.MergePipelineCache( INOUT _pipelineCache );
+		_pipelineCache.Deinitialize( GetDevice() );
 	}
 
 /*
@@ -60,25 +61,27 @@ namespace {
 		_batch			= batch;
 		_dbgFullBarriers= AllBits( desc.debugFlags, EDebugFlags::FullBarrier );
 		_dbgQueueSync	= AllBits( desc.debugFlags, EDebugFlags::QueueSync );
+		_pipelineMissPolicy = desc.pipelineMissPolicy;
+		_resUsage.optimizeBarriers	= desc.optimizeBarriers;
+		_resUsage.reorderTasks		= desc.reorderTasks;
+		_resUsage.reorderStatistic	= desc.reorderTasks and AllBits( desc.debugFlags, EDebugFlags::ReorderStatistic );
+		_subpassMerge.enabled		= desc.mergeRenderPasses;
 		_state			= EState::Recording;
 		_queueIndex		= queue->familyIndex;
 		
-		// create command pool
-		{
-			const uint	index = uint(_queueIndex);
+		CHECK_ERR( _instance.UpdatePipelineCache( INOUT _pipelineCache, INOUT _pipelineCacheVersion ));
 
-			_perQueue.resize( Max( _perQueue.size(), index+1 ));
-			
-			auto&	pool = _perQueue[index];
+		_batch->OnBegin( desc );
+		
+		// acquire command pool
+		{
+			_cmdPools.queue		= queue;
+			_cmdPools.primary	= _instance.GetCommandPoolManager().Acquire( queue );
+			CHECK_ERR( _cmdPools.primary );
 
-			if ( not pool.IsCreated() )
-			{
-				CHECK_ERR( pool.Create( GetDevice(), queue ));
-			}
+			_batch->AddCommandPool( _cmdPools.primary );
 		}
 		
-		_batch->OnBegin( desc );
-		
 		// setup local debugger
 		const EDebugFlags	debugger_flags = desc.debugFlags & ~CmdDebugFlags;
 
@@ -93,6 +96,7 @@ namespace {
 			_debugger.reset();
 
 		_taskGraph.OnStart( GetAllocator() );
+		_rm.resourceMap.Create( GetAllocator() );
 		return true;
 	}
 	
@@ -112,14 +116,26 @@ namespace {
 
 		_state = EState::Compiling;
 
+		// memory must be bound before image views are created
+		CHECK_ERR( _AllocateTransientMemory() );
+
+		if ( _subpassMerge.enabled )
+			_MergeRenderPasses();
+
+		_FlushDescriptorUpdates();
+
 		CHECK_ERR( _BuildCommandBuffers() );
 		
 		if_unlikely( _debugger )
 			_debugger->End( _batch->GetName(), _batch->GetDependencies(), _indexInPool, OUT &_batch->_debugDump, OUT &_batch->_debugGraph );
 
-		CHECK_ERR( _batch->OnBaked( INOUT _rm.resourceMap ));
+		CHECK_ERR( _batch->OnBaked( *_rm.resourceMap ));
 		
+		// share new pipelines with other command buffers
+		CHECK( _instance.MergePipelineCache( INOUT _pipelineCache ));
+
 		_taskGraph.OnDiscardMemory();
+		_rm.resourceMap.Destroy();
 		_AfterCompilation();
 		_mainAllocator.Discard();
 		
@@ -130,6 +146,27 @@ namespace {
 		return true;
 	}
 
+/*
+=================================================
+	_FlushDescriptorUpdates
+=================================================
+*/
+	void  VCommandBuffer::_FlushDescriptorUpdates ()
+	{
+		if ( _rm.pendingDescriptorSets.empty() )
+			return;
+
+		// same cached descriptor set may be added multiple times
+		auto&	sets = _rm.pendingDescriptorSets;
+		std::sort( sets.begin(), sets.end() );
+		sets.erase( std::unique( sets.begin(), sets.end() ), sets.end() );
+
+		VPipelineResources::FlushUpdates( GetDevice(), sets, GetAllocator() );
+
+		EditStatistic().resources.deferredDescriptorSets += uint(sets.size());
+		sets.clear();
+	}
+
 /*
 =================================================
 	_AfterCompilation
@@ -137,6 +174,17 @@ namespace {
 */
 	void  VCommandBuffer::_AfterCompilation ()
 	{
+		_ResetTransientResources();
+
+		_resUsage.usages.clear();
+		_resUsage.taskUsages.clear();
+		_subpassMerge.tasks.clear();
+
+		// pools are owned by the batch
+		_cmdPools.primary	= null;
+		_cmdPools.queue		= null;
+		_cmdPools.secondary.fill( null );
+
 		// reset global shader debugger
 		{
 			_shaderDbg.timemapIndex		= Default;
@@ -183,6 +231,31 @@ namespace {
 		_batch->WaitSemaphore( sem, stage );
 	}
 
+/*
+=================================================
+	GetSecondaryPool
+----
+	each recording thread must use its own command pool
+	because command pool requires external synchronization.
+=================================================
+*/
+	VCommandPool*  VCommandBuffer::GetSecondaryPool (uint index)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( index < FG_MaxSecondaryCmdBuffers );
+
+		auto&	pool = _cmdPools.secondary[ index ];
+
+		if ( pool == null )
+		{
+			pool = _instance.GetCommandPoolManager().Acquire( _cmdPools.queue );
+			CHECK_ERR( pool );
+
+			_batch->AddCommandPool( pool );
+		}
+		return pool;
+	}
+
 /*
 =================================================
 	_BuildCommandBuffers
@@ -198,10 +271,8 @@ namespace {
 		
 		// create command buffer
 		{
-			auto&	pool = _perQueue[ uint(_queueIndex) ];
-			
-			cmd = pool.AllocPrimary( dev );
-			_batch->PushBackCommandBuffer( cmd, &pool );
+			cmd = _cmdPools.primary->AllocPrimary( dev );
+			_batch->PushBackCommandBuffer( cmd, _cmdPools.primary );
 		}
 
 		// begin
@@ -234,6 +305,7 @@ namespace {
 			barrier.dstAccessMask	= VK_ACCESS_HOST_READ_BIT;
 			_barrierMngr.AddMemoryBarrier( VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, barrier );
 
+			_DiscardTransientStates();
 			_FlushLocalResourceStates( ExeOrderIndex::Final, _barrierMngr, GetDebugger() );
 			_barrierMngr.ForceCommit( dev, cmd, dev.GetAllWritableStages(), dev.GetAllReadableStages() );
 		}
@@ -259,65 +331,628 @@ namespace {
 		if_unlikely( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddTask( _currTask );
 
-		node->Process( this );
+		node->Process( this );
+
+		_movedTransitions.clear();
+	}
+
+namespace {
+/*
+=================================================
+	TaskOrderCost
+----
+	estimates number of transitions and pipeline switches for the next task,
+	uses the same rules as 'VBarrierOptimizer': transition is not needed
+	only if resource is read in the same state as in previous task.
+	Initial resource states are unknown, so the first use is not counted.
+=================================================
+*/
+	template <typename ResourceUsage, typename TaskUsageMap>
+	struct TaskOrderCost
+	{
+		struct LastUse
+		{
+			uint64_t	state;
+			bool		isWrite;
+		};
+
+		ArrayView<ResourceUsage>			usages;
+		TaskUsageMap const&					taskUsages;
+		HashMap< void const*, LastUse >		lastUse;
+		void const*							pipeline	= null;
+
+		TaskOrderCost (ArrayView<ResourceUsage> usages, const TaskUsageMap &taskUsages) : usages{usages}, taskUsages{taskUsages} {}
+
+		template <typename FnT>
+		void  _ForEachUsage (VTask node, FnT &&fn) const
+		{
+			auto	iter = taskUsages.find( node );
+			if ( iter == taskUsages.end() )
+				return;
+
+			const uint	first	= iter->second.first;
+			const uint	end		= first + iter->second.count;
+
+			for (uint u = first; u < end; ++u)
+			{
+				auto&		usage		= usages[u];
+				const auto	res			= usage.Resource();
+				bool		processed	= false;
+				bool		pinned		= false;
+				bool		is_write	= false;
+
+				for (uint j = first; j < u; ++j) {
+					processed |= (usages[j].Resource() == res);
+				}
+				if ( processed )
+					continue;
+
+				for (uint j = u; j < end; ++j)
+				{
+					if ( usages[j].Resource() != res )
+						continue;
+
+					pinned   |= (usages[j].state != usage.state or usages[j].layout != usage.layout);
+					is_write |= EResourceState_IsWritable( usages[j].state );
+				}
+
+				fn( res, (uint64_t(usage.layout) << 32) | uint64_t(usage.state), is_write or pinned );
+			}
+		}
+
+		ND_ uint  Transitions (VTask node) const
+		{
+			uint	count = 0;
+			_ForEachUsage( node, [this, &count] (void const* res, uint64_t state, bool isWrite)
+				{
+					auto	iter = lastUse.find( res );
+					count += uint(iter != lastUse.end() and (isWrite or iter->second.isWrite or iter->second.state != state));
+				});
+			return count;
+		}
+
+		ND_ bool  PipelineChanged (VTask node) const
+		{
+			auto	iter = taskUsages.find( node );
+			return	iter != taskUsages.end() and iter->second.pipeline != null and iter->second.pipeline != pipeline;
+		}
+
+		ND_ uint  operator () (VTask node) const
+		{
+			// transition is more expensive than pipeline switch
+			return Transitions( node ) * 2 + uint(PipelineChanged( node ));
+		}
+
+		void  Apply (VTask node)
+		{
+			_ForEachUsage( node, [this] (void const* res, uint64_t state, bool isWrite)
+				{
+					lastUse.insert_or_assign( res, LastUse{ state, isWrite });
+				});
+
+			auto	iter = taskUsages.find( node );
+			if ( iter != taskUsages.end() and iter->second.pipeline != null )
+				pipeline = iter->second.pipeline;
+		}
+	};
+}
+/*
+=================================================
+	_ScheduleTasks
+----
+	all passes must use this function to get the same execution order.
+	If reordering is enabled then among ready tasks the task that requires
+	fewer transitions and pipeline switches is processed first.
+=================================================
+*/
+	template <typename FnT>
+	bool  VCommandBuffer::_ScheduleTasks (FnT &&fn)
+	{
+		if ( not _resUsage.reorderTasks )
+			return _taskGraph.Schedule( GetAllocator(), std::forward<FnT>(fn) );
+
+		TaskOrderCost< ResourceUsage_t, decltype(_resUsage.taskUsages) >	cost{ _resUsage.usages, _resUsage.taskUsages };
+
+		return _taskGraph.ScheduleWithCost( GetAllocator(), cost,
+					[&cost, &fn] (VTask node)
+					{
+						cost.Apply( node );
+						fn( node );
+					});
+	}
+
+/*
+=================================================
+	_UpdateReorderStatistic
+----
+	compares default and reordered execution order using the same cost model,
+	result is an estimation, real number of barriers depends on barrier optimization.
+	Requires two additional scheduling passes, so enabled only with 'EDebugFlags::ReorderStatistic'.
+=================================================
+*/
+	void  VCommandBuffer::_UpdateReorderStatistic ()
+	{
+		using Cost_t = TaskOrderCost< ResourceUsage_t, decltype(_resUsage.taskUsages) >;
+
+		struct Counter
+		{
+			Cost_t			cost;
+			Array<VTask>	order;
+			int				barriers	= 0;
+			int				binds		= 0;
+
+			Counter (const VCommandBuffer &cb) : cost{ cb._resUsage.usages, cb._resUsage.taskUsages } {}
+
+			void  operator () (VTask node)
+			{
+				barriers += int(cost.Transitions( node ) > 0);
+				binds    += int(cost.PipelineChanged( node ));
+				cost.Apply( node );
+				order.push_back( node );
+			}
+		};
+
+		Counter		def_order	{ *this };
+		Counter		new_order	{ *this };
+
+		CHECK_ERRV( _taskGraph.Schedule( GetAllocator(), std::ref(def_order) ));
+		CHECK_ERRV( _ScheduleTasks( std::ref(new_order) ));
+		CHECK_ERRV( def_order.order.size() == new_order.order.size() );
+
+		auto&	stat = EditStatistic().renderer;
+
+		for (size_t i = 0; i < def_order.order.size(); ++i) {
+			stat.reorderedTasks += uint(def_order.order[i] != new_order.order[i]);
+		}
+		stat.barriersSavedByReorder			+= (def_order.barriers - new_order.barriers);
+		stat.pipelineBindsSavedByReorder	+= (def_order.binds - new_order.binds);
+	}
+
+/*
+=================================================
+	_ProcessTasks
+=================================================
+*/
+	bool  VCommandBuffer::_ProcessTasks (VkCommandBuffer cmd)
+	{
+		if_unlikely( _resUsage.reorderStatistic )
+			_UpdateReorderStatistic();
+
+		if ( _resUsage.optimizeBarriers )
+			return _ProcessTasksWithBarrierOptimization( cmd );
+
+		VTaskProcessor			processor{ *this, cmd };
+		ExeOrderIndex			exe_order_index	= ExeOrderIndex::First;
+		ExeOrderIndex const*	alias_barrier	= _transient.barriers.data();
+		ExeOrderIndex const*	alias_end		= alias_barrier + _transient.barriers.size();
+
+		return _ScheduleTasks(
+					[this, &processor, &exe_order_index, &alias_barrier, alias_end] (VTask node)
+					{
+						node->SetExecutionOrder( ++exe_order_index );
+
+						// memory of transient resource was used by another resource
+						if_unlikely( alias_barrier != alias_end and *alias_barrier == exe_order_index )
+						{
+							VkMemoryBarrier	barrier = {};
+							barrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+							barrier.srcAccessMask	= VK_ACCESS_MEMORY_WRITE_BIT;
+							barrier.dstAccessMask	= VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+							_barrierMngr.AddMemoryBarrier( VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, barrier );
+							++alias_barrier;
+						}
+
+						processor.Run( node );
+					});
+	}
+
+/*
+=================================================
+	_ProcessTasksWithBarrierOptimization
+----
+	tasks are scheduled before recording, then transitions are moved
+	to the earliest task where they can be merged with other transitions.
+=================================================
+*/
+	bool  VCommandBuffer::_ProcessTasksWithBarrierOptimization (VkCommandBuffer cmd)
+	{
+		using Optimizer_t = VBarrierOptimizer;
+
+		Array< VTask >					order;
+		Array< Optimizer_t::Task >		tasks;
+		Array< Optimizer_t::Usage >		usages;
+		Array< ResourceUsage_t const* >	states;		// for each usage
+		Array< uint >					consumers;	// for each usage
+		ExeOrderIndex					exe_order_index	= ExeOrderIndex::First;
+		ExeOrderIndex const*			alias_barrier	= _transient.barriers.data();
+		ExeOrderIndex const*			alias_end		= alias_barrier + _transient.barriers.size();
+
+		CHECK_ERR( _ScheduleTasks( [&order] (VTask node) { order.push_back( node ); }));
+
+		// gather resource usage in execution order
+		tasks.resize( order.size() );
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			auto&	dst = tasks[i];
+
+			order[i]->SetExecutionOrder( ++exe_order_index );
+
+			if_unlikely( alias_barrier != alias_end and *alias_barrier == exe_order_index )
+			{
+				dst.fence = true;
+				++alias_barrier;
+			}
+
+			auto	iter = _resUsage.taskUsages.find( order[i] );
+			if ( iter == _resUsage.taskUsages.end() )
+			{
+				dst.opaque = true;
+				continue;
+			}
+
+			dst.firstUsage	= uint(usages.size());
+			dst.usageCount	= iter->second.count;
+
+			for (uint j = 0; j < iter->second.count; ++j)
+			{
+				auto&	src = _resUsage.usages[ iter->second.first + j ];
+
+				usages.push_back({ src.Resource(), (uint64_t(src.layout) << 32) | uint64_t(src.state), EResourceState_IsWritable( src.state )});
+				states.push_back( &src );
+				consumers.push_back( uint(i) );
+			}
+		}
+
+		Optimizer_t::Result	plan;
+		CHECK_ERR( Optimizer_t::Optimize( tasks, usages, AnyBits( _GetQueueUsage(), ComputeBit ), OUT plan ));
+
+		// early transitions sorted by target task, events are sorted by producer
+		Array< Pair< uint, uint >>	early;
+		Array< Pair< uint, uint >>	signals;
+		Array< VkEvent >			events;		events.resize( usages.size(), VK_NULL_HANDLE );
+
+		const auto	IsFirstInGroup = [&] (uint u)
+		{
+			for (uint j = tasks[consumers[u]].firstUsage; j < u; ++j) {
+				if ( usages[j].resource == usages[u].resource )
+					return false;
+			}
+			return true;
+		};
+
+		for (uint u = 0; u < usages.size(); ++u)
+		{
+			if ( not IsFirstInGroup( u ))
+				continue;
+
+			if ( plan.splitProducer[u] != UMax )
+				signals.emplace_back( plan.splitProducer[u], u );
+			else
+			if ( plan.barrierPoint[u] != UMax and plan.barrierPoint[u] != consumers[u] )
+				early.emplace_back( plan.barrierPoint[u], u );
+		}
+		std::stable_sort( early.begin(), early.end(), [] (auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+		std::stable_sort( signals.begin(), signals.end(), [] (auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+		// record commands
+		VTaskProcessor	processor{ *this, cmd };
+		auto&			dev			= GetDevice();
+		size_t			early_idx	= 0;
+		size_t			signal_idx	= 0;
+
+		for (uint i = 0; i < order.size(); ++i)
+		{
+			// memory of transient resource was used by another resource
+			if_unlikely( tasks[i].fence )
+			{
+				VkMemoryBarrier	barrier = {};
+				barrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+				barrier.srcAccessMask	= VK_ACCESS_MEMORY_WRITE_BIT;
+				barrier.dstAccessMask	= VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+				_barrierMngr.AddMemoryBarrier( VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, barrier );
+			}
+
+			// transitions for next tasks will be recorded in this barrier
+			for (; early_idx < early.size() and early[early_idx].first == i; ++early_idx)
+			{
+				const uint	u = early[early_idx].second;
+				processor.AddEarlyTransition( *states[u], order[ consumers[u] ]);
+			}
+
+			// transitions for this task was recorded before
+			for (uint u = tasks[i].firstUsage, end = u + tasks[i].usageCount; u < end; ++u)
+			{
+				if ( not IsFirstInGroup( u ))
+					continue;
+
+				if ( events[u] != VK_NULL_HANDLE )
+					processor.WaitEvent( events[u], *states[u], order[i] );
+				else
+				if ( plan.barrierPoint[u] == UMax or plan.barrierPoint[u] == i )
+					continue;
+
+				processor.SkipTransition( usages[u].resource );
+			}
+
+			processor.Run( order[i] );
+
+			// first half of split barriers
+			for (; signal_idx < signals.size() and signals[signal_idx].first == i; ++signal_idx)
+			{
+				VkEventCreateInfo	info = {};
+				info.sType	= VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+				VkEvent		event = VK_NULL_HANDLE;
+				VK_CHECK( dev.vkCreateEvent( dev.GetVkDevice(), &info, null, OUT &event ));
+				_batch->DestroyPostponed( VK_OBJECT_TYPE_EVENT, BitCast<uint64_t>(event) );
+
+				processor.SignalEvent( event );
+				events[ signals[signal_idx].second ] = event;
+			}
+		}
+		return true;
+	}
+
+/*
+=================================================
+	PipelineResourceUsage
+=================================================
+*/
+namespace {
+	struct PipelineResourceUsage
+	{
+		VCommandBuffer &					cb;
+		Array<VTaskProcessor::ResourceUsage>&	usages;
+
+		void  operator () (const UniformID &, const PipelineResources::Buffer &buf)
+		{
+			for (uint i = 0; i < buf.elementCount; ++i) {
+				if ( auto* buffer = cb.ToLocal( buf.elements[i].bufferId ))
+					usages.push_back({ buffer, null, buf.state, Zero });
+			}
+		}
+
+		void  operator () (const UniformID &, const PipelineResources::TexelBuffer &texbuf)
+		{
+			for (uint i = 0; i < texbuf.elementCount; ++i) {
+				if ( auto* buffer = cb.ToLocal( texbuf.elements[i].bufferId ))
+					usages.push_back({ buffer, null, texbuf.state, Zero });
+			}
+		}
+
+		void  operator () (const UniformID &, const PipelineResources::Image &img)
+		{
+			for (uint i = 0; i < img.elementCount; ++i) {
+				if ( auto* image = cb.ToLocal( img.elements[i].imageId ))
+					usages.push_back({ null, image, img.state, EResourceState_ToImageLayout( img.state, image->AspectMask() )});
+			}
+		}
+
+		void  operator () (const UniformID &, const PipelineResources::Texture &tex)
+		{
+			for (uint i = 0; i < tex.elementCount; ++i) {
+				if ( auto* image = cb.ToLocal( tex.elements[i].imageId ))
+					usages.push_back({ null, image, tex.state, EResourceState_ToImageLayout( tex.state, image->AspectMask() )});
+			}
+		}
+
+		void  operator () (const UniformID &, const PipelineResources::Sampler &) {}
+		void  operator () (const UniformID &, const PipelineResources::RayTracingScene &) {}
+	};
+}
+/*
+=================================================
+	_GatherResourceUsage
+----
+	must match with resource usage in 'VTaskProcessor::Visit',
+	but ranges are not needed because transition is moved for the whole resource.
+=================================================
+*/
+	void  VCommandBuffer::_GatherResourceUsage (const VPipelineResourceSet &resourceSet)
+	{
+		PipelineResourceUsage	visitor{ *this, _resUsage.usages };
+
+		for (auto& res : resourceSet.resources) {
+			res.pplnRes->ForEachUniform( visitor );
+		}
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<DispatchCompute> &task)
+	{
+		_GatherResourceUsage( task.GetResources() );
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<DispatchComputeIndirect> &task)
+	{
+		_GatherResourceUsage( task.GetResources() );
+		_resUsage.usages.push_back({ task.indirectBuffer, null, EResourceState::IndirectBuffer, Zero });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<CopyBuffer> &task)
+	{
+		_resUsage.usages.push_back({ task.srcBuffer, null, EResourceState::TransferSrc, Zero });
+		_resUsage.usages.push_back({ task.dstBuffer, null, EResourceState::TransferDst, Zero });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<CopyImage> &task)
+	{
+		_resUsage.usages.push_back({ null, task.srcImage, EResourceState::TransferSrc, task.srcLayout });
+		_resUsage.usages.push_back({ null, task.dstImage, EResourceState::TransferDst, task.dstLayout });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<CopyBufferToImage> &task)
+	{
+		_resUsage.usages.push_back({ task.srcBuffer, null, EResourceState::TransferSrc, Zero });
+		_resUsage.usages.push_back({ null, task.dstImage, EResourceState::TransferDst, task.dstLayout });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<CopyImageToBuffer> &task)
+	{
+		_resUsage.usages.push_back({ null, task.srcImage, EResourceState::TransferSrc, task.srcLayout });
+		_resUsage.usages.push_back({ task.dstBuffer, null, EResourceState::TransferDst, Zero });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<BlitImage> &task)
+	{
+		_resUsage.usages.push_back({ null, task.srcImage, EResourceState::TransferSrc, task.srcLayout });
+		_resUsage.usages.push_back({ null, task.dstImage, EResourceState::TransferDst, task.dstLayout });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<ResolveImage> &task)
+	{
+		_resUsage.usages.push_back({ null, task.srcImage, EResourceState::TransferSrc, task.srcLayout });
+		_resUsage.usages.push_back({ null, task.dstImage, EResourceState::TransferDst, task.dstLayout });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<FillBuffer> &task)
+	{
+		_resUsage.usages.push_back({ task.dstBuffer, null, EResourceState::TransferDst, Zero });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<ClearColorImage> &task)
+	{
+		_resUsage.usages.push_back({ null, task.dstImage, EResourceState::TransferDst, task.dstLayout });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<ClearDepthStencilImage> &task)
+	{
+		_resUsage.usages.push_back({ null, task.dstImage, EResourceState::TransferDst, task.dstLayout });
+		return true;
+	}
+
+	bool  VCommandBuffer::_GatherResourceUsage (const VFgTask<UpdateBuffer> &task)
+	{
+		_resUsage.usages.push_back({ task.dstBuffer, null, EResourceState::TransferDst, Zero });
+		return true;
 	}
 
 /*
 =================================================
-	_ProcessTasks
+	_MergeRenderPasses
+----
+	render passes that are executed one after another are merged into subpasses,
+	so render targets are not stored to memory between them.
+	Pass with unknown resource usage (custom draw) or with storage writes is not merged
+	because synchronization inside render pass is limited to subpass dependencies.
 =================================================
 */
-	bool  VCommandBuffer::_ProcessTasks (VkCommandBuffer cmd)
+	void  VCommandBuffer::_MergeRenderPasses ()
 	{
-		VTaskProcessor	processor{ *this, cmd };
-		uint			visitor_id		= 1;
-		ExeOrderIndex	exe_order_index	= ExeOrderIndex::First;
+		using Merger_t = VSubpassMerger;
+
+		auto&	tasks = _subpassMerge.tasks;
+
+		if ( tasks.size() < 2 )
+			return;
+
+		// '_ProcessTasks' will produce same order
+		{
+			ExeOrderIndex	exe_order_index	= ExeOrderIndex::First;
+
+			CHECK_ERRV( _ScheduleTasks( [&exe_order_index] (VTask node) { node->SetExecutionOrder( ++exe_order_index ); }));
+		}
+		std::sort( tasks.begin(), tasks.end(), [] (auto* lhs, auto* rhs) { return lhs->ExecutionOrder() < rhs->ExecutionOrder(); });
 
-		TempTaskArray_t		pending{ GetAllocator() };
-		pending.reserve( 128 );
-		pending.assign( _taskGraph.Entries().begin(), _taskGraph.Entries().end() );
+		Array< Merger_t::Pass >			passes;
+		Array< Merger_t::ImageAccess >	images;
+		Array< Pair<size_t, size_t> >	image_ranges;
+		Array< Merger_t::Subpass >		subpasses;
+		Array< ResourceUsage_t >		usages;
+		PipelineResourceUsage			visitor{ *this, usages };
 
-		for (uint k = 0; k < 10 and not pending.empty(); ++k)
+		for (size_t first = 0; first < tasks.size();)
 		{
-			for (size_t i = 0; i < pending.size();)
+			// find tasks without any other tasks between them
+			size_t	last = first + 1;
+			for (; last < tasks.size() and uint(tasks[last]->ExecutionOrder()) == uint(tasks[last-1]->ExecutionOrder()) + 1; ++last) {}
+
+			if ( last - first < 2 )
 			{
-				auto	node = pending[i];
-				
-				if ( node->VisitorID() == visitor_id ) {
-					++i;
-					continue;
-				}
+				first = last;
+				continue;
+			}
+
+			passes.clear();
+			images.clear();
+			image_ranges.clear();
+
+			for (size_t i = first; i < last; ++i)
+			{
+				auto&	logical	= *tasks[i]->GetLogicalPass();
+				auto&	dst		= passes.emplace_back();
 
-				// wait for input
-				bool	input_processed = true;
+				dst.area		= logical.GetArea();
+				dst.mergeable	= not (logical.GetDrawTasks().empty() or logical.HasShadingRateImage());
+				dst.fence		= std::binary_search( _transient.barriers.begin(), _transient.barriers.end(), tasks[i]->ExecutionOrder() );
 
-				for (auto in_node : node->Inputs())
+				for (auto& ct : logical.GetColorTargets()) {
+					dst.attachments.push_back({ ct.imagePtr, ct._imageHash, ct.index, (ct.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) });
+				}
+				if ( auto& ds = logical.GetDepthStencilTarget(); ds.IsDefined() ) {
+					dst.attachments.push_back({ ds.imagePtr, ds._imageHash, Merger_t::DepthSlot, (ds.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) });
+				}
+
+				usages.clear();
+				for (auto& draw : logical.GetDrawTasks())
 				{
-					if ( in_node->VisitorID() != visitor_id ) {
-						input_processed = false;
+					auto*	res = draw->GetResourceSet();
+					if ( res == null ) {
+						dst.mergeable = false;
 						break;
 					}
+					for (auto& item : res->resources) {
+						item.pplnRes->ForEachUniform( visitor );
+					}
+				}
+				for (auto& item : logical.GetMutableImages()) {
+					usages.push_back({ null, item.first, item.second, Zero });
+				}
+				for (auto& item : logical.GetMutableBuffers()) {
+					usages.push_back({ item.first, null, item.second, Zero });
 				}
 
-				if ( not input_processed ) {
-					++i;
-					continue;
+				image_ranges.emplace_back( images.size(), 0 );
+				for (auto& usage : usages)
+				{
+					dst.mergeable &= not EResourceState_IsWritable( usage.state );
+
+					if ( usage.image )
+						images.push_back({ usage.image, ((usage.state & EResourceState::_StateMask) == EResourceState::InputAttachment) });
 				}
+				image_ranges.back().second = images.size();
+			}
 
-				node->SetVisitorID( visitor_id );
-				node->SetExecutionOrder( ++exe_order_index );
-				
-				processor.Run( node );
+			for (size_t i = 0; i < passes.size(); ++i) {
+				passes[i].images = ArrayView<Merger_t::ImageAccess>{ images }.section( image_ranges[i].first, image_ranges[i].second - image_ranges[i].first );
+			}
+
+			Merger_t::Merge( passes, OUT subpasses );
+
+			for (size_t i = 0; i < subpasses.size(); ++i)
+			{
+				auto*	task = tasks[ first + i ];
+
+				task->GetLogicalPass()->_SetInputAttachments( subpasses[i].inputMask );
 
-				for (auto out_node : node->Outputs())
+				if ( subpasses[i].index > 0 )
 				{
-					pending.push_back( out_node );
+					tasks[ first + i - 1 ]->SetNextSubpass( *task );
+					++EditStatistic().renderer.mergedRenderPasses;
 				}
-
-				pending.erase( pending.begin()+i );
 			}
+			first = last;
 		}
-		return true;
 	}
 //-----------------------------------------------------------------------------
 
@@ -447,6 +1082,395 @@ namespace {
 			buffer->SetInitialState( not makeMutable );
 		}
 	}
+	
+/*
+=================================================
+	CreateTransientImage
+----
+	image is created without memory, memory will be allocated in 'Execute'
+	when lifetimes of all transient resources are known.
+=================================================
+*/
+	RawImageID  VCommandBuffer::CreateTransientImage (const ImageDesc &desc, StringView dbgName)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+		CHECK_ERR( not desc.isExternal );
+		CHECK_ERR( desc.format != Default );
+		CHECK_ERR( desc.usage != Default );
+
+		auto&		dev		= GetDevice();
+		ImageDesc	img_desc = desc;
+		img_desc.Validate();
+
+		CHECK_ERR( VImage::IsSupported( dev, img_desc, EMemoryType::Default ));
+
+		VkImageCreateInfo	info = {};
+		info.sType			= VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		info.flags			= VEnumCast( img_desc.flags );
+		info.imageType		= VEnumCast( img_desc.imageType );
+		info.format			= VEnumCast( img_desc.format );
+		info.extent.width	= img_desc.dimension.x;
+		info.extent.height	= img_desc.dimension.y;
+		info.extent.depth	= img_desc.dimension.z;
+		info.mipLevels		= img_desc.maxLevel.Get();
+		info.arrayLayers	= img_desc.arrayLayers.Get();
+		info.samples		= VEnumCast( img_desc.samples );
+		info.tiling			= VK_IMAGE_TILING_OPTIMAL;
+		info.usage			= VEnumCast( img_desc.usage );
+		info.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+		info.initialLayout	= VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VkImage		image = VK_NULL_HANDLE;
+		VK_CHECK( dev.vkCreateImage( dev.GetVkDevice(), &info, null, OUT &image ));
+
+		VulkanImageDesc		vk_desc;
+		vk_desc.image		= BitCast<ImageVk_t>( image );
+		vk_desc.imageType	= BitCast<ImageTypeVk_t>( info.imageType );
+		vk_desc.flags		= BitCast<ImageFlagsVk_t>( info.flags );
+		vk_desc.usage		= BitCast<ImageUsageVk_t>( info.usage );
+		vk_desc.format		= BitCast<FormatVk_t>( info.format );
+		vk_desc.samples		= BitCast<SampleCountFlagBitsVk_t>( info.samples );
+		vk_desc.dimension	= img_desc.dimension;
+		vk_desc.arrayLayers	= info.arrayLayers;
+		vk_desc.maxLevels	= info.mipLevels;
+		vk_desc.queueFamily	= VK_QUEUE_FAMILY_IGNORED;
+
+		RawImageID	id = GetResourceManager().CreateImage( vk_desc, Default, dbgName );
+		if ( not id )
+		{
+			dev.vkDestroyImage( dev.GetVkDevice(), image, null );
+			RETURN_ERR( "failed when creating transient image" );
+		}
+
+		// image will be destroyed when command batch completes
+		ReleaseResource( id );
+		_batch->DestroyPostponed( VK_OBJECT_TYPE_IMAGE, BitCast<uint64_t>(image) );
+
+		// previous content is undefined
+		auto*	local = ToLocal( id );
+		CHECK_ERR( local );
+		local->SetInitialState( false, true );
+
+		TransientResource	res;
+		res.image		= id;
+		res.preferLazy	= AllBits( img_desc.usage, EImageUsage::TransientAttachment );
+		dev.vkGetImageMemoryRequirements( dev.GetVkDevice(), image, OUT &res.memReq );
+
+		// must be added after 'ToLocal' to skip initial state
+		_transient.resources.push_back( res );
+		
+		EditStatistic().resources.transientResources ++;
+		EditStatistic().resources.transientMemoryRequired += BytesU{ res.memReq.size };
+		return id;
+	}
+	
+/*
+=================================================
+	CreateTransientBuffer
+=================================================
+*/
+	RawBufferID  VCommandBuffer::CreateTransientBuffer (const BufferDesc &desc, StringView dbgName)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+		CHECK_ERR( not desc.isExternal );
+		CHECK_ERR( desc.size > 0 );
+		CHECK_ERR( desc.usage != Default );
+		
+		auto&	dev = GetDevice();
+		CHECK_ERR( VBuffer::IsSupported( dev, desc, EMemoryType::Default ));
+
+		VkBufferCreateInfo	info = {};
+		info.sType			= VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		info.usage			= VEnumCast( desc.usage );
+		info.size			= VkDeviceSize( desc.size );
+		info.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+
+		VkBuffer	buffer = VK_NULL_HANDLE;
+		VK_CHECK( dev.vkCreateBuffer( dev.GetVkDevice(), &info, null, OUT &buffer ));
+
+		VulkanBufferDesc	vk_desc;
+		vk_desc.buffer		= BitCast<BufferVk_t>( buffer );
+		vk_desc.usage		= BitCast<BufferUsageFlagsVk_t>( info.usage );
+		vk_desc.size		= desc.size;
+		vk_desc.queueFamily	= VK_QUEUE_FAMILY_IGNORED;
+
+		RawBufferID	id = GetResourceManager().CreateBuffer( vk_desc, Default, dbgName );
+		if ( not id )
+		{
+			dev.vkDestroyBuffer( dev.GetVkDevice(), buffer, null );
+			RETURN_ERR( "failed when creating transient buffer" );
+		}
+		
+		// buffer will be destroyed when command batch completes
+		ReleaseResource( id );
+		_batch->DestroyPostponed( VK_OBJECT_TYPE_BUFFER, BitCast<uint64_t>(buffer) );
+
+		TransientResource	res;
+		res.buffer = id;
+		dev.vkGetBufferMemoryRequirements( dev.GetVkDevice(), buffer, OUT &res.memReq );
+
+		_transient.resources.push_back( res );
+		
+		EditStatistic().resources.transientResources ++;
+		EditStatistic().resources.transientMemoryRequired += BytesU{ res.memReq.size };
+		return id;
+	}
+	
+/*
+=================================================
+	_OnTransientUse
+----
+	resource is used in task or draw task that is currently being added,
+	it will be bound to the task in 'AttachTransientResources'.
+=================================================
+*/
+	template <typename ID>
+	inline void  VCommandBuffer::_OnTransientUse (ID id)
+	{
+		if ( not _IsRecording() )
+			return;
+
+		// small number of transient resources is expected, so linear search is fast enough
+		for (size_t i = 0; i < _transient.resources.size(); ++i)
+		{
+			auto&	res = _transient.resources[i];
+			bool	eq;
+
+			if constexpr( IsSameTypes< ID, RawImageID >)
+				eq = (res.image == id);
+			else
+				eq = (res.buffer == id);
+
+			if ( eq )
+			{
+				if ( _transient.pending.empty() or _transient.pending.back() != i )
+					_transient.pending.push_back( uint(i) );
+				return;
+			}
+		}
+	}
+
+/*
+=================================================
+	_AttachTransientResources
+----
+	draw tasks are executed inside render pass,
+	so resources are bound to the logical pass and then to the 'SubmitRenderPass' task.
+=================================================
+*/
+	void  VCommandBuffer::_AttachTransientResources (LogicalPassID passId)
+	{
+		for (uint idx : _transient.pending) {
+			_transient.passUses.emplace_back( passId.Index(), idx );
+		}
+		_transient.pending.clear();
+	}
+	
+	void  VCommandBuffer::_AttachTransientResources (VTask task, LogicalPassID passId)
+	{
+		for (size_t i = 0; i < _transient.passUses.size();)
+		{
+			auto&	use = _transient.passUses[i];
+
+			if ( use.first == passId.Index() )
+			{
+				_transient.taskUses.emplace_back( task, use.second );
+
+				use = _transient.passUses.back();
+				_transient.passUses.pop_back();
+			}
+			else
+				++i;
+		}
+	}
+
+/*
+=================================================
+	ChooseTransientMemoryType
+=================================================
+*/
+namespace {
+	ND_ static uint  ChooseTransientMemoryType (const VkPhysicalDeviceMemoryProperties &props, const VkMemoryRequirements &memReq, bool preferLazy)
+	{
+		const VkMemoryPropertyFlags	lazy_flags		= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+		const VkMemoryPropertyFlags	preferred[]		= { (preferLazy ? lazy_flags : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+
+		for (auto flags : preferred)
+		{
+			for (uint i = 0; i < props.memoryTypeCount; ++i)
+			{
+				if ( AllBits( memReq.memoryTypeBits, 1u << i ) and
+					 AllBits( props.memoryTypes[i].propertyFlags, flags ))
+				{
+					// lazily allocated memory is not suitable for other resources
+					if ( not preferLazy and AllBits( props.memoryTypes[i].propertyFlags, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT ))
+						continue;
+
+					return i;
+				}
+			}
+		}
+		return UMax;
+	}
+}
+
+/*
+=================================================
+	_AllocateTransientMemory
+----
+	lifetime of each transient resource is a range of execution order indices of tasks that use it.
+	Resources with non-overlapped lifetimes share the same memory,
+	memory barrier is added before the first use of such resource.
+=================================================
+*/
+	bool  VCommandBuffer::_AllocateTransientMemory ()
+	{
+		using MemAllocator_t = VTransientMemoryAllocator;
+
+		if ( _transient.resources.empty() )
+			return true;
+
+		// uses without task (for example in 'AcquireImage') doesn't extend lifetime
+		_transient.pending.clear();
+		ASSERT( _transient.passUses.empty() and "some logical render passes are not submitted" );
+
+		// '_ProcessTasks' will produce same order
+		{
+			ExeOrderIndex	exe_order_index	= ExeOrderIndex::First;
+
+			CHECK_ERR( _ScheduleTasks( [&exe_order_index] (VTask node) { node->SetExecutionOrder( ++exe_order_index ); }));
+		}
+
+		auto&		dev			= GetDevice();
+		auto&		mem_props	= dev.GetProperties().memoryProperties;
+		auto&		res_mngr	= GetResourceManager();
+		const uint	count		= uint(_transient.resources.size());
+
+		Array< MemAllocator_t::Resource >	resources;
+		MemAllocator_t::Placements_t		placements;
+		MemAllocator_t::Heaps_t				heaps;
+
+		resources.resize( count );
+
+		for (uint i = 0; i < count; ++i)
+		{
+			auto&	src = _transient.resources[i];
+			auto&	dst = resources[i];
+
+			dst.size			= BytesU{ src.memReq.size };
+			dst.align			= BytesU{ src.memReq.alignment };
+			dst.memTypeIndex	= ChooseTransientMemoryType( mem_props, src.memReq, src.preferLazy );
+			CHECK_ERR( dst.memTypeIndex != UMax );
+		}
+
+		for (auto& use : _transient.taskUses)
+		{
+			auto&		dst		= resources[ use.second ];
+			const uint	index	= uint(use.first->ExecutionOrder());
+
+			dst.firstUse = Min( dst.firstUse, index );
+			dst.lastUse  = Max( dst.lastUse,  index );
+		}
+
+		// resource is not used in any task
+		for (auto& res : resources)
+		{
+			if ( res.firstUse > res.lastUse )
+				res.firstUse = res.lastUse = uint(ExeOrderIndex::Initial);
+		}
+
+		CHECK_ERR( MemAllocator_t::Allocate( resources, BytesU{dev.GetDeviceLimits().bufferImageGranularity}, OUT placements, OUT heaps ));
+
+		// acquire heaps, free heaps of completed batches are reused
+		FixedArray< VkDeviceMemory, VK_MAX_MEMORY_TYPES >	memory;
+
+		for (auto& heap : heaps)
+		{
+			VCmdBatch::TransientHeap	dst;
+			bool						is_new	= false;
+			CHECK_ERR( res_mngr.AcquireTransientHeap( heap.memTypeIndex, heap.size, OUT dst, OUT is_new ));
+
+			// heap will be returned to resource manager when command batch completes
+			_batch->AddTransientHeap( dst );
+			memory.push_back( dst.memory );
+
+			EditStatistic().resources.transientMemoryAllocated += heap.size;
+
+			if ( is_new )
+				EditStatistic().resources.transientHeapAllocations += 1;
+		}
+
+		// bind memory
+		for (uint i = 0; i < count; ++i)
+		{
+			auto&			src		= _transient.resources[i];
+			auto&			place	= placements[i];
+			VkDeviceMemory	mem		= memory[ place.heapIndex ];
+
+			if ( src.image )
+			{
+				auto*	image = res_mngr.GetResource( src.image );
+				CHECK_ERR( image );
+				VK_CHECK( dev.vkBindImageMemory( dev.GetVkDevice(), image->Handle(), mem, VkDeviceSize(place.offset) ));
+			}
+			else
+			{
+				auto*	buffer = res_mngr.GetResource( src.buffer );
+				CHECK_ERR( buffer );
+				VK_CHECK( dev.vkBindBufferMemory( dev.GetVkDevice(), buffer->Handle(), mem, VkDeviceSize(place.offset) ));
+			}
+
+			if ( place.aliased )
+				_transient.barriers.push_back( ExeOrderIndex(resources[i].firstUse) );
+		}
+
+		std::sort( _transient.barriers.begin(), _transient.barriers.end() );
+		_transient.barriers.erase( std::unique( _transient.barriers.begin(), _transient.barriers.end() ), _transient.barriers.end() );
+		return true;
+	}
+	
+/*
+=================================================
+	_DiscardTransientStates
+----
+	transient resources will be destroyed, so transition to default state is not needed,
+	it also prevents from writing to memory that is already used by another resource.
+=================================================
+*/
+	void  VCommandBuffer::_DiscardTransientStates ()
+	{
+		for (auto& res : _transient.resources)
+		{
+			if ( res.image and res.image.Index() < _rm.images.toLocal.size() )
+			{
+				Index_t	local = _rm.images.toLocal[ res.image.Index() ];
+				if ( local != UMax )
+					_rm.images.pool[ local ].Data().DiscardState();
+			}
+			if ( res.buffer and res.buffer.Index() < _rm.buffers.toLocal.size() )
+			{
+				Index_t	local = _rm.buffers.toLocal[ res.buffer.Index() ];
+				if ( local != UMax )
+					_rm.buffers.pool[ local ].Data().DiscardState();
+			}
+		}
+	}
+	
+/*
+=================================================
+	_ResetTransientResources
+=================================================
+*/
+	void  VCommandBuffer::_ResetTransientResources ()
+	{
+		_transient.resources.clear();
+		_transient.pending.clear();
+		_transient.taskUses.clear();
+		_transient.passUses.clear();
+		_transient.barriers.clear();
+	}
 
 /*
 =================================================
@@ -462,6 +1486,13 @@ namespace {
 		// TODO: add scale to shader timemap
 
 		auto	rp_task = _taskGraph.Add( *this, task );
+		CHECK_ERR( rp_task );
+
+		// draw tasks are executed together with render pass
+		_AttachTransientResources( rp_task, task.renderPassId );
+
+		if ( _subpassMerge.enabled )
+			_subpassMerge.tasks.push_back( rp_task );
 		
 		if ( AllBits( _shaderDbg.timemapStages, EShaderStages::Fragment ) and _shaderDbg.timemapIndex != Default )
 		{
@@ -710,11 +1741,11 @@ namespace {
 		// copy to staging buffer
 		for (auto& reg : task.regions)
 		{
-			for (BytesU readn; readn < ArraySizeOf(reg.data);)
+			for (BytesU readn; readn < reg.Size();)
 			{
 				RawBufferID		src_buffer;
 				BytesU			off, size;
-				CHECK_ERR( _StorePartialData( reg.data, readn, OUT src_buffer, OUT off, OUT size ));
+				CHECK_ERR( _StorePartialData( reg, readn, OUT src_buffer, OUT off, OUT size ));
 			
 				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 				{
@@ -774,7 +1805,7 @@ namespace {
 		const BytesU	slice_pitch		= Max( task.dataSlicePitch, min_slice_pitch );
 		const BytesU	total_size		= image_size.z > 1 ? slice_pitch * image_size.z : min_slice_pitch;
 
-		CHECK_ERR( total_size == ArraySizeOf(task.data) );
+		CHECK_ERR( task.writer ? task.data.empty() : total_size == ArraySizeOf(task.data) );
 
 		const BytesU		min_size	= _instance.GetResourceManager().GetHostWriteBufferSize() / 4;
 		const uint			row_length	= CheckCast<uint>((row_pitch * block_dim.x * 8) / block_size);
@@ -797,7 +1828,7 @@ namespace {
 			{
 				RawBufferID		src_buffer;
 				BytesU			off, size;
-				CHECK_ERR( _StoreImageData( task.data, readn, slice_pitch, total_size, OUT src_buffer, OUT off, OUT size ));
+				CHECK_ERR( _StoreImageData( task, 0_b, total_size, readn, slice_pitch, total_size, OUT src_buffer, OUT off, OUT size ));
 				
 				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 				{
@@ -827,14 +1858,15 @@ namespace {
 		// copy to staging buffer row by row
 		for (uint slice = 0; slice < image_size.z; ++slice)
 		{
-			uint				y_offset	= 0;
-			ArrayView<uint8_t>	data		= task.data.section( size_t(slice * slice_pitch), size_t(slice_pitch) );
+			uint			y_offset	= 0;
+			const BytesU	slice_off	= slice * slice_pitch;
+			const BytesU	slice_size	= Min( slice_pitch, total_size - slice_off );
 
-			for (BytesU readn; readn < ArraySizeOf(data);)
+			for (BytesU readn; readn < slice_size;)
 			{
 				RawBufferID		src_buffer;
 				BytesU			off, size;
-				CHECK_ERR( _StoreImageData( data, readn, row_pitch * block_dim.y, total_size, OUT src_buffer, OUT off, OUT size ));
+				CHECK_ERR( _StoreImageData( task, slice_off, slice_size, readn, row_pitch * block_dim.y, total_size, OUT src_buffer, OUT off, OUT size ));
 				
 				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 				{
@@ -878,7 +1910,26 @@ namespace {
 		if ( task.size == 0 )
 			return null;	// TODO: is it an error?
 
-		return _AddReadBufferTask( task );
+		return _AddReadBufferTask( task, null );
+	}
+	
+/*
+=================================================
+	AddTask (ReadBuffer)
+=================================================
+*/
+	Task  VCommandBuffer::AddTask (const ReadBuffer &task, OUT ReadbackFuture &result)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+		ASSERT( AllBits( TransferBit, _GetQueueUsage() ));
+		
+		result = null;
+
+		if ( task.size == 0 )
+			return null;	// TODO: is it an error?
+
+		return _AddReadBufferTask( task, &result );
 	}
 	
 /*
@@ -886,15 +1937,18 @@ namespace {
 	_AddReadBufferTask
 =================================================
 */
-	Task  VCommandBuffer::_AddReadBufferTask (const ReadBuffer &task)
+	Task  VCommandBuffer::_AddReadBufferTask (const ReadBuffer &task, OUT ReadbackFuture *result)
 	{
 		using OnDataLoadedEvent = VCmdBatch::OnBufferDataLoadedEvent;
 
-		CHECK_ERR( task.srcBuffer and task.callback );
+		CHECK_ERR( task.srcBuffer and (task.callback or result) );
 
 		OnDataLoadedEvent	load_event{ task.callback, task.size };
 		CopyBuffer			copy;
 
+		if ( result )
+			load_event.future = MakeShared<VReadbackFuture>( _instance, CommandBuffer{ this, _batch.get() });
+
 		copy.taskName	= task.taskName;
 		copy.debugColor	= task.debugColor;
 		copy.depends	= task.depends;
@@ -905,7 +1959,7 @@ namespace {
 		{
 			RawBufferID					dst_buffer;
 			OnDataLoadedEvent::Range	range;
-			CHECK_ERR( _batch->AddPendingLoad( written, task.size, OUT dst_buffer, OUT range ));
+			CHECK_ERR( _batch->AddPendingLoad( written, task.size, result != null, OUT dst_buffer, OUT range ));
 			
 			if ( copy.dstBuffer and dst_buffer != copy.dstBuffer )
 			{
@@ -922,6 +1976,9 @@ namespace {
 			copy.dstBuffer = dst_buffer;
 		}
 
+		if ( result )
+			*result = load_event.future;
+
 		_batch->AddDataLoadedEvent( std::move(load_event) );
 		
 		return AddTask( copy );
@@ -941,7 +1998,26 @@ namespace {
 		if ( All( task.imageSize == Zero ))
 			return null;	// TODO: is it an error?
 
-		return _AddReadImageTask( task );
+		return _AddReadImageTask( task, null );
+	}
+	
+/*
+=================================================
+	AddTask (ReadImage)
+=================================================
+*/
+	Task  VCommandBuffer::AddTask (const ReadImage &task, OUT ReadbackFuture &result)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+		ASSERT( AllBits( TransferBit, _GetQueueUsage() ));
+		
+		result = null;
+
+		if ( All( task.imageSize == Zero ))
+			return null;	// TODO: is it an error?
+
+		return _AddReadImageTask( task, &result );
 	}
 	
 /*
@@ -949,11 +2025,11 @@ namespace {
 	_AddReadImageTask
 =================================================
 */
-	Task  VCommandBuffer::_AddReadImageTask (const ReadImage &task)
+	Task  VCommandBuffer::_AddReadImageTask (const ReadImage &task, OUT ReadbackFuture *result)
 	{
 		using OnDataLoadedEvent = VCmdBatch::OnImageDataLoadedEvent;
 
-		CHECK_ERR( task.srcImage and task.callback );
+		CHECK_ERR( task.srcImage and (task.callback or result) );
 		ImageDesc const&	img_desc = AcquireTemporary( task.srcImage )->Description();
 
 		ASSERT( task.mipmapLevel < img_desc.maxLevel );
@@ -964,7 +2040,10 @@ namespace {
 		const BytesU		min_size		= _instance.GetResourceManager().GetHostReadBufferSize() / 4;
 		const auto&			fmt_info		= EPixelFormat_GetInfo( img_desc.format );
 		const auto&			block_dim		= fmt_info.blockSize;
-		const uint			block_size		= task.aspectMask != EImageAspect::Stencil ? fmt_info.bitsPerBlock : fmt_info.bitsPerBlock2;
+		const bool			is_depth24		= (img_desc.format == EPixelFormat::Depth24 or img_desc.format == EPixelFormat::Depth24_Stencil8);
+		const uint			block_size		= task.aspectMask == EImageAspect::Stencil ? fmt_info.bitsPerBlock2 :
+											  is_depth24 ? 32 :		// 24 bit depth is copied to buffer as 32 bit texels
+											  fmt_info.bitsPerBlock;
 		const BytesU		row_pitch		= BytesU(image_size.x * block_size + block_dim.x-1) / (block_dim.x * 8);
 		const BytesU		slice_pitch		= (image_size.y * row_pitch + block_dim.y-1) / block_dim.y;
 		const BytesU		total_size		= slice_pitch * image_size.z;
@@ -974,6 +2053,10 @@ namespace {
 		OnDataLoadedEvent	load_event{ task.callback, total_size, image_size, row_pitch, slice_pitch, img_desc.format, task.aspectMask };
 		CopyImageToBuffer	copy;
 
+		if ( result )
+			load_event.future = MakeShared<VReadbackFuture>( _instance, CommandBuffer{ this, _batch.get() }, image_size, row_pitch,
+															 slice_pitch, img_desc.format, task.aspectMask );
+
 		copy.taskName	= task.taskName;
 		copy.debugColor	= task.debugColor;
 		copy.depends	= task.depends;
@@ -987,7 +2070,7 @@ namespace {
 			{
 				RawBufferID					dst_buffer;
 				OnDataLoadedEvent::Range	range;
-				CHECK_ERR( _batch->AddPendingLoad( written, total_size, slice_pitch, OUT dst_buffer, OUT range ));
+				CHECK_ERR( _batch->AddPendingLoad( written, total_size, slice_pitch, result != null, OUT dst_buffer, OUT range ));
 			
 				if ( copy.dstBuffer and dst_buffer != copy.dstBuffer )
 				{
@@ -1022,7 +2105,7 @@ namespace {
 			{
 				RawBufferID					dst_buffer;
 				OnDataLoadedEvent::Range	range;
-				CHECK_ERR( _batch->AddPendingLoad( written, total_size, row_pitch * block_dim.y, OUT dst_buffer, OUT range ));
+				CHECK_ERR( _batch->AddPendingLoad( written, total_size, row_pitch * block_dim.y, result != null, OUT dst_buffer, OUT range ));
 				
 				if ( copy.dstBuffer and dst_buffer != copy.dstBuffer )
 				{
@@ -1047,6 +2130,9 @@ namespace {
 			ASSERT( y_offset == image_size.y );
 		}
 
+		if ( result )
+			*result = load_event.future;
+
 		_batch->AddDataLoadedEvent( std::move(load_event) );
 
 		return AddTask( copy );
@@ -1485,6 +2571,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVertices,
 						VTaskProcessor::Visit2_DrawVertices );
+
+		_AttachTransientResources( renderPass );
 	}
 	
 /*
@@ -1506,6 +2594,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexed,
 						VTaskProcessor::Visit2_DrawIndexed );
+
+		_AttachTransientResources( renderPass );
 	}
 	
 /*
@@ -1529,6 +2619,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshes,
 						VTaskProcessor::Visit2_DrawMeshes );
+
+		_AttachTransientResources( renderPass );
 	#else
 		Unused( renderPass, task );
 		ASSERT( !"mesh shader is not supported" );
@@ -1555,6 +2647,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVerticesIndirect,
 						VTaskProcessor::Visit2_DrawVerticesIndirect );
+
+		_AttachTransientResources( renderPass );
 	}
 	
 /*
@@ -1577,6 +2671,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexedIndirect,
 						VTaskProcessor::Visit2_DrawIndexedIndirect );
+
+		_AttachTransientResources( renderPass );
 	}
 	
 /*
@@ -1599,6 +2695,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVerticesIndirectCount,
 						VTaskProcessor::Visit2_DrawVerticesIndirectCount );
+
+		_AttachTransientResources( renderPass );
 	}
 	
 /*
@@ -1621,6 +2719,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexedIndirectCount,
 						VTaskProcessor::Visit2_DrawIndexedIndirectCount );
+
+		_AttachTransientResources( renderPass );
 	}
 
 /*
@@ -1644,6 +2744,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshesIndirect,
 						VTaskProcessor::Visit2_DrawMeshesIndirect );
+
+		_AttachTransientResources( renderPass );
 	#else
 		Unused( renderPass, task );
 		ASSERT( !"mesh shader is not supported" );
@@ -1671,6 +2773,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshesIndirectCount,
 						VTaskProcessor::Visit2_DrawMeshesIndirectCount );
+
+		_AttachTransientResources( renderPass );
 	#else
 		Unused( renderPass, task );
 		ASSERT( !"mesh shader is not supported" );
@@ -1695,6 +2799,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_CustomDraw,
 						VTaskProcessor::Visit2_CustomDraw );
+
+		_AttachTransientResources( renderPass );
 	}
 	
 /*
@@ -1736,7 +2842,10 @@ namespace {
 
 		_rm.logicalRenderPassCount = Max( uint(index)+1, _rm.logicalRenderPassCount );
 
-		return LogicalPassID( index, 0 );
+		const LogicalPassID	result{ index, 0 };
+		_AttachTransientResources( result );
+
+		return result;
 	}
 	
 /*
@@ -1932,8 +3041,12 @@ namespace {
 		EXLOCK( _drCheck );
 		CHECK_ERR( _state == EState::Recording or _state == EState::Compiling );
 
-		if ( id.Index() >= localRes.toLocal.size() )
-			return null;
+		// index is limited by the runtime capacity of the main pool, so the table is never greater than needed
+		if_unlikely( id.Index() >= localRes.toLocal.size() )
+		{
+			CHECK_ERR( id.Index() < MainPool::MaxCapacity() );
+			localRes.toLocal.resize( Min( Max( size_t(id.Index()) + 1, localRes.toLocal.size() * 2, MinRemapTableSize ), MainPool::MaxCapacity() ), Index_t(UMax) );
+		}
 
 		Index_t&	local = localRes.toLocal[ id.Index() ];
 
@@ -1972,11 +3085,17 @@ namespace {
 */
 	VLocalBuffer const*  VCommandBuffer::ToLocal (RawBufferID id)
 	{
+		if_unlikely( _transient.resources.size() )
+			_OnTransientUse( id );
+
 		return _ToLocal( id, _rm.buffers, "failed when creating local buffer" );
 	}
 
 	VLocalImage const*  VCommandBuffer::ToLocal (RawImageID id)
 	{
+		if_unlikely( _transient.resources.size() )
+			_OnTransientUse( id );
+
 		return _ToLocal( id, _rm.images, "failed when creating local image" );
 	}
 	
@@ -2030,16 +3149,19 @@ namespace {
 	_StorePartialData
 =================================================
 */
-	bool  VCommandBuffer::_StorePartialData (ArrayView<uint8_t> srcData, const BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
+	bool  VCommandBuffer::_StorePartialData (const UpdateBuffer::Region &srcData, const BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
 	{
 		// skip blocks less than 1/N of data size
-		const BytesU	src_size	= ArraySizeOf(srcData);
+		const BytesU	src_size	= srcData.Size();
 		const BytesU	min_size	= Min( (src_size + MaxBufferParts-1) / MaxBufferParts, Min( src_size, MinBufferPart ));
 		void *			ptr			= null;
 
 		if ( _batch->GetWritable( src_size - srcOffset, 1_b, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
 		{
-			MemCopy( ptr, size, srcData.data() + srcOffset, size );
+			if ( srcData.writer )
+				srcData.writer( ptr, srcOffset, size );
+			else
+				MemCopy( ptr, size, srcData.data.data() + srcOffset, size );
 			return true;
 		}
 		return false;
@@ -2050,17 +3172,21 @@ namespace {
 	_StoreImageData
 =================================================
 */
-	bool  VCommandBuffer::_StoreImageData (ArrayView<uint8_t> srcData, const BytesU srcOffset, const BytesU srcPitch, const BytesU srcTotalSize,
+	bool  VCommandBuffer::_StoreImageData (const UpdateImage &task, const BytesU srcBase, const BytesU srcSize, const BytesU srcOffset,
+										   const BytesU srcPitch, const BytesU srcTotalSize,
 										   OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
 	{
 		// skip blocks less than 1/N of total data size
-		const BytesU	src_size	= ArraySizeOf(srcData);
 		const BytesU	min_size	= Max( (srcTotalSize + MaxImageParts-1) / MaxImageParts, srcPitch );
 		void *			ptr			= null;
 
-		if ( _batch->GetWritable( src_size - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
+		if ( _batch->GetWritable( srcSize - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
 		{
-			MemCopy( ptr, size, srcData.data() + srcOffset, size );
+			// write directly to the staging memory without intermediate copy
+			if ( task.writer )
+				task.writer( ptr, srcBase + srcOffset, size );
+			else
+				MemCopy( ptr, size, task.data.data() + size_t(srcBase + srcOffset), size );
 			return true;
 		}
 		return false;
@@ -6,6 +6,7 @@
 #include "VTaskGraph.h"
 #include "VBarrierManager.h"
 #include "VTaskProcessor.h"
+#include "VBarrierOptimizer.h"
 #include "VPipelineCache.h"
 #include "VDescriptorManager.h"
 #include "VCmdBatch.h"
@@ -29,7 +30,6 @@ namespace FG
 			Compiling,
 		};
 
-		using TempTaskArray_t	= std::vector< VTask, StdLinearAllocator<VTask> >;
 		using TaskGraph_t		= VTaskGraph< VTaskProcessor >;
 		using Allocator_t		= LinearAllocator<>;
 		using Statistic_t		= IFrameGraph::Statistics;
@@ -42,8 +42,19 @@ namespace FG
 		static constexpr auto	MaxBufferParts	= VCmdBatch::MaxBufferParts;
 		static constexpr auto	MaxImageParts	= VCmdBatch::MaxImageParts;
 		static constexpr auto	MinBufferPart	= 4_Kb;
+		static constexpr size_t	MinRemapTableSize	= 1024;	// initial size of the global to local index table
+
+		using CmdPool_t			= VCommandPoolManager::Pool;
+		using SecondaryPools_t	= StaticArray< CmdPool_t *, FG_MaxSecondaryCmdBuffers >;
+		using ResourceUsage_t	= VTaskProcessor::ResourceUsage;
+
+		struct TaskUsage
+		{
+			uint			first		= 0;		// index in '_resUsage.usages'
+			uint			count		= 0;
+			void const*		pipeline	= null;		// pipeline that will be bound by the task, used for reordering
+		};
 
-		using PerQueueArray_t	= FixedArray< VCommandPool, 4 >;
 		
 		using Index_t			= VResourceManager::Index_t;
 		
@@ -52,10 +63,12 @@ namespace FG
 		
 		template <typename Res, typename MainPool, size_t MC>
 		struct LocalResPool {
-			PoolTmpl< Res, MainPool::capacity()/MC, MC >		pool;
-			StaticArray< Index_t, MainPool::capacity() >		toLocal;
-			uint												maxLocalIndex	= 0;
-			uint												maxGlobalIndex	= uint(MainPool::capacity());
+			static constexpr size_t	ChunkSize = size_t(1) << (CT_IntLog2< MainPool::MaxCapacity()/MC - 1 > + 1);	// must be power of 2
+
+			PoolTmpl< Res, ChunkSize, MC >		pool;
+			Array< Index_t >					toLocal;			// grows on demand up to the actual main pool capacity
+			uint								maxLocalIndex	= 0;
+			uint								maxGlobalIndex	= 0;
 		};
 
 		using LocalImages_t			= LocalResPool< VLocalImage,		VResourceManager::ImagePool_t,		16 >;
@@ -63,6 +76,14 @@ namespace FG
 		using LocalRTScenes_t		= LocalResPool< VLocalRTScene,		VResourceManager::RTScenePool_t,	16 >;
 		using LocalRTGeometries_t	= LocalResPool< VLocalRTGeometry,	VResourceManager::RTGeometryPool_t,	16 >;
 		using LogicalRenderPasses_t	= PoolTmpl< VLogicalRenderPass,		1u<<10,								16 >;
+
+		struct TransientResource
+		{
+			RawImageID				image;
+			RawBufferID				buffer;
+			VkMemoryRequirements	memReq		= {};
+			bool					preferLazy	= false;	// image may use lazily allocated memory
+		};
 		
 
 
@@ -78,6 +99,7 @@ namespace FG
 		const uint				_indexInPool;		// index in VFrameGraph::_cmdBufferPool
 		VBarrierManager			_barrierMngr;
 		VPipelineCache			_pipelineCache;
+		uint					_pipelineCacheVersion	= 0;	// version of global pipeline cache
 		Debugger_t				_debugger;
 
 		struct {
@@ -86,7 +108,7 @@ namespace FG
 		}						_shaderDbg;
 
 		struct {
-			ResourceMap_t			resourceMap;
+			InPlace<ResourceMap_t>	resourceMap;
 			LocalImages_t			images;
 			LocalBuffers_t			buffers;
 
@@ -97,11 +119,39 @@ namespace FG
 			
 			LogicalRenderPasses_t	logicalRenderPasses;
 			uint					logicalRenderPassCount	= 0;
+
+			Array<VPipelineResources const*>	pendingDescriptorSets;	// updated in 'Execute' in single batch
 		}						_rm;
+
+		struct {
+			Array<TransientResource>	resources;
+			Array<uint>					pending;	// resources used by the task that is currently being added
+			Array<Pair<VTask, uint>>	taskUses;
+			Array<Pair<uint, uint>>		passUses;	// logical pass index and resource index, moved to 'taskUses' when pass is submitted
+			Array<ExeOrderIndex>		barriers;	// tasks that require aliasing barrier, sorted
+		}						_transient;
+
+		struct {
+			Array<ResourceUsage_t>		usages;
+			HashMap<VTask, TaskUsage>	taskUsages;		// task without usages can't be optimized or reordered
+			bool						optimizeBarriers	= false;
+			bool						reorderTasks		= false;
+			bool						reorderStatistic	= false;	// see 'EDebugFlags::ReorderStatistic'
+		}						_resUsage;
+
+		struct {
+			Array<VFgTask<SubmitRenderPass>*>	tasks;		// all submitted render passes, merged in 'Execute'
+			bool								enabled		= false;
+		}						_subpassMerge;
 		
-		PerQueueArray_t			_perQueue;		// TODO: use global command pool manager to minimize memory usage
+		struct {
+			CmdPool_t *				primary		= null;
+			SecondaryPools_t		secondary	{};		// one pool per recording thread
+			VDeviceQueueInfoPtr		queue;
+		}						_cmdPools;		// acquired from the global manager, owned by the batch
 		bool					_dbgFullBarriers	= false;
 		bool					_dbgQueueSync		= false;
+		EPipelineMissPolicy		_pipelineMissPolicy	= EPipelineMissPolicy::Block;
 
 		DataRaceCheck			_drCheck;
 
@@ -127,6 +177,9 @@ namespace FG
 		void		AcquireImage (RawImageID id, bool makeMutable, bool invalidate) override;
 		void		AcquireBuffer (RawBufferID id, bool makeMutable) override;
 
+		RawImageID	CreateTransientImage (const ImageDesc &desc, StringView dbgName) override;
+		RawBufferID	CreateTransientBuffer (const BufferDesc &desc, StringView dbgName) override;
+
 
 		// tasks //
 		Task		AddTask (const SubmitRenderPass &) override;
@@ -146,6 +199,8 @@ namespace FG
 		Task		AddTask (const UpdateImage &) override;
 		Task		AddTask (const ReadBuffer &) override;
 		Task		AddTask (const ReadImage &) override;
+		Task		AddTask (const ReadBuffer &, OUT ReadbackFuture &) override;
+		Task		AddTask (const ReadImage &, OUT ReadbackFuture &) override;
 		Task		AddTask (const Present &) override;
 		Task		AddTask (const UpdateRayTracingShaderTable &) override;
 		Task		AddTask (const BuildRayTracingGeometry &) override;
@@ -186,6 +241,11 @@ namespace FG
 		ND_ VLocalRTScene const*	ToLocal (RawRTSceneID id);
 		ND_ VPipelineResources const* CreateDescriptorSet (const PipelineResources &desc);
 
+			void					AttachTransientResources (VTask task);
+
+		template <typename T>
+			void					AddResourceUsage (VFgTask<T> *task);
+
 		
 		ND_ StringView				GetName ()					const	{ EXLOCK( _drCheck );  return _batch->GetName(); }
 		ND_ VCmdBatch &				GetBatch ()					const	{ EXLOCK( _drCheck );  return *_batch; }
@@ -193,6 +253,7 @@ namespace FG
 		ND_ Allocator_t &			GetAllocator ()						{ EXLOCK( _drCheck );  return _mainAllocator; }
 		ND_ Statistic_t &			EditStatistic ()					{ EXLOCK( _drCheck );  return _batch->_statistic; }
 		ND_ VPipelineCache &		GetPipelineCache ()					{ EXLOCK( _drCheck );  return _pipelineCache; }
+		ND_ VCommandPool *			GetSecondaryPool (uint index);
 		ND_ VBarrierManager &		GetBarrierManager ()				{ EXLOCK( _drCheck );  return _barrierMngr; }
 		ND_ Ptr<VLocalDebugger>		GetDebugger ()						{ EXLOCK( _drCheck );  return _debugger.get(); }
 		ND_ VDevice const&			GetDevice ()				const	{ return _instance.GetDevice(); }
@@ -203,6 +264,7 @@ namespace FG
 		ND_ EQueueFamily			GetQueueFamily ()			const	{ EXLOCK( _drCheck );  return _queueIndex; }
 		ND_ bool					IsDebugFullBarriers ()		const	{ EXLOCK( _drCheck );  return _dbgFullBarriers; }
 		ND_ bool					IsDebugQueueSync ()			const	{ EXLOCK( _drCheck );  return _dbgQueueSync; }
+		ND_ EPipelineMissPolicy		GetPipelineMissPolicy ()	const	{ EXLOCK( _drCheck );  return _pipelineMissPolicy; }
 
 
 	private:
@@ -210,20 +272,22 @@ namespace FG
 		template <typename T>
 		bool  _AllocStorage (size_t count, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset, OUT T* &ptr);
 		bool  _StoreData (const void *dataPtr, BytesU dataSize, BytesU offsetAlign, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset);
-		bool  _StorePartialData (ArrayView<uint8_t> srcData, BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
-		bool  _StoreImageData (ArrayView<uint8_t> srcData, BytesU srcOffset, BytesU srcPitch, BytesU srcTotalSize,
+		bool  _StorePartialData (const UpdateBuffer::Region &srcData, BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
+		bool  _StoreImageData (const UpdateImage &task, BytesU srcBase, BytesU srcSize, BytesU srcOffset, BytesU srcPitch, BytesU srcTotalSize,
 							   OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
 		
 		ND_ Task  _AddUpdateBufferTask (const UpdateBuffer &);
 		ND_ Task  _AddUpdateImageTask (const UpdateImage &);
-		ND_ Task  _AddReadBufferTask (const ReadBuffer &);
-		ND_ Task  _AddReadImageTask (const ReadImage &);
+		ND_ Task  _AddReadBufferTask (const ReadBuffer &, OUT ReadbackFuture *);
+		ND_ Task  _AddReadImageTask (const ReadImage &, OUT ReadbackFuture *);
 
 
 	// task processor //
 		bool  _BuildCommandBuffers ();
 		bool  _ProcessTasks (VkCommandBuffer cmd);
+		bool  _ProcessTasksWithBarrierOptimization (VkCommandBuffer cmd);
 		void  _AfterCompilation ();
+		void  _FlushDescriptorUpdates ();
 		
 
 	// resource manager //
@@ -234,6 +298,49 @@ namespace FG
 		void  _ResetLocalRemaping ();
 
 
+	// transient resources //
+		template <typename ID>
+		void  _OnTransientUse (ID id);
+		void  _AttachTransientResources (LogicalPassID passId);
+		void  _AttachTransientResources (VTask task, LogicalPassID passId);
+		bool  _AllocateTransientMemory ();
+		void  _DiscardTransientStates ();
+		void  _ResetTransientResources ();
+
+
+	// barrier optimization //
+		template <typename T>
+		ND_ bool  _GatherResourceUsage (const VFgTask<T> &)		{ return false; }
+		ND_ bool  _GatherResourceUsage (const VFgTask<DispatchCompute> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<DispatchComputeIndirect> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<CopyBuffer> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<CopyImage> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<CopyBufferToImage> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<CopyImageToBuffer> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<BlitImage> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<ResolveImage> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<FillBuffer> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<ClearColorImage> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<ClearDepthStencilImage> &);
+		ND_ bool  _GatherResourceUsage (const VFgTask<UpdateBuffer> &);
+			void  _GatherResourceUsage (const VPipelineResourceSet &);
+
+		template <typename T>
+		ND_ static void const*  _GetTaskPipeline (const VFgTask<T> &)								{ return null; }
+		ND_ static void const*  _GetTaskPipeline (const VFgTask<DispatchCompute> &task)			{ return task.pipeline; }
+		ND_ static void const*  _GetTaskPipeline (const VFgTask<DispatchComputeIndirect> &task)	{ return task.pipeline; }
+
+
+	// task reordering //
+		template <typename FnT>
+		ND_ bool  _ScheduleTasks (FnT &&fn);
+			void  _UpdateReorderStatistic ();
+
+
+	// render pass merging //
+			void  _MergeRenderPasses ();
+
+
 	// queue //
 		ND_ EQueueUsage	_GetQueueUsage ()	const	{ return EQueueUsage(0) | _batch->GetQueueType(); }
 		ND_ bool		_IsRecording ()		const	{ return _state == EState::Recording; }
@@ -248,7 +355,7 @@ namespace FG
 	template <uint UID>
 	inline auto const*  VCommandBuffer::AcquireTemporary (_fg_hidden_::ResourceID<UID> id)
 	{
-		auto[iter, inserted] = _rm.resourceMap.insert({ Resource_t{ id }, 1 });
+		auto[iter, inserted] = _rm.resourceMap->insert({ Resource_t{ id }, 1 });
 
 		return _instance.GetResourceManager().GetResource( id, inserted );
 	}
@@ -261,9 +368,49 @@ namespace FG
 	template <uint UID>
 	inline void  VCommandBuffer::ReleaseResource (_fg_hidden_::ResourceID<UID> id)
 	{
-		_rm.resourceMap.insert({ Resource_t{ id }, 0 }).first->second++;
+		_rm.resourceMap->insert({ Resource_t{ id }, 0 }).first->second++;
+	}
+	
+/*
+=================================================
+	AttachTransientResources
+----
+	binds transient resources that was used in task constructor to the task.
+=================================================
+*/
+	inline void  VCommandBuffer::AttachTransientResources (VTask task)
+	{
+		if_likely( _transient.pending.empty() )
+			return;
+
+		for (uint idx : _transient.pending) {
+			_transient.taskUses.emplace_back( task, idx );
+		}
+		_transient.pending.clear();
 	}
 	
+/*
+=================================================
+	AddResourceUsage
+----
+	stores resources and pipeline that are used by the task,
+	tasks that are not supported by barrier optimizer and task reordering are skipped.
+=================================================
+*/
+	template <typename T>
+	inline void  VCommandBuffer::AddResourceUsage (VFgTask<T> *task)
+	{
+		if_likely( not (_resUsage.optimizeBarriers or _resUsage.reorderTasks) )
+			return;
+
+		const uint	first = uint(_resUsage.usages.size());
+
+		if ( _GatherResourceUsage( *task ))
+			_resUsage.taskUsages.insert_or_assign( task, TaskUsage{ first, uint(_resUsage.usages.size()) - first, _GetTaskPipeline( *task )});
+		else
+			_resUsage.usages.resize( first );
+	}
+
 /*
 =================================================
 	CreateDescriptorSet
@@ -271,7 +418,9 @@ namespace FG
 */
 	inline VPipelineResources const*  VCommandBuffer::CreateDescriptorSet (const PipelineResources &desc)
 	{
-		return GetResourceManager().CreateDescriptorSet( desc, INOUT _rm.resourceMap );
+		// descriptor sets created while recording are updated together before compilation
+		return GetResourceManager().CreateDescriptorSet( desc, INOUT *_rm.resourceMap,
+														 (_state == EState::Recording ? &_rm.pendingDescriptorSets : null) );
 	}
 
 
@@ -22,7 +22,7 @@ namespace FG
 	Create
 =================================================
 */
-	bool VCommandPool::Create (const VDevice &dev, VDeviceQueueInfoPtr queue, StringView dbgName)
+	bool VCommandPool::Create (const VDevice &dev, VDeviceQueueInfoPtr queue, StringView dbgName, VkCommandPoolCreateFlags flags)
 	{
 		CHECK_ERR( queue );
 		EXLOCK( _drCheck );
@@ -30,7 +30,7 @@ namespace FG
 
 		VkCommandPoolCreateInfo	info = {};
 		info.sType				= VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		info.flags				= VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		info.flags				= flags;
 		info.queueFamilyIndex	= uint(queue->familyIndex);
 
 		VK_CHECK( dev.vkCreateCommandPool( dev.GetVkDevice(), &info, null, OUT &_pool ));
@@ -15,7 +15,8 @@ namespace FG
 	{
 	// types
 	private:
-		using CmdBufPool_t	= FixedArray< VkCommandBuffer, 32 >;
+		using CmdBufPool_t		= FixedArray< VkCommandBuffer, 32 >;
+		using SecondaryPool_t	= Array< VkCommandBuffer >;
 
 
 	// variables
@@ -24,7 +25,7 @@ namespace FG
 
 		mutable Mutex			_cmdGuard;
 		mutable CmdBufPool_t	_freePrimaries;
-		mutable CmdBufPool_t	_freeSecondaries;
+		mutable SecondaryPool_t	_freeSecondaries;
 		
 		RWDataRaceCheck			_drCheck;
 
@@ -38,7 +39,8 @@ namespace FG
 		VCommandPool () {}
 		~VCommandPool ();
 
-		bool Create (const VDevice &dev, VDeviceQueueInfoPtr queue, StringView dbgName = Default);
+		bool Create (const VDevice &dev, VDeviceQueueInfoPtr queue, StringView dbgName = Default,
+					 VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
 		void Destroy (const VDevice &dev);
 		
 		ND_ VkCommandBuffer	AllocPrimary (const VDevice &dev);
@@ -0,0 +1,165 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VCommandPoolManager.h"
+#include "VDevice.h"
+#include "stl/Algorithms/StringUtils.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	VCommandPoolManager::VCommandPoolManager (const VDevice &dev) :
+		_device{ dev }
+	{}
+	
+/*
+=================================================
+	destructor
+=================================================
+*/
+	VCommandPoolManager::~VCommandPoolManager ()
+	{
+		CHECK( _pools.empty() );
+	}
+	
+/*
+=================================================
+	Deinitialize
+=================================================
+*/
+	void  VCommandPoolManager::Deinitialize ()
+	{
+		EXLOCK( _guard );
+
+		for (auto& pool : _pools)
+		{
+			CHECK( not pool->_inUse );
+			pool->Destroy( _device );
+		}
+		_pools.clear();
+
+		for (auto& f : _families)
+		{
+			if ( f.created )
+				FG_LOGD( "Max command pools for queue family "s << ToString( size_t(&f - _families.data()) ) << ": " << ToString( f.created ));
+
+			f = Default;
+		}
+	}
+
+/*
+=================================================
+	Acquire
+----
+	returns free pool, pool must be released by the batch when it is complete.
+=================================================
+*/
+	VCommandPoolManager::Pool*  VCommandPoolManager::Acquire (VDeviceQueueInfoPtr queue)
+	{
+		CHECK_ERR( queue );
+
+		const uint	family = uint(queue->familyIndex);
+		CHECK_ERR( family < _families.size() );
+
+		Pool*	result = null;
+		{
+			EXLOCK( _guard );
+			auto&	f = _families[family];
+
+			if ( f.freePools.size() )
+			{
+				result = f.freePools.back();
+				f.freePools.pop_back();
+			}
+			else
+			{
+				_pools.push_back( UniquePtr<Pool>{ new Pool{} });
+				result = _pools.back().get();
+				result->_family = family;
+				++f.created;
+			}
+
+			ASSERT( not result->_inUse );
+			result->_inUse = true;
+		}
+
+		if ( not result->IsCreated() )
+		{
+			// pool is reset only when all command buffers are complete
+			CHECK_ERR( result->Create( _device, queue, Default, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT ));
+		}
+
+		return result;
+	}
+	
+/*
+=================================================
+	Release
+----
+	all command buffers must be recycled before,
+	they are all reset to initial state and can be reused.
+=================================================
+*/
+	void  VCommandPoolManager::Release (Pool *pool)
+	{
+		CHECK_ERRV( pool );
+
+		size_t	free_count;
+		{
+			EXLOCK( _guard );
+			CHECK_ERRV( pool->_inUse );
+
+			pool->_inUse	= false;
+			free_count		= _families[ pool->_family ].freePools.size();
+		}
+
+		// too many free pools, destroy it
+		if ( free_count >= MaxFreePools )
+		{
+			_Destroy( pool );
+			return;
+		}
+
+		// release memory if there are many free pools
+		if ( free_count >= TrimThreshold )
+		{
+			pool->ResetAll( _device, VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT );
+
+			if ( _device.GetFeatures().commandPoolTrim )
+				pool->TrimAll( _device, 0 );
+		}
+		else
+			pool->ResetAll( _device, 0 );
+
+		EXLOCK( _guard );
+		_families[ pool->_family ].freePools.push_back( pool );
+	}
+	
+/*
+=================================================
+	_Destroy
+=================================================
+*/
+	void  VCommandPoolManager::_Destroy (Pool *pool)
+	{
+		pool->Destroy( _device );
+
+		EXLOCK( _guard );
+
+		for (auto iter = _pools.begin(); iter != _pools.end(); ++iter)
+		{
+			if ( iter->get() == pool )
+			{
+				_pools.erase( iter );
+				return;
+			}
+		}
+		ASSERT( false );
+	}
+
+
+}	// FG
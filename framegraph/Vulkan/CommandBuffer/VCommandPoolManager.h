@@ -0,0 +1,71 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Shared command pools for all command buffers.
+	Pool is exclusively acquired by recording thread and then owned by the batch,
+	when all batches that use the pool are complete the pool is reset with single 'vkResetCommandPool' call
+	and returned to the per queue family list of free pools.
+	Free pools are trimmed when there are too many of them.
+*/
+
+#pragma once
+
+#include "VCommandPool.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Command Pool Manager
+	//
+
+	class VCommandPoolManager final
+	{
+	// types
+	public:
+		class Pool final : public VCommandPool
+		{
+			friend class VCommandPoolManager;
+		private:
+			bool			_inUse		= false;	// protected by manager '_guard'
+			uint			_family		= UMax;
+		};
+
+	private:
+		static constexpr uint	MaxQueueFamilies	= 8;
+		static constexpr uint	TrimThreshold		= 8;	// number of free pools per queue family when memory of reset pool is released
+		static constexpr uint	MaxFreePools		= 16;	// number of free pools per queue family when new free pool is destroyed
+
+		struct PerFamily
+		{
+			Array< Pool *>		freePools;
+			uint				created		= 0;
+		};
+		using Families_t	= StaticArray< PerFamily, MaxQueueFamilies >;
+		using Pools_t		= Array< UniquePtr<Pool> >;
+
+
+	// variables
+	private:
+		VDevice const&		_device;
+
+		Mutex				_guard;
+		Families_t			_families;
+		Pools_t				_pools;
+
+
+	// methods
+	public:
+		explicit VCommandPoolManager (const VDevice &dev);
+		~VCommandPoolManager ();
+
+		void  Deinitialize ();
+
+		ND_ Pool*  Acquire (VDeviceQueueInfoPtr queue);
+			void   Release (Pool *pool);
+
+	private:
+		void  _Destroy (Pool *pool);
+	};
+
+
+}	// FG
@@ -22,16 +22,27 @@ namespace FG
 	public:
 		using Name_t			= _fg_hidden_::TaskName_t;
 		using ProcessFunc_t		= void (*) (void *visitor, void *taskData);
+
+		struct SortInfo
+		{
+			void const*		pipeline	= null;
+			HashVal			resources;			// hash of descriptor sets
+			uint16_t		depth		= 0;
+			uint8_t			layer		= 0;
+		};
 		
 
 	// variables
 	private:
-		ProcessFunc_t		_pass1			= null;
-		ProcessFunc_t		_pass2			= null;
-		Name_t				_taskName;
-		RGBA8u				_debugColor;
+		ProcessFunc_t				_pass1			= null;
+		ProcessFunc_t				_pass2			= null;
+		Name_t						_taskName;
+		RGBA8u						_debugColor;
+	protected:
+		SortInfo					_sortInfo;					// used by 'VLogicalRenderPass' to sort draw tasks
+		VPipelineResourceSet const*	_resourceSet	= null;		// used by 'VCommandBuffer' to merge render passes, 'null' for custom draw task
 	public:
-		ShaderDbgIndex		debugModeIndex	= Default;
+		ShaderDbgIndex				debugModeIndex	= Default;
 
 
 	// interface
@@ -41,8 +52,10 @@ namespace FG
 			_pass1{pass1}, _pass2{pass2}, _taskName{task.taskName}, _debugColor{task.debugColor} {}
 
 	public:
-		ND_ StringView	GetName ()			const	{ return _taskName; }
-		ND_ RGBA8u		GetDebugColor ()	const	{ return _debugColor; }
+		ND_ StringView						GetName ()			const	{ return _taskName; }
+		ND_ RGBA8u							GetDebugColor ()	const	{ return _debugColor; }
+		ND_ SortInfo const&					GetSortInfo ()		const	{ return _sortInfo; }
+		ND_ VPipelineResourceSet const*		GetResourceSet ()	const	{ return _resourceSet; }
 		
 		void Process1 (void *visitor)				{ ASSERT( _pass1 );  _pass1( visitor, this ); }
 		void Process2 (void *visitor)				{ ASSERT( _pass2 );  _pass2( visitor, this ); }
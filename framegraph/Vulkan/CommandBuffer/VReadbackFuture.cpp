@@ -0,0 +1,152 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VReadbackFuture.h"
+#include "VFrameGraph.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	VReadbackFuture::VReadbackFuture (VFrameGraph &fg, const CommandBuffer &cmd) :
+		_frameGraph{ fg },
+		_cmdBuffer{ (ICommandBuffer*)(null), cmd.GetBatch() },
+		_isImage{ false }
+	{}
+
+	VReadbackFuture::VReadbackFuture (VFrameGraph &fg, const CommandBuffer &cmd, const uint3 &imageSize, BytesU rowPitch,
+									  BytesU slicePitch, EPixelFormat format, EImageAspect aspect) :
+		_frameGraph{ fg },
+		_cmdBuffer{ (ICommandBuffer*)(null), cmd.GetBatch() },
+		_isImage{ true }
+	{
+		_image.size			= imageSize;
+		_image.rowPitch		= rowPitch;
+		_image.slicePitch	= slicePitch;
+		_image.format		= format;
+		_image.aspect		= aspect;
+	}
+
+/*
+=================================================
+	SetData
+=================================================
+*/
+	void  VReadbackFuture::SetData (ArrayView<ArrayView<T>> parts, MemoryRefs_t &&memory)
+	{
+		{
+			std::unique_lock	lock{ _guard };
+			ASSERT( not _ready.load( memory_order_relaxed ));
+
+			_parts.assign( parts.begin(), parts.end() );
+			_memory = std::move(memory);
+
+			_ready.store( true, memory_order_release );
+		}
+		_cv.notify_all();
+	}
+
+/*
+=================================================
+	IsReady
+=================================================
+*/
+	bool  VReadbackFuture::IsReady () const
+	{
+		if ( not _ready.load( memory_order_acquire ))
+			return false;
+
+		// batch is not needed anymore, allow to reuse it
+		std::unique_lock	lock{ _guard };
+		_cmdBuffer = null;
+		return true;
+	}
+
+/*
+=================================================
+	Wait
+----
+	batch may be completed in 'IFrameGraph::Wait' or in another thread,
+	so wait for fence and then wait until the data is set.
+=================================================
+*/
+	bool  VReadbackFuture::Wait (Nanoseconds timeout)
+	{
+		using Clock_t = std::chrono::high_resolution_clock;
+
+		const auto	start_time	= Clock_t::now();
+		const auto	TimeLeft	= [&] () -> Nanoseconds {
+									const auto	dt = std::chrono::duration_cast<Nanoseconds>( Clock_t::now() - start_time );
+									return dt < timeout ? timeout - dt : Nanoseconds{0};
+								};
+
+		for (;;)
+		{
+			CommandBuffer	cmd;
+			{
+				std::unique_lock	lock{ _guard };
+
+				if ( _ready.load( memory_order_relaxed ))
+				{
+					_cmdBuffer = null;
+					return true;
+				}
+				cmd = _cmdBuffer;
+			}
+
+			// batch may be not submitted yet
+			auto*	batch = Cast<VCmdBatch>( cmd.GetBatch() );
+			CHECK_ERR( batch );
+
+			const auto	state = batch->GetState();
+			if ( state == VCmdBatch::EState::Initial or state == VCmdBatch::EState::Recording )
+				return false;
+
+			if ( state < VCmdBatch::EState::Submitted )
+				_frameGraph.Flush( EQueueUsage::All );
+
+			if ( not _frameGraph.Wait( {cmd}, TimeLeft() ))
+				return false;
+
+			// 'Wait' returns immediately if batch is waiting for dependencies, so limit sleep time
+			{
+				std::unique_lock	lock{ _guard };
+				_cv.wait_for( lock, Min( TimeLeft(), Nanoseconds{1'000'000} ), [this] () { return _ready.load( memory_order_relaxed ); });
+			}
+
+			if ( TimeLeft() == Nanoseconds{0} )
+				return IsReady();
+		}
+	}
+
+/*
+=================================================
+	GetBuffer
+=================================================
+*/
+	BufferView  VReadbackFuture::GetBuffer () const
+	{
+		if ( _isImage or not _ready.load( memory_order_acquire ))
+			return Default;
+
+		return BufferView{ _parts };
+	}
+
+/*
+=================================================
+	GetImage
+=================================================
+*/
+	ImageView  VReadbackFuture::GetImage () const
+	{
+		if ( not _isImage or not _ready.load( memory_order_acquire ))
+			return Default;
+
+		return ImageView{ _parts, _image.size, _image.rowPitch, _image.slicePitch, _image.format, _image.aspect };
+	}
+
+
+}	// FG
@@ -0,0 +1,92 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#pragma once
+
+#include "framegraph/Public/ReadbackFuture.h"
+#include "framegraph/Public/CommandBuffer.h"
+#include "VStagingBufferManager.h"
+#include <condition_variable>
+
+namespace FG
+{
+
+	//
+	// Vulkan Readback Memory
+	//
+
+	class VReadbackMemory final
+	{
+	// variables
+	private:
+		VStagingBufferManager &		_stagingMngr;
+		const RawBufferID			_bufferId;
+		const BytesU				_size;
+		const StagingBufferIdx		_index;
+
+	// methods
+	public:
+		VReadbackMemory (VStagingBufferManager &sm, RawBufferID buf, BytesU size, StagingBufferIdx idx) :
+			_stagingMngr{sm}, _bufferId{buf}, _size{size}, _index{idx} {}
+
+		~VReadbackMemory ()		{ _stagingMngr.Release( _index, _bufferId, _size ); }
+	};
+
+
+
+	//
+	// Vulkan Readback Future
+	//
+
+	class VReadbackFuture final : public IReadbackFuture
+	{
+	// types
+	public:
+		static constexpr uint	MaxParts	= 4;
+
+		using T				= BufferView::value_type;
+		using DataParts_t	= FixedArray< ArrayView<T>, MaxParts >;
+		using MemoryRefs_t	= FixedArray< SharedPtr<VReadbackMemory>, MaxParts >;
+
+	private:
+		struct ImageInfo
+		{
+			uint3			size;
+			BytesU			rowPitch;
+			BytesU			slicePitch;
+			EPixelFormat	format		= Default;
+			EImageAspect	aspect		= Default;
+		};
+
+
+	// variables
+	private:
+		class VFrameGraph &				_frameGraph;
+
+		mutable Mutex					_guard;
+		std::condition_variable			_cv;
+		Atomic<bool>					_ready		{false};
+		mutable CommandBuffer			_cmdBuffer;		// keeps batch alive until data is available, used to wait for fence
+
+		DataParts_t						_parts;
+		MemoryRefs_t					_memory;
+		ImageInfo						_image;
+		const bool						_isImage;
+
+
+	// methods
+	public:
+		VReadbackFuture (VFrameGraph &fg, const CommandBuffer &cmd);
+		VReadbackFuture (VFrameGraph &fg, const CommandBuffer &cmd, const uint3 &imageSize, BytesU rowPitch,
+						 BytesU slicePitch, EPixelFormat format, EImageAspect aspect);
+
+		// called by command batch when data is read into the staging memory
+		void  SetData (ArrayView<ArrayView<T>> parts, MemoryRefs_t &&memory);
+
+		bool		IsReady () const override;
+		bool		Wait (Nanoseconds timeout) override;
+		BufferView	GetBuffer () const override;
+		ImageView	GetImage () const override;
+	};
+
+
+}	// FG
@@ -15,6 +15,8 @@ namespace FG
 	VSubmitted::VSubmitted (uint indexInPool) :
 		_indexInPool{ indexInPool },
 		_fence{ VK_NULL_HANDLE },
+		_timeline{ VK_NULL_HANDLE },
+		_timelineValue{ 0 },
 		_queueType{ Default }
 	{
 	}
@@ -34,12 +36,29 @@ namespace FG
 /*
 =================================================
 	Initialize
+----
+	if timeline semaphore is used then fence is not needed,
+	completion is checked by semaphore counter value.
 =================================================
 */
-	void  VSubmitted::Initialize (const VDevice &dev, EQueueType queue, ArrayView<VCmdBatchPtr> batches, ArrayView<VkSemaphore> semaphores)
+	void  VSubmitted::Initialize (const VDevice &dev, EQueueType queue, ArrayView<VCmdBatchPtr> batches, ArrayView<VkSemaphore> semaphores,
+								  VkSemaphore timeline, uint64_t timelineValue)
 	{
 		EXLOCK( _drCheck );
 
+		_timeline		= timeline;
+		_timelineValue	= timelineValue;
+
+		if ( _timeline )
+		{
+			ASSERT( _timelineValue > 0 );
+
+			if ( _fence ) {
+				dev.vkDestroyFence( dev.GetVkDevice(), _fence, null );
+				_fence = VK_NULL_HANDLE;
+			}
+		}
+		else
 		if ( not _fence )
 		{
 			VkFenceCreateInfo	info = {};
@@ -55,6 +74,30 @@ namespace FG
 		_queueType	= queue;
 	}
 
+/*
+=================================================
+	IsComplete
+=================================================
+*/
+	bool  VSubmitted::IsComplete (const VDevice &dev) const
+	{
+		EXLOCK( _drCheck );
+
+		#ifdef VK_KHR_timeline_semaphore
+		if ( _timeline )
+		{
+			uint64_t	value = 0;
+			VK_CHECK( dev.vkGetSemaphoreCounterValueKHR( dev.GetVkDevice(), _timeline, OUT &value ));
+			return value >= _timelineValue;
+		}
+		#endif
+
+		if ( _fence )
+			return dev.vkGetFenceStatus( dev.GetVkDevice(), _fence ) == VK_SUCCESS;
+
+		return true;
+	}
+
 /*
 =================================================
 	Release
@@ -29,6 +29,8 @@ namespace FG
 		Batches_t			_batches;
 		Semaphores_t		_semaphores;
 		VkFence				_fence;
+		VkSemaphore			_timeline;			// per queue timeline semaphore, used instead of fence
+		uint64_t			_timelineValue;		// value that is signaled when all batches complete
 		EQueueType			_queueType;
 
 		DataRaceCheck		_drCheck;
@@ -40,11 +42,15 @@ namespace FG
 		~VSubmitted ();
 
 		// called by VFrameGraph
-		void  Initialize (const VDevice &, EQueueType queue, ArrayView<VCmdBatchPtr>, ArrayView<VkSemaphore>);
+		void  Initialize (const VDevice &, EQueueType queue, ArrayView<VCmdBatchPtr>, ArrayView<VkSemaphore>, VkSemaphore timeline, uint64_t timelineValue);
 		void  Release (const VDevice &, VDebugger &, const IFrameGraph::ShaderDebugCallback_t &, INOUT Statistic_t &);
 		void  Destroy (const VDevice &);
 
+		ND_ bool		IsComplete (const VDevice &) const;
+
 		ND_ VkFence		GetFence ()			const	{ EXLOCK( _drCheck );  return _fence; }
+		ND_ VkSemaphore	GetTimeline ()		const	{ EXLOCK( _drCheck );  return _timeline; }
+		ND_ uint64_t	GetTimelineValue ()	const	{ EXLOCK( _drCheck );  return _timelineValue; }
 		ND_ EQueueType	GetQueueType ()		const	{ EXLOCK( _drCheck );  return _queueType; }
 		ND_ uint		GetIndexInPool ()	const	{ return _indexInPool; }
 	};
@@ -5,6 +5,7 @@
 #include "framegraph/Public/FrameGraph.h"
 #include "framegraph/Shared/EnumUtils.h"
 #include "VCommon.h"
+#include "stl/Containers/FlatHashMap.h"
 
 namespace FG
 {
@@ -34,7 +35,7 @@ namespace FG
 		Dependencies_t		_outputs;
 		Name_t				_taskName;
 		RGBA8u				_debugColor;
-		uint				_visitorID		= 0;
+		uint				_inDegree		= 0;		// number of unprocessed inputs, used by scheduler
 		ExeOrderIndex		_exeOrderIdx	= ExeOrderIndex::Initial;
 
 
@@ -54,6 +55,7 @@ namespace FG
 			for (size_t i = 0; i < task.depends.size(); ++i) {
 				_inputs[i] = Cast<VFrameGraphTask>( task.depends[i] );
 			}
+			_inDegree = uint(_inputs.size());
 
 			// validate dependencies
 			DEBUG_ONLY(
@@ -67,16 +69,17 @@ namespace FG
 	public:
 		ND_ StringView			Name ()				const	{ return _taskName; }
 		ND_ RGBA8u				DebugColor ()		const	{ return _debugColor; }
-		ND_ uint				VisitorID ()		const	{ return _visitorID; }
 		ND_ ExeOrderIndex		ExecutionOrder ()	const	{ return _exeOrderIdx; }
 
 		ND_ ArrayView< VTask >	Inputs ()			const	{ return _inputs; }
 		ND_ ArrayView< VTask >	Outputs ()			const	{ return _outputs; }
 
 			void Attach (VTask output)						{ _outputs.push_back( output ); }
-			void SetVisitorID (uint id)						{ _visitorID = id; }
 			void SetExecutionOrder (ExeOrderIndex idx)		{ _exeOrderIdx = idx; }
 
+		ND_ bool ReleaseInput ()							{ ASSERT( _inDegree > 0 );  return (--_inDegree == 0); }
+			void ResetInDegree ()							{ _inDegree = uint(_inputs.size()); }
+
 			void Process (void *visitor)			const	{ ASSERT( _processFunc );  _processFunc( visitor, this ); }
 	};
 
@@ -112,6 +115,8 @@ namespace FG
 
 		ND_ bool					IsSubpass ()		const	{ return _prevSubpass != null; }
 		ND_ bool					IsLastPass ()		const	{ return _nextSubpass == null; }
+
+			void					SetNextSubpass (Self &next)		{ ASSERT( not _nextSubpass and not next._prevSubpass );  _nextSubpass = &next;  next._prevSubpass = this; }
 	};
 
 
@@ -710,6 +715,35 @@ namespace FG
 	
 
 
+	//
+	// Task Scheduler
+	//
+
+	class VTaskScheduler final
+	{
+	// types
+	public:
+		using Allocator_t	= LinearAllocator<>;
+
+		static constexpr uint	MaxCandidates	= 16;	// number of ready tasks that are checked by 'RunWithCost'
+
+		struct Statistic
+		{
+			size_t	inputReleases	= 0;	// in-degree decrements, one per edge
+			size_t	queuePushes		= 0;	// tasks added to the ready queue, one per task
+		};
+
+	// methods
+	public:
+		template <typename FnT>
+		static bool  Run (ArrayView<VTask> entries, size_t count, Allocator_t &alloc, FnT &&fn, OUT Statistic *stat = null);
+
+		template <typename CostFn, typename FnT>
+		static bool  RunWithCost (ArrayView<VTask> entries, size_t count, Allocator_t &alloc, CostFn &&cost, FnT &&fn, OUT Statistic *stat = null);
+	};
+
+
+
 	//
 	// Task Graph
 	//
@@ -720,7 +754,7 @@ namespace FG
 	private:
 		using Self					= VTaskGraph< VisitorT >;
 		using Allocator_t			= LinearAllocator<>;
-		using SearchableNodes_t		= std::unordered_set< VTask, std::hash<VTask>, std::equal_to<VTask>, StdLinearAllocator<VTask> >;
+		using SearchableNodes_t		= FlatHashSet< VTask, std::hash<VTask>, std::equal_to<VTask>, StdLinearAllocator<VTask> >;
 		using Entries_t				= std::vector< VTask, StdLinearAllocator<VTask> >;
 
 
@@ -741,6 +775,14 @@ namespace FG
 		void OnStart (Allocator_t &);
 		void OnDiscardMemory ();
 
+		template <typename FnT>
+		bool  Schedule (Allocator_t &alloc, FnT &&fn)	const	{ return VTaskScheduler::Run( *_entries, Count(), alloc, std::forward<FnT>(fn) ); }
+
+		template <typename CostFn, typename FnT>
+		bool  ScheduleWithCost (Allocator_t &alloc, CostFn &&cost, FnT &&fn) const {
+			return VTaskScheduler::RunWithCost( *_entries, Count(), alloc, std::forward<CostFn>(cost), std::forward<FnT>(fn) );
+		}
+
 		ND_ ArrayView<VTask>	Entries ()		const	{ return *_entries; }
 		ND_ size_t				Count ()		const	{ return _nodes->size(); }
 		ND_ bool				Empty ()		const	{ return _nodes->empty(); }
@@ -774,6 +816,151 @@ namespace FG
 
 	
 	
+/*
+=================================================
+	Run
+----
+	Kahn's algorithm: a task becomes ready when all
+	its inputs are processed, each task and each
+	dependency is visited only once - O(N+E).
+	Every task is pushed to the ready queue exactly once,
+	so the queue never wraps and 'count' slots are enough.
+	In-degree counters are restored after processing,
+	so the same graph can be scheduled again.
+=================================================
+*/
+	template <typename FnT>
+	inline bool  VTaskScheduler::Run (ArrayView<VTask> entries, size_t count, Allocator_t &alloc, FnT &&fn, OUT Statistic *stat)
+	{
+		if ( count == 0 )
+			return true;
+
+		VTask*	queue		= alloc.Alloc<VTask>( count );
+		size_t	head		= 0;
+		size_t	tail		= 0;
+		size_t	releases	= 0;
+		CHECK_ERR( queue );
+
+		for (auto node : entries)
+		{
+			ASSERT( node->Inputs().empty() );
+			CHECK_ERR( tail < count );
+			queue[tail++] = node;
+		}
+
+		for (; head < tail; ++head)
+		{
+			VTask	node = queue[head];
+
+			fn( node );
+			node->ResetInDegree();
+
+			for (auto out_node : node->Outputs())
+			{
+				++releases;
+
+				if ( out_node->ReleaseInput() )
+				{
+					CHECK_ERR( tail < count );
+					queue[tail++] = out_node;
+				}
+			}
+		}
+
+		if ( stat ) {
+			stat->inputReleases	= releases;
+			stat->queuePushes	= tail;
+		}
+
+		// some tasks have unresolved dependencies
+		CHECK_ERR( head == count );
+		return true;
+	}
+	
+/*
+=================================================
+	RunWithCost
+----
+	Same as 'Run', but the next task is the ready task with minimal cost,
+	only first 'MaxCandidates' tasks in the ready queue are checked - O(N * MaxCandidates + E).
+	Tasks with equal cost are processed in the ready order,
+	so with constant cost the order is the same as in 'Run'.
+	Cost may depend on previously processed tasks, so it is recalculated for each step.
+=================================================
+*/
+	template <typename CostFn, typename FnT>
+	inline bool  VTaskScheduler::RunWithCost (ArrayView<VTask> entries, size_t count, Allocator_t &alloc, CostFn &&cost, FnT &&fn, OUT Statistic *stat)
+	{
+		if ( count == 0 )
+			return true;
+
+		VTask*	queue		= alloc.Alloc<VTask>( count );
+		size_t	head		= 0;
+		size_t	tail		= 0;
+		size_t	releases	= 0;
+		CHECK_ERR( queue );
+
+		for (auto node : entries)
+		{
+			ASSERT( node->Inputs().empty() );
+			CHECK_ERR( tail < count );
+			queue[tail++] = node;
+		}
+
+		for (; head < tail; ++head)
+		{
+			size_t	best		= head;
+			uint	best_cost	= UMax;
+
+			for (size_t i = head, end = Min( tail, head + MaxCandidates ); i < end; ++i)
+			{
+				const uint	c = cost( queue[i] );
+
+				if ( c < best_cost )
+				{
+					best		= i;
+					best_cost	= c;
+
+					if ( c == 0 )
+						break;
+				}
+			}
+
+			// move selected task to the head, other tasks keep their order
+			VTask	node = queue[best];
+
+			for (size_t i = best; i > head; --i) {
+				queue[i] = queue[i-1];
+			}
+			queue[head] = node;
+
+			fn( node );
+			node->ResetInDegree();
+
+			for (auto out_node : node->Outputs())
+			{
+				++releases;
+
+				if ( out_node->ReleaseInput() )
+				{
+					CHECK_ERR( tail < count );
+					queue[tail++] = out_node;
+				}
+			}
+		}
+
+		if ( stat ) {
+			stat->inputReleases	= releases;
+			stat->queuePushes	= tail;
+		}
+
+		// some tasks have unresolved dependencies
+		CHECK_ERR( head == count );
+		return true;
+	}
+//-----------------------------------------------------------------------------
+
+
 /*
 =================================================
 	OnStart
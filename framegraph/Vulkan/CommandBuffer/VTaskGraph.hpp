@@ -23,6 +23,8 @@ namespace FG
 		CHECK_ERR( ptr->IsValid() );
 
 		_nodes->insert( ptr );
+		cb.AttachTransientResources( ptr );
+		cb.AddResourceUsage( ptr );
 
 		if ( ptr->Inputs().empty() )
 			_entries->push_back( ptr );
@@ -143,6 +145,25 @@ namespace FG
 
 		outScissors = { ptr, inScissors.size() };
 	}
+	
+/*
+=================================================
+	SetSortInfo
+----
+	dynamic offsets are not hashed, tasks with different offsets still share descriptor sets
+=================================================
+*/
+	template <typename TaskType>
+	inline void SetSortInfo (const TaskType &task, void const* pipeline, const VPipelineResourceSet &resources, OUT IDrawTask::SortInfo &outInfo)
+	{
+		outInfo.pipeline	= pipeline;
+		outInfo.layer		= task.sortLayer;
+		outInfo.depth		= task.sortDepth;
+
+		for (auto& res : resources.resources) {
+			outInfo.resources << HashOf( res.pplnRes );
+		}
+	}
 //-----------------------------------------------------------------------------
 	
 	
@@ -162,6 +183,8 @@ namespace FG
 		CopyScissors( cb, task.scissors, OUT _scissors );
 		CopyDescriptorSets( &rp, cb, task.resources, OUT _resources );
 		RemapVertexBuffers( cb, task.vertexBuffers, task.vertexInput, OUT _vertexBuffers, OUT _vbOffsets, OUT _vbStrides );
+		SetSortInfo( task, pipeline, _resources, OUT _sortInfo );
+		_resourceSet = &_resources;
 
 		if ( task.debugMode.mode != Default )
 			debugModeIndex = cb.GetBatch().AppendShader( INOUT _scissors, task.taskName, task.debugMode );
@@ -260,6 +283,8 @@ namespace FG
 	{
 		CopyScissors( cb, task.scissors, OUT _scissors );
 		CopyDescriptorSets( &rp, cb, task.resources, OUT _resources );
+		SetSortInfo( task, pipeline, _resources, OUT _sortInfo );
+		_resourceSet = &_resources;
 		
 		if ( task.debugMode.mode != Default )
 			debugModeIndex = cb.GetBatch().AppendShader( INOUT _scissors, task.taskName, task.debugMode );
@@ -689,11 +714,14 @@ namespace FG
 		{
 			auto&	src = task.regions[i];
 
-			dst[i].dataPtr		= cb.GetAllocator().Alloc( ArraySizeOf(src.data), AlignOf<uint8_t> );
-			dst[i].dataSize		= VkDeviceSize(ArraySizeOf(src.data));
+			dst[i].dataPtr		= cb.GetAllocator().Alloc( src.Size(), AlignOf<uint8_t> );
+			dst[i].dataSize		= VkDeviceSize(src.Size());
 			dst[i].bufferOffset	= VkDeviceSize(src.offset);
 
-			std::memcpy( dst[i].dataPtr, src.data.data(), size_t(dst[i].dataSize) );
+			if ( src.writer )
+				src.writer( dst[i].dataPtr, 0_b, src.Size() );
+			else
+				std::memcpy( dst[i].dataPtr, src.data.data(), size_t(dst[i].dataSize) );
 		}
 
 		_regions = ArrayView{ dst, cnt };
@@ -32,7 +32,7 @@ namespace FG
 
 	inline VTaskProcessor::Statistic_t&  VTaskProcessor::Stat () const
 	{
-		return _fgThread.EditStatistic().renderer;
+		return _stat;
 	}
 
 	inline uint64_t  CalcPrimitiveCount (uint vertCount, EPrimitive topology, uint patchSize)
@@ -158,10 +158,15 @@ namespace FG
 		VFgTask<SubmitRenderPass> const*	_currTask;
 		VkCommandBuffer						_cmdBuffer;
 
+		PipelineInstance_t *				_pipelines			= null;		// pipelines created by '_PrepareSecondaryCommands'
+		bool								_createPipelines	= false;	// create pipelines without recording commands
+		bool								_compatible			= true;		// draw tasks can be recorded into secondary command buffers
+
 
 	// methods
 	public:
 		DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd);
+		DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd, PipelineInstance_t* pipelines, bool createPipelines);
 
 		void  Visit (const VFgDrawTask<FG::DrawVertices> &task);
 		void  Visit (const VFgDrawTask<FG::DrawIndexed> &task);
@@ -174,7 +179,12 @@ namespace FG
 		void  Visit (const VFgDrawTask<FG::DrawMeshesIndirectCount> &task);
 		void  Visit (const VFgDrawTask<FG::CustomDraw> &task);
 
+		ND_ bool  IsCompatibleWithSecondary () const	{ return _compatible; }
+
 	private:
+		template <typename DrawTask>
+		ND_ bool  _BindPipeline (const DrawTask &task, OUT VPipelineLayout const* &layout);
+
 		void  _BindVertexBuffers (ArrayView<VLocalBuffer const*> vertexBuffers, ArrayView<VkDeviceSize> vertexOffsets) const;
 
 		template <typename DrawTask>
@@ -733,6 +743,52 @@ namespace FG
 		_tp{ tp },	_currTask{ task },	_cmdBuffer{ cmd }
 	{
 	}
+	
+	VTaskProcessor::DrawTaskCommands::DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd,
+														PipelineInstance_t* pipelines, bool createPipelines) :
+		_tp{ tp },	_currTask{ task },	_cmdBuffer{ cmd },
+		_pipelines{ pipelines },	_createPipelines{ createPipelines }
+	{
+		ASSERT( _pipelines );
+	}
+
+/*
+=================================================
+	_BindPipeline
+----
+	'_pipelines' contains pipeline for each draw task in same order as tasks are processed.
+	returns 'false' if draw commands must not be recorded.
+=================================================
+*/
+	template <typename DrawTask>
+	inline bool  VTaskProcessor::DrawTaskCommands::_BindPipeline (const DrawTask &task, OUT VPipelineLayout const* &layout)
+	{
+		auto const&		logical_rp = *_currTask->GetLogicalPass();
+
+		if ( not _pipelines )
+			return _tp._BindPipeline( logical_rp, task, OUT layout );
+
+		auto&	ppln = *(_pipelines++);
+
+		if ( _createPipelines )
+		{
+			// shader debugger uses per-batch descriptor sets that are not thread safe
+			_compatible &= (task.debugModeIndex == Default);
+			_compatible &= _tp._GetPipeline( logical_rp, task, OUT ppln.first, OUT ppln.second );
+			return false;
+		}
+
+		// pipeline is compiling on background thread
+		if ( ppln.first == VK_NULL_HANDLE )
+		{
+			_tp.Stat().skippedDrawCalls ++;
+			return false;
+		}
+
+		_tp._BindPipeline2( logical_rp, ppln.first );
+		layout = ppln.second;
+		return true;
+	}
 
 /*
 =================================================
@@ -751,8 +807,7 @@ namespace FG
 			buffers[i] = vertexBuffers[i]->Handle();
 		}
 
-		_tp.vkCmdBindVertexBuffers( _cmdBuffer, 0, uint(buffers.size()), buffers.data(), vertexOffsets.data() );
-		_tp.Stat().vertexBufferBindings ++;
+		_tp._state.BindVertexBuffers( 0, buffers, vertexOffsets );
 	}
 
 /*
@@ -763,18 +818,8 @@ namespace FG
 	template <typename DrawTask>
 	void  VTaskProcessor::DrawTaskCommands::_BindPipelineResources (const VPipelineLayout &layout, const DrawTask &task) const
 	{
-		if ( task.descriptorSets.size() )
-		{
-			_tp.vkCmdBindDescriptorSets( _cmdBuffer,
-										  VK_PIPELINE_BIND_POINT_GRAPHICS,
-										  layout.Handle(),
-										  layout.GetFirstDescriptorSet(),
-										  uint(task.descriptorSets.size()),
-										  task.descriptorSets.data(),
-										  uint(task.GetResources().dynamicOffsets.size()),
-										  task.GetResources().dynamicOffsets.data() );
-			_tp.Stat().descriptorBinds ++;
-		}
+		_tp._state.BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, layout.Handle(), layout.GetFirstDescriptorSet(),
+									   task.descriptorSets, task.GetResources().dynamicOffsets );
 		
 		if ( task.debugModeIndex != Default )
 		{
@@ -782,8 +827,7 @@ namespace FG
 			uint				offset, binding;
 			_tp._fgThread.GetBatch().GetDescriptotSet( task.debugModeIndex, OUT binding, OUT desc_set, OUT offset );
 			
-			_tp.vkCmdBindDescriptorSets( _cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout.Handle(), binding, 1, &desc_set, 1, &offset );
-			_tp.Stat().descriptorBinds ++;
+			_tp._state.BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, layout.Handle(), binding, {desc_set}, {offset} );
 		}
 	}
 
@@ -799,7 +843,8 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout ))
+			return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
@@ -829,14 +874,15 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout ))
+			return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 
 		_BindVertexBuffers( task.GetVertexBuffers(), task.GetVBOffsets() );
 		_tp._SetScissor( *_currTask->GetLogicalPass(), task.GetScissors() );
-		_tp._BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
+		_tp._state.BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
 		_tp._SetDynamicStates( task.dynamicStates );
 
 		for (auto& cmd : task.commands)
@@ -860,7 +906,8 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout ))
+			return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
@@ -895,14 +942,15 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout ))
+			return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
 
 		_BindVertexBuffers( task.GetVertexBuffers(), task.GetVBOffsets() );
 		_tp._SetScissor( *_currTask->GetLogicalPass(), task.GetScissors() );
-		_tp._BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
+		_tp._state.BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
 		_tp._SetDynamicStates( task.dynamicStates );
 
 		for (auto& cmd : task.commands)
@@ -933,7 +981,8 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout ))
+				return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -972,14 +1021,15 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout ))
+				return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
 
 			_BindVertexBuffers( task.GetVertexBuffers(), task.GetVBOffsets() );
 			_tp._SetScissor( *_currTask->GetLogicalPass(), task.GetScissors() );
-			_tp._BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
+			_tp._state.BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
 			_tp._SetDynamicStates( task.dynamicStates );
 
 			for (auto& cmd : task.commands)
@@ -1013,7 +1063,8 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout ))
+				return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1051,7 +1102,8 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout ))
+				return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1092,7 +1144,8 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout ))
+				return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1126,9 +1179,19 @@ namespace FG
 */
 	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::CustomDraw> &task)
 	{
+		// custom draw may call non thread safe methods
+		if ( _createPipelines )
+		{
+			_compatible = false;
+			return;
+		}
+
 		DrawContext	ctx{ _tp, *_currTask->GetLogicalPass() };
 
 		task.callback( task.callbackParam, ctx );
+
+		// custom draw may record commands without state tracking
+		_tp._state.Invalidate();
 	}
 //-----------------------------------------------------------------------------
 	
@@ -1188,9 +1251,8 @@ namespace FG
 		_renderState.multisample	= _logicalRP.GetMultisampleState();
 		_renderState.inputAssembly	= Default;
 
-		_tp._indexBuffer			= VK_NULL_HANDLE;
-		_tp._graphicsPipeline		= Default;
-		_tp._isDefaultScissor		= false;
+		// commands may be recorded by user
+		_tp._state.Invalidate();
 		_tp._perPassStatesUpdated	= false;
 	}
 
@@ -1231,6 +1293,7 @@ namespace FG
 											_renderState,
 											_dynamicStates,
 											Default,
+											EPipelineMissPolicy::Block,		// custom draw commands can't be skipped
 											OUT ppln_id, OUT _pplnLayout ))
 			{
 				_tp._BindPipeline2( _logicalRP, ppln_id );
@@ -1300,8 +1363,7 @@ namespace FG
 		uint						binding;
 		_pplnLayout->GetDescriptorSetLayout( id, OUT ds_layout, OUT binding );
 
-		_tp.vkCmdBindDescriptorSets( _tp._cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pplnLayout->Handle(), binding, 1, &ds, uint(dyn_offs.size()), dyn_offs.data() );
-		_tp.Stat().descriptorBinds ++;
+		_tp._state.BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, _pplnLayout->Handle(), binding, {ds}, dyn_offs );
 	}
 	
 /*
@@ -1350,8 +1412,7 @@ namespace FG
 			VkBuffer		vk_buf	= buf->Handle();
 			VkDeviceSize	off		{ offset };
 
-			_tp.vkCmdBindVertexBuffers( _tp._cmdBuffer, iter->second.index, 1, &vk_buf, &off );
-			_tp.Stat().vertexBufferBindings ++;
+			_tp._state.BindVertexBuffers( iter->second.index, {vk_buf}, {off} );
 		}
 	}
 	
@@ -1364,7 +1425,7 @@ namespace FG
 	{
 		auto*	buf = _tp._GetResource( ibuf );
 		if ( buf ) {
-			_tp._BindIndexBuffer( buf->Handle(), VkDeviceSize(offset), VEnumCast(type) );
+			_tp._state.BindIndexBuffer( buf->Handle(), VkDeviceSize(offset), VEnumCast(type) );
 		}
 	}
 	
@@ -1466,7 +1527,7 @@ namespace FG
 	void  VTaskProcessor::DrawContext::SetStencilCompareMask (uint value)
 	{
 		_BindPipeline( ALL_BITS );
-		_tp.vkCmdSetStencilCompareMask( _tp._cmdBuffer, VK_STENCIL_FRONT_AND_BACK, value );
+		_tp._state.SetStencilCompareMask( VK_STENCIL_FRONT_AND_BACK, value );
 	}
 	
 /*
@@ -1477,7 +1538,7 @@ namespace FG
 	void  VTaskProcessor::DrawContext::SetStencilWriteMask (uint value)
 	{
 		_BindPipeline( ALL_BITS );
-		_tp.vkCmdSetStencilWriteMask( _tp._cmdBuffer, VK_STENCIL_FRONT_AND_BACK, value );
+		_tp._state.SetStencilWriteMask( VK_STENCIL_FRONT_AND_BACK, value );
 	}
 	
 /*
@@ -1488,7 +1549,7 @@ namespace FG
 	void  VTaskProcessor::DrawContext::SetStencilReference (uint value)
 	{
 		_BindPipeline( ALL_BITS );
-		_tp.vkCmdSetStencilReference( _tp._cmdBuffer, VK_STENCIL_FRONT_AND_BACK, value );
+		_tp._state.SetStencilReference( VK_STENCIL_FRONT_AND_BACK, value );
 	}
 	
 /*
@@ -1775,10 +1836,26 @@ namespace FG
 =================================================
 */
 	VTaskProcessor::VTaskProcessor (VCommandBuffer &fgThread, VkCommandBuffer cmd) :
+		VTaskProcessor{ fgThread, cmd, fgThread.EditStatistic().renderer }
+	{
+		_enableDebugUtils = _fgThread.GetDevice().GetFeatures().debugUtils;
+
+		_CmdPushDebugGroup( "CommandBuffer: "s << (fgThread.GetName().size() ? fgThread.GetName() : ToString<16>( size_t(_cmdBuffer) )), RGBA8u{255} );
+	}
+	
+/*
+=================================================
+	constructor
+----
+	used for secondary command buffers too,
+	all methods that may be called from other threads must use only local state.
+=================================================
+*/
+	VTaskProcessor::VTaskProcessor (VCommandBuffer &fgThread, VkCommandBuffer cmd, Statistic_t &stat) :
 		_fgThread{ fgThread },
 		_cmdBuffer{ cmd },
-		_enableDebugUtils{ _fgThread.GetDevice().GetFeatures().debugUtils },
-		_isDefaultScissor{ false },	
+		_stat{ stat },
+		_enableDebugUtils{ false },
 		_perPassStatesUpdated{ false },
 		_dispatchBase{ _fgThread.GetDevice().GetFeatures().dispatchBase },
 		_drawIndirectCount{ _fgThread.GetDevice().GetFeatures().drawIndirectCount },
@@ -1788,13 +1865,12 @@ namespace FG
 		#ifdef VK_NV_mesh_shader
 		_maxMeshTaskCount{ _fgThread.GetDevice().GetProperties().meshShaderProperties.maxDrawMeshTasksCount },
 		#endif
-		_pendingResourceBarriers{ fgThread.GetAllocator() }
+		_pendingResourceBarriers{ fgThread.GetAllocator() },
+		_state{ fgThread.GetDevice(), cmd, stat }
 	{
 		ASSERT( _cmdBuffer );
 		
 		VulkanDeviceFn_Init( _fgThread.GetDevice() );
-
-		_CmdPushDebugGroup( "CommandBuffer: "s << (fgThread.GetName().size() ? fgThread.GetName() : ToString<16>( size_t(_cmdBuffer) )), RGBA8u{255} );
 	}
 	
 /*
@@ -2028,16 +2104,11 @@ namespace FG
 				vk_scissors.push_back( dst );
 			}
 
-			vkCmdSetScissor( _cmdBuffer, 0, uint(vk_scissors.size()), vk_scissors.data() );
-			_isDefaultScissor = false;
+			_state.SetScissors( 0, vk_scissors );
 		}
 		else
-		if ( not _isDefaultScissor )
 		{
-			const auto&	vk_scissors = logicalPsss.GetScissors();
-
-			vkCmdSetScissor( _cmdBuffer, 0, uint(vk_scissors.size()), vk_scissors.data() );
-			_isDefaultScissor = true;
+			_state.SetScissors( 0, logicalPsss.GetScissors() );
 		}
 	}
 	
@@ -2046,20 +2117,18 @@ namespace FG
 	_SetDynamicStates
 =================================================
 */
-	void  VTaskProcessor::_SetDynamicStates (const _fg_hidden_::DynamicStates &state) const
+	void  VTaskProcessor::_SetDynamicStates (const _fg_hidden_::DynamicStates &state)
 	{
 		if ( state.hasStencilTest and state.stencilTest )
 		{
 			if ( state.hasStencilCompareMask )
-				vkCmdSetStencilCompareMask( _cmdBuffer, VK_STENCIL_FRONT_AND_BACK, state.stencilCompareMask );
+				_state.SetStencilCompareMask( VK_STENCIL_FRONT_AND_BACK, state.stencilCompareMask );
 
 			if ( state.hasStencilReference )
-				vkCmdSetStencilReference( _cmdBuffer, VK_STENCIL_FRONT_AND_BACK, state.stencilReference );
+				_state.SetStencilReference( VK_STENCIL_FRONT_AND_BACK, state.stencilReference );
 
 			if ( state.hasStencilWriteMask )
-				vkCmdSetStencilWriteMask( _cmdBuffer, VK_STENCIL_FRONT_AND_BACK, state.stencilWriteMask );
-
-			Stat().dynamicStateChanges += uint(state.hasStencilCompareMask) + uint(state.hasStencilReference) + uint(state.hasStencilWriteMask);
+				_state.SetStencilWriteMask( VK_STENCIL_FRONT_AND_BACK, state.stencilWriteMask );
 		}
 	}
 
@@ -2085,6 +2154,9 @@ namespace FG
 			VkImageLayout&	layout	= rt._layout;
 			layout = EResourceState_ToImageLayout( state, rt.imagePtr->AspectMask() );
 
+			if ( _subpassLayouts )
+				Unused( _GetAttachmentLayout( rt.imagePtr, layout, true ));
+
 			_AddImage( rt.imagePtr, state, layout, rt.desc );
 		}
 
@@ -2097,6 +2169,9 @@ namespace FG
 			VkImageLayout&	layout	= rt._layout;
 			layout = EResourceState_ToImageLayout( state, rt.imagePtr->AspectMask() );
 
+			if ( _subpassLayouts )
+				Unused( _GetAttachmentLayout( rt.imagePtr, layout, true ));
+
 			_AddImage( rt.imagePtr, state, layout, rt.desc );
 		}
 	}
@@ -2205,7 +2280,7 @@ namespace FG
 	_BeginRenderPass
 =================================================
 */
-	void  VTaskProcessor::_BeginRenderPass (const VFgTask<SubmitRenderPass> &task)
+	void  VTaskProcessor::_BeginRenderPass (const VFgTask<SubmitRenderPass> &task, OUT SecondaryCommands &secondary)
 	{
 		ASSERT( not task.IsSubpass() );
 
@@ -2218,11 +2293,15 @@ namespace FG
 
 		
 		// add barriers
-		DrawTaskBarriers	barrier_visitor{ *this, *logical_passes.front() };
 		EResourceState		stages = _fgThread.GetDevice().GetGraphicsShaderStages();
 
+		_subpassLayouts = (logical_passes.size() > 1);
+		_attachmentLayouts.clear();
+
 		for (auto& pass : logical_passes)
 		{
+			DrawTaskBarriers	barrier_visitor{ *this, *pass };
+
 			for (auto& draw : pass->GetDrawTasks())
 			{
 				draw->Process1( &barrier_visitor );
@@ -2238,19 +2317,48 @@ namespace FG
 			{
 				_AddBuffer( item.first, item.second, 0, VK_WHOLE_SIZE );
 			}
+
+			_AddRenderTargetBarriers( *pass, barrier_visitor );
 		}
 		
 		VkImageView  sri_view = VK_NULL_HANDLE;
 		_SetShadingRateImage( *task.GetLogicalPass(), OUT sri_view );
 
-		_AddRenderTargetBarriers( *task.GetLogicalPass(), barrier_visitor );
 		_CommitBarriers();
+		_subpassLayouts = false;
 
 
 		// create render pass and framebuffer
 		CHECK( _CreateRenderPass( logical_passes ));
+
+		const bool	use_secondary = _PrepareSecondaryCommands( task, OUT secondary );
+
+		if ( not use_secondary )
+			secondary.cmdBuffers.clear();
 		
 
+		// attachment can be cleared only in the first subpass where it is used
+		VLogicalRenderPass::VkClearValues_t		clear_values;
+		{
+			auto	src = task.GetLogicalPass()->GetClearValues();
+			std::copy( src.begin(), src.end(), clear_values.begin() );
+		}
+
+		for (size_t i = 1; i < logical_passes.size(); ++i)
+		{
+			auto&	pass = *logical_passes[i];
+
+			for (auto& ct : pass.GetColorTargets())
+			{
+				if ( ct.loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR )
+					clear_values[ ct.index ] = pass.GetClearValues()[ ct.index ];
+			}
+
+			auto&	ds = pass.GetDepthStencilTarget();
+			if ( ds.IsDefined() and ds.loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR )
+				clear_values[ ds.index ] = pass.GetClearValues()[ ds.index ];
+		}
+
 		// begin render pass
 		VFramebuffer const*	framebuffer = _GetResource( task.GetLogicalPass()->GetFramebufferID() );
 		VRenderPass const*	render_pass = _GetResource( task.GetLogicalPass()->GetRenderPassID() );
@@ -2264,33 +2372,157 @@ namespace FG
 		pass_info.renderArea.extent.width	= CheckCast<uint>(area.Width());
 		pass_info.renderArea.extent.height	= CheckCast<uint>(area.Height());
 		pass_info.clearValueCount			= render_pass->GetCreateInfo().attachmentCount;
-		pass_info.pClearValues				= task.GetLogicalPass()->GetClearValues().data();
+		pass_info.pClearValues				= clear_values.data();
 		pass_info.framebuffer				= framebuffer->Handle();
 		
-		vkCmdBeginRenderPass( _cmdBuffer, &pass_info, VK_SUBPASS_CONTENTS_INLINE );
+		vkCmdBeginRenderPass( _cmdBuffer, &pass_info, use_secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE );
 
 		_BindShadingRateImage( sri_view );
 	}
 	
+/*
+=================================================
+	_PrepareSecondaryCommands
+----
+	splits draw tasks into chunks, each chunk will be recorded
+	into separate secondary command buffer on worker thread.
+	Render pass with subpasses, shading rate image, custom draw tasks
+	or shader debugging is recorded inline.
+=================================================
+*/
+	bool  VTaskProcessor::_PrepareSecondaryCommands (const VFgTask<SubmitRenderPass> &task, OUT SecondaryCommands &secondary)
+	{
+		auto const&		logical_rp	= *task.GetLogicalPass();
+		auto			draw_tasks	= logical_rp.GetDrawTasks();
+
+		if ( not logical_rp.UseSecondaryCmdbuf() or not task.IsLastPass() or logical_rp.HasShadingRateImage() )
+			return false;
+
+		if ( draw_tasks.size() < FG_MinDrawTasksPerSecondaryCmdBuf*2 )
+			return false;
+
+		const size_t	max_threads	= _fgThread.GetInstance().GetWorkerPool().ThreadCount() + 1;
+		const size_t	count		= Min( draw_tasks.size() / FG_MinDrawTasksPerSecondaryCmdBuf, max_threads, size_t(FG_MaxSecondaryCmdBuffers) );
+
+		if ( count < 2 )
+			return false;
+
+		// create pipelines
+		auto*				pipelines	= _fgThread.GetAllocator().Alloc<PipelineInstance_t>( draw_tasks.size() );
+		DrawTaskCommands	ppln_builder{ *this, &task, _cmdBuffer, pipelines, true };
+
+		for (auto& draw : draw_tasks)
+		{
+			draw->Process2( &ppln_builder );
+		}
+
+		if ( not ppln_builder.IsCompatibleWithSecondary() )
+			return false;
+
+		// allocate command buffers
+		auto const&		dev = _fgThread.GetDevice();
+
+		for (uint i = 0; i < count; ++i)
+		{
+			VCommandPool*	pool = _fgThread.GetSecondaryPool( i );
+			CHECK_ERR( pool );
+
+			VkCommandBuffer	cmd = pool->AllocSecondary( dev );
+			CHECK_ERR( cmd );
+
+			_fgThread.GetBatch().AddSecondaryCommandBuffer( cmd, pool );
+			secondary.cmdBuffers.push_back( cmd );
+		}
+
+		secondary.pipelines = pipelines;
+		return true;
+	}
+	
+/*
+=================================================
+	_RecordSecondaryCommands
+=================================================
+*/
+	void  VTaskProcessor::_RecordSecondaryCommands (const VFgTask<SubmitRenderPass> &task, const SecondaryCommands &secondary)
+	{
+		using Processors_t	= StaticArray< Optional<VTaskProcessor>, FG_MaxSecondaryCmdBuffers >;
+		using Statistics_t	= StaticArray< Statistic_t, FG_MaxSecondaryCmdBuffers >;
+
+		auto const&		logical_rp	= *task.GetLogicalPass();
+		auto			draw_tasks	= logical_rp.GetDrawTasks();
+		const size_t	count		= secondary.cmdBuffers.size();
+		const size_t	chunk_size	= (draw_tasks.size() + count - 1) / count;
+
+		VkCommandBufferInheritanceInfo	inheritance = {};
+		inheritance.sType		= VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritance.renderPass	= _GetResource( logical_rp.GetRenderPassID() )->Handle();
+		inheritance.subpass		= logical_rp.GetSubpassIndex();
+		inheritance.framebuffer	= _GetResource( logical_rp.GetFramebufferID() )->Handle();
+
+		VkCommandBufferBeginInfo	begin_info = {};
+		begin_info.sType			= VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		begin_info.flags			= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		begin_info.pInheritanceInfo	= &inheritance;
+
+		// processors must be created on current thread
+		Processors_t	processors;
+		Statistics_t	stats;
+
+		for (size_t i = 0; i < count; ++i) {
+			processors[i].emplace( _fgThread, secondary.cmdBuffers[i], stats[i] );
+		}
+
+		_fgThread.GetInstance().GetWorkerPool().ParallelFor( count,
+			[&] (size_t index)
+			{
+				auto&			tp		= *processors[index];
+				const size_t	first	= index * chunk_size;
+				const size_t	last	= Min( first + chunk_size, draw_tasks.size() );
+
+				VK_CALL( vkBeginCommandBuffer( tp._cmdBuffer, &begin_info ));
+
+				DrawTaskCommands	command_builder{ tp, &task, tp._cmdBuffer, secondary.pipelines + first, false };
+
+				for (size_t i = first; i < last; ++i)
+				{
+					draw_tasks[i]->Process2( &command_builder );
+				}
+
+				VK_CALL( vkEndCommandBuffer( tp._cmdBuffer ));
+			});
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			processors[i].reset();
+			Stat().Merge( stats[i] );
+		}
+		Stat().secondaryCmdBuffers += uint(count);
+
+		vkCmdExecuteCommands( _cmdBuffer, uint(count), secondary.cmdBuffers.data() );
+		
+		// all states are undefined after executing secondary command buffers
+		_state.Invalidate();
+		_perPassStatesUpdated = false;
+	}
+	
 /*
 =================================================
 	_BeginSubpass
 =================================================
 */
-	void  VTaskProcessor::_BeginSubpass (const VFgTask<SubmitRenderPass> &task)
+	void  VTaskProcessor::_BeginSubpass (const VFgTask<SubmitRenderPass> &task, OUT SecondaryCommands &secondary)
 	{
 		ASSERT( task.IsSubpass() );
 
-		// TODO: barriers for attachments
+		// barriers for all subpasses are added in '_BeginRenderPass',
+		// attachments are synchronized by subpass dependencies
+
+		const bool	use_secondary = _PrepareSecondaryCommands( task, OUT secondary );
+
+		if ( not use_secondary )
+			secondary.cmdBuffers.clear();
 
-		vkCmdNextSubpass( _cmdBuffer, VK_SUBPASS_CONTENTS_INLINE );
-		/*
-		// TODO
-		vkCmdClearAttachments( _cmdBuffer,
-							   uint( attachments.Count() ),
-							   attachments.ptr(),
-							   uint( clear_rects.Count() ),
-							   clear_rects.ptr() );*/
+		vkCmdNextSubpass( _cmdBuffer, use_secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE );
 	}
 
 /*
@@ -2304,28 +2536,36 @@ namespace FG
 			return;
 
 		// invalidate some states
-		_isDefaultScissor		= false;
-		_perPassStatesUpdated	= false;
+		_perPassStatesUpdated = false;
+
+		SecondaryCommands	secondary;
 
 		if ( not task.IsSubpass() )
 		{
 			_CmdPushDebugGroup( task.Name(), task.DebugColor() );
-			_BeginRenderPass( task );
+			_BeginRenderPass( task, OUT secondary );
 		}
 		else
 		{
 			_CmdPopDebugGroup();
 			_CmdPushDebugGroup( task.Name(), task.DebugColor() );
-			_BeginSubpass( task );
+			_BeginSubpass( task, OUT secondary );
 		}
 
 
 		// draw
-		DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
-		
-		for (auto& draw : task.GetLogicalPass()->GetDrawTasks())
+		if ( secondary.cmdBuffers.size() )
 		{
-			draw->Process2( &command_builder );
+			_RecordSecondaryCommands( task, secondary );
+		}
+		else
+		{
+			DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
+		
+			for (auto& draw : task.GetLogicalPass()->GetDrawTasks())
+			{
+				draw->Process2( &command_builder );
+			}
 		}
 
 		// end render pass
@@ -2393,18 +2633,7 @@ namespace FG
 		VkDescriptorSets_t	descriptor_sets;
 		_ExtractDescriptorSets( layout, resourceSet, OUT descriptor_sets );
 
-		if ( descriptor_sets.size() )
-		{
-			vkCmdBindDescriptorSets( _cmdBuffer,
-									  bindPoint,
-									  layout.Handle(),
-									  layout.GetFirstDescriptorSet(),
-									  uint(descriptor_sets.size()),
-									  descriptor_sets.data(),
-									  uint(resourceSet.dynamicOffsets.size()),
-									  resourceSet.dynamicOffsets.data() );
-			Stat().descriptorBinds ++;
-		}
+		_state.BindDescriptorSets( bindPoint, layout.Handle(), layout.GetFirstDescriptorSet(), descriptor_sets, resourceSet.dynamicOffsets );
 
 		if ( debugModeIndex != Default )
 		{
@@ -2412,8 +2641,7 @@ namespace FG
 			uint				offset, binding;
 			_fgThread.GetBatch().GetDescriptotSet( debugModeIndex, OUT binding, OUT desc_set, OUT offset );
 
-			vkCmdBindDescriptorSets( _cmdBuffer, bindPoint, layout.Handle(), binding, 1, &desc_set, 1, &offset );
-			Stat().descriptorBinds ++;
+			_state.BindDescriptorSets( bindPoint, layout.Handle(), binding, {desc_set}, {offset} );
 		}
 	}
 
@@ -2452,12 +2680,7 @@ namespace FG
 */
 	inline void  VTaskProcessor::_BindPipeline2 (const VLogicalRenderPass &logicalRP, VkPipeline pipelineId)
 	{
-		if ( _graphicsPipeline.pipeline != pipelineId )
-		{
-			_graphicsPipeline.pipeline = pipelineId;
-			vkCmdBindPipeline( _cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineId );
-			Stat().graphicsPipelineBindings ++;
-		}
+		_state.BindPipeline( VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineId );
 		
 		// all pipelines in current render pass have same viewport count and same dynamic states, so this values should not be invalidated.
 		if ( _perPassStatesUpdated )
@@ -2465,8 +2688,7 @@ namespace FG
 
 		_perPassStatesUpdated = true;
 		
-		if ( auto viewports = logicalRP.GetViewports(); viewports.size() )
-			vkCmdSetViewport( _cmdBuffer, 0, uint(viewports.size()), viewports.data() );
+		_state.SetViewports( 0, logicalRP.GetViewports() );
 		
 		#ifdef VK_NV_shading_rate_image
 		if ( auto palette = logicalRP.GetShadingRatePalette(); palette.size() )
@@ -2539,10 +2761,11 @@ namespace FG
 
 /*
 =================================================
-	_BindPipeline
+	_GetPipeline
 =================================================
 */
-	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, VPipelineLayout const* &pplnLayout)
+	inline bool  VTaskProcessor::_GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task,
+											   OUT VkPipeline &pipelineId, OUT VPipelineLayout const* &pplnLayout)
 	{
 		RenderState				render_state;
 		EPipelineDynamicState	dynamic_states = EPipelineDynamicState::Viewport | EPipelineDynamicState::Scissor;
@@ -2561,7 +2784,6 @@ namespace FG
 									INOUT render_state.rasterization, INOUT dynamic_states, task.dynamicStates );
 		SetupExtensions( logicalRP, INOUT dynamic_states );
 
-		VkPipeline	ppln_id;
 		CHECK_ERR( _fgThread.GetPipelineCache().CreatePipelineInstance(
 										_fgThread,
 										logicalRP,
@@ -2570,18 +2792,18 @@ namespace FG
 										render_state,
 										dynamic_states,
 										task.debugModeIndex,
-										OUT ppln_id, OUT pplnLayout ));
-		
-		_BindPipeline2( logicalRP, ppln_id );
+										_fgThread.GetPipelineMissPolicy(),
+										OUT pipelineId, OUT pplnLayout ));
 		return true;
 	}
 	
 /*
 =================================================
-	_BindPipeline
+	_GetPipeline
 =================================================
 */
-	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, VPipelineLayout const* &pplnLayout)
+	inline bool  VTaskProcessor::_GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task,
+											   OUT VkPipeline &pipelineId, OUT VPipelineLayout const* &pplnLayout)
 	{
 	#ifdef VK_NV_mesh_shader
 		RenderState				render_state;
@@ -2598,7 +2820,6 @@ namespace FG
 									INOUT render_state.rasterization, INOUT dynamic_states, task.dynamicStates );
 		SetupExtensions( logicalRP, INOUT dynamic_states );
 
-		VkPipeline	ppln_id;
 		CHECK_ERR( _fgThread.GetPipelineCache().CreatePipelineInstance(
 										_fgThread,
 										logicalRP,
@@ -2606,16 +2827,38 @@ namespace FG
 										render_state,
 										dynamic_states,
 										task.debugModeIndex,
-										OUT ppln_id, OUT pplnLayout ));
-		
-		_BindPipeline2( logicalRP, ppln_id );
+										OUT pipelineId, OUT pplnLayout ));
 		return true;
 	#else
-		Unused( logicalRP, task, pplnLayout );
+		Unused( logicalRP, task, pipelineId, pplnLayout );
 		return false;
 	#endif
 	}
 
+/*
+=================================================
+	_BindPipeline
+----
+	returns 'false' if draw task must be skipped.
+=================================================
+*/
+	template <typename DrawTask>
+	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const DrawTask &task, OUT VPipelineLayout const* &pplnLayout)
+	{
+		VkPipeline	ppln_id;
+		CHECK_ERR( _GetPipeline( logicalRP, task, OUT ppln_id, OUT pplnLayout ));
+
+		// pipeline is compiling on background thread
+		if ( ppln_id == VK_NULL_HANDLE )
+		{
+			Stat().skippedDrawCalls ++;
+			return false;
+		}
+
+		_BindPipeline2( logicalRP, ppln_id );
+		return true;
+	}
+
 /*
 =================================================
 	_BindPipeline
@@ -2632,12 +2875,7 @@ namespace FG
 										debugModeIndex,
 										OUT ppln_id, OUT pplnLayout ));
 		
-		if ( _computePipeline.pipeline != ppln_id )
-		{
-			_computePipeline.pipeline = ppln_id;
-			vkCmdBindPipeline( _cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ppln_id );
-			Stat().computePipelineBindings ++;
-		}
+		_state.BindPipeline( VK_PIPELINE_BIND_POINT_COMPUTE, ppln_id );
 		return true;
 	}
 
@@ -3443,12 +3681,7 @@ namespace FG
 			VPipelineLayout const*	layout		= _GetResource( layout_id );
 			VLocalBuffer const*		sbt_buffer	= _ToLocal( task.shaderTable->GetBuffer() );
 		
-			if ( _rayTracingPipeline.pipeline != pipeline )
-			{
-				_rayTracingPipeline.pipeline = pipeline;
-				vkCmdBindPipeline( _cmdBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_NV, pipeline );
-				Stat().rayTracingPipelineBindings ++;
-			}
+			_state.BindPipeline( VK_PIPELINE_BIND_POINT_RAY_TRACING_NV, pipeline );
 
 			_BindPipelineResources( *layout, task.GetResources(), VK_PIPELINE_BIND_POINT_RAY_TRACING_NV, task.debugModeIndex );
 			_PushConstants( *layout, task.pushConstants );
@@ -3500,6 +3733,9 @@ namespace FG
 		ctx.commandBuffer		= BitCast<CommandBufferVk_t>(_cmdBuffer);
 
 		task.callback( ctx );
+
+		// user may record any commands
+		_state.Invalidate();
 	}
 
 /*
@@ -3512,14 +3748,39 @@ namespace FG
 		ASSERT( img );
 		ASSERT( not state.range.IsEmpty() );
 
-		_pendingResourceBarriers.insert({ img, &CommitResourceBarrier<VLocalImage> });
+		if_likely( _movedTransitions.empty() or not _IsTransitionMoved( img ))
+		{
+			_pendingResourceBarriers.insert({ img, &CommitResourceBarrier<VLocalImage> });
 
-		img->AddPendingState( state );
+			img->AddPendingState( state );
+		}
 
 		if_unlikely( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddImageUsage( img->ToGlobal(), state );
 	}
 	
+/*
+=================================================
+	_GetAttachmentLayout
+----
+	image must have the same layout in all subpasses, the first layout of render target is used,
+	render pass performs transitions between subpasses, see 'VRenderPass::_Initialize'.
+=================================================
+*/
+	inline VkImageLayout  VTaskProcessor::_GetAttachmentLayout (const VLocalImage *img, VkImageLayout layout, bool isRenderTarget)
+	{
+		for (auto& item : _attachmentLayouts)
+		{
+			if ( item.first == img )
+				return item.second;
+		}
+
+		if ( isRenderTarget )
+			_attachmentLayouts.push_back({ img, layout });
+
+		return layout;
+	}
+
 /*
 =================================================
 	_AddImage
@@ -3529,6 +3790,9 @@ namespace FG
 	{
 		ASSERT( desc.layerCount > 0 and desc.levelCount > 0 );
 
+		if_unlikely( _subpassLayouts )
+			layout = _GetAttachmentLayout( img, layout, false );
+
 		_AddImageState( img,
 						ImageState{
 							state, layout,
@@ -3579,9 +3843,13 @@ namespace FG
 	inline void  VTaskProcessor::_AddBufferState (const VLocalBuffer *buf, const BufferState &state)
 	{
 		ASSERT( buf );
-		_pendingResourceBarriers.insert({ buf, &CommitResourceBarrier<VLocalBuffer> });
 
-		buf->AddPendingState( state );
+		if_likely( _movedTransitions.empty() or not _IsTransitionMoved( buf ))
+		{
+			_pendingResourceBarriers.insert({ buf, &CommitResourceBarrier<VLocalBuffer> });
+
+			buf->AddPendingState( state );
+		}
 		
 		if_unlikely( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddBufferUsage( buf->ToGlobal(), state );
@@ -3733,32 +4001,114 @@ namespace FG
 
 			barrier_mngr.AddMemoryBarrier( VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, barrier );
 			barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer );
+			Stat().pipelineBarriers ++;
 		}
 		else
 	#endif	// FG_DEBUG
 
-		barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer );
+		if ( barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer ))
+			Stat().pipelineBarriers ++;
 	}
-	
+
 /*
 =================================================
-	_BindIndexBuffer
+	_AddWholeResourceState
+----
+	transition is moved to another task, so it is not known
+	which part of the resource will be used, the whole resource is transited.
 =================================================
 */
-	inline void  VTaskProcessor::_BindIndexBuffer (VkBuffer indexBuffer, VkDeviceSize indexOffset, VkIndexType indexType)
+	void  VTaskProcessor::_AddWholeResourceState (const ResourceUsage &usage, VTask consumer) const
 	{
-		if ( _indexBuffer		!= indexBuffer	or
-			 _indexBufferOffset	!= indexOffset	or
-			 _indexType			!= indexType )
+		if ( usage.buffer )
 		{
-			_indexBuffer		= indexBuffer;
-			_indexBufferOffset	= indexOffset;
-			_indexType			= indexType;
+			usage.buffer->AddPendingState( BufferState{ usage.state, 0, VkDeviceSize(usage.buffer->Size()), consumer });
+		}
+		else
+		{
+			auto*	img = usage.image;
+			ASSERT( img );
 
-			vkCmdBindIndexBuffer( _cmdBuffer, _indexBuffer, _indexBufferOffset, _indexType );
-			Stat().indexBufferBindings ++;
+			img->AddPendingState( ImageState{ usage.state, usage.layout,
+											  ImageRange{ 0_layer, img->ArrayLayers(), 0_mipmap, img->MipmapLevels() },
+											  VkImageAspectFlagBits(img->AspectMask()), consumer });
 		}
 	}
-	
+
+/*
+=================================================
+	AddEarlyTransition
+----
+	transition will be recorded in barrier of the next task.
+=================================================
+*/
+	void  VTaskProcessor::AddEarlyTransition (const ResourceUsage &usage, VTask consumer)
+	{
+		_AddWholeResourceState( usage, consumer );
+
+		if ( usage.buffer )
+			_pendingResourceBarriers.insert({ usage.buffer, &CommitResourceBarrier<VLocalBuffer> });
+		else
+			_pendingResourceBarriers.insert({ usage.image, &CommitResourceBarrier<VLocalImage> });
+	}
+
+/*
+=================================================
+	SignalEvent
+----
+	first half of the split barrier, must be called after the producer task.
+=================================================
+*/
+	void  VTaskProcessor::SignalEvent (VkEvent event)
+	{
+		vkCmdSetEvent( _cmdBuffer, event, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT );
+	}
+
+/*
+=================================================
+	WaitEvent
+----
+	second half of the split barrier, must be called before the consumer task.
+=================================================
+*/
+	void  VTaskProcessor::WaitEvent (VkEvent event, const ResourceUsage &usage, VTask consumer)
+	{
+		_AddWholeResourceState( usage, consumer );
+
+		if ( usage.buffer )
+			usage.buffer->CommitBarrier( _splitBarrierMngr, _fgThread.GetDebugger() );
+		else
+			usage.image->CommitBarrier( _splitBarrierMngr, _fgThread.GetDebugger() );
+
+		if ( _splitBarrierMngr.CommitWaitEvent( _fgThread.GetDevice(), _cmdBuffer, event, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT ))
+			Stat().splitBarriers ++;
+	}
+
+/*
+=================================================
+	SkipTransition
+----
+	transition of the resource for the next task was already recorded.
+=================================================
+*/
+	void  VTaskProcessor::SkipTransition (void const* resource)
+	{
+		_movedTransitions.push_back( resource );
+	}
+
+/*
+=================================================
+	_IsTransitionMoved
+=================================================
+*/
+	inline bool  VTaskProcessor::_IsTransitionMoved (void const* resource) const
+	{
+		for (auto* res : _movedTransitions) {
+			if ( res == resource )
+				return true;
+		}
+		return false;
+	}
+
 
 }	// FG
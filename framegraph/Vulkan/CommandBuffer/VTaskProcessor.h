@@ -8,6 +8,7 @@
 #include "VLocalRTGeometry.h"
 #include "VLocalRTScene.h"
 #include "VBarrierManager.h"
+#include "VCmdStateTracker.h"
 
 namespace FG
 {
@@ -19,6 +20,18 @@ namespace FG
 	class VTaskProcessor final : public VulkanDeviceFn
 	{
 	// types
+	public:
+		// resource state that is used by barrier optimizer
+		struct ResourceUsage
+		{
+			VLocalBuffer const*		buffer	= null;
+			VLocalImage const*		image	= null;
+			EResourceState			state	= Default;
+			VkImageLayout			layout	= Zero;
+
+			ND_ void const*  Resource () const	{ return buffer ? static_cast<void const*>(buffer) : static_cast<void const*>(image); }
+		};
+
 	private:
 		class DrawTaskBarriers;
 		class DrawTaskCommands;
@@ -49,9 +62,14 @@ namespace FG
 		using Statistic_t				= IFrameGraph::RenderingStatistics;
 		using StencilValue_t			= decltype(_fg_hidden_::DynamicStates::stencilReference);
 
-		struct PipelineState
+		using PipelineInstance_t		= Pair< VkPipeline, VPipelineLayout const* >;
+		using SecondaryCmdBuffers_t		= FixedArray< VkCommandBuffer, FG_MaxSecondaryCmdBuffers >;
+		using AttachmentLayouts_t		= FixedArray< Pair< VLocalImage const*, VkImageLayout >, FG_MaxColorBuffers+1 >;
+
+		struct SecondaryCommands
 		{
-			VkPipeline		pipeline	= VK_NULL_HANDLE;
+			PipelineInstance_t *			pipelines	= null;		// pipeline for each draw task, created on main thread because pipeline cache is not thread safe
+			SecondaryCmdBuffers_t			cmdBuffers;				// if empty then draw tasks will be recorded inline
 		};
 
 
@@ -59,10 +77,10 @@ namespace FG
 	private:
 		VCommandBuffer &			_fgThread;
 		const VkCommandBuffer		_cmdBuffer;
+		Statistic_t &				_stat;
 		
 		VTask						_currTask;
 		bool						_enableDebugUtils		: 1;
-		bool						_isDefaultScissor		: 1;
 		bool						_perPassStatesUpdated	: 1;
 		const bool					_dispatchBase			: 1;
 		const bool					_drawIndirectCount		: 1;
@@ -74,22 +92,21 @@ namespace FG
 		#endif
 
 		PendingResourceBarriers_t	_pendingResourceBarriers;
+		Array<void const*>			_movedTransitions;		// transitions for current task that was recorded by previous tasks
+		VBarrierManager				_splitBarrierMngr;
 
-		PipelineState				_graphicsPipeline;
-		PipelineState				_computePipeline;
-		PipelineState				_rayTracingPipeline;
-
-		// index bufer state
-		VkBuffer					_indexBuffer		= VK_NULL_HANDLE;
-		VkDeviceSize				_indexBufferOffset	= UMax;
-		VkIndexType					_indexType			= VK_INDEX_TYPE_MAX_ENUM;
+		VCmdStateTracker			_state;					// bound pipelines, resources and dynamic states
 
 		VkImageView					_shadingRateImage	= VK_NULL_HANDLE;
 
+		AttachmentLayouts_t			_attachmentLayouts;				// used only in '_BeginRenderPass' for render pass with subpasses
+		bool						_subpassLayouts		= false;
+
 
 	// methods
 	public:
 		explicit VTaskProcessor (VCommandBuffer &, VkCommandBuffer);
+		VTaskProcessor (VCommandBuffer &, VkCommandBuffer secondaryCmdBuffer, Statistic_t &);
 		~VTaskProcessor ();
 
 		void  Visit (const VFgTask<SubmitRenderPass> &);
@@ -136,6 +153,12 @@ namespace FG
 
 		void  Run (VTask);
 
+		// barrier optimization //
+		void  AddEarlyTransition (const ResourceUsage &usage, VTask consumer);
+		void  SignalEvent (VkEvent event);
+		void  WaitEvent (VkEvent event, const ResourceUsage &usage, VTask consumer);
+		void  SkipTransition (void const* resource);
+
 
 	private:
 		void  _CmdDebugMarker (StringView text) const;
@@ -146,26 +169,33 @@ namespace FG
 		template <typename ID>	ND_ auto const*  _GetResource (ID id) const;
 		
 		void  _CommitBarriers ();
+		void  _AddWholeResourceState (const ResourceUsage &usage, VTask consumer) const;
+		ND_ bool  _IsTransitionMoved (void const* resource) const;
 		
 		void  _AddRenderTargetBarriers (const VLogicalRenderPass &logicalRP, const DrawTaskBarriers &info);
 		void  _SetShadingRateImage (const VLogicalRenderPass &logicalRP, OUT VkImageView &view);
-		void  _BeginRenderPass (const VFgTask<SubmitRenderPass> &task);
-		void  _BeginSubpass (const VFgTask<SubmitRenderPass> &task);
+		void  _BeginRenderPass (const VFgTask<SubmitRenderPass> &task, OUT SecondaryCommands &secondary);
+		void  _BeginSubpass (const VFgTask<SubmitRenderPass> &task, OUT SecondaryCommands &secondary);
 		bool  _CreateRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses);
+		bool  _PrepareSecondaryCommands (const VFgTask<SubmitRenderPass> &task, OUT SecondaryCommands &secondary);
+		void  _RecordSecondaryCommands (const VFgTask<SubmitRenderPass> &task, const SecondaryCommands &secondary);
 
 		void  _ExtractDescriptorSets (const VPipelineLayout &, const VPipelineResourceSet &, OUT VkDescriptorSets_t &);
 		void  _BindPipelineResources (const VPipelineLayout &layout, const VPipelineResourceSet &resourceSet, VkPipelineBindPoint bindPoint, ShaderDbgIndex debugModeIndex);
-		bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, OUT VPipelineLayout const* &pplnLayout);
-		bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, OUT VPipelineLayout const* &pplnLayout);
+		bool  _GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, OUT VkPipeline &pipelineId, OUT VPipelineLayout const* &pplnLayout);
+		bool  _GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, OUT VkPipeline &pipelineId, OUT VPipelineLayout const* &pplnLayout);
+		template <typename DrawTask>
+		bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const DrawTask &task, OUT VPipelineLayout const* &pplnLayout);
 		void  _BindPipeline2 (const VLogicalRenderPass &logicalRP, VkPipeline pipelineId);
 		bool  _BindPipeline (const VComputePipeline* pipeline, const Optional<uint3> &localSize, ShaderDbgIndex debugModeIndex,
 							 VkPipelineCreateFlags flags, OUT VPipelineLayout const* &pplnLayout);
 		void  _PushConstants (const VPipelineLayout &layout, const _fg_hidden_::PushConstants_t &pc) const;
 		void  _SetScissor (const VLogicalRenderPass &, ArrayView<RectI>);
-		void  _SetDynamicStates (const _fg_hidden_::DynamicStates &) const;
+		void  _SetDynamicStates (const _fg_hidden_::DynamicStates &);
 		void  _BindShadingRateImage (VkImageView view);
 		void  _ResetDrawContext ();
 
+		ND_ VkImageLayout  _GetAttachmentLayout (const VLocalImage *img, VkImageLayout layout, bool isRenderTarget);
 		void  _AddImage (const VLocalImage *img, EResourceState state, VkImageLayout layout, const ImageViewDesc &desc);
 		void  _AddImage (const VLocalImage *img, EResourceState state, VkImageLayout layout, const VkImageSubresourceLayers &subresLayers);
 		void  _AddImage (const VLocalImage *img, EResourceState state, VkImageLayout layout, const VkImageSubresourceRange &subres);
@@ -178,8 +208,6 @@ namespace FG
 		void  _AddRTGeometry (const VLocalRTGeometry *geom, EResourceState state);
 		void  _AddRTScene (const VLocalRTScene *scene, EResourceState state);
 
-		void  _BindIndexBuffer (VkBuffer indexBuffer, VkDeviceSize indexOffset, VkIndexType indexType);
-
 		ND_ Statistic_t&  Stat () const;
 	};
 
@@ -15,7 +15,7 @@ namespace FG
 		_device{ dev }
 	{
 	}
-	
+
 /*
 =================================================
 	destructor
@@ -23,9 +23,12 @@ namespace FG
 */
 	VDescriptorManager::~VDescriptorManager ()
 	{
-		CHECK( _descriptorPools.empty() );
+		for (auto& slot : _perThread) {
+			CHECK( slot.pools.empty() );
+		}
+		CHECK( _allTransientPools.empty() );
 	}
-	
+
 /*
 =================================================
 	Initialize
@@ -33,12 +36,10 @@ namespace FG
 */
 	bool VDescriptorManager::Initialize ()
 	{
-		EXLOCK( _guard );
-
-		CHECK_ERR( _CreateDescriptorPool() );
+		// pools are created on demand
 		return true;
 	}
-	
+
 /*
 =================================================
 	Deinitialize
@@ -46,56 +47,92 @@ namespace FG
 */
 	void VDescriptorManager::Deinitialize ()
 	{
-		EXLOCK( _guard );
+		VkDevice	dev = _device.GetVkDevice();
 
-		for (auto& item : _descriptorPools)
+		for (auto& slot : _perThread)
 		{
-			//EXLOCK( item.guard );
+			EXLOCK( slot.guard );
 
-			if ( item.pool )
-			{
-				_device.vkDestroyDescriptorPool( _device.GetVkDevice(), item.pool, null );
-				item.pool = VK_NULL_HANDLE;
+			for (auto& pool : slot.pools) {
+				_device.vkDestroyDescriptorPool( dev, pool, null );
 			}
+			slot.pools.clear();
+			slot.current = 0;
 		}
-		_descriptorPools.clear();
+
+		EXLOCK( _transientGuard );
+		CHECK( _freeTransientPools.size() == _allTransientPools.size() );
+
+		for (auto& pool : _allTransientPools) {
+			_device.vkDestroyDescriptorPool( dev, pool, null );
+		}
+		_allTransientPools.clear();
+		_freeTransientPools.clear();
 	}
-	
+
+/*
+=================================================
+	_ThreadIndex
+=================================================
+*/
+	uint  VDescriptorManager::_ThreadIndex ()
+	{
+		static Atomic<uint>			counter {0};
+		static thread_local uint	index = UMax;	// constant initialization is faster
+
+		if ( index == UMax )
+			index = counter.fetch_add( 1, memory_order_relaxed ) & (ThreadSlotCount-1);
+
+		return index;
+	}
+
 /*
 =================================================
 	AllocDescriptorSet
+----
+	'ds.second' contains thread slot in low bits and pool index in high bits.
 =================================================
 */
 	bool  VDescriptorManager::AllocDescriptorSet (VkDescriptorSetLayout layout, OUT DescriptorSet &ds)
 	{
-		EXLOCK( _guard );
+		const uint	slot_idx	= _ThreadIndex();
+		auto&		slot		= _perThread[ slot_idx ];
+		EXLOCK( slot.guard );
 
 		VkDescriptorSetAllocateInfo		info = {};
 		info.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		info.descriptorSetCount	= 1;
 		info.pSetLayouts		= &layout;
 
-		for (auto& item : _descriptorPools)
+		// try last used pool first, then all other pools
+		for (size_t i = 0, cnt = slot.pools.size(); i < cnt; ++i)
 		{
-			//EXLOCK( item.guard );
-			info.descriptorPool = item.pool;
-			
+			const uint	pool_idx = uint((slot.current + i) % cnt);
+
+			info.descriptorPool = slot.pools[pool_idx];
+
 			if ( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds.first ) == VK_SUCCESS )
 			{
-				ds.second = uint8_t(Distance( _descriptorPools.data(), &item ));
+				slot.current	= pool_idx;
+				ds.second		= slot_idx | (pool_idx << ThreadSlotBits);
 				return true;
 			}
 		}
 
-		CHECK_ERR( _CreateDescriptorPool() );
-		
-		info.descriptorPool = _descriptorPools.back().pool;
+		VkDescriptorPool	pool;
+		CHECK_ERR( _CreateDescriptorPool( true, OUT pool ));
+		slot.pools.push_back( pool );
+
+		const uint	pool_idx = uint(slot.pools.size() - 1);
+
+		info.descriptorPool = pool;
 		VK_CHECK( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds.first ));
-		ds.second = uint8_t(_descriptorPools.size() - 1);
 
+		slot.current	= pool_idx;
+		ds.second		= slot_idx | (pool_idx << ThreadSlotBits);
 		return true;
 	}
-	
+
 /*
 =================================================
 	DeallocDescriptorSet
@@ -103,13 +140,15 @@ namespace FG
 */
 	bool  VDescriptorManager::DeallocDescriptorSet (const DescriptorSet &ds)
 	{
-		EXLOCK( _guard );
-		CHECK_ERR( ds.second < _descriptorPools.size() );
+		auto&		slot		= _perThread[ ds.second & (ThreadSlotCount-1) ];
+		const uint	pool_idx	= ds.second >> ThreadSlotBits;
+		EXLOCK( slot.guard );
+		CHECK_ERR( pool_idx < slot.pools.size() );
 
-		VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), _descriptorPools[ds.second].pool, 1, &ds.first ));
+		VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), slot.pools[pool_idx], 1, &ds.first ));
 		return true;
 	}
-	
+
 /*
 =================================================
 	DeallocDescriptorSets
@@ -117,16 +156,24 @@ namespace FG
 */
 	bool  VDescriptorManager::DeallocDescriptorSets (ArrayView<DescriptorSet> descSets)
 	{
-		EXLOCK( _guard );
-
 		FixedArray< VkDescriptorSet, 32 >	temp;
-		uint8_t								last_idx = UMax;
+		uint								last_idx = UMax;
+
+		const auto	FreeSets = [this, &temp] (uint index)
+		{
+			auto&		slot		= _perThread[ index & (ThreadSlotCount-1) ];
+			const uint	pool_idx	= index >> ThreadSlotBits;
+			EXLOCK( slot.guard );
+			CHECK_ERRV( pool_idx < slot.pools.size() );
+
+			VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), slot.pools[pool_idx], uint(temp.size()), temp.data() ));
+		};
 
 		for (auto& ds : descSets)
 		{
-			if ( last_idx != ds.second and temp.size() )
+			if ( (last_idx != ds.second or temp.size() == temp.capacity()) and temp.size() )
 			{
-				VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), _descriptorPools[last_idx].pool, uint(temp.size()), temp.data() ));
+				FreeSets( last_idx );
 				temp.clear();
 			}
 
@@ -134,22 +181,65 @@ namespace FG
 			temp.push_back( ds.first );
 		}
 
-		if ( temp.size() )
-		{
-			VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), _descriptorPools[last_idx].pool, uint(temp.size()), temp.data() ));
+		if ( temp.size() ) {
+			FreeSets( last_idx );
 		}
 		return true;
 	}
 
 /*
 =================================================
-	_CreateDescriptorPool
+	AcquireTransientPool
 =================================================
 */
-	bool  VDescriptorManager::_CreateDescriptorPool ()
+	VkDescriptorPool  VDescriptorManager::AcquireTransientPool ()
 	{
-		CHECK_ERR( _descriptorPools.size() < _descriptorPools.capacity() );
+		{
+			EXLOCK( _transientGuard );
+
+			if ( _freeTransientPools.size() )
+			{
+				VkDescriptorPool	pool = _freeTransientPools.back();
+				_freeTransientPools.pop_back();
+				return pool;
+			}
+		}
+
+		VkDescriptorPool	pool;
+		CHECK_ERR( _CreateDescriptorPool( false, OUT pool ));
 
+		EXLOCK( _transientGuard );
+		_allTransientPools.push_back( pool );
+		return pool;
+	}
+
+/*
+=================================================
+	ReleaseTransientPools
+----
+	all descriptor sets allocated from pools must be unused.
+=================================================
+*/
+	void  VDescriptorManager::ReleaseTransientPools (ArrayView<VkDescriptorPool> pools)
+	{
+		if ( pools.empty() )
+			return;
+
+		for (auto& pool : pools) {
+			VK_CALL( _device.vkResetDescriptorPool( _device.GetVkDevice(), pool, 0 ));
+		}
+
+		EXLOCK( _transientGuard );
+		_freeTransientPools.insert( _freeTransientPools.end(), pools.begin(), pools.end() );
+	}
+
+/*
+=================================================
+	_CreateDescriptorPool
+=================================================
+*/
+	bool  VDescriptorManager::_CreateDescriptorPool (bool freeable, OUT VkDescriptorPool &outPool) const
+	{
 		FixedArray< VkDescriptorPoolSize, 32 >	pool_sizes;
 
 		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_SAMPLER,						MaxDescriptorPoolSize });
@@ -161,25 +251,22 @@ namespace FG
 		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,				MaxDescriptorPoolSize * 2 });
 		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,		MaxDescriptorPoolSize });
 		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,		MaxDescriptorPoolSize });
-		
+
 		#ifdef VK_NV_ray_tracing
 		if ( _device.GetFeatures().rayTracingNV ) {
 			pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV, MaxDescriptorPoolSize });
 		}
 		#endif
 
-		
+
 		VkDescriptorPoolCreateInfo	info = {};
 		info.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 		info.poolSizeCount	= uint(pool_sizes.size());
 		info.pPoolSizes		= pool_sizes.data();
 		info.maxSets		= MaxDescriptorSets;
-		info.flags			= VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-
-		VkDescriptorPool	ds_pool;
-		VK_CHECK( _device.vkCreateDescriptorPool( _device.GetVkDevice(), &info, null, OUT &ds_pool ));
+		info.flags			= (freeable ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0);
 
-		_descriptorPools.push_back({ ds_pool });
+		VK_CHECK( _device.vkCreateDescriptorPool( _device.GetVkDevice(), &info, null, OUT &outPool ));
 		return true;
 	}
 
@@ -18,28 +18,43 @@ namespace FG
 		static constexpr uint	MaxDescriptorPoolSize	= 1u << 11;
 		static constexpr uint	MaxDescriptorSets		= 1u << 10;
 
-		struct DSPool
+		// each thread allocates descriptor sets from its own pools,
+		// threads share slot only if there are more threads than slots.
+		static constexpr uint	ThreadSlotCount			= 16;
+		static constexpr uint	ThreadSlotBits			= CT_IntLog2< ThreadSlotCount >;
+
+		using DescriptorPoolArray_t		= Array< VkDescriptorPool >;
+		using DescriptorSet				= VDescriptorSetLayout::DescriptorSet;
+
+		struct alignas(FG_CACHE_LINE) PerThread
 		{
-			VkDescriptorPool	pool	= VK_NULL_HANDLE;
+			Mutex					guard;
+			DescriptorPoolArray_t	pools;			// can grow without limit
+			uint					current	= 0;	// index of the last pool that has free space
 		};
+		using PerThreadArray_t			= StaticArray< PerThread, ThreadSlotCount >;
 
-		using DescriptorPoolArray_t		= FixedArray< DSPool, 8 >;
-		using DescriptorSet				= VDescriptorSetLayout::DescriptorSet;
+		STATIC_ASSERT( IsPowerOfTwo( ThreadSlotCount ));
 
 
 	// variables
 	private:
 		VDevice const&				_device;
 
-		Mutex						_guard;
-		DescriptorPoolArray_t		_descriptorPools;
+		PerThreadArray_t			_perThread;
+
+		// transient pools are never freed by descriptor set,
+		// they are reset in bulk when command batch completes.
+		Mutex						_transientGuard;
+		DescriptorPoolArray_t		_freeTransientPools;
+		DescriptorPoolArray_t		_allTransientPools;
 
 
 	// methods
 	public:
 		explicit VDescriptorManager (const VDevice &);
 		~VDescriptorManager ();
-		
+
 		bool Initialize ();
 		void Deinitialize ();
 
@@ -47,8 +62,13 @@ namespace FG
 		bool DeallocDescriptorSet (const DescriptorSet &ds);
 		bool DeallocDescriptorSets (ArrayView<DescriptorSet> ds);
 
+		ND_ VkDescriptorPool  AcquireTransientPool ();
+			void			  ReleaseTransientPools (ArrayView<VkDescriptorPool> pools);
+
 	private:
-		bool _CreateDescriptorPool ();
+		ND_ bool _CreateDescriptorPool (bool freeable, OUT VkDescriptorPool &pool) const;
+
+		ND_ static uint  _ThreadIndex ();
 	};
 
 
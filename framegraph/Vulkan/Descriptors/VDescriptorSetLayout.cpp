@@ -17,6 +17,7 @@ namespace FG
 	VDescriptorSetLayout::~VDescriptorSetLayout ()
 	{
 		CHECK( not _layout );
+		CHECK( not _updateTemplate );
 	}
 
 /*
@@ -66,10 +67,112 @@ namespace FG
 
 		VK_CHECK( dev.vkCreateDescriptorSetLayout( dev.GetVkDevice(), &descriptor_info, null, OUT &_layout ));
 
+		// if failed then 'vkUpdateDescriptorSets' will be used
+		_CreateUpdateTemplate( dev, binding );
+
 		_resourcesTemplate = PipelineResourcesHelper::CreateDynamicData( _uniforms, _maxIndex+1, _elementCount, _dynamicOffsetCount );
 		return true;
 	}
 	
+/*
+=================================================
+	_CreateUpdateTemplate
+----
+	descriptors are packed in binding order,
+	each binding occupies 'descriptorCount' elements of
+	VkDescriptorImageInfo, VkDescriptorBufferInfo or VkBufferView.
+=================================================
+*/
+	bool VDescriptorSetLayout::_CreateUpdateTemplate (const VDevice &dev, const DescriptorBinding_t &binding)
+	{
+	#ifdef VK_KHR_descriptor_update_template
+		if ( not dev.GetFeatures().descriptorUpdateTemplate or binding.empty() )
+			return false;
+
+		// unsized arrays are partially updated, it is not supported by template
+		for (auto& un : *_uniforms)
+		{
+			if ( un.second.arraySize == 0 )
+				return false;
+		}
+
+		Array< VkDescriptorUpdateTemplateEntry >	entries;
+		entries.reserve( binding.size() );
+		_templateEntries.resize( _maxIndex+1 );
+
+		uint	offset = 0;
+		for (auto& bind : binding)
+		{
+			size_t	stride = 0;
+
+			switch ( bind.descriptorType )
+			{
+				case VK_DESCRIPTOR_TYPE_SAMPLER :
+				case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER :
+				case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE :
+				case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE :
+				case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT :			stride = sizeof(VkDescriptorImageInfo);		break;
+
+				case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER :
+				case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER :		stride = sizeof(VkBufferView);				break;
+
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER :
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER :
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC :
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC :	stride = sizeof(VkDescriptorBufferInfo);	break;
+
+				default :
+					// acceleration structures can't be passed as raw data
+					_templateEntries.clear();
+					return false;
+			}
+
+			auto&	dst = entries.emplace_back();
+			dst.dstBinding		= bind.binding;
+			dst.dstArrayElement	= 0;
+			dst.descriptorCount	= bind.descriptorCount;
+			dst.descriptorType	= bind.descriptorType;
+			dst.offset			= offset;
+			dst.stride			= stride;
+
+			_templateEntries[ bind.binding ] = TemplateEntry{ offset, bind.descriptorCount, bind.descriptorType };
+			offset += uint(stride * bind.descriptorCount);
+		}
+
+		VkDescriptorUpdateTemplateCreateInfo	info = {};
+		info.sType						= VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+		info.descriptorUpdateEntryCount	= uint(entries.size());
+		info.pDescriptorUpdateEntries	= entries.data();
+		info.templateType				= VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+		info.descriptorSetLayout		= _layout;
+
+		if ( dev.vkCreateDescriptorUpdateTemplateKHR( dev.GetVkDevice(), &info, null, OUT &_updateTemplate ) != VK_SUCCESS )
+		{
+			_templateEntries.clear();
+			_updateTemplate = VK_NULL_HANDLE;
+			return false;
+		}
+
+		_templateDataSize	= offset;
+		_templateEntryCount	= uint(entries.size());
+		return true;
+	#else
+		Unused( dev, binding );
+		return false;
+	#endif
+	}
+	
+/*
+=================================================
+	GetTemplateEntry
+=================================================
+*/
+	VDescriptorSetLayout::TemplateEntry  VDescriptorSetLayout::GetTemplateEntry (uint binding) const
+	{
+		SHAREDLOCK( _drCheck );
+		return binding < _templateEntries.size() ? _templateEntries[binding] : TemplateEntry{};
+	}
+	
 /*
 =================================================
 	Destroy
@@ -83,21 +186,30 @@ namespace FG
 			resMngr.GetDescriptorManager().DeallocDescriptorSets( _descSetCache );
 		}
 
+		if ( _updateTemplate ) {
+			auto&	dev = resMngr.GetDevice();
+			dev.vkDestroyDescriptorUpdateTemplateKHR( dev.GetVkDevice(), _updateTemplate, null );
+		}
+
 		if ( _layout ) {
 			auto&	dev = resMngr.GetDevice();
 			dev.vkDestroyDescriptorSetLayout( dev.GetVkDevice(), _layout, null );
 		}
 
 		_descSetCache.clear();
+		_templateEntries.clear();
 		_resourcesTemplate.reset();
 		_poolSize.clear();
 
 		_uniforms			= null;
 		_layout				= VK_NULL_HANDLE;
+		_updateTemplate		= VK_NULL_HANDLE;
 		_hash				= Default;
 		_maxIndex			= 0;
 		_elementCount		= 0;
 		_dynamicOffsetCount	= 0;
+		_templateDataSize	= 0;
+		_templateEntryCount	= 0;
 	}
 	
 /*
@@ -18,13 +18,21 @@ namespace FG
 	// types
 	public:
 		using DescriptorBinding_t	= Array< VkDescriptorSetLayoutBinding >;
-		using DescriptorSet			= Pair< VkDescriptorSet, /*pool index*/uint8_t >;
+		using DescriptorSet			= Pair< VkDescriptorSet, /*pool index*/uint >;
+
+		struct TemplateEntry
+		{
+			uint				offset	= UMax;		// offset in packed descriptor data
+			uint				count	= 0;		// descriptor count
+			VkDescriptorType	type	= VK_DESCRIPTOR_TYPE_MAX_ENUM;
+		};
 
 	private:
 		using UniformMapPtr			= PipelineDescription::UniformMapPtr;
 		using PoolSizeArray_t		= FixedArray< VkDescriptorPoolSize, 10 >;
 		using DynamicDataPtr		= PipelineResources::DynamicDataPtr;
 		using DescSetCache_t		= FixedArray< DescriptorSet, 32 >;
+		using TemplateEntries_t		= Array< TemplateEntry >;
 
 
 	// variables
@@ -41,8 +49,12 @@ namespace FG
 		mutable Mutex			_descSetCacheGuard;
 		mutable DescSetCache_t	_descSetCache;
 
+		VkDescriptorUpdateTemplate	_updateTemplate		= VK_NULL_HANDLE;
+		TemplateEntries_t			_templateEntries;		// indexed by binding
+		uint						_templateDataSize	= 0;
+		uint						_templateEntryCount	= 0;
+
 		DebugName_t				_debugName;
-		// TODO: desc set update template
 
 		RWDataRaceCheck			_drCheck;
 
@@ -70,6 +82,11 @@ namespace FG
 		ND_ uint					GetMaxIndex ()		const	{ SHAREDLOCK( _drCheck );  return _maxIndex; }
 		ND_ StringView				GetDebugName ()		const	{ SHAREDLOCK( _drCheck );  return _debugName; }
 
+		ND_ VkDescriptorUpdateTemplate	GetUpdateTemplate ()		const	{ SHAREDLOCK( _drCheck );  return _updateTemplate; }
+		ND_ uint					GetTemplateDataSize ()		const	{ SHAREDLOCK( _drCheck );  return _templateDataSize; }
+		ND_ uint					GetTemplateEntryCount ()	const	{ SHAREDLOCK( _drCheck );  return _templateEntryCount; }
+		ND_ TemplateEntry			GetTemplateEntry (uint binding) const;
+
 
 	private:
 		void _AddUniform (const PipelineDescription::Uniform &un, INOUT DescriptorBinding_t &binding);
@@ -81,6 +98,7 @@ namespace FG
 		void _AddStorageBuffer (const PipelineDescription::StorageBuffer &sb, uint bindingIndex, uint arraySize, EShaderStages stageFlags, INOUT DescriptorBinding_t &binding);
 		void _AddRayTracingScene (const PipelineDescription::RayTracingScene &rts, uint bindingIndex, uint arraySize, EShaderStages stageFlags, INOUT DescriptorBinding_t &binding);
 		void _IncDescriptorCount (VkDescriptorType type);
+		bool _CreateUpdateTemplate (const VDevice &dev, const DescriptorBinding_t &binding);
 	};
 
 }	// FG
@@ -7,6 +7,7 @@
 #include "VEnumCast.h"
 #include "stl/Algorithms/StringUtils.h"
 #include "Shared/EnumToString.h"
+#include <thread>
 
 namespace FG
 {
@@ -56,7 +57,7 @@ namespace FG
 	Create
 =================================================
 */
-	bool  VPipelineResources::Create (VResourceManager &resMngr)
+	bool  VPipelineResources::Create (VResourceManager &resMngr, bool deferUpdate)
 	{
 		EXLOCK( _drCheck );
 		CHECK_ERR( not _descriptorSet.first );
@@ -86,12 +87,157 @@ namespace FG
 		UpdateDescriptors	update;
 		update.descriptors		= update.allocator.Alloc< VkWriteDescriptorSet >( ds_layout->GetMaxIndex() + 1 );
 		update.descriptorIndex	= 0;
+		update.updateTemplate	= ds_layout->GetUpdateTemplate();
+
+		if ( update.updateTemplate )
+		{
+			update.layout		= ds_layout;
+			update.templateData	= update.allocator.Alloc( BytesU{ds_layout->GetTemplateDataSize()}, AlignOf<VkDescriptorBufferInfo> );
+		}
 
 		_dataPtr->ForEachUniform( [&](auto& un, auto& data) { _AddResource( resMngr, un, data, INOUT update ); });
 		
-		dev.vkUpdateDescriptorSets( dev.GetVkDevice(), update.descriptorIndex, update.descriptors, 0, null );
+		// template requires that all descriptors are written
+		if ( update.descriptorIndex != ds_layout->GetTemplateEntryCount() )
+			update.updateTemplate = VK_NULL_HANDLE;
+
+		if ( deferUpdate )
+		{
+			_pendingUpdate.reset( new UpdateDescriptors{ std::move(update) });
+			_updateState.store( EUpdateState::Pending, memory_order_release );
+			return true;
+		}
+
+		_UpdateDescriptorSet( dev, update );
 		return true;
 	}
+	
+/*
+=================================================
+	_UpdateDescriptorSet
+=================================================
+*/
+	void  VPipelineResources::_UpdateDescriptorSet (const VDevice &dev, const UpdateDescriptors &update) const
+	{
+		if ( update.updateTemplate )
+			dev.vkUpdateDescriptorSetWithTemplateKHR( dev.GetVkDevice(), _descriptorSet.first, update.updateTemplate, update.templateData );
+		else
+			dev.vkUpdateDescriptorSets( dev.GetVkDevice(), update.descriptorIndex, update.descriptors, 0, null );
+	}
+	
+/*
+=================================================
+	_TryBeginUpdate
+----
+	descriptor set may be shared between command buffers,
+	only one of them will update it.
+=================================================
+*/
+	inline bool  VPipelineResources::_TryBeginUpdate () const
+	{
+		EUpdateState	expected = EUpdateState::Pending;
+		return _updateState.compare_exchange_strong( INOUT expected, EUpdateState::Updating, memory_order_acquire, memory_order_relaxed );
+	}
+	
+/*
+=================================================
+	_EndUpdate
+=================================================
+*/
+	inline void  VPipelineResources::_EndUpdate () const
+	{
+		_pendingUpdate.reset();
+		_updateState.store( EUpdateState::Updated, memory_order_release );
+	}
+	
+/*
+=================================================
+	_WaitUpdate
+=================================================
+*/
+	inline void  VPipelineResources::_WaitUpdate () const
+	{
+		while ( _updateState.load( memory_order_acquire ) != EUpdateState::Updated )
+		{
+			std::this_thread::yield();
+		}
+	}
+
+/*
+=================================================
+	FlushUpdate
+=================================================
+*/
+	void  VPipelineResources::FlushUpdate (const VDevice &dev) const
+	{
+		SHAREDLOCK( _drCheck );
+
+		if ( _TryBeginUpdate() )
+		{
+			_UpdateDescriptorSet( dev, *_pendingUpdate );
+			_EndUpdate();
+		}
+		else
+			_WaitUpdate();
+	}
+	
+/*
+=================================================
+	FlushUpdates
+----
+	descriptor sets with update template are updated one by one,
+	all other descriptor writes are merged into single call.
+=================================================
+*/
+	void  VPipelineResources::FlushUpdates (const VDevice &dev, ArrayView<VPipelineResources const*> sets, LinearAllocator<> &allocator)
+	{
+		if ( sets.empty() )
+			return;
+
+		auto*	locked			= allocator.Alloc< VPipelineResources const* >( sets.size() );
+		size_t	locked_count	= 0;
+		size_t	write_count		= 0;
+
+		for (auto* ds : sets)
+		{
+			if ( ds->_TryBeginUpdate() )
+			{
+				locked[locked_count++] = ds;
+
+				if ( not ds->_pendingUpdate->updateTemplate )
+					write_count += ds->_pendingUpdate->descriptorIndex;
+			}
+		}
+
+		auto*	writes		= allocator.Alloc< VkWriteDescriptorSet >( write_count );
+		size_t	write_pos	= 0;
+
+		for (size_t i = 0; i < locked_count; ++i)
+		{
+			auto&	update = *locked[i]->_pendingUpdate;
+
+			if ( update.updateTemplate )
+				locked[i]->_UpdateDescriptorSet( dev, update );
+			else
+			{
+				std::memcpy( writes + write_pos, update.descriptors, sizeof(*writes) * update.descriptorIndex );
+				write_pos += update.descriptorIndex;
+			}
+		}
+		ASSERT( write_pos == write_count );
+
+		if ( write_count )
+			dev.vkUpdateDescriptorSets( dev.GetVkDevice(), uint(write_count), writes, 0, null );
+
+		for (size_t i = 0; i < locked_count; ++i) {
+			locked[i]->_EndUpdate();
+		}
+
+		// wait for descriptor sets that are updated in another thread
+		for (auto* ds : sets) {
+			ds->_WaitUpdate();
+		}
+	}
 
 /*
 =================================================
@@ -114,6 +260,8 @@ namespace FG
 		}
 
 		_dataPtr.reset();
+		_pendingUpdate.reset();
+		_updateState.store( EUpdateState::Updated, memory_order_relaxed );
 		_descriptorSet	= { VK_NULL_HANDLE, UMax };
 		_layoutId		= Default;
 		_hash			= Default;
@@ -234,6 +382,29 @@ namespace FG
 		#endif
 	}
 
+/*
+=================================================
+	UpdateDescriptors::Alloc
+----
+	returns pointer to the packed template data if binding is compatible,
+	otherwise disables template and allocates temporary memory.
+=================================================
+*/
+	template <typename T>
+	inline T*  VPipelineResources::UpdateDescriptors::Alloc (uint binding, uint count, VkDescriptorType type)
+	{
+		if ( updateTemplate )
+		{
+			auto	entry = layout->GetTemplateEntry( binding );
+
+			if ( entry.count == count and entry.type == type )
+				return Cast<T>( templateData + BytesU{entry.offset} );
+
+			updateTemplate = VK_NULL_HANDLE;
+		}
+		return allocator.Alloc<T>( count );
+	}
+
 /*
 =================================================
 	_AddResource
@@ -241,7 +412,13 @@ namespace FG
 */
 	bool  VPipelineResources::_AddResource (VResourceManager &resMngr, const UniformID &un, INOUT PipelineResources::Buffer &buf, INOUT UpdateDescriptors &list)
 	{
-		auto*	info = list.allocator.Alloc< VkDescriptorBufferInfo >( buf.elementCount );
+		const bool				is_uniform	= ((buf.state & EResourceState::_StateMask) == EResourceState::UniformRead);
+		const bool				is_dynamic	= AllBits( buf.state, EResourceState::_BufferDynamicOffset );
+		const VkDescriptorType	type		= (is_uniform ?
+												(is_dynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) :
+												(is_dynamic ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER));
+
+		auto*	info = list.Alloc< VkDescriptorBufferInfo >( buf.index.VKBinding(), buf.elementCount, type );
 
 		for (uint i = 0; i < buf.elementCount; ++i)
 		{
@@ -261,15 +438,10 @@ namespace FG
 			_CheckBufferUsage( *buffer, buf.state );
 		}
 
-		const bool	is_uniform	= ((buf.state & EResourceState::_StateMask) == EResourceState::UniformRead);
-		const bool	is_dynamic	= AllBits( buf.state, EResourceState::_BufferDynamicOffset );
-
 		VkWriteDescriptorSet&	wds = list.descriptors[list.descriptorIndex++];
 		wds = {};
 		wds.sType			= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		wds.descriptorType	= (is_uniform ?
-								(is_dynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) :
-								(is_dynamic ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER));
+		wds.descriptorType	= type;
 		wds.descriptorCount	= buf.elementCount;
 		wds.dstBinding		= buf.index.VKBinding();
 		wds.dstSet			= _descriptorSet.first;
@@ -285,7 +457,10 @@ namespace FG
 */
 	bool  VPipelineResources::_AddResource (VResourceManager &resMngr, const UniformID &un, INOUT PipelineResources::TexelBuffer &texbuf, INOUT UpdateDescriptors &list)
 	{
-		auto*	info = list.allocator.Alloc< VkBufferView >( texbuf.elementCount );
+		const bool				is_uniform	= ((texbuf.state & EResourceState::_StateMask) == EResourceState::UniformRead);
+		const VkDescriptorType	type		= is_uniform ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+
+		auto*	info = list.Alloc< VkBufferView >( texbuf.index.VKBinding(), texbuf.elementCount, type );
 
 		for (uint i = 0; i < texbuf.elementCount; ++i)
 		{
@@ -309,12 +484,10 @@ namespace FG
 			_CheckTexelBufferUsage( *buffer, texbuf.state );
 		}
 		
-		const bool	is_uniform	= ((texbuf.state & EResourceState::_StateMask) == EResourceState::UniformRead);
-
 		VkWriteDescriptorSet&	wds = list.descriptors[list.descriptorIndex++];
 		wds = {};
 		wds.sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		wds.descriptorType		= is_uniform ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+		wds.descriptorType		= type;
 		wds.descriptorCount		= texbuf.elementCount;
 		wds.dstBinding			= texbuf.index.VKBinding();
 		wds.dstSet				= _descriptorSet.first;
@@ -330,7 +503,10 @@ namespace FG
 */
 	bool  VPipelineResources::_AddResource (VResourceManager &resMngr, const UniformID &un, INOUT PipelineResources::Image &img, INOUT UpdateDescriptors &list)
 	{
-		auto*	info = list.allocator.Alloc< VkDescriptorImageInfo >( img.elementCount );
+		const VkDescriptorType	type = ((img.state & EResourceState::_StateMask) == EResourceState::InputAttachment) ?
+										VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+		auto*	info = list.Alloc< VkDescriptorImageInfo >( img.index.VKBinding(), img.elementCount, type );
 
 		for (uint i = 0; i < img.elementCount; ++i)
 		{
@@ -360,8 +536,7 @@ namespace FG
 		VkWriteDescriptorSet&	wds = list.descriptors[list.descriptorIndex++];
 		wds = {};
 		wds.sType			= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		wds.descriptorType	= ((img.state & EResourceState::_StateMask) == EResourceState::InputAttachment) ?
-								VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		wds.descriptorType	= type;
 		wds.descriptorCount	= img.elementCount;
 		wds.dstBinding		= img.index.VKBinding();
 		wds.dstSet			= _descriptorSet.first;
@@ -377,7 +552,7 @@ namespace FG
 */
 	bool  VPipelineResources::_AddResource (VResourceManager &resMngr, const UniformID &un, INOUT PipelineResources::Texture &tex, INOUT UpdateDescriptors &list)
 	{
-		auto*	info = list.allocator.Alloc< VkDescriptorImageInfo >( tex.elementCount );
+		auto*	info = list.Alloc< VkDescriptorImageInfo >( tex.index.VKBinding(), tex.elementCount, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER );
 
 		for (uint i = 0; i < tex.elementCount; ++i)
 		{
@@ -424,7 +599,7 @@ namespace FG
 */
 	bool  VPipelineResources::_AddResource (VResourceManager &resMngr, const UniformID &un, const PipelineResources::Sampler &samp, INOUT UpdateDescriptors &list)
 	{
-		auto*	info = list.allocator.Alloc< VkDescriptorImageInfo >( samp.elementCount );
+		auto*	info = list.Alloc< VkDescriptorImageInfo >( samp.index.VKBinding(), samp.elementCount, VK_DESCRIPTOR_TYPE_SAMPLER );
 
 		for (uint i = 0; i < samp.elementCount; ++i)
 		{
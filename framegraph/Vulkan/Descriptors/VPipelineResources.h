@@ -22,6 +22,21 @@ namespace FG
 			LinearAllocator<>			allocator;
 			VkWriteDescriptorSet *		descriptors;
 			uint						descriptorIndex;
+
+			// packed data for descriptor update template
+			VDescriptorSetLayout const*	layout			= null;
+			VkDescriptorUpdateTemplate	updateTemplate	= VK_NULL_HANDLE;
+			void *						templateData	= null;
+
+			template <typename T>
+			ND_ T*  Alloc (uint binding, uint count, VkDescriptorType type);
+		};
+
+		enum class EUpdateState : uint
+		{
+			Updated,
+			Pending,	// descriptor set is allocated but not updated yet
+			Updating,
 		};
 
 		//using Element_t			= Union< VkDescriptorBufferInfo, VkDescriptorImageInfo, VkAccelerationStructureNV >;
@@ -36,6 +51,9 @@ namespace FG
 		HashVal						_hash;
 		DynamicDataPtr				_dataPtr;
 		bool						_allowEmptyResources;
+
+		mutable Atomic<EUpdateState>		_updateState	{EUpdateState::Updated};
+		mutable UniquePtr<UpdateDescriptors>	_pendingUpdate;		// deferred until 'FlushUpdate' or 'FlushUpdates'
 		
 		DebugName_t					_debugName;
 		
@@ -51,10 +69,14 @@ namespace FG
 		explicit VPipelineResources (INOUT PipelineResources &desc);
 		~VPipelineResources ();
 
-			bool Create (VResourceManager &);
+			bool Create (VResourceManager &, bool deferUpdate = false);
 			void Destroy (VResourceManager &);
 
+			void FlushUpdate (const VDevice &) const;
+		static	void FlushUpdates (const VDevice &, ArrayView<VPipelineResources const*> sets, LinearAllocator<> &);
+
 		ND_ bool IsAllResourcesAlive (const VResourceManager &) const;
+		ND_ bool IsUpdatePending ()	const						{ return _updateState.load( memory_order_acquire ) != EUpdateState::Updated; }
 
 		ND_ bool operator == (const VPipelineResources &rhs) const;
 		
@@ -79,6 +101,11 @@ namespace FG
 
 		void _LogUniform (const UniformID &, uint idx) const;
 
+		void _UpdateDescriptorSet (const VDevice &, const UpdateDescriptors &) const;
+		ND_ bool _TryBeginUpdate () const;
+		void _EndUpdate () const;
+		void _WaitUpdate () const;
+
 		static void _CheckBufferUsage (const VBuffer &, EResourceState state);
 		static void _CheckTexelBufferUsage (const VBuffer &, EResourceState state);
 		static void _CheckImageUsage (const VImage &, EResourceState state);
@@ -326,6 +326,20 @@ namespace FG
 		_accessForReadWrite.clear();
 	}
 
+/*
+=================================================
+	DiscardState
+----
+	content is not needed anymore, skip transition to the default state.
+=================================================
+*/
+	void VLocalImage::DiscardState () const
+	{
+		ASSERT( _pendingAccesses.empty() and "you must commit all pending states before discarding" );
+
+		_accessForReadWrite.clear();
+	}
+
 /*
 =================================================
 	CommitBarrier
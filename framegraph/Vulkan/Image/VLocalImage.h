@@ -85,6 +85,7 @@ namespace FG
 		void SetInitialState (bool immutable, bool invalidate) const;
 		void AddPendingState (const ImageState &) const;
 		void ResetState (ExeOrderIndex index, VBarrierManager &barrierMngr, Ptr<VLocalDebugger> debugger) const;
+		void DiscardState () const;
 		void CommitBarrier (VBarrierManager &barrierMngr, Ptr<VLocalDebugger> debugger) const;
 		
 		ND_ VkImageView			GetView (const VDevice &dev, bool isDefault, INOUT ImageViewDesc &desc) const	{ return _imageData->GetView( dev, isDefault, INOUT desc ); }
@@ -157,6 +157,9 @@ namespace FG
 		_features.commandPoolTrim			= has_maintenance1;
 		_features.array2DCompatible			= has_maintenance1;
 		#endif
+		#ifdef VK_KHR_descriptor_update_template
+		_features.descriptorUpdateTemplate	= _vkVersion >= EShaderLangFormat::Vulkan_110 or HasDeviceExtension( VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME );
+		#endif
 		#ifdef VK_KHR_device_group
 		_features.dispatchBase				= _vkVersion >= EShaderLangFormat::Vulkan_110 or HasDeviceExtension( VK_KHR_DEVICE_GROUP_EXTENSION_NAME );
 		#endif
@@ -169,6 +172,9 @@ namespace FG
 		#ifdef VK_KHR_draw_indirect_count
 		_features.drawIndirectCount			= _vkVersion >= EShaderLangFormat::Vulkan_120 or HasDeviceExtension( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
 		#endif
+		#ifdef VK_KHR_timeline_semaphore
+		_features.timelineSemaphore			= _vkVersion >= EShaderLangFormat::Vulkan_120 or HasDeviceExtension( VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME );
+		#endif
 		#ifdef VK_EXT_descriptor_indexing
 		_features.descriptorIndexing		= _vkVersion >= EShaderLangFormat::Vulkan_120 or HasDeviceExtension( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
 		#endif
@@ -187,6 +193,9 @@ namespace FG
 		#ifdef VK_EXT_robustness2
 		_features.robustness2				= HasDeviceExtension( VK_EXT_ROBUSTNESS_2_EXTENSION_NAME );
 		#endif
+		#ifdef VK_EXT_memory_budget
+		_features.memoryBudget				= HasDeviceExtension( VK_EXT_MEMORY_BUDGET_EXTENSION_NAME );
+		#endif
 
 		// load extensions
 		if ( _vkVersion >= EShaderLangFormat::Vulkan_110 or HasInstanceExtension( VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME ))
@@ -219,6 +228,14 @@ namespace FG
 				_properties.descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
 			}
 			#endif
+			#ifdef VK_KHR_timeline_semaphore
+			if ( _features.timelineSemaphore )
+			{
+				*next_feat	= &_properties.timelineSemaphoreFeatures;
+				next_feat	= &_properties.timelineSemaphoreFeatures.pNext;
+				_properties.timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+			}
+			#endif
 			#ifdef VK_EXT_robustness2
 			if ( _features.robustness2 )
 			{
@@ -237,6 +254,9 @@ namespace FG
 			#ifdef VK_NV_shading_rate_image
 			_features.shadingRateImageNV	&= (_properties.shadingRateImageFeatures.shadingRateImage == VK_TRUE);
 			#endif
+			#ifdef VK_KHR_timeline_semaphore
+			_features.timelineSemaphore		&= (_properties.timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE);
+			#endif
 			#ifdef VK_EXT_robustness2
 			_features.robustness2			&= !!(_properties.robustness2Features.robustBufferAccess2 | _properties.robustness2Features.robustImageAccess2 | _properties.robustness2Features.nullDescriptor);
 			#endif
@@ -309,6 +329,12 @@ namespace FG
 
 			vkGetPhysicalDeviceProperties2KHR( GetVkPhysicalDevice(), OUT &props2 );
 		}
+		else
+		{
+			// 'vkGetPhysicalDeviceMemoryProperties2' is required to query memory budget
+			_features.memoryBudget		= false;
+			_features.timelineSemaphore	= false;
+		}
 
 		VulkanLoader::SetupDeviceBackwardCompatibility( _properties.properties.apiVersion, INOUT _deviceFnTable );
 	}
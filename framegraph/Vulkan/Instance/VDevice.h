@@ -53,12 +53,14 @@ namespace FG
 			bool	dispatchBase			: 1;
 			bool	array2DCompatible		: 1;
 			bool	blockTexelView			: 1;
+			bool	descriptorUpdateTemplate: 1;
 			// vulkan 1.2 core
 			bool	samplerMirrorClamp		: 1;
 			bool	descriptorIndexing		: 1;
 			bool	renderPass2				: 1;
 			bool	depthStencilResolve		: 1;
 			bool	drawIndirectCount		: 1;
+			bool	timelineSemaphore		: 1;
 			// window extensions
 			bool	surface					: 1;
 			bool	surfaceCaps2			: 1;
@@ -69,6 +71,7 @@ namespace FG
 			bool	rayTracingNV			: 1;
 			bool	shadingRateImageNV		: 1;
 			bool	robustness2				: 1;
+			bool	memoryBudget			: 1;
 			//bool	rayTracing				: 1;
 		};
 
@@ -99,6 +102,9 @@ namespace FG
 			VkPhysicalDeviceVulkan11Properties					properties110;
 			VkPhysicalDeviceVulkan12Properties					properties120;
 			#endif
+			#ifdef VK_KHR_timeline_semaphore
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR		timelineSemaphoreFeatures;
+			#endif
 			#ifdef VK_EXT_robustness2
 			VkPhysicalDeviceRobustness2FeaturesEXT				robustness2Features;
 			VkPhysicalDeviceRobustness2PropertiesEXT			robustness2Properties;
@@ -5,6 +5,7 @@
 #include "VSubmitted.h"
 #include "Shared/PipelineResourcesHelper.h"
 #include "stl/Algorithms/StringUtils.h"
+#include "stl/Platforms/ThreadName.h"
 
 namespace FG
 {
@@ -12,10 +13,74 @@ namespace FG
 	using SubmitInfos_t			= StaticArray< VkSubmitInfo, VSubmitted::MaxBatches >;
 	using TempSemaphores_t		= VSubmitted::Semaphores_t;
 	using PendingSwapchains_t	= FixedArray< VSwapchain const*, 16 >;
-	using TempFences_t			= FixedArray< VkFence, 32 >;
 	using TempSubmitted_t		= FixedArray< VSubmitted*, 32 >;
 	using TimePoint_t			= std::chrono::high_resolution_clock::time_point;
 
+namespace {
+	//
+	// Wait List
+	//
+	struct TempWaitList
+	{
+		FixedArray< VkFence, 32 >		fences;
+		FixedArray< VkSemaphore, 32 >	timelines;
+		FixedArray< uint64_t, 32 >		values;		// for each timeline semaphore
+
+		ND_ bool  IsFull ()	const	{ return fences.size() == fences.capacity() or timelines.size() == timelines.capacity(); }
+		ND_ bool  Empty ()	const	{ return fences.empty() and timelines.empty(); }
+
+		void  Add (const VSubmitted &submitted)
+		{
+			if ( VkSemaphore sem = submitted.GetTimeline() )
+			{
+				// wait for the max value only
+				for (size_t i = 0; i < timelines.size(); ++i)
+				{
+					if ( timelines[i] == sem ) {
+						values[i] = Max( values[i], submitted.GetTimelineValue() );
+						return;
+					}
+				}
+				timelines.push_back( sem );
+				values.push_back( submitted.GetTimelineValue() );
+			}
+			else
+			if ( VkFence fence = submitted.GetFence() )
+			{
+				if ( std::find( fences.begin(), fences.end(), fence ) == fences.end() )
+					fences.push_back( fence );
+			}
+		}
+
+		ND_ VkResult  Wait (const VDevice &dev, Nanoseconds timeout, bool waitAll = true)
+		{
+			VkResult	res = VK_SUCCESS;
+
+			if ( fences.size() )
+				res = dev.vkWaitForFences( dev.GetVkDevice(), uint(fences.size()), fences.data(), (waitAll ? VK_TRUE : VK_FALSE), uint64_t(timeout.count()) );
+
+			#ifdef VK_KHR_timeline_semaphore
+			if ( res == VK_SUCCESS and timelines.size() )
+			{
+				VkSemaphoreWaitInfoKHR	info = {};
+				info.sType			= VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+				info.flags			= (waitAll ? 0 : VK_SEMAPHORE_WAIT_ANY_BIT_KHR);
+				info.semaphoreCount	= uint(timelines.size());
+				info.pSemaphores	= timelines.data();
+				info.pValues		= values.data();
+
+				res = dev.vkWaitSemaphoresKHR( dev.GetVkDevice(), &info, uint64_t(timeout.count()) );
+			}
+			#endif
+
+			fences.clear();
+			timelines.clear();
+			values.clear();
+			return res;
+		}
+	};
+}
+
 /*
 =================================================
 	constructor
@@ -23,9 +88,12 @@ namespace FG
 */
 	VFrameGraph::VFrameGraph (const VulkanDeviceInfo &vdi) :
 		_state{ EState::Initial },	_device{ vdi },
-		_queueUsage{ Default },		_resourceMngr{ _device, vdi.maxStagingBufferMemory, vdi.stagingBufferSize },
-		_queryPool{ VK_NULL_HANDLE }
+		_queueUsage{ Default },		_cmdPoolMngr{ _device },
+		_resourceMngr{ _device, vdi.maxStagingBufferMemory, vdi.stagingBufferSize, vdi.resourcePoolLimits },
+		_queryPool{ VK_NULL_HANDLE },	_pipelinePrewarmer{ *this }
 	{
+		_completion.enabled		= vdi.useCompletionThread;
+		_completion.executor	= vdi.callbackExecutor;
 	}
 	
 /*
@@ -75,12 +143,16 @@ namespace FG
 			VkQueryPoolCreateInfo	info = {};
 			info.sType		= VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 			info.queryType	= VK_QUERY_TYPE_TIMESTAMP;
-			info.queryCount	= uint(CmdBatchPool_t::Capacity() * 2);
+			info.queryCount	= MaxQueryBatches * 2;
 		
 			VK_CHECK( _device.vkCreateQueryPool( _device.GetVkDevice(), &info, null, OUT &_queryPool ));
 		}
 
 		CHECK_ERR( _resourceMngr.Initialize() );
+		CHECK_ERR( _pipelineCache.Initialize( _device ));
+
+		if ( _completion.enabled )
+			_StartCompletionThread();
 		
 		CHECK_ERR( _SetState( EState::Initialization, EState::Idle ));
 		return true;
@@ -96,6 +168,10 @@ namespace FG
 		CHECK_ERRV( _SetState( EState::Idle, EState::Destroyed ));
 		CHECK_ERRV( WaitIdle( MaxTimeout ));
 
+		_StopCompletionThread();
+		_workerPool.Stop();
+		_pipelinePrewarmer.Deinitialize();
+
 		// delete command buffers
 		{
 			FG_LOGD( "Max command buffers "s << ToString(_cmdBufferPool.CreatedObjectsCount()) );
@@ -105,6 +181,7 @@ namespace FG
 			_cmdBufferPool.Release();
 			_cmdBatchPool.Release();
 			_submittedPool.Release([this] (auto& s) { s.Destroy( GetDevice() ); });
+			_cmdPoolMngr.Deinitialize();
 		}
 
 		// delete per queue data
@@ -113,7 +190,7 @@ namespace FG
 
 			for (auto& q : _queueMap)
 			{
-				CHECK( q.pending.empty() );
+				CHECK( q.pending.Empty() and q.ready.empty() and q.waiting == 0 );
 				CHECK( q.submitted.empty() );
 
 				q.cmdPool.Destroy( _device );
@@ -122,6 +199,11 @@ namespace FG
 					_device.vkDestroySemaphore( _device.GetVkDevice(), sem, null );
 					sem = VK_NULL_HANDLE;
 				}
+
+				if ( q.timeline ) {
+					_device.vkDestroySemaphore( _device.GetVkDevice(), q.timeline, null );
+					q.timeline = VK_NULL_HANDLE;
+				}
 			}
 		}
 		
@@ -130,6 +212,12 @@ namespace FG
 			_queryPool = VK_NULL_HANDLE;
 		}
 
+		// command buffers merged their pipeline caches in destructor
+		{
+			EXLOCK( _pipelineCacheGuard );
+			_pipelineCache.Deinitialize( _device );
+		}
+
 		_shaderDebugCallback = {};
 		_resourceMngr.Deinitialize();
 	}
@@ -221,6 +309,7 @@ namespace FG
 		result.samplerMirrorClamp				= feats.samplerMirrorClamp;
 		result.descriptorIndexing				= feats.descriptorIndexing;
 		result.drawIndirectCount				= feats.drawIndirectCount;
+		result.timelineSemaphore				= feats.timelineSemaphore;
 		result.swapchain						= feats.surface and feats.swapchain;
 		result.meshShaderNV						= feats.meshShaderNV;
 		result.rayTracingNV						= feats.rayTracingNV;
@@ -396,6 +485,17 @@ namespace FG
 		return RTShaderTableID{ _resourceMngr.CreateRayTracingShaderTable( dbgName )};
 	}
 
+/*
+=================================================
+	CreateMemoryPool
+=================================================
+*/
+	bool  VFrameGraph::CreateMemoryPool (const MemPoolID &id, const MemoryPoolDesc &desc)
+	{
+		CHECK_ERR( _IsInitialized() );
+		return _resourceMngr.GetMemoryManager().CreatePool( id, desc );
+	}
+
 /*
 =================================================
 	_InitPipelineResources
@@ -779,8 +879,17 @@ namespace FG
 			uint	q_idx = uint(batch->GetQueueType());
 			CHECK_ERR( q_idx < _queueMap.size() );
 
-			EXLOCK( _queueGuard );
-			_queueMap[q_idx].pending.push_back( batch );
+			auto&	q = _queueMap[q_idx];
+
+			// lock-free, doesn't wait for 'Flush' on another thread
+			if ( not q.pending.Push( VCmdBatchPtr{batch} ))
+			{
+				// queue is full, make space and try again
+				EXLOCK( _queueGuard );
+				_FetchPendingBatches( q );
+
+				CHECK_ERR( q.pending.Push( std::move(batch) ));
+			}
 		}
 
 		//_FlushQueue( batch->GetQueueUsage(), 3u );
@@ -806,6 +915,38 @@ namespace FG
 		return result;
 	}
 
+/*
+=================================================
+	_CreateTimelineSemaphore
+----
+	one semaphore is used for all submissions on the queue,
+	value is increased on each submission.
+=================================================
+*/
+	VkSemaphore  VFrameGraph::_CreateTimelineSemaphore ()
+	{
+	#ifdef VK_KHR_timeline_semaphore
+		VkSemaphoreTypeCreateInfoKHR	type_info	= {};
+		VkSemaphoreCreateInfo			info		= {};
+		VkSemaphore						result		= VK_NULL_HANDLE;
+
+		type_info.sType			= VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+		type_info.semaphoreType	= VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+		type_info.initialValue	= 0;
+
+		info.sType	= VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		info.pNext	= &type_info;
+		info.flags	= 0;
+
+		VK_CHECK( _device.vkCreateSemaphore( _device.GetVkDevice(), &info, null, OUT &result ));
+		_device.SetObjectName( uint64_t(result), "QueueTimeline", VK_OBJECT_TYPE_SEMAPHORE );
+
+		return result;
+	#else
+		return VK_NULL_HANDLE;
+	#endif
+	}
+
 /*
 =================================================
 	Flush
@@ -842,18 +983,57 @@ namespace FG
 			for (size_t qi = 0; qi < _queueMap.size(); ++qi)
 			{
 				if ( _queueMap[qi].ptr and AllBits( queues, 1u<<qi ))
-					changed |= size_t(_FlushQueue( EQueueType(qi), 10u ));
+					changed |= size_t(_FlushQueue( EQueueType(qi) ));
 			}
 		}
 		return true;
 	}
 	
+/*
+=================================================
+	_FetchPendingBatches
+----
+	moves batches from lock-free queue to the ready list or
+	to the dependents list of the batches they depend on.
+=================================================
+*/
+	void  VFrameGraph::_FetchPendingBatches (QueueData &q)
+	{
+		VCmdBatchPtr	batch;
+
+		while ( q.pending.Pop( OUT batch ))
+		{
+			if ( batch->WaitForDependencies() )
+				q.ready.push_back( std::move(batch) );
+			else
+				++q.waiting;
+		}
+	}
+	
+/*
+=================================================
+	_AddReadyBatches
+=================================================
+*/
+	void  VFrameGraph::_AddReadyBatches (ArrayView<VCmdBatchPtr> batches)
+	{
+		for (auto& batch : batches)
+		{
+			auto&	q = _queueMap[ uint(batch->GetQueueType()) ];
+
+			ASSERT( q.waiting > 0 );
+			--q.waiting;
+
+			q.ready.push_back( batch );
+		}
+	}
+
 /*
 =================================================
 	_FlushQueue
 =================================================
 */
-	bool  VFrameGraph::_FlushQueue (EQueueType queueIndex, uint maxIter)
+	bool  VFrameGraph::_FlushQueue (EQueueType queueIndex)
 	{
 		const auto	start_time = TimePoint_t::clock::now();
 
@@ -867,45 +1047,33 @@ namespace FG
 		TempSemaphores_t	release_semaphores;
 		PendingSwapchains_t	swapchains;
 
-		// find batches that can be submitted
-		for (size_t b = 0, b_max = Min( maxIter, q.pending.size()), changed = 1;
-			 changed and (b < b_max);
-			 ++b)
-		{
-			changed = 0;
+		_FetchPendingBatches( q );
 
-			for (auto iter = q.pending.begin(); iter != q.pending.end();)
+		// take batches that can be submitted,
+		// batches from the same queue that depend on them are added to the end of the ready list
+		Array<VCmdBatchPtr>	ready_batches;
+		{
+			size_t	count = 0;
+			for (; count < q.ready.size() and pending.size() < pending.capacity(); ++count)
 			{
-				auto&		batch	 = *iter;
-				bool		is_ready = true;
-				EQueueUsage	q_mask2	 = Default;
+				VCmdBatchPtr	batch = std::move( q.ready[count] );
 
 				ASSERT( batch->GetState() == EBatchState::Backed );
 				
-				for (auto& dep : batch->GetDependencies())
-				{
-					const auto	min_state = (dep->GetQueueType() == queueIndex ? EBatchState::Ready : EBatchState::Submitted);
-
-					q_mask2		|= dep->GetQueueType();
-					is_ready	&= (dep->GetState() >= min_state);
+				for (auto& dep : batch->GetDependencies()) {
+					q_mask |= dep->GetQueueType();
 				}
 
-				if ( is_ready )
-				{
-					if ( pending.size() == pending.capacity() )
-						break;
-
-					wait_idle |= batch->IsQueueSyncRequired();
-					batch->OnReadyToSubmit();
-					pending.push_back( std::move(batch) );
-							
-					changed	= 1;
-					iter	= q.pending.erase( iter );
-					q_mask	|= q_mask2;
-				}
-				else
-					++iter;
+				wait_idle |= batch->IsQueueSyncRequired();
+				batch->OnReadyToSubmit();
+
+				batch->ReleaseDependents( OUT ready_batches );
+				_AddReadyBatches( ready_batches );
+				ready_batches.clear();
+
+				pending.push_back( std::move(batch) );
 			}
+			q.ready.erase( q.ready.begin(), q.ready.begin() + count );
 		}
 		
 		if ( pending.empty() )
@@ -915,30 +1083,53 @@ namespace FG
 		}
 
 		// add semaphores
-		for (size_t qj = 0; qj < _queueMap.size(); ++qj)
+		if ( q.timeline )
 		{
-			auto&	q2 = _queueMap[qj];
-
-			if ( not q2.ptr or qi == qj )
-				continue;
-			
-			// input
-			if ( AllBits( q_mask, 1u<<qj ) and q2.semaphores[qi] )
+			// wait for the last submission on the queues that these batches depend on
+			for (size_t qj = 0; qj < _queueMap.size(); ++qj)
 			{
-				pending.front()->WaitSemaphore( q2.semaphores[qi], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT );
-				release_semaphores.push_back( q2.semaphores[qi] );
-				q2.semaphores[qi] = VK_NULL_HANDLE;
+				auto&	q2 = _queueMap[qj];
+
+				if ( not q2.ptr or qi == qj or not AllBits( q_mask, 1u<<qj ))
+					continue;
+
+				if ( q2.timelineValue > q.waitedValues[qj] )
+				{
+					pending.front()->WaitSemaphore( q2.timeline, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, q2.timelineValue );
+					q.waitedValues[qj] = q2.timelineValue;
+				}
 			}
-						
-			// output
+
+			pending.back()->SignalSemaphore( q.timeline, ++q.timelineValue );
+		}
+		else
+		{
+			// binary semaphores for each pair of queues
+			for (size_t qj = 0; qj < _queueMap.size(); ++qj)
 			{
-				if ( q.semaphores[qj] )
-					release_semaphores.push_back( q.semaphores[qj] );
+				auto&	q2 = _queueMap[qj];
+
+				if ( not q2.ptr or qi == qj )
+					continue;
+			
+				// input
+				if ( AllBits( q_mask, 1u<<qj ) and q2.semaphores[qi] )
+				{
+					pending.front()->WaitSemaphore( q2.semaphores[qi], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT );
+					release_semaphores.push_back( q2.semaphores[qi] );
+					q2.semaphores[qi] = VK_NULL_HANDLE;
+				}
+						
+				// output
+				{
+					if ( q.semaphores[qj] )
+						release_semaphores.push_back( q.semaphores[qj] );
 
-				VkSemaphore	sem = _CreateSemaphore();
+					VkSemaphore	sem = _CreateSemaphore();
 
-				pending.back()->SignalSemaphore( sem );
-				q.semaphores[qj] = sem;
+					pending.back()->SignalSemaphore( sem );
+					q.semaphores[qj] = sem;
+				}
 			}
 		}
 
@@ -950,7 +1141,7 @@ namespace FG
 			if ( _submittedPool.Assign( OUT index, [](VSubmitted* ptr, uint idx) { PlacementNew<VSubmitted>( ptr, idx ); }) )
 			{
 				submit = &_submittedPool[index];
-				submit->Initialize( GetDevice(), EQueueType(qi), pending, release_semaphores );
+				submit->Initialize( GetDevice(), EQueueType(qi), pending, release_semaphores, q.timeline, (q.timeline ? q.timelineValue : 0) );
 				break;
 			}
 			
@@ -1016,17 +1207,18 @@ namespace FG
 			}
 		}
 
+		// batches from other queues that depend on submitted batches
+		for (auto& batch : pending) {
+			batch->ReleaseDependents( OUT ready_batches );
+		}
+		_AddReadyBatches( ready_batches );
+
 		// remove completed batches
-		for (auto iter = q.submitted.begin(); iter != q.submitted.end();)
+		for (auto iter = q.submitted.begin(); not _completion.enabled and iter != q.submitted.end();)
 		{
-			VSubmitted*	submitted	= *iter;
-			VkFence		fence		= submitted->GetFence();
-			bool		is_complete	= not fence;
+			VSubmitted*	submitted = *iter;
 
-			if ( fence and _device.vkGetFenceStatus( _device.GetVkDevice(), fence ) == VK_SUCCESS )
-				is_complete = true;
-
-			if ( is_complete )
+			if ( submitted->IsComplete( _device ))
 			{
 				{
 					EXLOCK( _statisticGuard );
@@ -1041,6 +1233,9 @@ namespace FG
 		}
 
 		q.submitted.push_back( submit );
+
+		if ( _completion.enabled )
+			_NotifyCompletionThread( submit );
 		
 		_resourceMngr.OnSubmit();
 		
@@ -1059,15 +1254,23 @@ namespace FG
 
 		const auto	start_time = TimePoint_t::clock::now();
 
+		// submissions are released by completion thread
+		if ( _completion.enabled )
+		{
+			bool	result = _WaitCompletionThread( commands, timeout );
+			_waitingTime.fetch_add( (TimePoint_t::clock::now() - start_time).count(), memory_order_relaxed );
+			return result;
+		}
+
 		EXLOCK( _queueGuard );
 
-		TempFences_t		tmp_fences;
+		TempWaitList		wait_list;
 		TempSubmitted_t		tmp_submitted;
 		bool				result = true;
 
-		const auto	WaitAndRelease = [this, &tmp_fences, &tmp_submitted, &result, timeout] ()
+		const auto	WaitAndRelease = [this, &wait_list, &tmp_submitted, &result, timeout] ()
 		{
-			auto  res = _device.vkWaitForFences( _device.GetVkDevice(), uint(tmp_fences.size()), tmp_fences.data(), VK_TRUE, uint64_t(timeout.count()) );
+			auto  res = wait_list.Wait( _device, timeout );
 
 			if ( res == VK_SUCCESS )
 			{
@@ -1084,7 +1287,6 @@ namespace FG
 				CHECK( res == VK_TIMEOUT );
 			}
 
-			tmp_fences.clear();
 			tmp_submitted.clear();
 		};
 
@@ -1102,27 +1304,20 @@ namespace FG
 			else
 			if ( state == EBatchState::Submitted )
 			{
-				auto	fence = submitted->GetFence();
-				bool	found = false;
+				ASSERT( submitted->GetFence() or submitted->GetTimeline() );
 
-				ASSERT( fence );
-
-				for (auto& f : tmp_fences) {
-					found |= (f == fence);
-				}
-
-				if ( not found )
+				if ( std::find( tmp_submitted.begin(), tmp_submitted.end(), submitted ) == tmp_submitted.end() )
 				{
-					tmp_fences.push_back( fence );
+					wait_list.Add( *submitted );
 					tmp_submitted.push_back( submitted );
 				}
 			}
 
-			if ( tmp_fences.size() == tmp_fences.capacity() )
+			if ( wait_list.IsFull() or tmp_submitted.size() == tmp_submitted.capacity() )
 				WaitAndRelease();
 		}
 
-		if ( tmp_fences.size() )
+		if ( not wait_list.Empty() )
 			WaitAndRelease();
 		
 		_waitingTime.fetch_add( (TimePoint_t::clock::now() - start_time).count(), memory_order_relaxed );
@@ -1138,19 +1333,17 @@ namespace FG
 	{
 		const auto		start_time	= TimePoint_t::clock::now();
 		bool			result		= true;
-		TempFences_t	tmp_fences;
+		TempWaitList	wait_list;
 		
-		const auto	WaitAndRelease = [this, &tmp_fences, &result, timeout] ()
+		const auto	WaitAndRelease = [this, &wait_list, &result, timeout] ()
 		{
-			auto  res = _device.vkWaitForFences( _device.GetVkDevice(), uint(tmp_fences.size()), tmp_fences.data(), VK_TRUE, uint64_t(timeout.count()) );
+			auto  res = wait_list.Wait( _device, timeout );
 
 			if ( res != VK_SUCCESS )
 			{
 				result = false;
 				CHECK( res == VK_TIMEOUT );
 			}
-
-			tmp_fences.clear();
 		};
 
 		// access to queues must be protected
@@ -1163,25 +1356,24 @@ namespace FG
 			{
 				auto&	q = _queueMap[i];
 
-				CHECK( q.pending.empty() );	// circular dependency
+				// 'Execute' doesn't lock '_queueGuard', so new batches may be added to 'pending' on another thread
+				CHECK( q.ready.empty() );
+				CHECK( q.waiting == 0 );	// circular dependency
 
 				for (auto& s : q.submitted)
 				{
-					if ( auto fence = s->GetFence() )
-					{
-						tmp_fences.push_back( fence );
+					wait_list.Add( *s );
 						
-						if ( tmp_fences.size() == tmp_fences.capacity() )
-							WaitAndRelease();
-					}
+					if ( wait_list.IsFull() )
+						WaitAndRelease();
 				}
 			}
 		
-			if ( tmp_fences.size() )
+			if ( not wait_list.Empty() )
 				WaitAndRelease();
 		
 			// clear queues
-			if ( result )
+			if ( result and not _completion.enabled )
 			{
 				EXLOCK( _statisticGuard );
 
@@ -1197,6 +1389,10 @@ namespace FG
 			}
 		}
 
+		// submissions are released by completion thread
+		if ( result and _completion.enabled )
+			result = _WaitCompletionThread( timeout );
+
 		_resourceMngr.RunValidation( 100 );
 
 		_waitingTime.fetch_add( (TimePoint_t::clock::now() - start_time).count(), memory_order_relaxed );
@@ -1234,6 +1430,243 @@ namespace FG
 		return true;
 	}
 
+/*
+=================================================
+	_StartCompletionThread
+=================================================
+*/
+	void  VFrameGraph::_StartCompletionThread ()
+	{
+		ASSERT( not _completion.thread.joinable() );
+
+		_completion.stop.store( false, memory_order_relaxed );
+		_completion.thread = std::thread{ [this] ()
+									{
+										SetCurrentThreadName( "FG_Completion" );
+										_CompletionLoop();
+									}};
+	}
+	
+/*
+=================================================
+	_StopCompletionThread
+=================================================
+*/
+	void  VFrameGraph::_StopCompletionThread ()
+	{
+		if ( not _completion.thread.joinable() )
+			return;
+
+		{
+			std::unique_lock	lock{ _completion.guard };
+			_completion.stop.store( true, memory_order_relaxed );
+		}
+		_completion.cv.notify_all();
+		_completion.thread.join();
+
+		ASSERT( _completion.pending.empty() );
+	}
+	
+/*
+=================================================
+	_NotifyCompletionThread
+=================================================
+*/
+	void  VFrameGraph::_NotifyCompletionThread (VSubmitted *submitted)
+	{
+		{
+			std::unique_lock	lock{ _completion.guard };
+			_completion.hasWork = true;
+
+			if ( submitted )
+				_completion.pending.push_back( submitted );
+		}
+		_completion.cv.notify_one();
+	}
+
+/*
+=================================================
+	_CompletionLoop
+----
+	waits for the oldest submission on each queue,
+	completed submissions are removed from queue and released by callback executor,
+	so 'ReadBuffer', 'ReadImage' and shader debug callbacks are not called on submitting thread.
+=================================================
+*/
+	void  VFrameGraph::_CompletionLoop ()
+	{
+		// timeout is used to check 'stop' flag
+		const Nanoseconds	timeout {10'000'000};
+		TempWaitList		wait_list;
+		TempSubmitted_t		completed;
+
+		for (; not _completion.stop.load( memory_order_relaxed );)
+		{
+			{
+				EXLOCK( _queueGuard );
+
+				for (auto& q : _queueMap)
+				{
+					if ( q.submitted.size() )
+						wait_list.Add( *q.submitted.front() );
+				}
+			}
+
+			// nothing to wait
+			if ( wait_list.Empty() )
+			{
+				std::unique_lock	lock{ _completion.guard };
+				_completion.cv.wait( lock, [this] () { return _completion.hasWork or _completion.stop.load( memory_order_relaxed ); });
+				_completion.hasWork = false;
+				continue;
+			}
+
+			// wait until any submission completes
+			{
+				auto	res = wait_list.Wait( _device, timeout, false );
+				CHECK( res == VK_SUCCESS or res == VK_TIMEOUT );
+
+				if ( res != VK_SUCCESS )
+					continue;
+			}
+
+			// submissions in queue complete in order
+			{
+				EXLOCK( _queueGuard );
+
+				for (auto& q : _queueMap)
+				{
+					auto	iter = q.submitted.begin();
+					for (; iter != q.submitted.end() and completed.size() < completed.capacity() and (*iter)->IsComplete( _device ); ++iter)
+					{
+						completed.push_back( *iter );
+					}
+					q.submitted.erase( q.submitted.begin(), iter );
+				}
+			}
+
+			for (auto* submitted : completed)
+			{
+				if ( _completion.executor )
+					_completion.executor( [this, submitted] () { _ReleaseSubmitted( submitted ); });
+				else
+					_ReleaseSubmitted( submitted );
+			}
+			completed.clear();
+		}
+	}
+	
+/*
+=================================================
+	_ReleaseSubmitted
+=================================================
+*/
+	void  VFrameGraph::_ReleaseSubmitted (VSubmitted *submitted)
+	{
+		{
+			EXLOCK( _statisticGuard );
+			submitted->Release( GetDevice(), _debugger, _shaderDebugCallback, INOUT _lastStatistic );
+		}
+		{
+			std::unique_lock	lock{ _completion.guard };
+
+			auto	iter = std::find( _completion.pending.begin(), _completion.pending.end(), submitted );
+			ASSERT( iter != _completion.pending.end() );
+
+			if ( iter != _completion.pending.end() )
+				_completion.pending.erase( iter );
+		}
+		_completion.released.notify_all();
+
+		_submittedPool.Unassign( submitted->GetIndexInPool() );
+	}
+	
+/*
+=================================================
+	_WaitCompletionThread
+----
+	waits until all submissions are released by completion thread.
+	Callback executor must not depend on current thread, otherwise it will deadlock.
+=================================================
+*/
+	bool  VFrameGraph::_WaitCompletionThread (Nanoseconds timeout)
+	{
+		const auto	end_time = TimePoint_t::clock::now() + timeout;
+
+		_NotifyCompletionThread();
+
+		std::unique_lock	lock{ _completion.guard };
+
+		if ( not _completion.released.wait_until( lock, end_time, [this] () { return _completion.pending.empty(); }))
+			return false;	// timeout
+
+		return true;
+	}
+	
+/*
+=================================================
+	_WaitCompletionThread
+----
+	waits until submissions that contain command buffers are released by completion thread,
+	so readback callbacks are called before return, but not on current thread.
+=================================================
+*/
+	bool  VFrameGraph::_WaitCompletionThread (ArrayView<CommandBuffer> commands, Nanoseconds timeout)
+	{
+		const auto		end_time = TimePoint_t::clock::now() + timeout;
+		TempSubmitted_t	tmp_submitted;
+		bool			wait_all = false;
+
+		// batch state and submission are changed only under '_queueGuard' lock
+		{
+			EXLOCK( _queueGuard );
+
+			for (auto& cmd : commands)
+			{
+				auto*	batch = Cast<VCmdBatch>(cmd.GetBatch());
+				if ( not batch or batch->GetState() != EBatchState::Submitted )
+					continue;
+
+				auto*	submitted = batch->GetSubmitted();
+
+				if ( std::find( tmp_submitted.begin(), tmp_submitted.end(), submitted ) != tmp_submitted.end() )
+					continue;
+
+				if ( tmp_submitted.size() == tmp_submitted.capacity() )
+				{
+					wait_all = true;
+					break;
+				}
+				tmp_submitted.push_back( submitted );
+			}
+		}
+
+		if ( wait_all )
+			return _WaitCompletionThread( timeout );
+
+		if ( tmp_submitted.empty() )
+			return true;
+
+		_NotifyCompletionThread();
+
+		std::unique_lock	lock{ _completion.guard };
+
+		const auto	IsReleased = [this, &tmp_submitted] ()
+		{
+			for (auto* submitted : tmp_submitted)
+			{
+				if ( std::find( _completion.pending.begin(), _completion.pending.end(), submitted ) != _completion.pending.end() )
+					return false;
+			}
+			return true;
+		};
+
+		if ( not _completion.released.wait_until( lock, end_time, IsReleased ))
+			return false;	// timeout
+
+		return true;
+	}
+
 /*
 =================================================
 	GetStatistics
@@ -1245,6 +1678,9 @@ namespace FG
 		EXLOCK( _statisticGuard );
 
 		result = _lastStatistic;
+		_pipelinePrewarmer.GetStatistics( INOUT result.resources );
+		_resourceMngr.GetStagingBufferManager().GetStatistics( INOUT result.resources );
+		_resourceMngr.GetMemoryManager().GetStatistics( OUT result.memory );
 		result.renderer.submitingTime   = Nanoseconds{_submitingTime.exchange( 0, memory_order_relaxed )};
 		result.renderer.waitingTime	 = Nanoseconds{_waitingTime.exchange( 0, memory_order_relaxed )};
 		
@@ -1306,6 +1742,11 @@ namespace FG
 
 		CHECK_ERR( q.cmdPool.Create( _device, q.ptr ));
 
+		if ( _device.GetFeatures().timelineSemaphore )
+		{
+			q.timeline = _CreateTimelineSemaphore();
+			CHECK_ERR( q.timeline );
+		}
 		return true;
 	}
 
@@ -1452,6 +1893,111 @@ namespace FG
 		return uint(type) < _queueMap.size() ? _queueMap[ uint(type) ].ptr : null;
 	}
 
+/*
+=================================================
+	SerializePipelineCache
+=================================================
+*/
+	bool  VFrameGraph::SerializePipelineCache (OUT Array<uint8_t> &data)
+	{
+		CHECK_ERR( _IsInitialized() );
+		EXLOCK( _pipelineCacheGuard );
+
+		return _pipelineCache.Serialize( _device, OUT data );
+	}
+	
+/*
+=================================================
+	DeserializePipelineCache
+=================================================
+*/
+	bool  VFrameGraph::DeserializePipelineCache (ArrayView<uint8_t> data)
+	{
+		CHECK_ERR( _IsInitialized() );
+		EXLOCK( _pipelineCacheGuard );
+
+		if ( not _pipelineCache.Deserialize( _device, data ))
+			return false;
+
+		// command buffers will update their caches in 'Begin'
+		_pipelineCacheVersion.fetch_add( 1, memory_order_relaxed );
+		return true;
+	}
+	
+/*
+=================================================
+	PrewarmPipeline
+=================================================
+*/
+	bool  VFrameGraph::PrewarmPipeline (RawGPipelineID pipeline, const RenderPassDesc &renderPass, const RenderState &renderState,
+										const VertexInputState &vertexInput, EPipelineDynamicState dynamicState)
+	{
+		CHECK_ERR( _IsInitialized() );
+
+		return _pipelinePrewarmer.Prewarm( pipeline, renderPass, renderState, vertexInput, dynamicState );
+	}
+	
+/*
+=================================================
+	UpdatePipelineCache
+----
+	creates command buffer local pipeline cache or
+	updates it if global cache was changed by 'DeserializePipelineCache'.
+=================================================
+*/
+	bool  VFrameGraph::UpdatePipelineCache (INOUT VPipelineCache &cache, INOUT uint &version)
+	{
+		const uint	curr_version = _pipelineCacheVersion.load( memory_order_relaxed );
+
+		if ( cache.IsCreated() and version == curr_version )
+			return true;
+
+		if ( not cache.IsCreated() )
+			CHECK_ERR( cache.Initialize( _device ));
+
+		EXLOCK( _pipelineCacheGuard );
+		CHECK_ERR( cache.MergeCache( _device, INOUT _pipelineCache ));
+
+		version = curr_version;
+		return true;
+	}
+	
+/*
+=================================================
+	MergePipelineCache
+=================================================
+*/
+	bool  VFrameGraph::MergePipelineCache (INOUT VPipelineCache &cache)
+	{
+		if ( not cache.IsCreated() or not cache.HasNewPipelines() )
+			return true;
+
+		EXLOCK( _pipelineCacheGuard );
+		CHECK_ERR( _pipelineCache.IsCreated() );
+
+		return _pipelineCache.MergeCache( _device, INOUT cache );
+	}
+
+/*
+=================================================
+	GetWorkerPool
+----
+	threads are created on first use,
+	current thread participates in jobs too.
+=================================================
+*/
+	WorkerPool&  VFrameGraph::GetWorkerPool ()
+	{
+		std::call_once( _workerPoolInit, [this] ()
+			{
+				const uint	hw_threads	= Max( 1u, std::thread::hardware_concurrency() );
+				const uint	count		= Min( hw_threads, FG_MaxSecondaryCmdBuffers ) - 1;
+
+				CHECK( _workerPool.Start( count, "FG_Recording" ));
+			});
+		return _workerPool;
+	}
+
 /*
 =================================================
 	_GetQueuesMask
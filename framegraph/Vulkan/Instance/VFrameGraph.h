@@ -7,7 +7,10 @@
 #include "VDevice.h"
 #include "VCmdBatch.h"
 #include "VDebugger.h"
-#include "stl/ThreadSafe/LfIndexedPool.h"
+#include "VPipelinePrewarmer.h"
+#include "stl/ThreadSafe/LfGrowableIndexedPool.h"
+#include "stl/ThreadSafe/LfMPSCQueue.h"
+#include "stl/ThreadSafe/WorkerPool.h"
 
 namespace FG
 {
@@ -19,6 +22,9 @@ namespace FG
 	class VFrameGraph final : public IFrameGraph
 	{
 	// types
+	public:
+		static constexpr uint	MaxQueryBatches	= 2048;		// batches with greater index in pool don't measure GPU time
+
 	private:
 		enum class EState : uint
 		{
@@ -30,6 +36,13 @@ namespace FG
 		
 		using EBatchState		= VCmdBatch::EState;
 		using PerQueueSem_t		= StaticArray< VkSemaphore, uint(EQueueType::_Count) >;
+		using PerQueueValue_t	= StaticArray< uint64_t, uint(EQueueType::_Count) >;
+		
+		// pools grow on demand, first directory page is enough for typical frame
+		using CmdBufferPool_t	= LfGrowableIndexedPool< VCommandBuffer, uint, 32, 4 >;
+		using CmdBatchPool_t	= LfGrowableIndexedPool< VCmdBatch, uint, 32, 16 >;
+		using SubmittedPool_t	= LfGrowableIndexedPool< VSubmitted, uint, 32, 8 >;
+		using PendingQueue_t	= LfMPSCQueue< VCmdBatchPtr, 1024 >;	// when overflowed 'Execute' moves batches to the ready list under lock
 
 		struct QueueData
 		{
@@ -38,20 +51,23 @@ namespace FG
 			EQueueType					type			= Default;
 
 		// mutable data
-			Array<VCmdBatchPtr>			pending;		// TODO: circular queue
+			PendingQueue_t				pending;		// batches from 'Execute', lock-free
+			Array<VCmdBatchPtr>			ready;			// batches that can be submitted
+			uint						waiting			= 0;	// number of batches that are waiting for dependencies
 			Array<VSubmitted *>			submitted;
-			PerQueueSem_t				semaphores		{};
+			PerQueueSem_t				semaphores		{};		// binary semaphores, used if timeline semaphores are not supported
+			VkSemaphore					timeline		= VK_NULL_HANDLE;
+			uint64_t					timelineValue	= 0;	// last value that will be signaled by submitted batches
+			PerQueueValue_t				waitedValues	{};		// last values of other queues timeline that this queue waits for
 
 			VCommandPool				cmdPool;
 			Array<VkImageMemoryBarrier>	imageBarriers;
 		};
 
-		using CmdBufferPool_t	= LfIndexedPool< VCommandBuffer, uint, 32, 4 >;
-		using CmdBatchPool_t	= LfIndexedPool< VCmdBatch, uint, 32, 16 >;
-		using SubmittedPool_t	= LfIndexedPool< VSubmitted, uint, 32, 8 >;
 		using QueueMap_t		= StaticArray< QueueData, uint(EQueueType::_Count) >;
 		using Fences_t			= Array< VkFence >;
 		using Semaphores_t		= Array< VkSemaphore >;
+		using CallbackExecutor_t= VulkanDeviceInfo::CallbackExecutor_t;
 
 
 	// variables
@@ -60,10 +76,11 @@ namespace FG
 
 		VDevice					_device;
 
-		Mutex					_queueGuard;		// TODO: remove global lock
+		Mutex					_queueGuard;		// used only for submission, 'Execute' doesn't lock it
 		QueueMap_t				_queueMap;
 		EQueueUsage				_queueUsage;
 
+		VCommandPoolManager		_cmdPoolMngr;
 		CmdBufferPool_t			_cmdBufferPool;
 		CmdBatchPool_t			_cmdBatchPool;
 		SubmittedPool_t			_submittedPool;
@@ -74,6 +91,26 @@ namespace FG
 
 		ShaderDebugCallback_t	_shaderDebugCallback;
 
+		Mutex					_pipelineCacheGuard;
+		VPipelineCache			_pipelineCache;		// global cache, per command buffer caches are merged into it
+		Atomic<uint>			_pipelineCacheVersion	{0};
+		VPipelinePrewarmer		_pipelinePrewarmer;
+
+		WorkerPool				_workerPool;		// for parallel command recording
+		std::once_flag			_workerPoolInit;
+
+		struct {
+			std::thread					thread;
+			Mutex						guard;
+			std::condition_variable		cv;
+			std::condition_variable		released;				// notified by '_ReleaseSubmitted'
+			bool						hasWork		= false;	// protected by 'guard'
+			Atomic<bool>				stop		{false};
+			Array<VSubmitted *>			pending;				// submitted but not released yet, protected by 'guard'
+			CallbackExecutor_t			executor;
+			bool						enabled		= false;
+		}						_completion;
+
 		mutable Mutex			_statisticGuard;
 		mutable Statistics		_lastStatistic;
 
@@ -111,6 +148,7 @@ namespace FG
 		RTGeometryID	CreateRayTracingGeometry (const RayTracingGeometryDesc &desc, const MemoryDesc &mem, StringView dbgName) override;
 		RTSceneID		CreateRayTracingScene (const RayTracingSceneDesc &desc, const MemoryDesc &mem, StringView dbgName) override;
 		RTShaderTableID	CreateRayTracingShaderTable (StringView dbgName) override;
+		bool			CreateMemoryPool (const MemPoolID &id, const MemoryPoolDesc &desc) override;
 		bool			InitPipelineResources (RawGPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) override;
 		bool			InitPipelineResources (RawCPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) override;
 		bool			InitPipelineResources (RawMPipelineID pplnId, const DescriptorSetID &id, OUT PipelineResources &resources) override;
@@ -128,6 +166,10 @@ namespace FG
 		bool			ReleaseResource (INOUT RTGeometryID &id) override;
 		bool			ReleaseResource (INOUT RTSceneID &id) override;
 		bool			ReleaseResource (INOUT RTShaderTableID &id) override;
+		bool			SerializePipelineCache (OUT Array<uint8_t> &data) override;
+		bool			DeserializePipelineCache (ArrayView<uint8_t> data) override;
+		bool			PrewarmPipeline (RawGPipelineID pipeline, const RenderPassDesc &renderPass, const RenderState &renderState,
+										 const VertexInputState &vertexInput, EPipelineDynamicState dynamicState) override;
 		
 		bool			IsSupported (RawImageID image, const ImageViewDesc &desc) const override;
 		bool			IsSupported (RawBufferID buffer, const BufferViewDesc &desc) const override;
@@ -212,7 +254,12 @@ namespace FG
 		ND_ VDeviceQueueInfoPtr	FindQueue (EQueueType type) const;
 		ND_ VDevice const&		GetDevice ()				const	{ return _device; }
 		ND_ VResourceManager &	GetResourceManager ()				{ return _resourceMngr; }
+		ND_ VCommandPoolManager&GetCommandPoolManager ()			{ return _cmdPoolMngr; }
 		ND_ VkQueryPool			GetQueryPool ()				const	{ return _queryPool; }
+		ND_ WorkerPool &		GetWorkerPool ();
+
+		bool  UpdatePipelineCache (INOUT VPipelineCache &cache, INOUT uint &version);
+		bool  MergePipelineCache (INOUT VPipelineCache &cache);
 
 
 	private:
@@ -226,6 +273,7 @@ namespace FG
 		void  _TransitImageLayoutToDefault (RawImageID imageId, VkImageLayout initialLayout, uint queueFamily);
 
 		ND_ VkSemaphore	 _CreateSemaphore ();
+		ND_ VkSemaphore	 _CreateTimelineSemaphore ();
 
 
 		// queues //
@@ -240,10 +288,22 @@ namespace FG
 
 			bool  _TryFlush (const VCmdBatchPtr &batch);
 			bool  _FlushAll (EQueueUsage queues, uint maxIter);
-			bool  _FlushQueue (EQueueType queue, uint maxIter);
+			bool  _FlushQueue (EQueueType queue);
+			void  _FetchPendingBatches (QueueData &q);
+			void  _AddReadyBatches (ArrayView<VCmdBatchPtr> batches);
 			bool  _WaitQueue (EQueueType queue, Nanoseconds timeout);
 
 
+		// completion thread //
+			void  _StartCompletionThread ();
+			void  _StopCompletionThread ();
+			void  _CompletionLoop ();
+			void  _NotifyCompletionThread (VSubmitted *submitted = null);
+			void  _ReleaseSubmitted (VSubmitted *);
+			bool  _WaitCompletionThread (Nanoseconds timeout);
+			bool  _WaitCompletionThread (ArrayView<CommandBuffer> commands, Nanoseconds timeout);
+
+
 		// states //
 		ND_ bool	_IsInitialized () const;
 		ND_ EState	_GetState () const;
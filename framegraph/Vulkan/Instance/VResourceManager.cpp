@@ -57,15 +57,67 @@ namespace FG
 	constructor
 =================================================
 */
-	VResourceManager::VResourceManager (const VDevice &dev, BytesU maxStagingBufferMemory, BytesU stagingBufferSize) :
+	VResourceManager::VResourceManager (const VDevice &dev, BytesU maxStagingBufferMemory, BytesU stagingBufferSize,
+										const VulkanDeviceInfo::ResourcePoolLimits &limits) :
 		_device{ dev },
 		_memoryMngr{ dev },
 		_descMngr{ dev },
+		_stagingMngr{ *this },
 		_submissionCounter{ 0 }
 	{
 		_staging.maxStagingBufferMemory = maxStagingBufferMemory < 1_Mb ? ~0_b : maxStagingBufferMemory;
 		_staging.writeBufPageSize		= stagingBufferSize < 1_Kb ? 0_b : stagingBufferSize;
 		_staging.readBufPageSize		= _staging.writeBufPageSize;
+
+		_SetPoolLimits( limits );
+	}
+	
+/*
+=================================================
+	_SetPoolLimits
+----
+	pools allocate chunks on demand,
+	so only max number of chunks is changed.
+=================================================
+*/
+	void  VResourceManager::_SetPoolLimits (const VulkanDeviceInfo::ResourcePoolLimits &limits)
+	{
+		const uint	images		= limits.images			 ? limits.images			: FG_MaxImages;
+		const uint	buffers		= limits.buffers		 ? limits.buffers			: FG_MaxBuffers;
+		const uint	mem_objs	= limits.memoryObjects	 ? limits.memoryObjects		: FG_MaxMemoryObjects;
+		const uint	cached		= limits.cachedObjects	 ? limits.cachedObjects		: FG_MaxCachedObjects;
+		const uint	rt_objs		= limits.rayTracingObjects ? limits.rayTracingObjects : FG_MaxRayTracingObjects;
+
+		_imagePool.SetCapacity( images );
+		_bufferPool.SetCapacity( buffers );
+		_memoryObjPool.SetCapacity( mem_objs );
+		_samplerCache.SetCapacity( cached );
+		_graphicsPplnPool.SetCapacity( cached );
+		_computePplnPool.SetCapacity( cached );
+		_pplnLayoutCache.SetCapacity( cached );
+		_dsLayoutCache.SetCapacity( cached );
+		_pplnResourcesCache.SetCapacity( cached );
+		_renderPassCache.SetCapacity( cached );
+		_framebufferCache.SetCapacity( cached );
+		
+		#ifdef VK_NV_mesh_shader
+		_meshPplnPool.SetCapacity( cached );
+		#endif
+
+		#ifdef VK_NV_ray_tracing
+		_rayTracingPplnPool.SetCapacity( cached );
+		_rtGeometryPool.SetCapacity( rt_objs );
+		_rtScenePool.SetCapacity( rt_objs );
+		_rtShaderTablePool.SetCapacity( rt_objs );
+		#else
+		Unused( rt_objs );
+		#endif
+
+		if ( images > ImagePool_t::MaxCapacity() or buffers > BufferPool_t::MaxCapacity() or mem_objs > MemoryPool_t::MaxCapacity() or
+			 cached > GPipelinePool_t::MaxCapacity() or rt_objs > RTGeometryPool_t::MaxCapacity() )
+		{
+			FG_LOGI( "some resource pool limits are greater than max supported and will be clamped" );
+		}
 	}
 	
 /*
@@ -90,6 +142,7 @@ namespace FG
 		_CreateEmptyDescriptorSetLayout();
 		_CheckHostVisibleMemory();
 
+		CHECK_ERR( _stagingMngr.Initialize( _staging.writeBufPageSize, _staging.maxStagingBufferMemory ));
 		return true;
 	}
 	
@@ -100,7 +153,7 @@ namespace FG
 */
 	void  VResourceManager::Deinitialize ()
 	{
-		_DestroyStagingBuffers();
+		_stagingMngr.Deinitialize();
 		_DestroyShaderDebuggerResources();
 
 		_DestroyResourceCache( INOUT _samplerCache );
@@ -129,6 +182,7 @@ namespace FG
 			_compilers.clear();
 		}
 		
+		_DestroyTransientHeaps();
 		_descMngr.Deinitialize();
 		_memoryMngr.Deinitialize();
 	}
@@ -154,6 +208,93 @@ namespace FG
 		_submissionCounter.fetch_add( 1, memory_order_relaxed );
 	}
 	
+/*
+=================================================
+	AcquireTransientHeap
+----
+	returns the smallest free heap that is big enough,
+	new heap is allocated only if there is no such heap.
+=================================================
+*/
+	bool  VResourceManager::AcquireTransientHeap (uint memTypeIndex, BytesU size, OUT TransientHeap &heap, OUT bool &isNew)
+	{
+		CHECK_ERR( memTypeIndex < _freeTransientHeaps.size() );
+		{
+			EXLOCK( _transientHeapGuard );
+
+			auto&	heaps	= _freeTransientHeaps[ memTypeIndex ];
+			auto	iter	= std::lower_bound( heaps.begin(), heaps.end(), size, [] (auto& lhs, BytesU rhs) { return lhs.size < rhs; });
+
+			if ( iter != heaps.end() )
+			{
+				heap  = *iter;
+				isNew = false;
+				heaps.erase( iter );
+				return true;
+			}
+		}
+
+		VkMemoryAllocateInfo	info = {};
+		info.sType				= VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		info.allocationSize		= VkDeviceSize( size );
+		info.memoryTypeIndex	= memTypeIndex;
+
+		heap.size			= size;
+		heap.memTypeIndex	= memTypeIndex;
+		isNew				= true;
+		VK_CHECK( _device.vkAllocateMemory( _device.GetVkDevice(), &info, null, OUT &heap.memory ));
+		return true;
+	}
+	
+/*
+=================================================
+	ReleaseTransientHeaps
+----
+	memory must not be used by any resource.
+=================================================
+*/
+	void  VResourceManager::ReleaseTransientHeaps (ArrayView<TransientHeap> heaps)
+	{
+		if ( heaps.empty() )
+			return;
+
+		EXLOCK( _transientHeapGuard );
+
+		for (auto& heap : heaps)
+		{
+			ASSERT( heap.memory != VK_NULL_HANDLE );
+			auto&	dst		= _freeTransientHeaps[ heap.memTypeIndex ];
+			auto	iter	= std::lower_bound( dst.begin(), dst.end(), heap.size, [] (auto& lhs, BytesU rhs) { return lhs.size < rhs; });
+
+			dst.insert( iter, heap );
+
+			// free the smallest heap, it is least likely to be reused
+			if ( dst.size() > MaxFreeTransientHeaps )
+			{
+				_device.vkFreeMemory( _device.GetVkDevice(), dst.front().memory, null );
+				dst.erase( dst.begin() );
+			}
+		}
+	}
+	
+/*
+=================================================
+	_DestroyTransientHeaps
+=================================================
+*/
+	void  VResourceManager::_DestroyTransientHeaps ()
+	{
+		EXLOCK( _transientHeapGuard );
+
+		for (auto& heaps : _freeTransientHeaps)
+		{
+			for (auto& heap : heaps) {
+				_device.vkFreeMemory( _device.GetVkDevice(), heap.memory, null );
+			}
+			heaps.clear();
+		}
+	}
+
 /*
 =================================================
 	_DestroyResourceCache
@@ -1066,6 +1207,14 @@ namespace FG
 										[&] (auto& data) { return data.Create( _device, dbgName ); });
 	}
 	
+	RawRenderPassID  VResourceManager::CreateRenderPass (ArrayView<VLogicalRenderPass::ColorTarget> colorTargets,
+														 const VLogicalRenderPass::DepthStencilTarget &depthStencilTarget, StringView dbgName)
+	{
+		return _CreateCachedResource<RawRenderPassID>( "failed when creating render pass",
+										[&] (auto& data) { Replace( data, colorTargets, depthStencilTarget ); },
+										[&] (auto& data) { return data.Create( _device, dbgName ); });
+	}
+	
 	RawFramebufferID  VResourceManager::CreateFramebuffer (ArrayView<Pair<RawImageID, ImageViewDesc>> attachments,
 														   RawRenderPassID rp, uint2 dim, uint layers, StringView dbgName)
 	{
@@ -1088,9 +1237,13 @@ namespace FG
 /*
 =================================================
 	CreateDescriptorSet
+----
+	if 'deferredUpdates' is not null then descriptor set update
+	may be postponed until 'VPipelineResources::FlushUpdates' call.
 =================================================
 */
-	VPipelineResources const*  VResourceManager::CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &resourceMap)
+	VPipelineResources const*  VResourceManager::CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &resourceMap,
+																	  Array<VPipelineResources const*> *deferredUpdates)
 	{
 		using Resource_t = VCmdBatch::Resource;
 
@@ -1107,7 +1260,7 @@ namespace FG
 					res.AddRef();
 				
 				ASSERT( res.Data().IsAllResourcesAlive( *this ));
-				return &res.Data();
+				return _FlushDescriptorSet( res.Data(), deferredUpdates );
 			}
 		}
 	
@@ -1119,7 +1272,7 @@ namespace FG
 		id = _CreateCachedResource<RawPipelineResourcesID>( "failed when creating descriptor set",
 								   [&] (auto& data) { return Replace( data, desc ); },
 								   [&] (auto& data) {
-										if (data.Create( *this )) {
+										if (data.Create( *this, deferredUpdates != null )) {
 											layout.AddRef();
 											_validation.createdPplnResources.fetch_add( 1, memory_order_relaxed );
 											return true;
@@ -1137,11 +1290,31 @@ namespace FG
 				res.AddRef();
 
 			ASSERT( res.Data().IsAllResourcesAlive( *this ));
-			return &res.Data();
+			return _FlushDescriptorSet( res.Data(), deferredUpdates );
 		}
 		return null;
 	}
 	
+/*
+=================================================
+	_FlushDescriptorSet
+----
+	descriptor set from cache may be created by another command buffer
+	and still not updated.
+=================================================
+*/
+	VPipelineResources const*  VResourceManager::_FlushDescriptorSet (const VPipelineResources &res, Array<VPipelineResources const*> *deferredUpdates)
+	{
+		if ( res.IsUpdatePending() )
+		{
+			if ( deferredUpdates )
+				deferredUpdates->push_back( &res );
+			else
+				res.FlushUpdate( _device );
+		}
+		return &res;
+	}
+	
 /*
 =================================================
 	CacheDescriptorSet
@@ -1423,7 +1596,6 @@ namespace FG
 		auto&	props	= dev.GetProperties().memoryProperties;
 		
 		VkMemoryRequirements	transfer_mem_req = {};
-		VkMemoryRequirements	uniform_mem_req  = {};
 		{
 			VkBuffer			id;
 			VkBufferCreateInfo	info = {};
@@ -1439,18 +1611,10 @@ namespace FG
 			VK_CHECK( dev.vkCreateBuffer( dev.GetVkDevice(), &info, null, OUT &id ));
 			dev.vkGetBufferMemoryRequirements( dev.GetVkDevice(), id, OUT &transfer_mem_req );
 			dev.vkDestroyBuffer( dev.GetVkDevice(), id, null );
-			
-			info.size  = 256;
-			info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-
-			VK_CHECK( dev.vkCreateBuffer( dev.GetVkDevice(), &info, null, OUT &id ));
-			dev.vkGetBufferMemoryRequirements( dev.GetVkDevice(), id, OUT &uniform_mem_req );
-			dev.vkDestroyBuffer( dev.GetVkDevice(), id, null );
 		}
 
 		BitSet<VK_MAX_MEMORY_HEAPS>		cached_heaps;
 		BitSet<VK_MAX_MEMORY_HEAPS>		cocherent_heaps;
-		BitSet<VK_MAX_MEMORY_HEAPS>		uniform_heaps;
 
 		for (uint i = 0; i < props.memoryTypeCount; ++i)
 		{
@@ -1464,167 +1628,34 @@ namespace FG
 				if ( AllBits( mt.propertyFlags, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT ))
 					cocherent_heaps[ mt.heapIndex ] = true;
 			}
-
-			if ( AllBits( uniform_mem_req.memoryTypeBits, 1u << i ) and
-				 AllBits( mt.propertyFlags, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT ))
-			{
-				uniform_heaps[ mt.heapIndex ] = true;
-			}
 		}
 
-		BytesU	uniform_heap_size;
 		BytesU	transfer_heap_size;
 
 		for (uint i = 0; i < props.memoryHeapCount; ++i)
 		{
-			if ( uniform_heaps[i] )
-				uniform_heap_size += props.memoryHeaps[i].size;
-
 			if ( cached_heaps[i] or cocherent_heaps[i] )
 				transfer_heap_size += props.memoryHeaps[i].size;
 		}
 
 		_staging.maxStagingBufferMemory = Min( transfer_heap_size * 4 / 5, _staging.maxStagingBufferMemory );
 
-		BytesU	un_size = uniform_heap_size  / StagingBufferfPool_t::Capacity();
-		BytesU	tr_size = _staging.maxStagingBufferMemory / StagingBufferfPool_t::Capacity();
-
-		if ( un_size > 128_Mb )		un_size = 32_Mb;	else
-		if ( un_size > 64_Mb )		un_size = 16_Mb;	else
-									un_size = 8_Mb;
-		_staging.uniformBufPageSize = un_size;
+		// each ring buffer contains 'BlocksPerRing' blocks, ring buffers are created on demand
+		BytesU	tr_size = _staging.maxStagingBufferMemory / (VStagingBufferManager::RingCount * VStagingBufferManager::BlocksPerRing);
 
-		if ( tr_size > 256_Mb )		tr_size = 128_Mb;	else
-		if ( tr_size > 128_Mb )		tr_size = 64_Mb;	else
-									tr_size = 32_Mb;
+		if ( tr_size > 64_Mb )		tr_size = 16_Mb;	else
+		if ( tr_size > 32_Mb )		tr_size = 8_Mb;		else
+									tr_size = 4_Mb;
 
 		if ( _staging.writeBufPageSize == 0_b )
 			_staging.writeBufPageSize = _staging.readBufPageSize = tr_size;
 
-		FG_LOGD( "Uniform buffer size:       "s << ToString( _staging.uniformBufPageSize ));
-		FG_LOGD( "Staging buffer size:       "s << ToString( _staging.writeBufPageSize ));
+		FG_LOGD( "Staging buffer block size: "s << ToString( _staging.writeBufPageSize ));
 		FG_LOGD( "Max staging buffer memory: "s << ToString( _staging.maxStagingBufferMemory ) << ", max available: " << ToString( transfer_heap_size ));
 
 		return true;
 	}
 
-/*
-=================================================
-	CreateStagingBuffer
-=================================================
-*/
-	bool  VResourceManager::CreateStagingBuffer (EBufferUsage usage, OUT RawBufferID &outBufferId, OUT StagingBufferIdx &outIndex)
-	{
-		BufferDesc				desc;
-		EMemoryType				mem_type;
-		StagingBufferfPool_t*	pool		= null;
-		uint					idx_mask	= 0;
-		const char *			name		= "";
-		desc.usage = usage;
-
-		switch ( usage )
-		{
-			case EBufferUsage::TransferSrc :
-				pool		= &_staging.write;
-				desc.size	= _staging.writeBufPageSize;
-				mem_type	= EMemoryType::HostWrite;
-				idx_mask	= 1u << 30;
-				name		= "HostWriteBuffer";
-				break;
-
-			case EBufferUsage::TransferDst :
-				pool		= &_staging.read;
-				desc.size	= _staging.readBufPageSize;
-				mem_type	= EMemoryType::HostRead;
-				idx_mask	= 2u << 30;
-				name		= "HostReadBuffer";
-				break;
-
-			case EBufferUsage::Uniform :
-				pool		= &_staging.uniform;
-				desc.size	= _staging.uniformBufPageSize;
-				mem_type	= EMemoryType::HostWrite;
-				idx_mask	= 3u << 30;
-				name		= "HostUniformBuffer";
-				break;
-
-			default :
-				RETURN_ERR( "unsupported buffer usage" );
-		}
-
-		const auto	ctor = [this, name, mem_type, &desc] (BufferID *ptr, uint)
-		{
-			if ( AnyBits( mem_type, EMemoryType::HostRead | EMemoryType::HostWrite ))
-			{
-				BytesU	total_size = BytesU{ _staging.currStagingBufferMemory.fetch_add( uint64_t(desc.size), memory_order_relaxed )} + desc.size;
-				
-				if ( total_size > _staging.maxStagingBufferMemory )
-					FG_LOGE( "Exceeded the maximum memory size for staging buffer" );
-
-				FG_LOGD( "Used host memory for staging buffers: "s << ToString(total_size) );
-			}
-
-			RawBufferID	id = CreateBuffer( desc, MemoryDesc{ mem_type }, EQueueFamilyMask::Unknown, name );
-			CHECK( id );
-			PlacementNew< BufferID >( ptr, id );
-		};
-		
-
-		uint	index;
-		CHECK_ERR( pool->Assign( OUT index, ctor ));
-		
-		outBufferId = (*pool)[ index ];
-		CHECK_ERR( outBufferId );
-
-		outIndex = StagingBufferIdx(index | idx_mask);
-		return true;
-	}
-	
-/*
-=================================================
-	ReleaseStagingBuffer
-=================================================
-*/
-	void  VResourceManager::ReleaseStagingBuffer (StagingBufferIdx index)
-	{
-		const uint	idx = uint(index) & ~(3u << 30);
-
-		switch ( uint(index) >> 30 )
-		{
-			case 1 :
-				_staging.write.Unassign( idx );
-				break;
-
-			case 2 :
-				_staging.read.Unassign( idx );
-				break;
-				
-			case 3 :
-				_staging.uniform.Unassign( idx );
-				break;
-
-			default :
-				CHECK( !"something goes wrong!" );
-				break;
-		}
-	}
-	
-/*
-=================================================
-	_DestroyStagingBuffers
-=================================================
-*/
-	void  VResourceManager::_DestroyStagingBuffers ()
-	{
-		const auto	dtor = [this] (BufferID &id)
-		{
-			ReleaseResource( id.Release() );
-		};
-
-		_staging.write.Release( dtor );
-		_staging.read.Release( dtor );
-	}
-	
 /*
 =================================================
 	_CreateFindMaxValuePipeline1
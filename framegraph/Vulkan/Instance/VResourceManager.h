@@ -8,7 +8,6 @@
 #include "stl/Memory/LinearAllocator.h"
 #include "stl/Containers/ChunkedIndexedPool.h"
 #include "stl/Containers/CachedIndexedPool.h"
-#include "stl/ThreadSafe/LfIndexedPool.h"
 #include "VBuffer.h"
 #include "VImage.h"
 #include "VSampler.h"
@@ -18,6 +17,7 @@
 #include "VFramebuffer.h"
 #include "VPipelineResources.h"
 #include "VRayTracingGeometry.h"
+#include "VStagingBufferManager.h"
 #include "VRayTracingScene.h"
 #include "VRayTracingShaderTable.h"
 #include "VSwapchain.h"
@@ -46,38 +46,43 @@ namespace FG
 		template <typename T, size_t ChunkSize, size_t MaxChunks>
 		using CachedPoolTmpl	= CachedIndexedPool< T, Index_t, ChunkSize, MaxChunks, UntypedAlignedAllocator, AssignOpGuard_t, CacheGuard_t, AtomicPtr >;
 
+		// chunk sizes, number of chunks is limited by index type (UMax is invalid index),
+		// actual pool capacity is set in constructor, see 'VulkanDeviceInfo::ResourcePoolLimits'
 		static constexpr uint	MaxImages		= 1u << 10;
 		static constexpr uint	MaxBuffers		= 1u << 10;
 		static constexpr uint	MaxMemoryObjs	= 1u << 10;
 		static constexpr uint	MaxCached		= 1u <<  9;
 		static constexpr uint	MaxRTObjects	= 1u <<  9;
 
-		using ImagePool_t			= PoolTmpl<			ResourceBase<VImage>,					MaxImages,		32 >;
-		using BufferPool_t			= PoolTmpl<			ResourceBase<VBuffer>,					MaxBuffers,		32 >;
-		using MemoryPool_t			= PoolTmpl<			ResourceBase<VMemoryObj>,				MaxMemoryObjs,	63 >;
-		using SamplerPool_t			= CachedPoolTmpl<	ResourceBase<VSampler>,					MaxCached,		 8 >;
-		using GPipelinePool_t		= PoolTmpl<			ResourceBase<VGraphicsPipeline>,		MaxCached,		 8 >;
-		using CPipelinePool_t		= PoolTmpl<			ResourceBase<VComputePipeline>,			MaxCached,		 8 >;
-		using MPipelinePool_t		= PoolTmpl<			ResourceBase<VMeshPipeline>,			MaxCached,		 8 >;
-		using RTPipelinePool_t		= PoolTmpl<			ResourceBase<VRayTracingPipeline>,		MaxCached,		 8 >;
-		using PplnLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VPipelineLayout>,			MaxCached,		 8 >;
-		using DSLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VDescriptorSetLayout>,		MaxCached,		 8 >;
-		using RenderPassPool_t		= CachedPoolTmpl<	ResourceBase<VRenderPass>,				MaxCached,		 8 >;
-		using FramebufferPool_t		= CachedPoolTmpl<	ResourceBase<VFramebuffer>,				MaxCached,		 8 >;
-		using PplnResourcesPool_t	= CachedPoolTmpl<	ResourceBase<VPipelineResources>,		MaxCached,		 8 >;
-		using RTGeometryPool_t		= PoolTmpl<			ResourceBase<VRayTracingGeometry>,		MaxRTObjects,	16 >;
-		using RTScenePool_t			= PoolTmpl<			ResourceBase<VRayTracingScene>,			MaxRTObjects,	16 >;
-		using RTShaderTablePool_t	= PoolTmpl<			ResourceBase<VRayTracingShaderTable>,	MaxRTObjects,	16 >;
+		using ImagePool_t			= PoolTmpl<			ResourceBase<VImage>,					MaxImages,		 63 >;
+		using BufferPool_t			= PoolTmpl<			ResourceBase<VBuffer>,					MaxBuffers,		 63 >;
+		using MemoryPool_t			= PoolTmpl<			ResourceBase<VMemoryObj>,				MaxMemoryObjs,	 63 >;
+		using SamplerPool_t			= CachedPoolTmpl<	ResourceBase<VSampler>,					MaxCached,		127 >;
+		using GPipelinePool_t		= PoolTmpl<			ResourceBase<VGraphicsPipeline>,		MaxCached,		127 >;
+		using CPipelinePool_t		= PoolTmpl<			ResourceBase<VComputePipeline>,			MaxCached,		127 >;
+		using MPipelinePool_t		= PoolTmpl<			ResourceBase<VMeshPipeline>,			MaxCached,		127 >;
+		using RTPipelinePool_t		= PoolTmpl<			ResourceBase<VRayTracingPipeline>,		MaxCached,		127 >;
+		using PplnLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VPipelineLayout>,			MaxCached,		127 >;
+		using DSLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VDescriptorSetLayout>,		MaxCached,		127 >;
+		using RenderPassPool_t		= CachedPoolTmpl<	ResourceBase<VRenderPass>,				MaxCached,		127 >;
+		using FramebufferPool_t		= CachedPoolTmpl<	ResourceBase<VFramebuffer>,				MaxCached,		127 >;
+		using PplnResourcesPool_t	= CachedPoolTmpl<	ResourceBase<VPipelineResources>,		MaxCached,		127 >;
+		using RTGeometryPool_t		= PoolTmpl<			ResourceBase<VRayTracingGeometry>,		MaxRTObjects,	127 >;
+		using RTScenePool_t			= PoolTmpl<			ResourceBase<VRayTracingScene>,			MaxRTObjects,	127 >;
+		using RTShaderTablePool_t	= PoolTmpl<			ResourceBase<VRayTracingShaderTable>,	MaxRTObjects,	127 >;
 		using SwapchainPool_t		= PoolTmpl<			ResourceBase<VSwapchain>,				8,				 4 >;
 		
 		using PipelineCompilers_t	= HashSet< PipelineCompiler >;
 		using VkShaderPtr			= PipelineDescription::VkShaderPtr;
 		using ShaderModules_t		= Array< VkShaderPtr >;
 		using DSLayouts_t			= FixedArray<Pair< RawDescriptorSetLayoutID, ResourceBase<VDescriptorSetLayout> *>, FG_MaxDescriptorSets >;
+		using TransientHeap			= VCmdBatch::TransientHeap;
+		using TransientHeapMap_t	= StaticArray< Array<TransientHeap>, VK_MAX_MEMORY_TYPES >;
+
+		// max number of unused transient heaps per memory type, smallest heaps are freed first
+		static constexpr uint		MaxFreeTransientHeaps	= 8;
 		
 		using DebugLayoutCache_t	= HashMap< uint, RawDescriptorSetLayoutID >;
-		
-		using StagingBufferfPool_t	= LfIndexedPool< BufferID, uint, 32, 2 >;
 
 
 	// variables
@@ -85,6 +90,7 @@ namespace FG
 		VDevice const&				_device;
 		VMemoryManager				_memoryMngr;
 		VDescriptorManager			_descMngr;
+		VStagingBufferManager		_stagingMngr;
 
 		BufferPool_t				_bufferPool;
 		ImagePool_t					_imagePool;
@@ -120,6 +126,10 @@ namespace FG
 		SharedMutex					_compilersGuard;
 		PipelineCompilers_t			_compilers;
 
+		// transient heaps are reused when command batch completes
+		Mutex						_transientHeapGuard;
+		TransientHeapMap_t			_freeTransientHeaps;		// sorted by size
+
 		Atomic<uint>				_submissionCounter;
 
 		struct {
@@ -130,14 +140,9 @@ namespace FG
 		}							_shaderDbg;
 
 		struct {
-			StagingBufferfPool_t		write;
-			StagingBufferfPool_t		read;
-			StagingBufferfPool_t		uniform;
 			BytesU						writeBufPageSize;
 			BytesU						readBufPageSize;
-			BytesU						uniformBufPageSize;
 			BytesU						maxStagingBufferMemory;
-			Atomic<uint64_t>			currStagingBufferMemory		{0};
 		}							_staging;
 
 		// cached resources validation
@@ -162,7 +167,8 @@ namespace FG
 
 	// methods
 	public:
-		VResourceManager (const VDevice &dev, BytesU maxStagingBufferMemory, BytesU stagingBufferSize);
+		VResourceManager (const VDevice &dev, BytesU maxStagingBufferMemory, BytesU stagingBufferSize,
+						  const VulkanDeviceInfo::ResourcePoolLimits &limits);
 		~VResourceManager ();
 
 		bool  Initialize ();
@@ -184,9 +190,10 @@ namespace FG
 		ND_ RawBufferID			CreateBuffer (const VulkanBufferDesc &desc, IFrameGraph::OnExternalBufferReleased_t &&onRelease, StringView dbgName);
 
 		ND_ RawRenderPassID		CreateRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses, StringView dbgName);
+		ND_ RawRenderPassID		CreateRenderPass (ArrayView<VLogicalRenderPass::ColorTarget> colorTargets, const VLogicalRenderPass::DepthStencilTarget &depthStencilTarget, StringView dbgName);
 		ND_ RawFramebufferID	CreateFramebuffer (ArrayView<Pair<RawImageID, ImageViewDesc>> attachments, RawRenderPassID rp, uint2 dim, uint layers, StringView dbgName);
 
-		ND_ VPipelineResources const*	CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &);
+		ND_ VPipelineResources const*	CreateDescriptorSet (const PipelineResources &desc, VCmdBatch::ResourceMap_t &, Array<VPipelineResources const*> *deferredUpdates = null);
 			bool						CacheDescriptorSet (INOUT PipelineResources &desc);
 		
 		ND_ RawRTGeometryID		CreateRayTracingGeometry (const RayTracingGeometryDesc &desc, const MemoryDesc &mem, StringView dbgName);
@@ -202,6 +209,9 @@ namespace FG
 		
 		ND_ RawSwapchainID		CreateSwapchain (const VulkanSwapchainCreateInfo &desc, RawSwapchainID oldSwapchain, VFrameGraph &, StringView dbgName);
 
+		ND_ bool				AcquireTransientHeap (uint memTypeIndex, BytesU size, OUT TransientHeap &heap, OUT bool &isNew);
+			void				ReleaseTransientHeaps (ArrayView<TransientHeap> heaps);
+
 		template <typename ID>
 		bool ReleaseResource (ID id, uint refCount = 1);
 		void ReleaseResource (INOUT PipelineResources &desc);
@@ -221,6 +231,7 @@ namespace FG
 		ND_ VDevice const&		GetDevice ()				const	{ return _device; }
 		ND_ VMemoryManager&		GetMemoryManager ()					{ return _memoryMngr; }
 		ND_ VDescriptorManager&	GetDescriptorManager ()				{ return _descMngr; }
+		ND_ VStagingBufferManager&	GetStagingBufferManager ()		{ return _stagingMngr; }
 		
 		ND_ uint				GetSubmitIndex ()			const	{ return _submissionCounter.load( memory_order_relaxed ); }
 		
@@ -228,20 +239,17 @@ namespace FG
 		
 		ND_ BytesU				GetHostReadBufferSize ()	const	{ return _staging.readBufPageSize; }
 		ND_ BytesU				GetHostWriteBufferSize ()	const	{ return _staging.writeBufPageSize; }
-		ND_ BytesU				GetUniformBufferSize ()		const	{ return _staging.uniformBufPageSize; }
 		
 		ND_ Tuple<RawCPipelineID, RawCPipelineID, RawCPipelineID>	GetShaderTimemapPipelines ();
 
 		void  CheckTask (const BuildRayTracingScene &);
 
 		void  RunValidation (uint maxIter);
-		
-		bool  CreateStagingBuffer (EBufferUsage usage, OUT RawBufferID &id, OUT StagingBufferIdx &index);
-		void  ReleaseStagingBuffer (StagingBufferIdx index);
 
 
 	private:
 		bool  _CheckHostVisibleMemory ();
+		void  _SetPoolLimits (const VulkanDeviceInfo::ResourcePoolLimits &limits);
 
 		bool  _CreateMemory (OUT RawMemoryID &id, OUT ResourceBase<VMemoryObj>* &memPtr, const MemoryDesc &desc, StringView dbgName);
 
@@ -257,6 +265,8 @@ namespace FG
 		template <typename ID, typename FnInitialize, typename FnCreate>
 		ND_ ID  _CreateCachedResource (StringView errorStr, FnInitialize&& fnInit, FnCreate&& fnCreate);
 
+		ND_ VPipelineResources const*  _FlushDescriptorSet (const VPipelineResources &, Array<VPipelineResources const*> *deferredUpdates);
+
 		template <typename DescT>
 		bool  _CompileShaders (INOUT DescT &desc, const VDevice &dev);
 		bool  _CompileShader (INOUT ComputePipelineDesc &desc, const VDevice &dev);
@@ -271,8 +281,6 @@ namespace FG
 		template <typename DataT, size_t CS, size_t MC>
 		bool  _ReleaseResource (CachedPoolTmpl<DataT,CS,MC> &pool, DataT& data, Index_t index, uint refCount);
 
-		void  _DestroyStagingBuffers ();
-
 
 	// resource pool
 		ND_ auto&  _GetResourcePool (const RawBufferID &)				{ return _bufferPool; }
@@ -316,6 +324,9 @@ namespace FG
 		bool  _CreateFindMaxValuePipeline2 ();
 		bool  _CreateTimemapRemapPipeline ();
 		void  _DestroyShaderDebuggerResources ();
+
+	// transient memory
+		void  _DestroyTransientHeaps ();
 	};
 
 	
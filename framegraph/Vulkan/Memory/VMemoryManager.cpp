@@ -1,6 +1,7 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "VMemoryManager.h"
+#include "VDevice.h"
 
 namespace FG
 {
@@ -163,5 +164,77 @@ namespace FG
 		return true;
 	}
 
+/*
+=================================================
+	CreatePool
+=================================================
+*/
+	bool VMemoryManager::CreatePool (const MemPoolID &id, const MemoryPoolDesc &desc)
+	{
+		SHAREDLOCK( _drCheck );
+		CHECK_ERR( id.IsDefined() );
+
+		for (auto& alloc : _allocators)
+		{
+			if ( alloc->IsSupported( desc.memType ))
+			{
+				CHECK_ERR( alloc->CreatePool( id, desc ));
+				return true;
+			}
+		}
+		RETURN_ERR( "unsupported memory type" );
+	}
+	
+/*
+=================================================
+	GetStatistics
+----
+	budget and usage are reported by driver for whole process,
+	'allocated' is the memory that was allocated by framegraph.
+=================================================
+*/
+	void VMemoryManager::GetStatistics (OUT MemoryStat_t &stat) const
+	{
+		SHAREDLOCK( _drCheck );
+
+		const auto&		mem_props = _device.GetProperties().memoryProperties;
+
+		stat.heaps.clear();
+		stat.pools.clear();
+		stat.heaps.resize( Min( mem_props.memoryHeapCount, stat.heaps.capacity() ));
+
+		for (size_t i = 0; i < stat.heaps.size(); ++i)
+		{
+			auto&	dst = stat.heaps[i];
+			dst.size		= BytesU(mem_props.memoryHeaps[i].size);
+			dst.budget		= dst.size;
+			dst.deviceLocal	= AllBits( mem_props.memoryHeaps[i].flags, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT );
+		}
+
+		#ifdef VK_EXT_memory_budget
+		if ( _device.GetFeatures().memoryBudget )
+		{
+			VkPhysicalDeviceMemoryBudgetPropertiesEXT	budget = {};
+			budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+			VkPhysicalDeviceMemoryProperties2	props2 = {};
+			props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+			props2.pNext = &budget;
+
+			vkGetPhysicalDeviceMemoryProperties2KHR( _device.GetVkPhysicalDevice(), OUT &props2 );
+
+			for (size_t i = 0; i < stat.heaps.size(); ++i)
+			{
+				stat.heaps[i].budget = BytesU(budget.heapBudget[i]);
+				stat.heaps[i].usage  = BytesU(budget.heapUsage[i]);
+			}
+		}
+		#endif
+
+		for (auto& alloc : _allocators) {
+			alloc->GetStatistics( INOUT stat );
+		}
+	}
+
 
 }	// FG
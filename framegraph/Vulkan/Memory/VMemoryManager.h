@@ -3,6 +3,7 @@
 #pragma once
 
 #include "VMemoryObj.h"
+#include "framegraph/Public/FrameGraph.h"
 
 namespace FG
 {
@@ -17,6 +18,7 @@ namespace FG
 	protected:
 		using Storage_t		= VMemoryObj::Storage_t;
 		using MemoryInfo_t	= VMemoryObj::MemoryInfo;
+		using MemoryStat_t	= IFrameGraph::MemoryStatistics;
 
 		class DedicatedMemAllocator;
 		class HostMemAllocator;
@@ -43,6 +45,11 @@ namespace FG
 			virtual bool Dealloc (INOUT Storage_t &data) = 0;
 			
 			virtual bool GetMemoryInfo (const Storage_t &data, OUT MemoryInfo_t &info) const = 0;
+
+			virtual bool CreatePool (const MemPoolID &id, const MemoryPoolDesc &desc) = 0;
+
+			// adds allocated memory to heaps and appends pools
+			virtual void GetStatistics (INOUT MemoryStat_t &stat) const = 0;
 		};
 
 		using AllocatorPtr	= UniquePtr< IMemoryAllocator >;
@@ -76,6 +83,10 @@ namespace FG
 
 		virtual bool GetMemoryInfo (const Storage_t &data, OUT MemoryInfo_t &info) const;
 
+		virtual bool CreatePool (const MemPoolID &id, const MemoryPoolDesc &desc);
+
+		virtual void GetStatistics (OUT MemoryStat_t &stat) const;
+
 
 	private:
 		ND_ AllocatorPtr  _CreateVMA ();
@@ -70,12 +70,21 @@ namespace FG
 			VmaAllocation	allocation;
 		};
 
+		struct PoolInfo
+		{
+			VmaPool			handle			= VK_NULL_HANDLE;
+			uint			memTypeIndex	= UMax;
+			BytesU			budget;		// 0 - unlimited
+		};
+		using Pools_t = HashMap< MemPoolID, PoolInfo >;
+
 
 	// variables
 	private:
 		mutable SharedMutex		_guard;
 		VDevice const&			_device;
 		VmaAllocator			_allocator;
+		Pools_t					_pools;
 
 
 	// methods
@@ -96,9 +105,15 @@ namespace FG
 		
 		bool GetMemoryInfo (const Storage_t &data, OUT MemoryInfo_t &info) const override;
 
+		bool CreatePool (const MemPoolID &id, const MemoryPoolDesc &desc) override;
+		void GetStatistics (INOUT MemoryStat_t &stat) const override;
+
 	private:
 		bool _CreateAllocator (OUT VmaAllocator &alloc) const;
 
+		ND_ bool _FindPool (const MemPoolID &id, OUT PoolInfo const* &pool) const;
+		ND_ bool _CheckBudget (const PoolInfo &pool, VkDeviceSize size) const;
+
 		ND_ static Data *					_CastStorage (Storage_t &data);
 		ND_ static Data const*				_CastStorage (const Storage_t &data);
 		
@@ -139,6 +154,11 @@ namespace FG
 	{
 		EXLOCK( _guard );
 
+		for (auto& pool : _pools) {
+			vmaDestroyPool( _allocator, pool.second.handle );
+		}
+		_pools.clear();
+
 		if ( _allocator ) {
 			vmaDestroyAllocator( _allocator );
 		}
@@ -189,9 +209,14 @@ namespace FG
 		info.pool			= VK_NULL_HANDLE;
 		info.pUserData		= null;
 
-		VmaAllocation	mem = null;
+		PoolInfo const*	pool	= null;
+		CHECK_ERR( _FindPool( desc.poolId, OUT pool ));
+
+		VmaAllocation	mem		= null;
+		auto*			req		= UnionGetIf<VulkanMemRequirements>( &desc.req );
 		
-		if ( auto* req = UnionGetIf<VulkanMemRequirements>( &desc.req ))
+		// allocation from pool requires memory size to check budget
+		if ( req or pool )
 		{
 			// because used private api
 			VMA_DEBUG_GLOBAL_MUTEX_LOCK
@@ -201,8 +226,16 @@ namespace FG
 			bool prefers_dedicated_allocation	= false;
 			_allocator->GetImageMemoryRequirements( image, OUT vkMemReq, OUT requires_dedicated_allocation, OUT prefers_dedicated_allocation );
 
-			vkMemReq.alignment		= Max( vkMemReq.alignment, req->alignment );
-			vkMemReq.memoryTypeBits	&= (req->memTypeBits ? req->memTypeBits : ~0u);
+			if ( req ) {
+				vkMemReq.alignment		= Max( vkMemReq.alignment, req->alignment );
+				vkMemReq.memoryTypeBits	&= (req->memTypeBits ? req->memTypeBits : ~0u);
+			}
+			if ( pool ) {
+				// VMA doesn't check memory type bits if pool is used
+				CHECK_ERR( vkMemReq.memoryTypeBits & (1u << pool->memTypeIndex) );
+				CHECK_ERR( _CheckBudget( *pool, vkMemReq.size ));
+				info.pool = pool->handle;
+			}
 			
 			CHECK_ERR( vkMemReq.memoryTypeBits != 0 );
 
@@ -238,9 +271,14 @@ namespace FG
 		info.pool			= VK_NULL_HANDLE;
 		info.pUserData		= null;
 		
-		VmaAllocation	mem = null;
+		PoolInfo const*	pool	= null;
+		CHECK_ERR( _FindPool( desc.poolId, OUT pool ));
+
+		VmaAllocation	mem		= null;
+		auto*			req		= UnionGetIf<VulkanMemRequirements>( &desc.req );
 
-		if ( auto* req = UnionGetIf<VulkanMemRequirements>( &desc.req ))
+		// allocation from pool requires memory size to check budget
+		if ( req or pool )
 		{
 			// because used private api
 			VMA_DEBUG_GLOBAL_MUTEX_LOCK
@@ -250,8 +288,16 @@ namespace FG
 			bool prefers_dedicated_allocation	= false;
 			_allocator->GetBufferMemoryRequirements( buffer, OUT vkMemReq, OUT requires_dedicated_allocation, OUT prefers_dedicated_allocation );
 
-			vkMemReq.alignment		= Max( vkMemReq.alignment, req->alignment );
-			vkMemReq.memoryTypeBits	&= (req->memTypeBits ? req->memTypeBits : ~0u);
+			if ( req ) {
+				vkMemReq.alignment		= Max( vkMemReq.alignment, req->alignment );
+				vkMemReq.memoryTypeBits	&= (req->memTypeBits ? req->memTypeBits : ~0u);
+			}
+			if ( pool ) {
+				// VMA doesn't check memory type bits if pool is used
+				CHECK_ERR( vkMemReq.memoryTypeBits & (1u << pool->memTypeIndex) );
+				CHECK_ERR( _CheckBudget( *pool, vkMemReq.size ));
+				info.pool = pool->handle;
+			}
 			
 			CHECK_ERR( vkMemReq.memoryTypeBits != 0 );
 
@@ -296,6 +342,16 @@ namespace FG
 		info.pool			= VK_NULL_HANDLE;
 		info.pUserData		= null;
 		
+		PoolInfo const*	pool = null;
+		CHECK_ERR( _FindPool( desc.poolId, OUT pool ));
+
+		if ( pool ) {
+			// VMA doesn't check memory type bits if pool is used
+			CHECK_ERR( mem_req.memoryRequirements.memoryTypeBits & (1u << pool->memTypeIndex) );
+			CHECK_ERR( _CheckBudget( *pool, mem_req.memoryRequirements.size ));
+			info.pool = pool->handle;
+		}
+
 		// because used private api
 	    VMA_DEBUG_GLOBAL_MUTEX_LOCK
 
@@ -358,6 +414,126 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	CreatePool
+=================================================
+*/
+	bool VMemoryManager::VulkanMemoryAllocator::CreatePool (const MemPoolID &id, const MemoryPoolDesc &desc)
+	{
+		EXLOCK( _guard );
+		CHECK_ERR( _pools.find( id ) == _pools.end() );
+		
+		VmaAllocationCreateInfo		alloc_info = {};
+		alloc_info.flags			= _ConvertToMemoryFlags( desc.memType ) & ~VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+		alloc_info.usage			= _ConvertToMemoryUsage( desc.memType );
+		alloc_info.requiredFlags	= _ConvertToMemoryProperties( desc.memType );
+
+		VmaPoolCreateInfo	info = {};
+		VK_CHECK( vmaFindMemoryTypeIndex( _allocator, (desc.memTypeBits ? desc.memTypeBits : ~0u), &alloc_info, OUT &info.memoryTypeIndex ));
+
+		info.blockSize			= VkDeviceSize(desc.blockSize);
+		info.minBlockCount		= desc.minBlockCount;
+		info.maxBlockCount		= desc.maxBlockCount;
+		info.frameInUseCount	= 0;
+
+		BEGIN_ENUM_CHECKS();
+		switch ( desc.algorithm )
+		{
+			case EMemoryPoolAlgorithm::Default :	info.flags = 0;										break;
+			case EMemoryPoolAlgorithm::Linear :		info.flags = VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;	break;
+			case EMemoryPoolAlgorithm::Buddy :		info.flags = VMA_POOL_CREATE_BUDDY_ALGORITHM_BIT;	break;
+		}
+		END_ENUM_CHECKS();
+
+		// buddy algorithm uses only power of two part of the block
+		CHECK_ERR( desc.algorithm != EMemoryPoolAlgorithm::Buddy or desc.blockSize == 0 or IsPowerOfTwo( VkDeviceSize(desc.blockSize) ));
+
+		PoolInfo	pool;
+		pool.budget			= desc.budget;
+		pool.memTypeIndex	= info.memoryTypeIndex;
+		VK_CHECK( vmaCreatePool( _allocator, &info, OUT &pool.handle ));
+
+		_pools.insert_or_assign( id, pool );
+		return true;
+	}
+	
+/*
+=================================================
+	_FindPool
+=================================================
+*/
+	bool VMemoryManager::VulkanMemoryAllocator::_FindPool (const MemPoolID &id, OUT PoolInfo const* &pool) const
+	{
+		pool = null;
+
+		if ( not id.IsDefined() )
+			return true;
+
+		auto	iter = _pools.find( id );
+		if ( iter == _pools.end() )
+			RETURN_ERR( "unknown memory pool" );
+		
+		pool = &iter->second;
+		return true;
+	}
+	
+/*
+=================================================
+	_CheckBudget
+=================================================
+*/
+	bool VMemoryManager::VulkanMemoryAllocator::_CheckBudget (const PoolInfo &pool, VkDeviceSize size) const
+	{
+		if ( pool.budget == 0 )
+			return true;
+
+		VmaPoolStats	stats = {};
+		vmaGetPoolStats( _allocator, pool.handle, OUT &stats );
+
+		const VkDeviceSize	used = stats.size - stats.unusedSize;
+
+		if ( used + size > VkDeviceSize(pool.budget) )
+			RETURN_ERR( "memory pool budget exceeded" );
+
+		return true;
+	}
+	
+/*
+=================================================
+	GetStatistics
+=================================================
+*/
+	void VMemoryManager::VulkanMemoryAllocator::GetStatistics (INOUT MemoryStat_t &stat) const
+	{
+		SHAREDLOCK( _guard );
+
+		VmaStats	total = {};
+		vmaCalculateStats( _allocator, OUT &total );
+
+		for (size_t i = 0; i < stat.heaps.size(); ++i)
+		{
+			auto&	src = total.memoryHeap[i];
+			stat.heaps[i].allocated += BytesU(src.usedBytes + src.unusedBytes);
+		}
+
+		for (auto& pool : _pools)
+		{
+			VmaPoolStats	src = {};
+			vmaGetPoolStats( _allocator, pool.second.handle, OUT &src );
+
+			MemoryStat_t::Pool	dst;
+			dst.id				= pool.first;
+			dst.budget			= pool.second.budget;
+			dst.allocated		= BytesU(src.size);
+			dst.used			= BytesU(src.size - src.unusedSize);
+			dst.blockCount		= uint(src.blockCount);
+			dst.allocationCount	= uint(src.allocationCount);
+
+			stat.pools.push_back( dst );
+		}
+	}
+
 /*
 =================================================
 	_ConvertToMemoryFlags
@@ -0,0 +1,408 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VStagingBufferManager.h"
+#include "VResourceManager.h"
+#include "VDevice.h"
+#include "stl/Algorithms/StringUtils.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	VStagingRingAllocator::VStagingRingAllocator (BytesU capacity, BytesU align) :
+		_capacity{ AlignToSmaller( capacity, align )}, _align{ align }
+	{
+		ASSERT( _align > 0_b );
+	}
+
+/*
+=================================================
+	Allocate
+=================================================
+*/
+	bool  VStagingRingAllocator::Allocate (BytesU size, BytesU minSize, OUT BytesU &offset, OUT BytesU &outSize, OUT uint &id)
+	{
+		size	= AlignToLarger( size, _align );
+		minSize	= AlignToLarger( Max( Min( minSize, size ), 1_b ), _align );
+
+		if ( _allocations.empty() )
+			_head = _tail = 0_b;
+		else
+		if ( _head == _tail )
+			return false;	// ring is full
+
+		BytesU	begin, available;
+
+		if ( _head >= _tail )
+		{
+			// free space at the end and at the beginning of the ring
+			const BytesU	at_end		= _capacity - _head;
+			const BytesU	at_begin	= _tail;
+
+			if ( at_end >= size or at_end >= at_begin ) {
+				begin		= _head;
+				available	= at_end;
+			}else{
+				begin		= 0_b;
+				available	= at_begin;
+			}
+		}
+		else
+		{
+			begin		= _head;
+			available	= _tail - _head;
+		}
+
+		if ( available < minSize )
+			return false;
+
+		offset	= begin;
+		outSize	= Min( available, size );
+		id		= (_firstId + uint(_allocations.size())) & IdMask;
+		_head	= begin + outSize;
+		_used  += outSize;
+
+		ASSERT( _allocations.size() < IdMask );
+		_allocations.push_back({ begin, _head, false });
+		return true;
+	}
+
+/*
+=================================================
+	Shrink
+=================================================
+*/
+	BytesU  VStagingRingAllocator::Shrink (uint id, BytesU size)
+	{
+		const size_t	idx = (id - _firstId) & IdMask;
+		CHECK_ERR( idx < _allocations.size(), 0_b );
+
+		auto&	alloc = _allocations[idx];
+		size = Max( AlignToLarger( size, _align ), _align );
+
+		// only the last allocation can be shrinked
+		if ( idx+1 == _allocations.size() and size < alloc.end - alloc.begin )
+		{
+			ASSERT( _head == alloc.end );
+			_used	-= (alloc.end - alloc.begin) - size;
+			alloc.end = alloc.begin + size;
+			_head	 = alloc.end;
+		}
+		return alloc.end - alloc.begin;
+	}
+
+/*
+=================================================
+	Release
+=================================================
+*/
+	void  VStagingRingAllocator::Release (uint id)
+	{
+		const size_t	idx = (id - _firstId) & IdMask;
+		CHECK_ERRV( idx < _allocations.size() );
+
+		auto&	alloc = _allocations[idx];
+		CHECK_ERRV( not alloc.released );
+
+		alloc.released	 = true;
+		_used			-= alloc.end - alloc.begin;
+
+		// move tail
+		for (; _allocations.size() and _allocations.front().released;)
+		{
+			_allocations.pop_front();
+			_firstId = (_firstId + 1) & IdMask;
+		}
+
+		if ( _allocations.empty() )
+			_head = _tail = 0_b;
+		else
+			_tail = _allocations.front().begin;
+	}
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	VStagingBufferManager::VStagingBufferManager (VResourceManager &rm) :
+		_resMngr{ rm }
+	{}
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	VStagingBufferManager::~VStagingBufferManager ()
+	{
+		for (auto& ring : _rings) {
+			CHECK( not ring.buffer );
+		}
+	}
+
+/*
+=================================================
+	Initialize
+=================================================
+*/
+	bool  VStagingBufferManager::Initialize (BytesU blockSize, BytesU maxMemory)
+	{
+		auto&	limits = _resMngr.GetDevice().GetDeviceLimits();
+
+		// block may be used as uniform buffer and it is flushed separately
+		_align		= Max( BytesU{limits.minUniformBufferOffsetAlignment}, BytesU{limits.nonCoherentAtomSize},
+						   BytesU{limits.optimalBufferCopyOffsetAlignment}, 16_b );
+		_blockSize	= AlignToLarger( blockSize, _align );
+		_maxMemory	= maxMemory;
+
+		CHECK_ERR( _blockSize > 0_b );
+		return true;
+	}
+
+/*
+=================================================
+	Deinitialize
+=================================================
+*/
+	void  VStagingBufferManager::Deinitialize ()
+	{
+		for (auto& ring : _rings)
+		{
+			EXLOCK( ring.guard );
+
+			if ( not ring.buffer )
+				continue;
+
+			CHECK( ring.alloc.Empty() );
+
+			_stat.allocated.fetch_sub( uint64_t(ring.alloc.Capacity()), memory_order_relaxed );
+			_resMngr.ReleaseResource( ring.buffer.Release() );
+
+			ring.memory	= Default;
+			ring.alloc	= VStagingRingAllocator{};
+		}
+	}
+
+/*
+=================================================
+	Allocate
+----
+	returns block with size in range [Min('minSize', 'requiredSize'), Max('requiredSize', block size)],
+	block must be released when GPU has finished using it.
+=================================================
+*/
+	bool  VStagingBufferManager::Allocate (EQueueType queue, EDirection dir, BytesU requiredSize, BytesU minSize, OUT Block &result)
+	{
+		CHECK_ERR( uint(queue) < uint(EQueueType::_Count) and uint(dir) < uint(EDirection::_Count) );
+
+		const uint		ring_idx	= uint(queue) * uint(EDirection::_Count) + uint(dir);
+		const BytesU	size		= AlignToLarger( Max( requiredSize, _blockSize ), _align );
+
+		// huge transfers use dedicated buffers, so ring buffer is not blocked by a single batch
+		if ( size <= _blockSize * BlocksPerRing / 2 )
+		{
+			auto&	ring = _rings[ring_idx];
+			EXLOCK( ring.guard );
+
+			if ( not ring.buffer )
+				CHECK_ERR( _CreateRing( INOUT ring, queue, dir ));
+
+			uint	id;
+			if ( ring.alloc.Allocate( size, Min( minSize, requiredSize ), OUT result.offset, OUT result.size, OUT id ))
+			{
+				result.bufferId	= ring.buffer.Get();
+				result.memoryId	= ring.memory;
+				result.index	= StagingBufferIdx( (ring_idx << RingIndexOffset) | id );
+
+				_AddUsed( result.size );
+				return true;
+			}
+		}
+
+		// ring buffer is full or transfer is too big
+		return _CreateDedicated( dir, size, OUT result );
+	}
+
+/*
+=================================================
+	Shrink
+----
+	returns unused memory at the end of the block to the ring buffer.
+=================================================
+*/
+	BytesU  VStagingBufferManager::Shrink (StagingBufferIdx index, BytesU usedSize, BytesU blockSize)
+	{
+		const uint	ring_idx = uint(index) >> RingIndexOffset;
+
+		if ( ring_idx == DedicatedIndex )
+			return blockSize;
+
+		CHECK_ERR( ring_idx < _rings.size(), blockSize );
+
+		auto&	ring = _rings[ring_idx];
+		EXLOCK( ring.guard );
+
+		const BytesU	new_size = ring.alloc.Shrink( uint(index) & VStagingRingAllocator::IdMask, usedSize );
+		CHECK_ERR( new_size <= blockSize, blockSize );
+
+		_SubUsed( blockSize - new_size );
+		return new_size;
+	}
+
+/*
+=================================================
+	Release
+=================================================
+*/
+	void  VStagingBufferManager::Release (StagingBufferIdx index, RawBufferID buffer, BytesU blockSize)
+	{
+		const uint	ring_idx = uint(index) >> RingIndexOffset;
+
+		_SubUsed( blockSize );
+
+		if ( ring_idx == DedicatedIndex )
+		{
+			_stat.allocated.fetch_sub( uint64_t(blockSize), memory_order_relaxed );
+			_resMngr.ReleaseResource( buffer );
+			return;
+		}
+
+		CHECK_ERRV( ring_idx < _rings.size() );
+
+		auto&	ring = _rings[ring_idx];
+		EXLOCK( ring.guard );
+
+		ASSERT( ring.buffer.Get() == buffer );
+		ring.alloc.Release( uint(index) & VStagingRingAllocator::IdMask );
+	}
+
+/*
+=================================================
+	GetStatistics
+=================================================
+*/
+	void  VStagingBufferManager::GetStatistics (INOUT Statistic_t &stat)
+	{
+		const uint64_t	used = _stat.used.load( memory_order_relaxed );
+
+		stat.stagingMemoryAllocated	 = BytesU{ _stat.allocated.load( memory_order_relaxed )};
+		stat.stagingMemoryUsed		 = BytesU{ used };
+		stat.stagingMemoryHighWater	 = BytesU{ Max( _stat.highWater.exchange( used, memory_order_relaxed ), used )};
+		stat.stagingOverflowBuffers	+= _stat.overflow.exchange( 0, memory_order_relaxed );
+	}
+
+/*
+=================================================
+	_CreateRing
+=================================================
+*/
+	bool  VStagingBufferManager::_CreateRing (INOUT Ring &ring, EQueueType queue, EDirection dir)
+	{
+		const BytesU	capacity	= _blockSize * BlocksPerRing;
+		RawBufferID		buf;
+
+		CHECK_ERR( _CreateBuffer( dir, capacity, _GetName( dir, true ), OUT buf, OUT ring.memory ));
+
+		ring.buffer	= BufferID{ buf };
+		ring.alloc	= VStagingRingAllocator{ capacity, _align };
+
+		FG_LOGD( "Created staging ring buffer for queue "s << ToString( uint(queue) ) << ", size: " << ToString( capacity ));
+		return true;
+	}
+
+/*
+=================================================
+	_CreateDedicated
+=================================================
+*/
+	bool  VStagingBufferManager::_CreateDedicated (EDirection dir, BytesU size, OUT Block &result)
+	{
+		CHECK_ERR( _CreateBuffer( dir, size, _GetName( dir, false ), OUT result.bufferId, OUT result.memoryId ));
+
+		result.offset	= 0_b;
+		result.size		= size;
+		result.index	= StagingBufferIdx( DedicatedIndex << RingIndexOffset );
+
+		_stat.overflow.fetch_add( 1, memory_order_relaxed );
+		_AddUsed( size );
+		return true;
+	}
+
+/*
+=================================================
+	_CreateBuffer
+=================================================
+*/
+	bool  VStagingBufferManager::_CreateBuffer (EDirection dir, BytesU size, StringView name, OUT RawBufferID &buffer, OUT RawMemoryID &memory)
+	{
+		const bool	is_write = (dir == EDirection::HostToDevice);
+		BufferDesc	desc;
+		desc.size	= size;
+		desc.usage	= is_write ? EBufferUsage::TransferSrc : EBufferUsage::TransferDst;
+
+		const BytesU	total_size = BytesU{ _stat.allocated.fetch_add( uint64_t(size), memory_order_relaxed )} + size;
+
+		if ( total_size > _maxMemory )
+			FG_LOGE( "Exceeded the maximum memory size for staging buffers" );
+
+		// 'HostRead' prefers host-cached memory, so CPU reads from the mapped pointer are fast
+		buffer = _resMngr.CreateBuffer( desc, MemoryDesc{ is_write ? EMemoryType::HostWrite : EMemoryType::HostRead }, EQueueFamilyMask::Unknown, name );
+
+		if ( not buffer )
+		{
+			_stat.allocated.fetch_sub( uint64_t(size), memory_order_relaxed );
+			RETURN_ERR( "failed to create staging buffer" );
+		}
+
+		memory = _resMngr.GetResource( buffer )->GetMemoryID();
+		CHECK_ERR( memory );
+		return true;
+	}
+
+/*
+=================================================
+	_GetName
+=================================================
+*/
+	StringView  VStagingBufferManager::_GetName (EDirection dir, bool isRing)
+	{
+		BEGIN_ENUM_CHECKS();
+		switch ( dir )
+		{
+			case EDirection::HostToDevice :	return isRing ? "HostWriteRing" : "HostWriteBuffer";
+			case EDirection::DeviceToHost :	return isRing ? "HostReadRing" : "HostReadBuffer";
+			case EDirection::Readback :		return isRing ? "HostReadbackRing" : "HostReadbackBuffer";
+			case EDirection::_Count :		break;
+		}
+		END_ENUM_CHECKS();
+		return "";
+	}
+
+/*
+=================================================
+	_AddUsed / _SubUsed
+=================================================
+*/
+	void  VStagingBufferManager::_AddUsed (BytesU size)
+	{
+		const uint64_t	used	= _stat.used.fetch_add( uint64_t(size), memory_order_relaxed ) + uint64_t(size);
+		uint64_t		hw		= _stat.highWater.load( memory_order_relaxed );
+
+		for (; hw < used and not _stat.highWater.compare_exchange_weak( INOUT hw, used, memory_order_relaxed );) {}
+	}
+
+	void  VStagingBufferManager::_SubUsed (BytesU size)
+	{
+		_stat.used.fetch_sub( uint64_t(size), memory_order_relaxed );
+	}
+
+
+}	// FG
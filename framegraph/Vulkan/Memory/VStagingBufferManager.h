@@ -0,0 +1,163 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Host visible memory for transfers between host and device.
+	Each queue has persistently mapped ring buffer for each direction,
+	command batch reserves a block in the ring and sub-allocates from it while recording,
+	unused tail of the block is returned when recording is complete,
+	whole block is released when the batch is complete (after fence or timeline semaphore signaled).
+	Transfers that don't fit into the ring buffer use dedicated buffers.
+	Readback ring contains blocks that are owned by readback futures and can be held for many frames.
+*/
+
+#pragma once
+
+#include "framegraph/Public/FrameGraph.h"
+#include "VCommon.h"
+
+namespace FG
+{
+	enum class StagingBufferIdx : uint {};
+
+
+
+	//
+	// Staging Ring Allocator
+	//
+
+	class VStagingRingAllocator final
+	{
+	// types
+	public:
+		static constexpr uint	IdMask	= (1u << 24) - 1;
+
+	private:
+		struct Allocation
+		{
+			BytesU		begin;
+			BytesU		end;
+			bool		released	= false;
+		};
+
+
+	// variables
+	private:
+		Deque< Allocation >		_allocations;	// in allocation order
+		uint					_firstId	= 0;	// id of the oldest allocation
+		BytesU					_capacity;
+		BytesU					_align;
+		BytesU					_head;				// next allocation starts here
+		BytesU					_tail;				// begin of the oldest allocation
+		BytesU					_used;				// size of all alive allocations
+
+
+	// methods
+	public:
+		VStagingRingAllocator () {}
+		VStagingRingAllocator (BytesU capacity, BytesU align);
+
+		// returns block with size in range ['minSize', 'size']
+		ND_ bool	Allocate (BytesU size, BytesU minSize, OUT BytesU &offset, OUT BytesU &outSize, OUT uint &id);
+
+		// returns unused tail of the last allocation to the ring, returns new size of allocation
+		ND_ BytesU	Shrink (uint id, BytesU size);
+
+		// allocations can be released in any order, but memory is reused only when the oldest allocation is released
+			void	Release (uint id);
+
+		ND_ BytesU	Capacity ()		const	{ return _capacity; }
+		ND_ BytesU	Used ()			const	{ return _used; }
+		ND_ bool	Empty ()		const	{ return _allocations.empty(); }
+	};
+
+
+
+	//
+	// Vulkan Staging Buffer Manager
+	//
+
+	class VStagingBufferManager final
+	{
+	// types
+	public:
+		enum class EDirection : uint
+		{
+			HostToDevice,	// CPU write, GPU read
+			DeviceToHost,	// CPU read, GPU write
+			Readback,		// CPU read, GPU write, released when the last readback future is released
+			_Count
+		};
+
+		struct Block
+		{
+			RawBufferID			bufferId;
+			RawMemoryID			memoryId;
+			BytesU				offset;		// offset in buffer
+			BytesU				size;
+			StagingBufferIdx	index;
+		};
+
+		using Statistic_t	= IFrameGraph::ResourceStatistics;
+
+		static constexpr uint	RingCount		= uint(EQueueType::_Count) * uint(EDirection::_Count);
+		static constexpr uint	BlocksPerRing	= 8;
+
+	private:
+		static constexpr uint	RingIndexOffset	= 24;
+		static constexpr uint	DedicatedIndex	= 0xFF;
+
+		struct Ring
+		{
+			Mutex					guard;
+			BufferID				buffer;
+			RawMemoryID				memory;
+			VStagingRingAllocator	alloc;
+		};
+		using Rings_t	= StaticArray< Ring, RingCount >;
+
+
+	// variables
+	private:
+		class VResourceManager&		_resMngr;
+		Rings_t						_rings;
+		BytesU						_blockSize;		// preferred block size, ring buffer size is 'BlocksPerRing * _blockSize'
+		BytesU						_align;
+		BytesU						_maxMemory;
+
+		struct {
+			Atomic<uint64_t>			allocated	{0};	// ring buffers and dedicated buffers
+			Atomic<uint64_t>			used		{0};
+			Atomic<uint64_t>			highWater	{0};
+			Atomic<uint>				overflow	{0};
+		}							_stat;
+
+
+	// methods
+	public:
+		explicit VStagingBufferManager (VResourceManager &);
+		~VStagingBufferManager ();
+
+		bool  Initialize (BytesU blockSize, BytesU maxMemory);
+		void  Deinitialize ();
+
+		ND_ bool	Allocate (EQueueType queue, EDirection dir, BytesU requiredSize, BytesU minSize, OUT Block &result);
+		ND_ BytesU	Shrink (StagingBufferIdx index, BytesU usedSize, BytesU blockSize);
+			void	Release (StagingBufferIdx index, RawBufferID buffer, BytesU blockSize);
+
+		void  GetStatistics (INOUT Statistic_t &);
+
+		ND_ BytesU	GetBlockSize ()		const	{ return _blockSize; }
+		ND_ BytesU	GetAlignment ()		const	{ return _align; }
+
+	private:
+		bool  _CreateRing (INOUT Ring &, EQueueType queue, EDirection dir);
+		bool  _CreateDedicated (EDirection dir, BytesU size, OUT Block &result);
+		bool  _CreateBuffer (EDirection dir, BytesU size, StringView name, OUT RawBufferID &buffer, OUT RawMemoryID &memory);
+
+		ND_ static StringView  _GetName (EDirection dir, bool isRing);
+
+		void  _AddUsed (BytesU size);
+		void  _SubUsed (BytesU size);
+	};
+
+
+}	// FG
@@ -0,0 +1,143 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VTransientMemoryAllocator.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	_IsIntersects
+----
+	returns 'true' if lifetimes are overlapped
+=================================================
+*/
+	inline bool  VTransientMemoryAllocator::_IsIntersects (const Resource &lhs, const Resource &rhs)
+	{
+		return lhs.firstUse <= rhs.lastUse and rhs.firstUse <= lhs.lastUse;
+	}
+
+/*
+=================================================
+	Allocate
+----
+	'granularity' is a 'bufferImageGranularity' limit,
+	it is used as minimal alignment because linear and optimal resources may be placed together.
+=================================================
+*/
+	bool  VTransientMemoryAllocator::Allocate (ArrayView<Resource> resources, BytesU granularity, OUT Placements_t &placements, OUT Heaps_t &heaps)
+	{
+		using Range_t = Pair< BytesU, BytesU >;
+
+		placements.clear();
+		placements.resize( resources.size() );
+		heaps.clear();
+
+		if ( resources.empty() )
+			return true;
+
+		// big resources first, it gives less fragmentation
+		Array<uint>		order;
+		order.resize( resources.size() );
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			auto&	res = resources[i];
+			CHECK_ERR( res.size > 0 );
+			CHECK_ERR( res.firstUse <= res.lastUse );
+			CHECK_ERR( res.memTypeIndex != UMax );
+
+			order[i] = uint(i);
+		}
+
+		std::sort( order.begin(), order.end(), [resources] (uint lhs, uint rhs)
+				   {
+						auto&	a = resources[lhs];
+						auto&	b = resources[rhs];
+						return	a.size  != b.size  ? a.size > b.size :
+								a.firstUse != b.firstUse ? a.firstUse < b.firstUse :
+								lhs < rhs;
+				   });
+
+		Array<Array<uint>>	placed;		// indices of resources in each heap
+		Array<Range_t>		busy;
+
+		for (uint idx : order)
+		{
+			auto&			res		= resources[idx];
+			auto&			dst		= placements[idx];
+			const BytesU	align	= Max( Max( res.align, granularity ), 1_b );
+
+			// one heap per memory type
+			uint	heap_idx = UMax;
+			for (size_t i = 0; i < heaps.size(); ++i)
+			{
+				if ( heaps[i].memTypeIndex == res.memTypeIndex ) {
+					heap_idx = uint(i);
+					break;
+				}
+			}
+
+			if ( heap_idx == UMax )
+			{
+				heap_idx = uint(heaps.size());
+				heaps.push_back({ res.memTypeIndex, 0_b });
+				placed.emplace_back();
+			}
+
+			// find memory ranges that are used by resources alive at the same time
+			busy.clear();
+			for (uint other : placed[heap_idx])
+			{
+				if ( _IsIntersects( res, resources[other] ))
+				{
+					auto&	p = placements[other];
+					busy.emplace_back( p.offset, p.offset + resources[other].size );
+				}
+			}
+			std::sort( busy.begin(), busy.end() );
+
+			// first fit
+			BytesU	offset;
+			for (auto& range : busy)
+			{
+				if ( AlignToLarger( offset, align ) + res.size <= range.first )
+					break;
+
+				offset = Max( offset, range.second );
+			}
+
+			dst.heapIndex	= heap_idx;
+			dst.offset		= AlignToLarger( offset, align );
+
+			heaps[heap_idx].size = Max( heaps[heap_idx].size, dst.offset + res.size );
+			placed[heap_idx].push_back( idx );
+		}
+
+		// find resources that reuse memory of previous resources
+		for (auto& heap_res : placed)
+		{
+			for (uint i : heap_res)
+			{
+				auto&	lhs = placements[i];
+
+				for (uint j : heap_res)
+				{
+					auto&	rhs = placements[j];
+
+					if ( i != j											and
+						 resources[j].lastUse < resources[i].firstUse	and
+						 lhs.offset < rhs.offset + resources[j].size	and
+						 rhs.offset < lhs.offset + resources[i].size )
+					{
+						lhs.aliased = true;
+						break;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+
+}	// FG
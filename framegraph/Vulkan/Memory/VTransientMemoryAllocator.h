@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Places transient resources into shared heaps.
+	Resources with non-overlapping lifetimes may share the same memory range.
+	This is interval graph coloring with greedy first-fit strategy:
+	big resources are placed first, then each resource takes the lowest offset
+	that doesn't intersect with resources which are alive at the same time.
+*/
+
+#pragma once
+
+#include "VCommon.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Transient Memory Allocator
+	//
+
+	class VTransientMemoryAllocator final
+	{
+	// types
+	public:
+		struct Resource
+		{
+			BytesU		size;
+			BytesU		align;
+			uint		memTypeIndex	= UMax;
+			uint		firstUse		= UMax;		// inclusive execution order index
+			uint		lastUse			= 0;		// inclusive execution order index
+		};
+
+		struct Placement
+		{
+			uint		heapIndex	= UMax;
+			BytesU		offset;
+			bool		aliased		= false;	// memory was used by another resource, barrier is required before first use
+		};
+
+		struct Heap
+		{
+			uint		memTypeIndex	= UMax;
+			BytesU		size;
+		};
+
+		using Placements_t	= Array< Placement >;
+		using Heaps_t		= Array< Heap >;
+
+
+	// methods
+	public:
+		static bool  Allocate (ArrayView<Resource> resources, BytesU granularity, OUT Placements_t &placements, OUT Heaps_t &heaps);
+
+	private:
+		ND_ static bool  _IsIntersects (const Resource &lhs, const Resource &rhs);
+	};
+
+
+}	// FG
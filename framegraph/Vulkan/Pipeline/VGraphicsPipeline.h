@@ -3,6 +3,7 @@
 #pragma once
 
 #include "VPipelineLayout.h"
+#include <condition_variable>
 
 namespace FG
 {
@@ -24,8 +25,6 @@ namespace FG
 			EShaderDebugMode					debugMode	= Default;
 		};
 
-
-	private:
 		struct PipelineInstance
 		{
 		// variables
@@ -52,6 +51,7 @@ namespace FG
 			ND_ size_t	operator () (const PipelineInstance &value) const	{ return size_t(value._hash); }
 		};
 
+	private:
 		using Instances_t			= HashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
 		using ShaderModules_t		= FixedArray< ShaderModule, 8 >;
 		using TopologyBits_t		= GraphicsPipelineDesc::TopologyBits_t;
@@ -62,7 +62,8 @@ namespace FG
 	// variables
 	private:
 		mutable SharedMutex			_instanceGuard;
-		mutable Instances_t			_instances;
+		mutable Instances_t			_instances;		// 'VK_NULL_HANDLE' if instance is compiling on background thread
+		mutable std::condition_variable_any	_instanceReady;	// notified when pending instance is compiled or removed
 
 		PipelineLayoutID			_baseLayoutId;
 		ShaderModules_t				_shaders;
@@ -9,6 +9,68 @@
 
 namespace FG
 {
+namespace
+{
+	//
+	// Pipeline Cache Header
+	//
+	struct PipelineCacheHeader
+	{
+		static constexpr uint	Magic	= 0x43504746;	// 'FGPC'
+		static constexpr uint	Version	= 2;	// 2 - FNV-1a hash
+
+		uint		magic;
+		uint		version;
+		uint		vendorID;
+		uint		deviceID;
+		uint		driverVersion;
+		uint8_t		pipelineCacheUUID [VK_UUID_SIZE];
+		uint		_padding;		// explicit padding, must be zero to keep serialized data deterministic
+		uint64_t	dataSize;
+		uint64_t	dataHash;
+	};
+	STATIC_ASSERT( sizeof(PipelineCacheHeader) == 56 );
+
+/*
+=================================================
+	CalcCacheHash
+----
+	64-bit FNV-1a, result must not depend on
+	standard library implementation.
+=================================================
+*/
+	ND_ static uint64_t  CalcCacheHash (ArrayView<uint8_t> data)
+	{
+		uint64_t	hash = 0xcbf29ce484222325ull;
+
+		for (auto b : data)
+		{
+			hash ^= b;
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+/*
+=================================================
+	InitCacheHeader
+=================================================
+*/
+	static void  InitCacheHeader (const VDevice &dev, ArrayView<uint8_t> data, OUT PipelineCacheHeader &header)
+	{
+		auto&	props = dev.GetProperties().properties;
+
+		header.magic			= PipelineCacheHeader::Magic;
+		header.version			= PipelineCacheHeader::Version;
+		header.vendorID			= props.vendorID;
+		header.deviceID			= props.deviceID;
+		header.driverVersion	= props.driverVersion;
+		header.dataSize			= data.size();
+		header.dataHash			= CalcCacheHash( data );
+
+		MemCopy( OUT header.pipelineCacheUUID, props.pipelineCacheUUID );
+	}
+}	// namespace
 
 /*
 =================================================
@@ -64,17 +126,117 @@ namespace FG
 			dev.vkDestroyPipelineCache( dev.GetVkDevice(), _pipelinesCache, null );
 			_pipelinesCache = VK_NULL_HANDLE;
 		}
+		_hasNewPipelines = false;
 	}
 
 /*
 =================================================
 	MergeCache
+----
+	copy pipelines from 'src' to this cache,
+	'src' pipelines are marked as merged.
 =================================================
 */
-	bool VPipelineCache::MergeCache (VPipelineCache &)
+	bool VPipelineCache::MergeCache (const VDevice &dev, INOUT VPipelineCache &src)
 	{
-		// TODO
-		return false;
+		CHECK_ERR( _pipelinesCache and src._pipelinesCache );
+		CHECK_ERR( _pipelinesCache != src._pipelinesCache );
+
+		VK_CHECK( dev.vkMergePipelineCaches( dev.GetVkDevice(), _pipelinesCache, 1, &src._pipelinesCache ));
+
+		src._hasNewPipelines = false;
+		return true;
+	}
+	
+/*
+=================================================
+	Serialize
+----
+	result contains header with device and driver info
+	and pipeline cache data returned by 'vkGetPipelineCacheData'.
+=================================================
+*/
+	bool VPipelineCache::Serialize (const VDevice &dev, OUT Array<uint8_t> &data) const
+	{
+		CHECK_ERR( _pipelinesCache );
+
+		size_t	size = 0;
+		VK_CHECK( dev.vkGetPipelineCacheData( dev.GetVkDevice(), _pipelinesCache, OUT &size, null ));
+
+		data.resize( sizeof(PipelineCacheHeader) + size );
+		
+		// size may be changed if pipelines was created on other threads
+		VK_CHECK( dev.vkGetPipelineCacheData( dev.GetVkDevice(), _pipelinesCache, INOUT &size, OUT data.data() + sizeof(PipelineCacheHeader) ));
+
+		data.resize( sizeof(PipelineCacheHeader) + size );
+
+		PipelineCacheHeader		header{};
+		InitCacheHeader( dev, ArrayView<uint8_t>{ data.data() + sizeof(header), size }, OUT header );
+
+		MemCopy( OUT data.data(), BytesU::SizeOf(header), &header, BytesU::SizeOf(header) );
+		return true;
+	}
+	
+/*
+=================================================
+	Deserialize
+----
+	header is validated before passing data to the driver,
+	some drivers don't handle invalid data correctly.
+=================================================
+*/
+	bool VPipelineCache::Deserialize (const VDevice &dev, ArrayView<uint8_t> data)
+	{
+		CHECK_ERR( _pipelinesCache );
+
+		PipelineCacheHeader		header{};
+
+		if ( data.size() <= sizeof(header) )
+		{
+			FG_LOGI( "pipeline cache is empty or truncated" );
+			return false;
+		}
+
+		MemCopy( OUT &header, BytesU::SizeOf(header), data.data(), BytesU::SizeOf(header) );
+
+		ArrayView<uint8_t>		cache_data = data.section( sizeof(header), UMax );
+		PipelineCacheHeader		expected{};
+		InitCacheHeader( dev, cache_data, OUT expected );
+		
+		if ( header.magic != expected.magic or header.version != expected.version )
+		{
+			FG_LOGI( "pipeline cache has unknown format or version" );
+			return false;
+		}
+
+		if ( header.dataSize != expected.dataSize or header.dataHash != expected.dataHash )
+		{
+			FG_LOGI( "pipeline cache data is corrupted" );
+			return false;
+		}
+
+		if ( header.vendorID		!= expected.vendorID		or
+			 header.deviceID		!= expected.deviceID		or
+			 header.driverVersion	!= expected.driverVersion	or
+			 std::memcmp( header.pipelineCacheUUID, expected.pipelineCacheUUID, sizeof(header.pipelineCacheUUID) ) != 0 )
+		{
+			FG_LOGI( "pipeline cache was created for another device or driver version" );
+			return false;
+		}
+
+		VkPipelineCacheCreateInfo	info = {};
+		info.sType				= VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		info.initialDataSize	= cache_data.size();
+		info.pInitialData		= cache_data.data();
+
+		VkPipelineCache		temp_cache = VK_NULL_HANDLE;
+		VK_CHECK( dev.vkCreatePipelineCache( dev.GetVkDevice(), &info, null, OUT &temp_cache ));
+
+		VkResult	err = dev.vkMergePipelineCaches( dev.GetVkDevice(), _pipelinesCache, 1, &temp_cache );
+		dev.vkDestroyPipelineCache( dev.GetVkDevice(), temp_cache, null );
+
+		VK_CHECK( err );
+		return true;
 	}
 	
 /*
@@ -168,6 +330,245 @@ namespace FG
 		return (uint(stages) & 0xFFFFFF) | (uint(mode) << 24);
 	}
 
+/*
+=================================================
+	InitPipelineInstance
+----
+	build key for graphics pipeline instance.
+=================================================
+*/
+	bool  VPipelineCache::InitPipelineInstance (const VDevice					&dev,
+												const VGraphicsPipeline			&gppln,
+												RawPipelineLayoutID				 layoutId,
+												RawRenderPassID					 renderPassId,
+												uint							 subpassIndex,
+												uint							 viewportCount,
+												VkImageLayout					 depthLayout,
+												const VertexInputState			&vertexInput,
+												const RenderState				&renderState,
+												const EPipelineDynamicState		 dynamicStates,
+												uint							 debugMode,
+												OUT PipelineInstance			&inst)
+	{
+		inst.layoutId		= layoutId;
+		inst.dynamicState	= dynamicStates;
+		inst.renderPassId	= renderPassId;
+		inst.subpassIndex	= uint8_t(subpassIndex);
+		inst.vertexInput	= vertexInput;
+		//inst.flags		= 0;	//pipelineFlags;	// TODO
+		inst.viewportCount	= uint8_t(viewportCount);
+		inst.debugMode		= debugMode;
+		inst.renderState	= renderState;
+
+		if ( gppln._patchControlPoints )
+			inst.renderState.inputAssembly.topology = EPrimitive::Patch;
+
+		inst.vertexInput.ApplyAttribs( gppln.GetVertexAttribs() );
+		_ValidateRenderState( dev, depthLayout, INOUT inst.renderState, INOUT inst.dynamicState );
+		
+		// check topology
+		CHECK_ERR(	uint(inst.renderState.inputAssembly.topology) < gppln._supportedTopology.size() and
+					gppln._supportedTopology[uint(inst.renderState.inputAssembly.topology)] );
+
+		inst.UpdateHash();
+		return true;
+	}
+
+/*
+=================================================
+	AddPendingInstance
+----
+	adds placeholder for instance that will be compiled on background thread.
+	returns 'false' if instance is already created or pending.
+=================================================
+*/
+	bool  VPipelineCache::AddPendingInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, const PipelineInstance &inst)
+	{
+		{
+			EXLOCK( gppln._instanceGuard );
+
+			if ( not gppln._instances.insert({ inst, VK_NULL_HANDLE }).second )
+				return false;
+		}
+
+		// layout is released in 'VGraphicsPipeline::Destroy' or in 'RemovePendingInstance'
+		CHECK( resMngr.AcquireResource( inst.layoutId ));
+		return true;
+	}
+	
+/*
+=================================================
+	RemovePendingInstance
+----
+	removes placeholder if background compilation failed.
+=================================================
+*/
+	void  VPipelineCache::RemovePendingInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, const PipelineInstance &inst)
+	{
+		{
+			EXLOCK( gppln._instanceGuard );
+
+			auto	iter = gppln._instances.find( inst );
+			if ( iter == gppln._instances.end() or iter->second != VK_NULL_HANDLE )
+				return;
+
+			gppln._instances.erase( iter );
+		}
+		gppln._instanceReady.notify_all();
+		resMngr.ReleaseResource( inst.layoutId );
+	}
+	
+/*
+=================================================
+	CompilePipelineInstance
+----
+	creates pipeline for pending instance, used for background compilation.
+=================================================
+*/
+	bool  VPipelineCache::CompilePipelineInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, const PipelineInstance &inst)
+	{
+		// instance may be already created on recording thread
+		{
+			SHAREDLOCK( gppln._instanceGuard );
+
+			auto	iter = gppln._instances.find( inst );
+			CHECK_ERR( iter != gppln._instances.end() );
+
+			if ( iter->second != VK_NULL_HANDLE )
+				return true;
+		}
+		
+		VRenderPass const*		render_pass	= resMngr.GetResource( inst.renderPassId );
+		VPipelineLayout const*	layout		= resMngr.GetResource( inst.layoutId );
+		CHECK_ERR( render_pass and layout );
+
+		VkPipeline	ppln = VK_NULL_HANDLE;
+		CHECK_ERR( _CreatePipeline( resMngr.GetDevice(), gppln, inst, *render_pass, *layout, Default, Default, OUT ppln ));
+		
+		_AddInstance( resMngr, gppln, PipelineInstance{inst}, INOUT ppln );
+		return true;
+	}
+	
+/*
+=================================================
+	_FindInstance
+----
+	returns 'false' if instance is not created or compilation is not complete.
+=================================================
+*/
+	bool  VPipelineCache::_FindInstance (const VGraphicsPipeline &gppln, const PipelineInstance &inst, OUT VkPipeline &outPipeline, OUT bool &isPending)
+	{
+		SHAREDLOCK( gppln._instanceGuard );
+
+		auto	iter = gppln._instances.find( inst );
+		
+		isPending	= (iter != gppln._instances.end());
+		outPipeline	= isPending ? iter->second : VK_NULL_HANDLE;
+		isPending	= isPending and outPipeline == VK_NULL_HANDLE;
+
+		return outPipeline != VK_NULL_HANDLE;
+	}
+
+/*
+=================================================
+	_WaitInstance
+----
+	blocks until pending instance is compiled or removed,
+	returns 'false' if background compilation failed.
+=================================================
+*/
+	bool  VPipelineCache::_WaitInstance (const VGraphicsPipeline &gppln, const PipelineInstance &inst, OUT VkPipeline &outPipeline)
+	{
+		std::shared_lock	lock{ gppln._instanceGuard };
+
+		gppln._instanceReady.wait( lock, [&] ()
+			{
+				auto	iter = gppln._instances.find( inst );
+				outPipeline = (iter != gppln._instances.end() ? iter->second : VK_NULL_HANDLE);
+				return iter == gppln._instances.end() or outPipeline != VK_NULL_HANDLE;
+			});
+
+		return outPipeline != VK_NULL_HANDLE;
+	}
+
+/*
+=================================================
+	_FindCompatibleInstance
+----
+	searches for instance with same states but created for compatible render pass.
+	linear search is used, but this is used only until requested instance is compiled.
+=================================================
+*/
+	bool  VPipelineCache::_FindCompatibleInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, const PipelineInstance &inst,
+												   const VRenderPass &renderPass, OUT VkPipeline &outPipeline)
+	{
+		SHAREDLOCK( gppln._instanceGuard );
+
+		const HashVal	compat_hash = renderPass.GetCompatibilityHash();
+
+		for (auto& [key, ppln] : gppln._instances)
+		{
+			if ( ppln == VK_NULL_HANDLE					or
+				 key.layoutId		!= inst.layoutId		or
+				 key.subpassIndex	!= inst.subpassIndex	or
+				 key.viewportCount	!= inst.viewportCount	or
+				 key.debugMode		!= inst.debugMode		or
+				 key.dynamicState	!= inst.dynamicState	or
+				 not (key.renderState == inst.renderState)	or
+				 not (key.vertexInput == inst.vertexInput) )
+				continue;
+
+			VRenderPass const*	rp = resMngr.GetResource( key.renderPassId, false, true );
+
+			if ( rp and rp->GetCompatibilityHash() == compat_hash )
+			{
+				outPipeline = ppln;
+				return true;
+			}
+		}
+		return false;
+	}
+	
+/*
+=================================================
+	_AddInstance
+----
+	fills pending instance or inserts new instance,
+	if instance is already created then 'pipeline' will be destroyed and replaced.
+=================================================
+*/
+	void  VPipelineCache::_AddInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, PipelineInstance &&inst, INOUT VkPipeline &pipeline)
+	{
+		auto&	dev			= resMngr.GetDevice();
+		bool	was_pending	= false;
+		{
+			EXLOCK( gppln._instanceGuard );
+
+			auto[iter, inserted] = gppln._instances.insert({ inst, pipeline });
+		
+			if ( not inserted )
+			{
+				if ( iter->second != VK_NULL_HANDLE ) {
+					dev.vkDestroyPipeline( dev.GetVkDevice(), pipeline, null );
+					pipeline = iter->second;
+					return;
+				}
+
+				// layout was acquired in 'AddPendingInstance'
+				iter->second	= pipeline;
+				was_pending		= true;
+			}
+		}
+
+		if ( was_pending )
+		{
+			gppln._instanceReady.notify_all();
+			return;
+		}
+		
+		CHECK( resMngr.AcquireResource( inst.layoutId ));
+	}
+
 /*
 =================================================
 	CreatePipelineInstance
@@ -180,59 +581,85 @@ namespace FG
 												  const RenderState				&renderState,
 												  const EPipelineDynamicState	 dynamicStates,
 												  const ShaderDbgIndex			 debugModeIndex,
+												  EPipelineMissPolicy			 missPolicy,
 												  OUT VkPipeline				&outPipeline,
 												  OUT VPipelineLayout const*	&outLayout)
 	{
 		CHECK_ERR( logicalRP.GetRenderPassID() );
 
 		VDevice const&			dev			= fgThread.GetDevice();
+		VResourceManager &		res_mngr	= fgThread.GetResourceManager();
 		VRenderPass const*		render_pass	= fgThread.AcquireTemporary( logicalRP.GetRenderPassID() );
 		EShaderDebugMode		dbg_mode	= Default;
 		EShaderStages			dbg_stages	= Default;
 		RawPipelineLayoutID		layout_id	= gppln.GetLayoutID();
+		auto&					stat		= fgThread.EditStatistic();
 
 		if ( debugModeIndex != Default ) {
 			CHECK( _SetupShaderDebugging( fgThread, gppln, debugModeIndex, OUT dbg_mode, OUT dbg_stages, OUT layout_id ));
 		}
 
 		VGraphicsPipeline::PipelineInstance		inst;
-		inst.layoutId		= layout_id;
-		inst.dynamicState	= dynamicStates;
-		inst.renderPassId	= logicalRP.GetRenderPassID();
-		inst.subpassIndex	= uint8_t(logicalRP.GetSubpassIndex());
-		inst.vertexInput	= vertexInput;
-		//inst.flags		= 0;	//pipelineFlags;	// TODO
-		inst.viewportCount	= uint8_t(logicalRP.GetViewports().size());
-		inst.debugMode		= GetDebugModeHash( dbg_mode, dbg_stages );
-		inst.renderState	= renderState;
-
-		if ( gppln._patchControlPoints )
-			inst.renderState.inputAssembly.topology = EPrimitive::Patch;
-
-		inst.vertexInput.ApplyAttribs( gppln.GetVertexAttribs() );
-		_ValidateRenderState( dev, logicalRP, INOUT inst.renderState, INOUT inst.dynamicState );
-		
-		// check topology
-		CHECK_ERR(	uint(inst.renderState.inputAssembly.topology) < gppln._supportedTopology.size() and
-					gppln._supportedTopology[uint(inst.renderState.inputAssembly.topology)] );
-
-		inst.UpdateHash();
+		CHECK_ERR( InitPipelineInstance( dev, gppln, layout_id, logicalRP.GetRenderPassID(), logicalRP.GetSubpassIndex(),
+										 uint(logicalRP.GetViewports().size()), logicalRP.GetDepthStencilTarget()._layout,
+										 vertexInput, renderState, dynamicStates, GetDebugModeHash( dbg_mode, dbg_stages ), OUT inst ));
 		
 		outLayout = fgThread.AcquireTemporary( layout_id );
 
 		// find existing instance
+		bool	is_pending = false;
+
+		if ( _FindInstance( gppln, inst, OUT outPipeline, OUT is_pending ))
 		{
-			SHAREDLOCK( gppln._instanceGuard );
+			stat.resources.pipelineCacheHits++;
+			return true;
+		}
+		stat.resources.pipelineCacheMisses++;
+		
+		if ( missPolicy == EPipelineMissPolicy::Compatible and
+			 _FindCompatibleInstance( res_mngr, gppln, inst, *render_pass, OUT outPipeline ))
+		{
+			stat.resources.compatiblePipelineHits++;
+			return true;
+		}
 
-			auto iter = gppln._instances.find( inst );
-			if ( iter != gppln._instances.end() ) {
-				outPipeline = iter->second;
+		if ( is_pending )
+		{
+			if ( missPolicy == EPipelineMissPolicy::SkipDraw )
+			{
+				outPipeline = VK_NULL_HANDLE;
 				return true;
 			}
-		}
 
+			// wait for background compilation, pending instance is filled or removed by prewarm worker
+			if ( _WaitInstance( gppln, inst, OUT outPipeline ))
+				return true;
+
+			// compilation failed, try to create instance on current thread
+		}
 
 		// create new instance
+		CHECK_ERR( _CreatePipeline( dev, gppln, inst, *render_pass, *outLayout, dbg_mode, dbg_stages, OUT outPipeline ));
+		stat.resources.newGraphicsPipelineCount++;
+
+		_AddInstance( res_mngr, gppln, std::move(inst), INOUT outPipeline );
+		return true;
+	}
+	
+/*
+=================================================
+	_CreatePipeline
+=================================================
+*/
+	bool  VPipelineCache::_CreatePipeline (const VDevice					&dev,
+										   const VGraphicsPipeline			&gppln,
+										   const PipelineInstance			&inst,
+										   const VRenderPass				&renderPass,
+										   const VPipelineLayout			&layout,
+										   EShaderDebugMode					 dbgMode,
+										   EShaderStages					 dbgStages,
+										   OUT VkPipeline					&outPipeline)
+	{
 		_ClearTemp();
 
 		VkGraphicsPipelineCreateInfo			pipeline_info		= {};
@@ -246,9 +673,9 @@ namespace FG
 		VkPipelineVertexInputStateCreateInfo	vertex_input_info	= {};
 		VkPipelineViewportStateCreateInfo		viewport_info		= {};
 
-		CHECK_ERR( _SetShaderStages( OUT _tempStages, INOUT _tempSpecialization, INOUT _tempSpecEntries, gppln._shaders, dbg_mode, dbg_stages ));
+		CHECK_ERR( _SetShaderStages( OUT _tempStages, INOUT _tempSpecialization, INOUT _tempSpecEntries, gppln._shaders, dbgMode, dbgStages ));
 		_SetDynamicState( OUT dynamic_state_info, OUT _tempDynamicStates, inst.dynamicState );
-		_SetColorBlendState( OUT blend_info, OUT _tempAttachments, inst.renderState.color, *render_pass, inst.subpassIndex );
+		_SetColorBlendState( OUT blend_info, OUT _tempAttachments, inst.renderState.color, renderPass, inst.subpassIndex );
 		_SetMultisampleState( OUT multisample_info, inst.renderState.multisample );
 		_SetTessellationState( OUT tessellation_info, gppln._patchControlPoints );
 		_SetDepthStencilState( OUT depth_stencil_info, inst.renderState.depth, inst.renderState.stencil );
@@ -271,10 +698,10 @@ namespace FG
 		pipeline_info.pDynamicState			= (_tempDynamicStates.empty() ? null : &dynamic_state_info);
 		pipeline_info.basePipelineIndex		= -1;
 		pipeline_info.basePipelineHandle	= VK_NULL_HANDLE;
-		pipeline_info.layout				= outLayout->Handle();
+		pipeline_info.layout				= layout.Handle();
 		pipeline_info.stageCount			= uint(_tempStages.size());
 		pipeline_info.pStages				= _tempStages.data();
-		pipeline_info.renderPass			= render_pass->Handle();
+		pipeline_info.renderPass			= renderPass.Handle();
 		pipeline_info.subpass				= inst.subpassIndex;
 		
 		if ( not rasterization_info.rasterizerDiscardEnable )
@@ -289,27 +716,11 @@ namespace FG
 
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateGraphicsPipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		_hasNewPipelines = true;
 
-		fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
-		
-		// try to insert new instance
-		{
-			EXLOCK( gppln._instanceGuard );
-
-			auto[iter, inserted] = gppln._instances.insert({ std::move(inst), outPipeline });
-		
-			if ( not inserted )
-			{
-				dev.vkDestroyPipeline( dev.GetVkDevice(), outPipeline, null );
-
-				outPipeline = iter->second;
-				return true;
-			}
-		}
-		
-		CHECK( fgThread.GetResourceManager().AcquireResource( layout_id ));
 		return true;
 	}
+
 /*
 =================================================
 	CreatePipelineInstance
@@ -349,7 +760,7 @@ namespace FG
 		inst.renderState	= renderState;
 		
 		inst.renderState.inputAssembly.topology	= mppln._topology;
-		_ValidateRenderState( dev, logicalRP, INOUT inst.renderState, INOUT inst.dynamicState );
+		_ValidateRenderState( dev, logicalRP.GetDepthStencilTarget()._layout, INOUT inst.renderState, INOUT inst.dynamicState );
 
 		inst.UpdateHash();
 		
@@ -422,6 +833,7 @@ namespace FG
 
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateGraphicsPipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		_hasNewPipelines = true;
 		
 		fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
 		
@@ -544,6 +956,7 @@ namespace FG
 
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateComputePipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		_hasNewPipelines = true;
 		
 		fgThread.EditStatistic().resources.newComputePipelineCount++;
 		
@@ -752,6 +1165,7 @@ namespace FG
 			pipeline_info.basePipelineHandle	= VK_NULL_HANDLE;
 
 			VK_CHECK( dev.vkCreateRayTracingPipelinesNV( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &table.pipeline ));
+			_hasNewPipelines = true;
 			fgThread.EditStatistic().resources.newRayTracingPipelineCount++;
 			
 			CHECK( res_mngr.AcquireResource( layout_id ));
@@ -1402,8 +1816,8 @@ namespace FG
 	_ValidateRenderState
 =================================================
 */
-	void VPipelineCache::_ValidateRenderState (const VDevice &dev, const VLogicalRenderPass &logicalRP,
-											   INOUT RenderState &renderState, INOUT EPipelineDynamicState &dynamicStates) const
+	void VPipelineCache::_ValidateRenderState (const VDevice &dev, VkImageLayout depthLayout,
+											   INOUT RenderState &renderState, INOUT EPipelineDynamicState &dynamicStates)
 	{
 		if ( renderState.rasterization.rasterizerDiscard )
 		{
@@ -1523,7 +1937,7 @@ namespace FG
 		#ifdef FG_DEBUG
 		{
 			BEGIN_ENUM_CHECKS();
-			switch ( logicalRP.GetDepthStencilTarget()._layout )
+			switch ( depthLayout )
 			{
 				case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL :
 					// depth & stencil test are allowed
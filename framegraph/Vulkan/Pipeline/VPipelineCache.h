@@ -63,6 +63,8 @@ namespace FG
 		using ShaderModule_t			= VGraphicsPipeline::ShaderModule;
 
 	public:
+		using PipelineInstance			= VGraphicsPipeline::PipelineInstance;
+
 		struct BufferCopyRegion
 		{
 			VLocalBuffer const*		srcBuffer	= null;
@@ -75,6 +77,7 @@ namespace FG
 	// variables
 	private:
 		VkPipelineCache				_pipelinesCache;
+		bool						_hasNewPipelines	= false;	// pipelines was created after last merge
 
 		// temporary arrays
 		ShaderStages_t				_tempStages;			// TODO: use custom allocator?
@@ -102,7 +105,13 @@ namespace FG
 		bool Initialize (const VDevice &dev);
 		void Deinitialize (const VDevice &dev);
 
-		bool MergeCache (VPipelineCache &);
+		bool MergeCache (const VDevice &dev, INOUT VPipelineCache &src);
+
+		bool Serialize (const VDevice &dev, OUT Array<uint8_t> &data) const;
+		bool Deserialize (const VDevice &dev, ArrayView<uint8_t> data);
+
+		ND_ bool  IsCreated ()			const	{ return _pipelinesCache != VK_NULL_HANDLE; }
+		ND_ bool  HasNewPipelines ()	const	{ return _hasNewPipelines; }
 
 		bool CreatePipelineInstance (VCommandBuffer					&fgThread,
 									 const VLogicalRenderPass		&logicalRP,
@@ -111,6 +120,7 @@ namespace FG
 									 const RenderState				&renderState,
 									 const EPipelineDynamicState	 dynamicStates,
 									 const ShaderDbgIndex			 debugModeIndex,
+									 EPipelineMissPolicy			 missPolicy,
 									 OUT VkPipeline					&outPipeline,
 									 OUT VPipelineLayout const*		&outLayout);
 		
@@ -140,9 +150,37 @@ namespace FG
 							  INOUT VRayTracingShaderTable	&shaderTable,
 							  OUT BufferCopyRegions_t		&copyRegions);
 
+		// background compilation
+		static bool InitPipelineInstance (const VDevice					&dev,
+										  const VGraphicsPipeline		&gpipeline,
+										  RawPipelineLayoutID			 layoutId,
+										  RawRenderPassID				 renderPassId,
+										  uint							 subpassIndex,
+										  uint							 viewportCount,
+										  VkImageLayout					 depthLayout,
+										  const VertexInputState		&vertexInput,
+										  const RenderState				&renderState,
+										  const EPipelineDynamicState	 dynamicStates,
+										  uint							 debugMode,
+										  OUT PipelineInstance			&inst);
+
+		static bool AddPendingInstance (VResourceManager &resMngr, const VGraphicsPipeline &gpipeline, const PipelineInstance &inst);
+		static void RemovePendingInstance (VResourceManager &resMngr, const VGraphicsPipeline &gpipeline, const PipelineInstance &inst);
+
+		bool CompilePipelineInstance (VResourceManager &resMngr, const VGraphicsPipeline &gpipeline, const PipelineInstance &inst);
+
 
 	private:
 		bool _CreatePipelineCache (const VDevice &dev);
+		
+		bool _CreatePipeline (const VDevice &dev, const VGraphicsPipeline &gpipeline, const PipelineInstance &inst, const VRenderPass &renderPass,
+							  const VPipelineLayout &layout, EShaderDebugMode dbgMode, EShaderStages dbgStages, OUT VkPipeline &outPipeline);
+
+		static bool _FindInstance (const VGraphicsPipeline &gpipeline, const PipelineInstance &inst, OUT VkPipeline &outPipeline, OUT bool &isPending);
+		static bool _WaitInstance (const VGraphicsPipeline &gpipeline, const PipelineInstance &inst, OUT VkPipeline &outPipeline);
+		static bool _FindCompatibleInstance (VResourceManager &resMngr, const VGraphicsPipeline &gpipeline, const PipelineInstance &inst,
+											 const VRenderPass &renderPass, OUT VkPipeline &outPipeline);
+		static void _AddInstance (VResourceManager &resMngr, const VGraphicsPipeline &gpipeline, PipelineInstance &&inst, INOUT VkPipeline &pipeline);
 
 		template <typename Pipeline>
 		bool _SetupShaderDebugging (VCommandBuffer &fgThread, const Pipeline &ppln, ShaderDbgIndex debugModeIndex,
@@ -208,8 +246,8 @@ namespace FG
 								OUT VkRayTracingShaderGroupCreateInfoNV &group_ci);
 	#endif
 
-		void _ValidateRenderState (const VDevice &dev, const VLogicalRenderPass &logicalRP,
-								   INOUT RenderState &renderState, INOUT EPipelineDynamicState &dynamicStates) const;
+		static void _ValidateRenderState (const VDevice &dev, VkImageLayout depthLayout,
+										  INOUT RenderState &renderState, INOUT EPipelineDynamicState &dynamicStates);
 	};
 
 
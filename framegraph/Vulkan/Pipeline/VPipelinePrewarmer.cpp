@@ -0,0 +1,219 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VPipelinePrewarmer.h"
+#include "VFrameGraph.h"
+#include "VEnumCast.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	VPipelinePrewarmer::VPipelinePrewarmer (VFrameGraph &fg) :
+		_instance{ fg }
+	{}
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	VPipelinePrewarmer::~VPipelinePrewarmer ()
+	{
+		for (auto& pt : _perThread) {
+			CHECK( not pt.cache.IsCreated() );
+		}
+	}
+
+/*
+=================================================
+	Deinitialize
+----
+	waits for all pending jobs.
+=================================================
+*/
+	void  VPipelinePrewarmer::Deinitialize ()
+	{
+		_workers.Stop();
+
+		EXLOCK( _perThreadGuard );
+
+		for (auto& pt : _perThread)
+		{
+			ASSERT( not pt.inUse );
+			_instance.MergePipelineCache( INOUT pt.cache );
+			pt.cache.Deinitialize( _instance.GetDevice() );
+		}
+	}
+
+/*
+=================================================
+	Prewarm
+----
+	render targets are initialized by 'VLogicalRenderPass::InitRenderTarget'
+	as in 'VLogicalRenderPass::Create', so pipeline instance
+	will be found in draw task if states are the same.
+=================================================
+*/
+	bool  VPipelinePrewarmer::Prewarm (RawGPipelineID pipelineId, const RenderPassDesc &rpDesc, const RenderState &inRenderState,
+									   const VertexInputState &vertexInput, EPipelineDynamicState dynamicState)
+	{
+		using ColorTarget			= VLogicalRenderPass::ColorTarget;
+		using DepthStencilTarget	= VLogicalRenderPass::DepthStencilTarget;
+		using ColorTargets_t		= VLogicalRenderPass::ColorTargets_t;
+
+		VResourceManager&			res_mngr	= _instance.GetResourceManager();
+		VGraphicsPipeline const*	gppln		= res_mngr.GetResource( pipelineId );
+		CHECK_ERR( gppln );
+
+		ColorTargets_t			color_targets;
+		DepthStencilTarget		depth_target;
+		RenderState				render_state	= inRenderState;
+		Optional<MultiSamples>	samples;
+
+		for (size_t i = 0; i < rpDesc.renderTargets.size(); ++i)
+		{
+			ColorTarget		dst;
+
+			if ( not rpDesc.renderTargets[i].image )
+				continue;
+
+			VImage const*	image = res_mngr.GetResource( rpDesc.renderTargets[i].image );
+			CHECK_ERR( image );
+			CHECK_ERR( VLogicalRenderPass::InitRenderTarget( rpDesc, uint(i), image->Description(), INOUT samples, OUT dst ));
+
+			// layouts are calculated in the same way as in 'VTaskProcessor::_AddRenderTargetBarriers'
+			if ( EPixelFormat_HasDepthOrStencil( dst.desc.format ))
+			{
+				const bool	depth_write	= rpDesc.depthState.write or render_state.depth.write or (dst.loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR);
+
+				dst.state  &= ~(depth_write ? EResourceState::Unknown : EResourceState::_Write);
+				dst._layout	= EResourceState_ToImageLayout( dst.state, image->AspectMask() );
+
+				depth_target = DepthStencilTarget{ dst };
+			}
+			else
+			{
+				dst._layout	= render_state.rasterization.rasterizerDiscard ? VK_IMAGE_LAYOUT_UNDEFINED :
+								EResourceState_ToImageLayout( dst.state, image->AspectMask() );
+
+				color_targets.push_back( dst );
+			}
+		}
+
+		VLogicalRenderPass::UpdateMultisampleState( samples, INOUT render_state.multisample );
+
+		// same as in 'VTaskProcessor::_GetPipeline'
+		dynamicState |= EPipelineDynamicState::Viewport | EPipelineDynamicState::Scissor;
+		dynamicState |= (rpDesc.shadingRate.image.IsValid() ? EPipelineDynamicState::ShadingRatePalette : Default);
+
+		// render passes are never released, same as in 'VTaskProcessor::_CreateRenderPass'
+		RawRenderPassID		rp_id = res_mngr.CreateRenderPass( color_targets, depth_target, "" );
+		CHECK_ERR( rp_id );
+
+		PipelineInstance	inst;
+		CHECK_ERR( VPipelineCache::InitPipelineInstance( _instance.GetDevice(), *gppln, gppln->GetLayoutID(), rp_id, 0, uint(rpDesc.viewports.size()),
+														 depth_target._layout, vertexInput, render_state, dynamicState, 0, OUT inst ));
+
+		// already created or pending
+		if ( not VPipelineCache::AddPendingInstance( res_mngr, *gppln, inst ))
+			return true;
+
+		std::call_once( _workersInit, [this] () { CHECK( _workers.Start( FG_PipelinePrewarmThreads, "FG_PipelinePrewarm" )); });
+
+		// pipeline must be alive until compilation is complete
+		CHECK( res_mngr.AcquireResource( pipelineId ));
+
+		if ( not _workers.Enqueue( [this, pipelineId, inst] () { _Compile( pipelineId, inst ); }))
+		{
+			VPipelineCache::RemovePendingInstance( res_mngr, *gppln, inst );
+			res_mngr.ReleaseResource( pipelineId );
+			return false;
+		}
+		return true;
+	}
+
+/*
+=================================================
+	_Compile
+=================================================
+*/
+	void  VPipelinePrewarmer::_Compile (RawGPipelineID pipelineId, const PipelineInstance &inst)
+	{
+		VResourceManager&			res_mngr	= _instance.GetResourceManager();
+		VGraphicsPipeline const*	gppln		= res_mngr.GetResource( pipelineId );
+		PerThread*					pt			= _AcquirePerThread();
+
+		// pending instance must be filled or removed, otherwise 'EPipelineMissPolicy::Block' will wait forever
+		if ( gppln )
+		{
+			if ( pt and
+				 _instance.UpdatePipelineCache( INOUT pt->cache, INOUT pt->cacheVersion ) and
+				 pt->cache.CompilePipelineInstance( res_mngr, *gppln, inst ))
+			{
+				_compiledCount.fetch_add( 1, memory_order_relaxed );
+				_instance.MergePipelineCache( INOUT pt->cache );
+			}
+			else
+				VPipelineCache::RemovePendingInstance( res_mngr, *gppln, inst );
+		}
+
+		_ReleasePerThread( pt );
+		res_mngr.ReleaseResource( pipelineId );
+	}
+
+/*
+=================================================
+	_AcquirePerThread
+----
+	number of caches is equal to number of threads,
+	so free cache always exists.
+=================================================
+*/
+	VPipelinePrewarmer::PerThread*  VPipelinePrewarmer::_AcquirePerThread ()
+	{
+		EXLOCK( _perThreadGuard );
+
+		for (auto& pt : _perThread)
+		{
+			if ( not pt.inUse )
+			{
+				pt.inUse = true;
+				return &pt;
+			}
+		}
+		RETURN_ERR( "no free pipeline cache" );
+	}
+
+/*
+=================================================
+	_ReleasePerThread
+=================================================
+*/
+	void  VPipelinePrewarmer::_ReleasePerThread (PerThread *pt)
+	{
+		if ( not pt )
+			return;
+
+		EXLOCK( _perThreadGuard );
+		pt->inUse = false;
+	}
+
+/*
+=================================================
+	GetStatistics
+=================================================
+*/
+	void  VPipelinePrewarmer::GetStatistics (INOUT ResourceStatistics &stat)
+	{
+		const uint	count = _compiledCount.exchange( 0, memory_order_relaxed );
+
+		stat.prewarmedPipelineCount		+= count;
+		stat.newGraphicsPipelineCount	+= count;
+	}
+
+
+}	// FG
@@ -0,0 +1,70 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compiles graphics pipeline instances on background threads.
+	Pending instances are added to 'VGraphicsPipeline' as placeholders,
+	see 'EPipelineMissPolicy' for how they are handled during recording.
+*/
+
+#pragma once
+
+#include "framegraph/Public/FrameGraph.h"
+#include "VPipelineCache.h"
+#include "stl/ThreadSafe/WorkerPool.h"
+
+namespace FG
+{
+
+	//
+	// Pipeline Prewarmer
+	//
+
+	class VPipelinePrewarmer final
+	{
+	// types
+	private:
+		using PipelineInstance	= VPipelineCache::PipelineInstance;
+		using ResourceStatistics= IFrameGraph::ResourceStatistics;
+
+		struct PerThread
+		{
+			VPipelineCache		cache;
+			uint				cacheVersion	= 0;
+			bool				inUse			= false;
+		};
+		using PerThread_t		= StaticArray< PerThread, FG_PipelinePrewarmThreads >;
+
+
+	// variables
+	private:
+		VFrameGraph &			_instance;
+
+		WorkerPool				_workers;
+		std::once_flag			_workersInit;
+
+		Mutex					_perThreadGuard;
+		PerThread_t				_perThread;
+
+		Atomic<uint>			_compiledCount	{0};
+
+
+	// methods
+	public:
+		explicit VPipelinePrewarmer (VFrameGraph &fg);
+		~VPipelinePrewarmer ();
+
+		void Deinitialize ();
+
+		bool Prewarm (RawGPipelineID pipelineId, const RenderPassDesc &renderPass, const RenderState &renderState,
+					  const VertexInputState &vertexInput, EPipelineDynamicState dynamicState);
+
+		void GetStatistics (INOUT ResourceStatistics &);
+
+	private:
+		void _Compile (RawGPipelineID pipelineId, const PipelineInstance &inst);
+
+		ND_ PerThread*  _AcquirePerThread ();
+			void		_ReleasePerThread (PerThread *);
+	};
+
+
+}	// FG
@@ -3,6 +3,7 @@
 #include "VLogicalRenderPass.h"
 #include "VCommandBuffer.h"
 #include "VEnumCast.h"
+#include "stl/Algorithms/RadixSort.h"
 
 namespace FG
 {
@@ -53,7 +54,8 @@ namespace {
 		_area				= desc.area;
 		//_parallelExecution= desc.parallelExecution;
 		//_canBeMerged		= desc.canBeMerged;
-		//_useSecondaryCmdbuf	= desc.useSecondaryCmdbuf;
+		_useSecondaryCmdbuf	= desc.useSecondaryCmdbuf;
+		_sortDrawTasks		= desc.sortDrawTasks;
 		
 		Optional<MultiSamples>	samples;
 
@@ -83,50 +85,15 @@ namespace {
 
 			dst.imagePtr	= fgThread.ToLocal( src.image );
 			CHECK_ERR( dst.imagePtr );
-
-			if ( src.desc.has_value() ) {
-				dst.desc = *src.desc;
-				dst.desc.Validate( dst.imagePtr->Description() );
-			}else
-				dst.desc = ImageViewDesc{dst.imagePtr->Description()};
-
-			dst.imageId		= src.image;
-			dst.samples		= VEnumCast( dst.imagePtr->Description().samples );
-			dst.loadOp		= VEnumCast( src.loadOp );
-			dst.storeOp		= VEnumCast( src.storeOp );
-			dst.state		= EResourceState::Unknown;
-			dst.index		= uint(i);
-			dst._imageHash	= HashOf( dst.imageId ) + HashOf( dst.desc );
+			CHECK_ERR( InitRenderTarget( desc, uint(i), dst.imagePtr->Description(), INOUT samples, OUT dst ));
 
 			ConvertClearValue( src.clearValue, OUT _clearValues[i] );
 
-			// validate image view description
-			if ( dst.desc.format == EPixelFormat::Unknown )
-				dst.desc.format = dst.imagePtr->Description().format;
-
-			if ( samples.has_value() )
-				CHECK_ERR( *samples == dst.imagePtr->Description().samples )
-			else
-				samples = dst.imagePtr->Description().samples;
-
-			// add resource state flags
-			if ( desc.area.left == 0 and desc.area.right  == int(dst.imagePtr->Width())  and
-				 desc.area.top  == 0 and desc.area.bottom == int(dst.imagePtr->Height()) )
-			{
-				if ( src.loadOp  == EAttachmentLoadOp::Clear or src.loadOp  == EAttachmentLoadOp::Invalidate )
-					dst.state |= EResourceState::InvalidateBefore;
-
-				if ( src.storeOp == EAttachmentStoreOp::Invalidate )
-					dst.state |= EResourceState::InvalidateAfter;
-			}
-
 			// add color or depth-stencil render target
 			if ( EPixelFormat_HasDepthOrStencil( dst.desc.format ))
 			{
 				ASSERT( RenderTargetID(i) == RenderTargetID::DepthStencil );
 				ASSERT( AllBits( dst.imagePtr->Description().usage, EImageUsage::DepthStencilAttachment ));
-				
-				dst.state |= EResourceState::DepthStencilAttachmentReadWrite;	// TODO: add support for other layouts
 
 				_depthStencilTarget = DepthStencilTarget{ dst };
 			}
@@ -134,25 +101,12 @@ namespace {
 			{
 				ASSERT( AnyBits( dst.imagePtr->Description().usage, EImageUsage::ColorAttachment | EImageUsage::ColorAttachmentBlend ));
 
-				dst.state |= EResourceState::ColorAttachmentReadWrite;		// TODO: remove 'Read' state if blending disabled or 'loadOp' is 'Clear'
-
 				_colorTargets.push_back( dst );
 			}
 		}
 
 		// validate image samples
-		if ( samples.has_value() )
-		{
-			if ( _multisampleState.samples != *samples )
-			{
-				//FG_LOGD( "Render pass attachment sample count was changed, sample mask updated" );
-
-				for (auto& mask : _multisampleState.sampleMask) {
-					mask = UMax;
-				}
-				_multisampleState.samples = *samples;
-			}
-		}
+		UpdateMultisampleState( samples, INOUT _multisampleState );
 
 		// create viewports and default scissors
 		for (auto& src : desc.viewports)
@@ -258,6 +212,81 @@ namespace {
 	#endif
 	}
 
+/*
+=================================================
+	InitRenderTarget
+----
+	'imagePtr' is not set, it is not available for prewarming.
+=================================================
+*/
+	bool  VLogicalRenderPass::InitRenderTarget (const RenderPassDesc &desc, uint index, const ImageDesc &imageDesc,
+												INOUT Optional<MultiSamples> &samples, OUT ColorTarget &dst)
+	{
+		const auto&		src = desc.renderTargets[index];
+		CHECK_ERR( src.image );
+
+		if ( src.desc.has_value() ) {
+			dst.desc = *src.desc;
+			dst.desc.Validate( imageDesc );
+		}else
+			dst.desc = ImageViewDesc{imageDesc};
+
+		dst.imageId		= src.image;
+		dst.samples		= VEnumCast( imageDesc.samples );
+		dst.loadOp		= VEnumCast( src.loadOp );
+		dst.storeOp		= VEnumCast( src.storeOp );
+		dst.state		= EResourceState::Unknown;
+		dst.index		= index;
+		dst._imageHash	= HashOf( dst.imageId ) + HashOf( dst.desc );
+
+		// validate image view description
+		if ( dst.desc.format == EPixelFormat::Unknown )
+			dst.desc.format = imageDesc.format;
+
+		if ( samples.has_value() )
+			CHECK_ERR( *samples == imageDesc.samples )
+		else
+			samples = imageDesc.samples;
+
+		// add resource state flags
+		if ( desc.area.left == 0 and desc.area.right  == int(imageDesc.dimension.x) and
+			 desc.area.top  == 0 and desc.area.bottom == int(imageDesc.dimension.y) )
+		{
+			if ( src.loadOp  == EAttachmentLoadOp::Clear or src.loadOp  == EAttachmentLoadOp::Invalidate )
+				dst.state |= EResourceState::InvalidateBefore;
+
+			if ( src.storeOp == EAttachmentStoreOp::Invalidate )
+				dst.state |= EResourceState::InvalidateAfter;
+		}
+
+		if ( EPixelFormat_HasDepthOrStencil( dst.desc.format ))
+			dst.state |= EResourceState::DepthStencilAttachmentReadWrite;	// TODO: add support for other layouts
+		else
+			dst.state |= EResourceState::ColorAttachmentReadWrite;			// TODO: remove 'Read' state if blending disabled or 'loadOp' is 'Clear'
+
+		return true;
+	}
+	
+/*
+=================================================
+	UpdateMultisampleState
+----
+	sample count must be the same as in render targets.
+=================================================
+*/
+	void  VLogicalRenderPass::UpdateMultisampleState (const Optional<MultiSamples> &samples, INOUT RS::MultisampleState &state)
+	{
+		if ( samples.has_value() and state.samples != *samples )
+		{
+			//FG_LOGD( "Render pass attachment sample count was changed, sample mask updated" );
+
+			for (auto& mask : state.sampleMask) {
+				mask = UMax;
+			}
+			state.samples = *samples;
+		}
+	}
+	
 /*
 =================================================
 	Destroy
@@ -308,10 +337,53 @@ namespace {
 			_mutableBuffers = { buf_ptr, buffers.size() };
 		}
 
+		if ( _sortDrawTasks )
+			_SortDrawTasks();
+
 		_isSubmited = true;
 		return true;
 	}
 	
+/*
+=================================================
+	_SortDrawTasks
+----
+	key: layer (8 bits), pipeline (16 bits), resources (24 bits), depth (16 bits).
+	Pipelines and resources are replaced by indices in order of first use,
+	so sorting is deterministic and tasks with same key keep submission order.
+=================================================
+*/
+	void VLogicalRenderPass::_SortDrawTasks ()
+	{
+		using Item = Pair< uint64_t, IDrawTask* >;
+
+		const size_t	count = _drawTasks.size();
+		if ( count < 2 )
+			return;
+
+		HashMap< void const*, uint >	pipelines;
+		HashMap< size_t, uint >			resources;
+
+		auto*	items	= _allocator->Alloc< Item >( count );
+		auto*	temp	= _allocator->Alloc< Item >( count );
+		CHECK_ERRV( items and temp );
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto&			info	= _drawTasks[i]->GetSortInfo();
+			const uint64_t	ppln	= Min( pipelines.insert({ info.pipeline, uint(pipelines.size()) }).first->second, 0xFFFFu );
+			const uint64_t	res		= Min( resources.insert({ size_t(info.resources), uint(resources.size()) }).first->second, 0xFF'FFFFu );
+
+			items[i] = { (uint64_t(info.layer) << 56) | (ppln << 40) | (res << 16) | uint64_t(info.depth), _drawTasks[i] };
+		}
+
+		RadixSort( items, temp, count, [] (const Item &x) { return x.first; });
+
+		for (size_t i = 0; i < count; ++i) {
+			_drawTasks[i] = items[i].second;
+		}
+	}
+	
 /*
 =================================================
 	_SetRenderPass
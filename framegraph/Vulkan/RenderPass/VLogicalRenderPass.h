@@ -63,6 +63,7 @@ namespace FG
 		RawFramebufferID			_framebufferId;
 		RawRenderPassID				_renderPassId;
 		uint						_subpassIndex			= 0;
+		uint						_inputAttachments		= 0;	// bit per render target, set by 'VSubpassMerger'
 
 		// TODO: DOD ?
 		Array< IDrawTask *>			_drawTasks;				// all draw tasks created with custom allocator in FrameGraph and
@@ -84,7 +85,8 @@ namespace FG
 		RectI						_area;
 		//bool						_parallelExecution		= true;
 		//bool						_canBeMerged			= true;
-		//bool						_useSecondaryCmdbuf		= false;
+		bool						_useSecondaryCmdbuf		= false;
+		bool						_sortDrawTasks			= false;
 		bool						_isSubmited				= false;
 		
 		VPipelineResourceSet		_perPassResources;
@@ -110,6 +112,11 @@ namespace FG
 		bool Create (VCommandBuffer &, const RenderPassDesc &);
 		void Destroy (VResourceManager &);
 
+		// used in 'Create' and in 'VPipelinePrewarmer', so pipeline instances are the same
+		ND_ static bool  InitRenderTarget (const RenderPassDesc &desc, uint index, const ImageDesc &imageDesc,
+										   INOUT Optional<MultiSamples> &samples, OUT ColorTarget &dst);
+			static void  UpdateMultisampleState (const Optional<MultiSamples> &samples, INOUT RS::MultisampleState &state);
+
 
 		template <typename DrawTaskType, typename ...Args>
 		bool AddTask (Args&& ...args)
@@ -123,10 +130,13 @@ namespace FG
 		bool Submit (VCommandBuffer &, ArrayView<Pair<RawImageID, EResourceState>>, ArrayView<Pair<RawBufferID, EResourceState>>);
 
 		void _SetRenderPass (RawRenderPassID rp, uint subpass, RawFramebufferID fb, uint depthIndex);
+		void _SetInputAttachments (uint mask)								{ _inputAttachments = mask; }
 		void _SetShaderDebugIndex (ShaderDbgIndex id);
 		
 		bool GetShadingRateImage (OUT VLocalImage const* &, OUT ImageViewDesc &) const;
 
+		void _SortDrawTasks ();
+
 		ND_ ArrayView< IDrawTask *>				GetDrawTasks ()				const	{ return _drawTasks; }
 		
 		ND_ ColorTargets_t const&				GetColorTargets ()			const	{ return _colorTargets; }
@@ -136,10 +146,12 @@ namespace FG
 		ND_ RectI const&						GetArea ()					const	{ return _area; }
 
 		ND_ bool								IsSubmited ()				const	{ return _isSubmited; }
+		ND_ bool								UseSecondaryCmdbuf ()		const	{ return _useSecondaryCmdbuf; }
 		
 		ND_ RawFramebufferID					GetFramebufferID ()			const	{ return _framebufferId; }
 		ND_ RawRenderPassID						GetRenderPassID ()			const	{ return _renderPassId; }
 		ND_ uint								GetSubpassIndex ()			const	{ return _subpassIndex; }
+		ND_ uint								GetInputAttachments ()		const	{ return _inputAttachments; }
 
 		ND_ ArrayView<VkViewport>				GetViewports ()				const	{ return _viewports; }
 		ND_ ArrayView<VkRect2D>					GetScissors ()				const	{ return _defaultScissors; }
@@ -26,16 +26,45 @@ namespace FG
 */
 	VRenderPass::VRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses)
 	{
-		_Initialize( logicalPasses );
+		CHECK( logicalPasses.size() and logicalPasses.size() <= maxSubpasses );
+
+		if ( logicalPasses.empty() )
+			return;
+
+		if ( logicalPasses.size() > 1 )
+		{
+			_Initialize( logicalPasses );
+			return;
+		}
+
+		const auto *	pass = logicalPasses.front();
+
+		_Initialize( pass->GetColorTargets(), pass->GetDepthStencilTarget() );
 	}
-		
-	bool VRenderPass::_Initialize (ArrayView<VLogicalRenderPass*> logicalPasses)
+	
+/*
+=================================================
+	constructor
+----
+	used to create render pass without logical render pass,
+	attachment layouts must be same as in 'VTaskProcessor::_AddRenderTargetBarriers'.
+=================================================
+*/
+	VRenderPass::VRenderPass (ArrayView<ColorTarget> colorTargets, const DepthStencilTarget &depthStencilTarget)
+	{
+		_Initialize( colorTargets, depthStencilTarget );
+	}
+	
+/*
+=================================================
+	_Initialize
+=================================================
+*/
+	bool VRenderPass::_Initialize (ArrayView<ColorTarget> colorTargets, const DepthStencilTarget &depthStencilTarget)
 	{
 		EXLOCK( _drCheck );
-		CHECK_ERR( logicalPasses.size() == 1 );		// not supported yet
 
-		const auto *	pass		= logicalPasses.front();
-		uint			max_index	= 0;
+		uint	max_index	= 0;
 
 		_attachments.resize( _attachments.capacity() );
 		
@@ -48,7 +77,7 @@ namespace FG
 		
 
 		// setup color attachments
-		for (auto& ct : pass->GetColorTargets())
+		for (auto& ct : colorTargets)
 		{
 			const VkImageLayout			layout	= ct._layout;
 			VkAttachmentDescription&	desc	= _attachments[ ct.index ];
@@ -72,9 +101,9 @@ namespace FG
 
 
 		// setup depth stencil attachment
-		if ( pass->GetDepthStencilTarget().IsDefined() )
+		if ( depthStencilTarget.IsDefined() )
 		{
-			const auto&					ds_target	= pass->GetDepthStencilTarget();
+			const auto&					ds_target	= depthStencilTarget;
 			const VkImageLayout			layout		= ds_target._layout;
 			VkAttachmentDescription&	desc		= _attachments[max_index];
 
@@ -106,9 +135,222 @@ namespace FG
 
 
 		_CalcHash( _createInfo, OUT _hash, OUT _attachmentHash, OUT _subpassesHash );
+		_compatibilityHash = _CalcCompatibilityHash( _createInfo );
+		return true;
+	}
+
+/*
+=================================================
+	_Initialize
+----
+	creates render pass with subpasses, see 'VSubpassMerger'.
+	Attachment has the same initial and final layout as in the first subpass where it is used,
+	this layout is used by 'VTaskProcessor' to track image state,
+	transitions between subpasses are performed by render pass.
+=================================================
+*/
+	bool VRenderPass::_Initialize (ArrayView<VLogicalRenderPass*> logicalPasses)
+	{
+		using SubpassUsage	= VSubpassMerger::SubpassUsage;
+		using Usages_t		= FixedArray< SubpassUsage, maxSubpasses >;
+
+		EXLOCK( _drCheck );
+		CHECK_ERR( logicalPasses.size() <= maxSubpasses );
+
+		Usages_t	usages;
+		uint		depth_index		= 0;
+		bool		has_depth		= false;
+		uint		defined_mask	= 0;		// attachments that are used in previous subpasses
+
+		// depth stencil attachment is placed after all color attachments
+		for (auto* pass : logicalPasses)
+		{
+			for (auto& ct : pass->GetColorTargets()) {
+				depth_index = Max( ct.index+1, depth_index );
+			}
+			has_depth |= pass->GetDepthStencilTarget().IsDefined();
+		}
+
+		const auto	SlotToIndex = [depth_index] (uint slot) -> uint
+		{
+			return slot == VSubpassMerger::DepthSlot ? depth_index : slot;
+		};
+
+		const auto	SetAttachment = [this, &defined_mask] (const ColorTarget &ct, uint index, bool isDepth)
+		{
+			VkAttachmentDescription&	desc = _attachments[ index ];
+
+			// store operation is taken from the last subpass
+			if ( defined_mask & (1u << index) )
+			{
+				desc.storeOp = ct.storeOp;
+				if ( isDepth )
+					desc.stencilStoreOp = ct.storeOp;
+				return;
+			}
+
+			defined_mask |= (1u << index);
+
+			desc.flags			= 0;
+			desc.format			= VEnumCast( ct.desc.format );
+			desc.samples		= ct.samples;
+			desc.loadOp			= ct.loadOp;
+			desc.storeOp		= ct.storeOp;
+			desc.initialLayout	= ct._layout;
+			desc.finalLayout	= ct._layout;
+
+			if ( isDepth )
+			{
+				desc.stencilLoadOp	= ct.loadOp;
+				desc.stencilStoreOp	= ct.storeOp;
+			}
+		};
+
+		_attachments.resize( depth_index + uint(has_depth) );
+		_subpasses.resize( logicalPasses.size() );
+		usages.resize( logicalPasses.size() );
+
+		for (size_t i = 0; i < logicalPasses.size(); ++i)
+		{
+			auto&					pass		= *logicalPasses[i];
+			VkSubpassDescription&	subpass		= _subpasses[i];
+			SubpassUsage&			usage		= usages[i];
+			const uint				input_mask	= pass.GetInputAttachments();
+
+			subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+			// setup input attachments, 'input_attachment_index' in shader is a render target index
+			if ( input_mask )
+			{
+				subpass.pInputAttachments = _inputAttachRef.end();
+
+				for (uint slot = 0; (input_mask >> slot) != 0; ++slot)
+				{
+					const uint	index = SlotToIndex( slot );
+
+					if ( (input_mask & (1u << slot)) and (defined_mask & (1u << index)) )
+						_inputAttachRef.push_back({ index, (slot == VSubpassMerger::DepthSlot ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
+																								VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) });
+					else
+						_inputAttachRef.push_back({ VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED });
+
+					++subpass.inputAttachmentCount;
+				}
+				usage.inputMask = input_mask;
+			}
+
+			// setup color attachments
+			subpass.pColorAttachments = _attachmentRef.end();
+
+			for (auto& ct : pass.GetColorTargets())
+			{
+				SetAttachment( ct, ct.index, false );
+
+				_attachmentRef.push_back({ ct.index, ct._layout });
+				++subpass.colorAttachmentCount;
+				usage.outputMask |= (1u << ct.index);
+			}
+
+			if ( subpass.colorAttachmentCount == 0 )
+				subpass.pColorAttachments = null;
+
+			// setup depth stencil attachment
+			if ( pass.GetDepthStencilTarget().IsDefined() )
+			{
+				const auto&	ds_target = pass.GetDepthStencilTarget();
+
+				SetAttachment( ds_target, depth_index, true );
+
+				subpass.pDepthStencilAttachment = _attachmentRef.end();
+				_attachmentRef.push_back({ depth_index, ds_target._layout });
+				usage.outputMask |= (1u << VSubpassMerger::DepthSlot);
+			}
+		}
+
+		// setup preserve attachments
+		for (size_t i = 0; i < _subpasses.size(); ++i)
+		{
+			VkSubpassDescription&	subpass	= _subpasses[i];
+			const uint				mask	= VSubpassMerger::GetPreserveMask( usages, uint(i) );
+
+			if ( mask == 0 )
+				continue;
+
+			subpass.pPreserveAttachments = _preserves.end();
+
+			for (uint slot = 0; (mask >> slot) != 0; ++slot)
+			{
+				if ( mask & (1u << slot) ) {
+					_preserves.push_back( SlotToIndex( slot ));
+					++subpass.preserveAttachmentCount;
+				}
+			}
+		}
+
+		VSubpassMerger::GetDependencies( usages, OUT _dependencies );
+
+
+		// setup create info
+		_createInfo					= {};
+		_createInfo.sType			= VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		_createInfo.flags			= 0;
+		_createInfo.attachmentCount	= uint(_attachments.size());
+		_createInfo.pAttachments	= _attachments.data();
+		_createInfo.subpassCount	= uint(_subpasses.size());
+		_createInfo.pSubpasses		= _subpasses.data();
+		_createInfo.dependencyCount	= uint(_dependencies.size());
+		_createInfo.pDependencies	= _dependencies.size() ? _dependencies.data() : null;
+
+
+		_CalcHash( _createInfo, OUT _hash, OUT _attachmentHash, OUT _subpassesHash );
+		_compatibilityHash = _CalcCompatibilityHash( _createInfo );
 		return true;
 	}
 
+/*
+=================================================
+	_CalcCompatibilityHash
+----
+	pipeline can be used with any render pass that is compatible with
+	render pass used for pipeline creation, attachments are compatible
+	if they have same format and sample count.
+=================================================
+*/
+	HashVal  VRenderPass::_CalcCompatibilityHash (const VkRenderPassCreateInfo &ci)
+	{
+		const auto	AttachmentRefHash = [&ci] (const VkAttachmentReference *ref) -> HashVal
+		{
+			if ( ref == null or ref->attachment == VK_ATTACHMENT_UNUSED )
+				return HashOf( VK_ATTACHMENT_UNUSED );
+
+			const auto&	attachment = ci.pAttachments[ ref->attachment ];
+			return HashOf( attachment.format ) + HashOf( attachment.samples );
+		};
+
+		const auto	AttachmentRefArrayHash = [&AttachmentRefHash] (const VkAttachmentReference* refs, uint count) -> HashVal
+		{
+			HashVal	res = HashOf( count );
+
+			for (uint i = 0; refs and i < count; ++i) {
+				res << AttachmentRefHash( refs + i );
+			}
+			return res;
+		};
+
+		HashVal	hash = HashOf( ci.subpassCount );
+
+		for (uint i = 0; i < ci.subpassCount; ++i)
+		{
+			const VkSubpassDescription&	subpass = ci.pSubpasses[i];
+			
+			hash << AttachmentRefArrayHash( subpass.pInputAttachments, subpass.inputAttachmentCount );
+			hash << AttachmentRefArrayHash( subpass.pColorAttachments, subpass.colorAttachmentCount );
+			hash << AttachmentRefArrayHash( subpass.pResolveAttachments, subpass.pResolveAttachments ? subpass.colorAttachmentCount : 0 );
+			hash << AttachmentRefHash( subpass.pDepthStencilAttachment );
+		}
+		return hash;
+	}
+
 /*
 =================================================
 	_CalcHash
@@ -236,6 +478,7 @@ namespace FG
 		_createInfo		= Default;
 		_hash			= Default;
 		_attachmentHash	= Default;
+		_compatibilityHash = Default;
 
 		_subpassesHash.clear();
 
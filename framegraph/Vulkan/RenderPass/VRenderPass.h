@@ -4,6 +4,7 @@
 
 #include "framegraph/Public/Pipeline.h"
 #include "VLogicalRenderPass.h"
+#include "VSubpassMerger.h"
 
 namespace FG
 {
@@ -19,15 +20,16 @@ namespace FG
 		static constexpr uint	maxColorAttachments	= FG_MaxColorBuffers;
 		static constexpr uint	maxAttachments		= FG_MaxColorBuffers + 1;
 		static constexpr uint	maxSubpasses		= FG_MaxRenderPassSubpasses;
-		static constexpr uint	maxDependencies		= maxSubpasses * 2;
 
 		using Attachments_t			= FixedArray< VkAttachmentDescription, maxAttachments >;
 		using AttachmentsRef_t		= FixedArray< VkAttachmentReference, maxAttachments * maxSubpasses >;
 		using AttachmentsRef2_t		= FixedArray< VkAttachmentReference, maxSubpasses >;
 		using Subpasses_t			= FixedArray< VkSubpassDescription, maxSubpasses >;
-		using Dependencies_t		= FixedArray< VkSubpassDependency, maxDependencies >;
+		using Dependencies_t		= VSubpassMerger::Dependencies_t;
 		using Preserves_t			= FixedArray< uint, maxColorAttachments * maxSubpasses >;
 		using SubpassesHash_t		= FixedArray< HashVal, maxSubpasses >;
+		using ColorTarget			= VLogicalRenderPass::ColorTarget;
+		using DepthStencilTarget	= VLogicalRenderPass::DepthStencilTarget;
 
 
 	// variables
@@ -36,6 +38,7 @@ namespace FG
 
 		HashVal					_hash;
 		HashVal					_attachmentHash;
+		HashVal					_compatibilityHash;		// ignores layouts and load/store ops, see 'Render Pass Compatibility' in specs
 		SubpassesHash_t			_subpassesHash;
 		
 		VkRenderPassCreateInfo	_createInfo		= {};
@@ -58,6 +61,7 @@ namespace FG
 		VRenderPass (VRenderPass &&) = delete;
 		VRenderPass (const VRenderPass &) = delete;
 		explicit VRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses);
+		VRenderPass (ArrayView<ColorTarget> colorTargets, const DepthStencilTarget &depthStencilTarget);
 		~VRenderPass ();
 
 		bool Create (const VDevice &dev, StringView dbgName);
@@ -68,13 +72,17 @@ namespace FG
 		ND_ VkRenderPass					Handle ()			const	{ SHAREDLOCK( _drCheck );  return _renderPass; }
 		ND_ VkRenderPassCreateInfo const&	GetCreateInfo ()	const	{ SHAREDLOCK( _drCheck );  return _createInfo; }
 		ND_ HashVal							GetHash ()			const	{ SHAREDLOCK( _drCheck );  return _hash; }
+		ND_ HashVal							GetCompatibilityHash () const	{ SHAREDLOCK( _drCheck );  return _compatibilityHash; }
 
 
 	private:
+		bool _Initialize (ArrayView<ColorTarget> colorTargets, const DepthStencilTarget &depthStencilTarget);
 		bool _Initialize (ArrayView<VLogicalRenderPass*> logicalPasses);
 
 		static void  _CalcHash (const VkRenderPassCreateInfo &ci, OUT HashVal &hash, OUT HashVal &attachmentHash,
 								OUT SubpassesHash_t &subpassesHash);
+		
+		ND_ static HashVal  _CalcCompatibilityHash (const VkRenderPassCreateInfo &ci);
 	};
 
 
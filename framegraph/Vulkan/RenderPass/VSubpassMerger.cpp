@@ -0,0 +1,257 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VSubpassMerger.h"
+
+namespace FG
+{
+namespace
+{
+	using SubpassUsage	= VSubpassMerger::SubpassUsage;
+
+	struct SlotState
+	{
+		void const*		image	= null;
+		HashVal			view;
+	};
+	using Slots_t	= StaticArray< SlotState, VSubpassMerger::MaxSlots >;
+
+/*
+=================================================
+	FindSlot
+=================================================
+*/
+	ND_ inline uint  FindSlot (const Slots_t &slots, void const* image)
+	{
+		for (uint i = 0; i < slots.size(); ++i)
+		{
+			if ( slots[i].image == image )
+				return i;
+		}
+		return UMax;
+	}
+
+/*
+=================================================
+	CanMerge
+=================================================
+*/
+	ND_ inline bool  CanMerge (const VSubpassMerger::Pass &pass, const RectI &area, const Slots_t &slots, ArrayView<void const*> sampledImages)
+	{
+		if ( not pass.mergeable or pass.fence or not All( pass.area == area ))
+			return false;
+
+		uint	output_mask = 0;
+
+		for (auto& att : pass.attachments)
+		{
+			ASSERT( att.slot < slots.size() );
+			auto&	slot = slots[ att.slot ];
+
+			output_mask |= (1u << att.slot);
+
+			if ( slot.image )
+			{
+				// content can not be discarded in the middle of render pass
+				if ( slot.image != att.image or slot.view != att.view or not att.load )
+					return false;
+			}
+			else
+			{
+				// the same image can not be bound to different slots
+				if ( FindSlot( slots, att.image ) != UMax )
+					return false;
+			}
+
+			// image was sampled in previous subpass
+			for (auto* img : sampledImages) {
+				if ( img == att.image )
+					return false;
+			}
+		}
+
+		for (auto& img : pass.images)
+		{
+			const uint	slot = FindSlot( slots, img.image );
+
+			if ( img.inputAttachment )
+			{
+				// input attachment must be written by previous subpass and must not be a render target at the same time
+				if ( slot == UMax or (output_mask & (1u << slot)) )
+					return false;
+			}
+			else
+			{
+				// render target can be read only as input attachment
+				if ( slot != UMax )
+					return false;
+			}
+		}
+		return true;
+	}
+
+/*
+=================================================
+	AddStages
+=================================================
+*/
+	inline void  AddStages (const SubpassUsage &usage, uint slot, bool isSrc, INOUT VkPipelineStageFlags &stages, INOUT VkAccessFlags &access)
+	{
+		const uint	bit = (1u << slot);
+
+		if ( usage.outputMask & bit )
+		{
+			if ( slot == VSubpassMerger::DepthSlot )
+			{
+				stages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+				access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | (isSrc ? 0 : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT);
+			}
+			else
+			{
+				stages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				access |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (isSrc ? 0 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT);
+			}
+		}
+
+		if ( usage.inputMask & bit )
+		{
+			// read after read doesn't need memory dependency, but write after read needs execution dependency
+			stages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			access |= (isSrc ? 0 : VK_ACCESS_INPUT_ATTACHMENT_READ_BIT);
+		}
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+/*
+=================================================
+	Merge
+----
+	passes must be in execution order without any other tasks between them.
+=================================================
+*/
+	void  VSubpassMerger::Merge (ArrayView<Pass> passes, OUT Array<Subpass> &result)
+	{
+		Slots_t					slots;
+		Array< void const* >	sampled_images;
+		RectI					area;
+		uint					count		= 0;		// number of subpasses in current render pass
+		bool					can_merge	= false;
+
+		result.clear();
+		result.resize( passes.size() );
+
+		for (size_t i = 0; i < passes.size(); ++i)
+		{
+			auto&	pass	= passes[i];
+			auto&	dst		= result[i];
+
+			if ( can_merge and count < MaxSubpasses and CanMerge( pass, area, slots, sampled_images ))
+			{
+				dst.index = count++;
+			}
+			else
+			{
+				// begin new render pass
+				slots	= Default;
+				area	= pass.area;
+				count	= 1;
+				dst.index = 0;
+				sampled_images.clear();
+			}
+			can_merge = pass.mergeable;
+
+			for (auto& img : pass.images)
+			{
+				if ( not img.inputAttachment ) {
+					sampled_images.push_back( img.image );
+					continue;
+				}
+
+				const uint	slot = FindSlot( slots, img.image );
+				if ( slot != UMax )
+					dst.inputMask |= (1u << slot);
+			}
+
+			for (auto& att : pass.attachments)
+			{
+				ASSERT( att.slot < slots.size() );
+				slots[ att.slot ] = { att.image, att.view };
+			}
+		}
+	}
+
+/*
+=================================================
+	GetDependencies
+----
+	for each attachment used in subpass finds the last previous subpass that used it,
+	all attachments are framebuffer-local, so dependencies are by region.
+=================================================
+*/
+	void  VSubpassMerger::GetDependencies (ArrayView<SubpassUsage> subpasses, OUT Dependencies_t &result)
+	{
+		result.clear();
+
+		for (uint dst = 1; dst < subpasses.size(); ++dst)
+		{
+			auto&	dst_usage	= subpasses[dst];
+			uint	remaining	= dst_usage.outputMask | dst_usage.inputMask;
+
+			for (uint src = dst; (src-- > 0) and remaining;)
+			{
+				auto&		src_usage	= subpasses[src];
+				const uint	common		= remaining & (src_usage.outputMask | src_usage.inputMask);
+
+				if ( common == 0 )
+					continue;
+
+				remaining &= ~common;
+
+				VkSubpassDependency	dep = {};
+				dep.srcSubpass		= src;
+				dep.dstSubpass		= dst;
+				dep.dependencyFlags	= VK_DEPENDENCY_BY_REGION_BIT;
+
+				for (uint slot = 0; slot < MaxSlots; ++slot)
+				{
+					if ( not (common & (1u << slot)) )
+						continue;
+
+					AddStages( src_usage, slot, true,  INOUT dep.srcStageMask, INOUT dep.srcAccessMask );
+					AddStages( dst_usage, slot, false, INOUT dep.dstStageMask, INOUT dep.dstAccessMask );
+				}
+
+				CHECK_ERRV( result.size() < result.capacity() );
+				result.push_back( dep );
+			}
+		}
+	}
+
+/*
+=================================================
+	GetPreserveMask
+----
+	returns attachments that are used before and after the subpass but not in the subpass.
+=================================================
+*/
+	uint  VSubpassMerger::GetPreserveMask (ArrayView<SubpassUsage> subpasses, uint index)
+	{
+		uint	before	= 0;
+		uint	after	= 0;
+
+		for (uint i = 0; i < subpasses.size(); ++i)
+		{
+			const uint	mask = subpasses[i].outputMask | subpasses[i].inputMask;
+
+			if ( i < index )	before	|= mask;	else
+			if ( i > index )	after	|= mask;
+		}
+
+		ASSERT( index < subpasses.size() );
+		return before & after & ~(subpasses[index].outputMask | subpasses[index].inputMask);
+	}
+
+
+}	// FG
@@ -0,0 +1,80 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Merges consecutive render passes into subpasses of a single render pass.
+	Pass is merged with the previous passes if they have the same render area,
+	shared render targets are bound to the same slots with the same view
+	and previous content is loaded, and previous render targets are accessed only as input attachments.
+	Input attachment with 'input_attachment_index = N' is the render target that is bound to 'RenderTargetID(N)'.
+	Dependencies are calculated per attachment between the last subpass that used it and the next one.
+*/
+
+#pragma once
+
+#include "VCommon.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Subpass Merger
+	//
+
+	class VSubpassMerger final
+	{
+	// types
+	public:
+		static constexpr uint	MaxSubpasses	= FG_MaxRenderPassSubpasses;
+		static constexpr uint	MaxDependencies	= MaxSubpasses * MaxSubpasses / 2;
+		static constexpr uint	DepthSlot		= FG_MaxColorBuffers;		// same as 'RenderTargetID::DepthStencil'
+		static constexpr uint	MaxSlots		= FG_MaxColorBuffers + 1;
+
+		using Dependencies_t	= FixedArray< VkSubpassDependency, MaxDependencies >;
+
+		struct Attachment
+		{
+			void const*		image		= null;
+			HashVal			view;					// hash of image view description
+			uint			slot		= UMax;		// render target index or 'DepthSlot'
+			bool			load		= true;		// 'false' if content is cleared or invalidated
+		};
+		using Attachments_t		= FixedArray< Attachment, MaxSlots >;
+
+		struct ImageAccess
+		{
+			void const*		image			= null;
+			bool			inputAttachment	= false;
+		};
+
+		struct Pass
+		{
+			RectI						area;
+			Attachments_t				attachments;
+			ArrayView< ImageAccess >	images;					// images that are used by draw tasks, render targets are not included
+			bool						mergeable	= true;		// 'false' if pass has custom draw tasks, writes to storage resources, etc.
+			bool						fence		= false;	// pass starts with memory aliasing barrier, can not be merged with previous pass
+		};
+
+		struct Subpass
+		{
+			uint			index		= 0;		// 0 - pass starts new render pass
+			uint			inputMask	= 0;		// bit per slot that is read as input attachment
+		};
+
+		struct SubpassUsage
+		{
+			uint			outputMask	= 0;		// bit per slot that is used as color or depth-stencil attachment
+			uint			inputMask	= 0;
+		};
+
+
+	// methods
+	public:
+		static void  Merge (ArrayView<Pass> passes, OUT Array<Subpass> &result);
+
+		static void  GetDependencies (ArrayView<SubpassUsage> subpasses, OUT Dependencies_t &result);
+
+		ND_ static uint  GetPreserveMask (ArrayView<SubpassUsage> subpasses, uint index);
+	};
+
+
+}	// FG
@@ -0,0 +1,93 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	LSD radix sort for 64 bit keys.
+	Sort is stable, each pass processes 8 bits of the key - O(N * 8).
+	Passes where all keys have the same byte value are skipped,
+	so small keys are sorted in 1-2 passes.
+*/
+
+#pragma once
+
+#include "stl/Common.h"
+
+namespace FGC
+{
+
+/*
+=================================================
+	RadixSort
+----
+	'getKey' must return 'uint64_t' for element,
+	'temp' must have at least 'count' elements,
+	elements are copied, so 'T' should be small, for example key and index.
+=================================================
+*/
+	template <typename T, typename KeyFn>
+	inline void  RadixSort (INOUT T* data, T* temp, size_t count, KeyFn &&getKey)
+	{
+		static constexpr uint	Passes	= sizeof(uint64_t);
+		static constexpr uint	Radix	= 256;
+
+		if ( count < 2 )
+			return;
+
+		ASSERT( data and temp );
+
+		// build histograms for all passes at once
+		StaticArray< StaticArray< size_t, Radix >, Passes >		histogram = {};
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint64_t	key = getKey( data[i] );
+
+			for (uint p = 0; p < Passes; ++p) {
+				++histogram[p][ (key >> (p*8)) & 0xFF ];
+			}
+		}
+
+		T*	src = data;
+		T*	dst = temp;
+
+		for (uint p = 0; p < Passes; ++p)
+		{
+			auto&	hist = histogram[p];
+
+			// all keys have the same value in this byte
+			if ( hist[ (getKey( src[0] ) >> (p*8)) & 0xFF ] == count )
+				continue;
+
+			size_t	offset = 0;
+			for (auto& h : hist) {
+				const size_t	c = h;
+				h       = offset;
+				offset += c;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint	b = uint(getKey( src[i] ) >> (p*8)) & 0xFF;
+				dst[ hist[b]++ ] = src[i];
+			}
+			std::swap( src, dst );
+		}
+
+		if ( src != data )
+			std::copy( src, src + count, OUT data );
+	}
+
+/*
+=================================================
+	RadixSort
+=================================================
+*/
+	template <typename T, typename KeyFn>
+	inline void  RadixSort (INOUT Array<T> &arr, KeyFn &&getKey)
+	{
+		Array<T>	temp;
+		temp.resize( arr.size() );
+
+		RadixSort( arr.data(), temp.data(), arr.size(), std::forward<KeyFn>(getKey) );
+	}
+
+
+}	// FGC
@@ -148,7 +148,19 @@ namespace FGC
 
 		ND_ bool				empty ()						const	{ return _pool.empty(); }
 		ND_ size_t				size ()							const	{ return _pool.size(); }
-		ND_ constexpr size_t	capacity ()						const	{ return _pool.capacity(); }
+		ND_ size_t				capacity ()						const	{ return _pool.capacity(); }
+
+		ND_ static constexpr size_t	MaxCapacity ()						{ return Pool_t::MaxCapacity(); }
+
+
+		// Hash map is reserved for all elements, so it never rehashed
+		// and doesn't block readers for a long time when pool grows.
+		void  SetCapacity (size_t count)
+		{
+			EXLOCK( _cacheGuard );
+			_pool.SetCapacity( count );
+			_cache.reserve( _pool.capacity() );
+		}
 	};
 	
 	
@@ -16,6 +16,9 @@ namespace FGC
 	//
 	// Chunked Indexed Pool
 	//
+	//	'MaxChunks' is a size of chunk directory, chunks are allocated on demand.
+	//	Actual limit can be decreased at runtime by 'SetCapacity'.
+	//
 	
 	template <typename ValueType,
 			  typename IndexType,
@@ -54,6 +57,8 @@ namespace FGC
 	// variables
 	private:
 		mutable AssignOpGuard	_assignOpGuard;
+		size_t					_maxChunks		= MaxChunks;
+		size_t					_firstFreeChunk	= 0;		// all chunks before it have no free indices
 		IndexCountArray_t		_indexCount;
 		IndexChunks_t			_indices;
 		ValueChunks_t			_values;
@@ -93,6 +98,7 @@ namespace FGC
 			EXLOCK( _assignOpGuard );
 
 			_indexCount.clear();
+			_firstFreeChunk = 0;
 
 			for (auto& chunk : _indices)
 			{
@@ -120,6 +126,8 @@ namespace FGC
 
 			// TODO: swap _assignOpGuard ?
 			CHECK( _alloc == other._alloc );
+			std::swap( _maxChunks,		other._maxChunks );
+			std::swap( _firstFreeChunk,	other._firstFreeChunk );
 			std::swap( _indexCount,	other._indexCount );
 			std::swap( _indices,	other._indices );
 			std::swap( _values,		other._values );
@@ -136,7 +144,7 @@ namespace FGC
 
 			size_t	result = 0;
 
-			for (size_t i = 0, count = _indexCount.size();
+			for (size_t i = _firstFreeChunk, count = _indexCount.size();
 				 i < count and result < numIndices;
 				 ++i)
 			{
@@ -149,12 +157,14 @@ namespace FGC
 				{
 					arr.emplace_back( indices[idx_count + j] );
 				}
+
+				_firstFreeChunk = (idx_count == 0 and _firstFreeChunk == i ? i+1 : _firstFreeChunk);
 			}
 
 			if ( result >= numIndices )
 				return result;
 
-			if ( _indexCount.size() == _indexCount.capacity() )
+			if ( _indexCount.size() >= _maxChunks )
 				return result;
 
 			const size_t	chunk_idx = _indexCount.size();
@@ -180,7 +190,7 @@ namespace FGC
 		{
 			EXLOCK( _assignOpGuard );
 
-			for (size_t i = 0, count = _indexCount.size(); i < count; ++i)
+			for (size_t i = _firstFreeChunk, count = _indexCount.size(); i < count; ++i)
 			{
 				auto&	idx_count = _indexCount[i];
 
@@ -190,9 +200,11 @@ namespace FGC
 					index = (*_indices [i])[ --idx_count ];
 					return true;
 				}
+
+				_firstFreeChunk = i+1;
 			}
 
-			if ( _indexCount.size() == _indexCount.capacity() ) {
+			if ( _indexCount.size() >= _maxChunks ) {
 				ASSERT(!"out of memory!");
 				return false;
 			}
@@ -262,11 +274,26 @@ namespace FGC
 			return _indexCount.size() * ChunkSize;
 		}
 
-		ND_ static constexpr size_t  capacity ()
+		ND_ size_t  capacity () const
+		{
+			EXLOCK( _assignOpGuard );
+			return _maxChunks * ChunkSize;
+		}
+
+		ND_ static constexpr size_t  MaxCapacity ()
 		{
 			return MaxChunks * ChunkSize;
 		}
 
+
+		// Set max number of elements, rounded up to chunk size.
+		// Can not be less than current size and greater than 'MaxCapacity'.
+		void  SetCapacity (size_t count)
+		{
+			EXLOCK( _assignOpGuard );
+			_maxChunks = Clamp( (count + ChunkSize-1) / ChunkSize, Max( _indexCount.size(), size_t(1) ), MaxChunks );
+		}
+
 		ND_ bool  empty () const
 		{
 			EXLOCK( _assignOpGuard );
@@ -339,6 +366,7 @@ namespace FGC
 			})
 
 			indices[ idx_count++ ] = RawIndex_t(index);
+			_firstFreeChunk = Min( _firstFreeChunk, size_t(chunk_idx) );
 		}
 	};
 	
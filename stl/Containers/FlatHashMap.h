@@ -0,0 +1,333 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Hash map with open addressing and linear probing.
+	All elements are stored in a single array, so insertion doesn't allocate node per element
+	and the map can be used with 'StdLinearAllocator'.
+
+	Elements can not be erased, use 'clear' to remove all elements.
+	Insertion invalidates iterators and pointers to elements.
+*/
+
+#pragma once
+
+#include "stl/Math/Math.h"
+#include "stl/Math/BitMath.h"
+#include "stl/Memory/MemUtils.h"
+#include "stl/CompileTime/TypeTraits.h"
+#include <memory>
+#include <cstring>
+
+namespace FGC
+{
+
+	//
+	// Flat Hash Map
+	//
+
+	template <typename Key,
+			  typename Value,
+			  typename Hasher		= std::hash<Key>,
+			  typename KeyEqual		= std::equal_to<Key>,
+			  typename Allocator	= std::allocator< Pair< const Key, Value >>
+			 >
+	struct FlatHashMap
+	{
+	// types
+	private:
+		using Self				= FlatHashMap< Key, Value, Hasher, KeyEqual, Allocator >;
+		using Pair_t			= Pair< const Key, Value >;
+		using PairAlloc_t		= typename std::allocator_traits< Allocator >::template rebind_alloc< Pair_t >;
+		using CtrlAlloc_t		= typename std::allocator_traits< Allocator >::template rebind_alloc< uint8_t >;
+
+		static constexpr size_t	MinCapacity	= 16;
+
+		template <typename T>
+		struct TIterator
+		{
+			friend struct FlatHashMap;
+
+		private:
+			T *				_slots	= null;
+			uint8_t const*	_ctrl	= null;
+			size_t			_index	= 0;
+			size_t			_count	= 0;
+
+			TIterator (T* slots, uint8_t const* ctrl, size_t index, size_t count) :
+				_slots{slots}, _ctrl{ctrl}, _index{index}, _count{count}
+			{
+				_Skip();
+			}
+
+			void  _Skip ()
+			{
+				for (; _index < _count and not _ctrl[_index]; ++_index) {}
+			}
+
+		public:
+			TIterator () {}
+
+			TIterator&  operator ++ ()						{ ++_index;  _Skip();  return *this; }
+
+			ND_ T&		operator * ()				const	{ return _slots[_index]; }
+			ND_ T*		operator -> ()				const	{ return &_slots[_index]; }
+
+			ND_ bool	operator == (const TIterator &rhs)	const	{ return _index == rhs._index; }
+			ND_ bool	operator != (const TIterator &rhs)	const	{ return _index != rhs._index; }
+		};
+
+	public:
+		using key_type			= Key;
+		using mapped_type		= Value;
+		using value_type		= Pair_t;
+		using iterator			= TIterator< Pair_t >;
+		using const_iterator	= TIterator< Pair_t const >;
+
+
+	// variables
+	private:
+		Pair_t *		_slots		= null;
+		uint8_t *		_ctrl		= null;		// 1 - slot is used
+		size_t			_count		= 0;
+		size_t			_capacity	= 0;		// power of 2
+		PairAlloc_t		_pairAlloc;
+		CtrlAlloc_t		_ctrlAlloc;
+
+
+	// methods
+	public:
+		FlatHashMap () {}
+		explicit FlatHashMap (const Allocator &alloc) : _pairAlloc{alloc}, _ctrlAlloc{alloc} {}
+
+		FlatHashMap (const Self &) = delete;
+		Self&  operator = (const Self &) = delete;
+
+		FlatHashMap (Self &&other) :
+			_slots{other._slots}, _ctrl{other._ctrl}, _count{other._count}, _capacity{other._capacity},
+			_pairAlloc{std::move(other._pairAlloc)}, _ctrlAlloc{std::move(other._ctrlAlloc)}
+		{
+			other._slots	= null;
+			other._ctrl		= null;
+			other._count	= 0;
+			other._capacity	= 0;
+		}
+
+		~FlatHashMap ()
+		{
+			_Deallocate();
+		}
+
+
+		template <typename K, typename V>
+		Pair< iterator, bool >  insert (Pair< K, V > &&value)
+		{
+			return _Insert( std::forward<K>(value.first), std::forward<V>(value.second) );
+		}
+
+		Pair< iterator, bool >  insert (const Pair< Key, Value > &value)
+		{
+			return _Insert( value.first, value.second );
+		}
+
+		template <typename K, typename V>
+		Pair< iterator, bool >  emplace (K &&key, V &&value)
+		{
+			return _Insert( std::forward<K>(key), std::forward<V>(value) );
+		}
+
+
+		ND_ iterator  find (const Key &key)
+		{
+			const size_t	idx = _Find( key );
+			return idx < _capacity ? iterator{ _slots, _ctrl, idx, _capacity } : end();
+		}
+
+		ND_ const_iterator  find (const Key &key) const
+		{
+			const size_t	idx = _Find( key );
+			return idx < _capacity ? const_iterator{ _slots, _ctrl, idx, _capacity } : end();
+		}
+
+		ND_ size_t  count (const Key &key)		const	{ return _Find( key ) < _capacity ? 1 : 0; }
+		ND_ bool	contains (const Key &key)	const	{ return _Find( key ) < _capacity; }
+
+
+		void  reserve (size_t count)
+		{
+			// max load factor is 3/4
+			size_t	cap = Max( MinCapacity, _capacity );
+			for (; cap * 3 < count * 4; cap <<= 1) {}
+
+			if ( cap > _capacity )
+				_Rehash( cap );
+		}
+
+		void  clear ()
+		{
+			if ( _count == 0 )
+				return;
+
+			for (size_t i = 0; i < _capacity; ++i)
+			{
+				if ( _ctrl[i] ) {
+					_slots[i].~Pair_t();
+					_ctrl[i] = 0;
+				}
+			}
+			_count = 0;
+		}
+
+
+		ND_ size_t			size ()				const	{ return _count; }
+		ND_ bool			empty ()			const	{ return _count == 0; }
+		ND_ size_t			capacity ()			const	{ return _capacity; }
+
+		ND_ iterator		begin ()					{ return iterator{ _slots, _ctrl, 0, _capacity }; }
+		ND_ const_iterator	begin ()			const	{ return const_iterator{ _slots, _ctrl, 0, _capacity }; }
+		ND_ iterator		end ()						{ return iterator{ _slots, _ctrl, _capacity, _capacity }; }
+		ND_ const_iterator	end ()				const	{ return const_iterator{ _slots, _ctrl, _capacity, _capacity }; }
+
+
+	private:
+		// keys may have bad distribution in low bits (pointers, packed IDs), so use fibonacci hashing
+		ND_ size_t  _StartIndex (const Key &key) const
+		{
+			const uint64_t	h = uint64_t(Hasher{}( key )) * 0x9E3779B97F4A7C15ull;
+			return size_t(h >> (64 - IntLog2( _capacity )));
+		}
+
+		ND_ size_t  _Find (const Key &key) const
+		{
+			if ( _count == 0 )
+				return UMax;
+
+			const size_t	mask = _capacity - 1;
+
+			for (size_t i = _StartIndex( key );; i = (i + 1) & mask)
+			{
+				if ( not _ctrl[i] )
+					return UMax;
+
+				if ( KeyEqual{}( _slots[i].first, key ))
+					return i;
+			}
+		}
+
+		template <typename K, typename V>
+		Pair< iterator, bool >  _Insert (K &&key, V &&value)
+		{
+			if ( (_count + 1) * 4 > _capacity * 3 )
+				_Rehash( Max( MinCapacity, _capacity << 1 ));
+
+			const size_t	mask = _capacity - 1;
+			size_t			i	 = _StartIndex( key );
+
+			for (; _ctrl[i]; i = (i + 1) & mask)
+			{
+				if ( KeyEqual{}( _slots[i].first, key ))
+					return { iterator{ _slots, _ctrl, i, _capacity }, false };
+			}
+
+			PlacementNew<Pair_t>( &_slots[i], std::forward<K>(key), std::forward<V>(value) );
+			_ctrl[i] = 1;
+			++_count;
+
+			return { iterator{ _slots, _ctrl, i, _capacity }, true };
+		}
+
+		void  _Rehash (size_t newCapacity)
+		{
+			ASSERT( IsPowerOfTwo( newCapacity ));
+
+			Pair_t*		old_slots	= _slots;
+			uint8_t*	old_ctrl	= _ctrl;
+			size_t		old_cap		= _capacity;
+
+			_slots		= std::allocator_traits< PairAlloc_t >::allocate( _pairAlloc, newCapacity );
+			_ctrl		= std::allocator_traits< CtrlAlloc_t >::allocate( _ctrlAlloc, newCapacity );
+			_capacity	= newCapacity;
+			std::memset( _ctrl, 0, newCapacity );
+
+			const size_t	mask = _capacity - 1;
+
+			for (size_t j = 0; j < old_cap; ++j)
+			{
+				if ( not old_ctrl[j] )
+					continue;
+
+				size_t	i = _StartIndex( old_slots[j].first );
+				for (; _ctrl[i]; i = (i + 1) & mask) {}
+
+				PlacementNew<Pair_t>( &_slots[i], std::move(old_slots[j]) );
+				_ctrl[i] = 1;
+				old_slots[j].~Pair_t();
+			}
+
+			if ( old_slots )
+			{
+				std::allocator_traits< PairAlloc_t >::deallocate( _pairAlloc, old_slots, old_cap );
+				std::allocator_traits< CtrlAlloc_t >::deallocate( _ctrlAlloc, old_ctrl, old_cap );
+			}
+		}
+
+		void  _Deallocate ()
+		{
+			clear();
+
+			if ( _slots )
+			{
+				std::allocator_traits< PairAlloc_t >::deallocate( _pairAlloc, _slots, _capacity );
+				std::allocator_traits< CtrlAlloc_t >::deallocate( _ctrlAlloc, _ctrl, _capacity );
+			}
+			_slots		= null;
+			_ctrl		= null;
+			_capacity	= 0;
+		}
+	};
+
+
+
+	//
+	// Flat Hash Set
+	//
+
+	template <typename Key,
+			  typename Hasher		= std::hash<Key>,
+			  typename KeyEqual		= std::equal_to<Key>,
+			  typename Allocator	= std::allocator< Key >
+			 >
+	struct FlatHashSet
+	{
+	// types
+	private:
+		struct Empty {};
+		using Map_t		= FlatHashMap< Key, Empty, Hasher, KeyEqual,
+									   typename std::allocator_traits< Allocator >::template rebind_alloc< Pair< const Key, Empty >>>;
+
+	public:
+		using key_type		= Key;
+		using value_type	= Key;
+
+
+	// variables
+	private:
+		Map_t	_map;
+
+
+	// methods
+	public:
+		FlatHashSet () {}
+		explicit FlatHashSet (const Allocator &alloc) : _map{ typename std::allocator_traits< Allocator >::template rebind_alloc< Pair< const Key, Empty >>{alloc} } {}
+
+		bool  insert (const Key &key)						{ return _map.emplace( key, Empty{} ).second; }
+
+		void  reserve (size_t count)						{ _map.reserve( count ); }
+		void  clear ()										{ _map.clear(); }
+
+		ND_ size_t	count (const Key &key)			const	{ return _map.count( key ); }
+		ND_ bool	contains (const Key &key)		const	{ return _map.contains( key ); }
+		ND_ size_t	size ()							const	{ return _map.size(); }
+		ND_ bool	empty ()						const	{ return _map.empty(); }
+	};
+
+
+}	// FGC
@@ -0,0 +1,515 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Same as 'LfIndexedPool', but:
+	- chunks are allocated on demand, chunk directory grows by pages,
+	  first page contains 'DirPageSize' chunks and each next page is twice larger,
+	  so capacity is limited only by the range of 'IndexType'.
+	  Pages and chunks are never moved, so lookup is lock-free and O(1).
+	- search starts from the hint chunk instead of the first chunk.
+	- unassigned indices are kept in small per-thread caches,
+	  so 'Assign' on the same thread doesn't touch shared bitfields.
+
+	Index in the thread cache is still marked as assigned, so 'IsAssigned' returns 'true' for it,
+	'AssignedBitsCount' excludes cached indices.
+*/
+
+#pragma once
+
+#include "stl/CompileTime/TypeTraits.h"
+#include "stl/Containers/FixedArray.h"
+#include "stl/CompileTime/Math.h"
+#include "stl/Memory/UntypedAllocator.h"
+#include "stl/Math/BitMath.h"
+#include <atomic>
+
+namespace FGC
+{
+namespace _fgc_hidden_
+{
+	// returns number of directory pages that are needed to address 'maxChunks'
+	inline constexpr uint  LfGrowableIndexedPool_PageCount (uint64_t maxChunks, uint64_t dirPageSize)
+	{
+		uint	pages	= 0;
+		for (uint64_t count = 0; count < maxChunks; ++pages) {
+			count += (dirPageSize << pages);
+		}
+		return pages;
+	}
+}	// _fgc_hidden_
+
+
+	//
+	// Lock-free Growable Indexed Pool
+	//
+
+	template <typename ValueType,
+			  typename IndexType,
+			  size_t ChunkSize = 32,
+			  size_t DirPageSize = 16,
+			  typename AllocatorType = UntypedAlignedAllocator,
+			  size_t ThreadCacheCount = 16,
+			  size_t ThreadCacheSize = 8
+			 >
+	struct LfGrowableIndexedPool final
+	{
+		STATIC_ASSERT( ChunkSize > 1 and DirPageSize > 0 );
+		STATIC_ASSERT( IsPowerOfTwo( ChunkSize ) );	// must be power of 2 to increase performance
+		STATIC_ASSERT( IsPowerOfTwo( DirPageSize ));
+		STATIC_ASSERT( ThreadCacheCount > 0 and IsPowerOfTwo( ThreadCacheCount ));
+
+	// types
+	public:
+		using Self				= LfGrowableIndexedPool< ValueType, IndexType, ChunkSize, DirPageSize, AllocatorType, ThreadCacheCount, ThreadCacheSize >;
+		using Index_t			= IndexType;
+		using Value_t			= ValueType;
+		using Allocator_t		= AllocatorType;
+
+	private:
+		using Bitfield_t		= Conditional< (ChunkSize > 64), void, Conditional< (ChunkSize > 32), uint64_t, Conditional< (ChunkSize > 16), uint32_t, uint16_t >>>;
+
+		struct alignas(FG_CACHE_LINE) Chunk
+		{
+			Atomic<Bitfield_t>	assignedBits	{Bitfield_t(UMax)};	// 1 - is unassigned bit, 0 - assigned bit
+			Atomic<Bitfield_t>	createdBits		{0};					// 1 - constructor has been called
+			alignas(Value_t) uint8_t	values [sizeof(Value_t) * ChunkSize];
+
+			ND_ Value_t*  Data ()		{ return Cast<Value_t>( &values[0] ); }
+		};
+		using ChunkPtr_t		= Atomic<Chunk *>;
+
+		struct alignas(FG_CACHE_LINE) ThreadCache
+		{
+			Atomic<bool>							locked	{false};
+			Atomic<uint>							count	{0};
+			StaticArray< Index_t, ThreadCacheSize >	indices;
+		};
+		using ThreadCaches_t	= StaticArray< ThreadCache, ThreadCacheCount >;
+
+		static constexpr uint	ChunkSizePOT	= CT_IntLog2< ChunkSize >;
+		static constexpr uint	DirPagePOT		= CT_IntLog2< DirPageSize >;
+		static constexpr uint	IndexBits		= Min( uint(sizeof(Index_t) * 8), 32u );
+		static constexpr uint	MaxChunks		= uint(Min( (uint64_t(1) << IndexBits) >> ChunkSizePOT, uint64_t(~uint(0)) ));
+		static constexpr uint	MaxPages		= _fgc_hidden_::LfGrowableIndexedPool_PageCount( MaxChunks, DirPageSize );
+
+		using PageDir_t			= StaticArray< Atomic<ChunkPtr_t *>, MaxPages >;
+
+		STATIC_ASSERT( IndexBits > ChunkSizePOT );
+		STATIC_ASSERT( Atomic<Bitfield_t>::is_always_lock_free );
+		STATIC_ASSERT( ChunkPtr_t::is_always_lock_free );
+
+
+	// variables
+	private:
+		alignas(FG_CACHE_LINE) Atomic<uint>		_chunkCount	{0};	// number of allocated chunks, all chunks in range [0, count) are non-null
+		alignas(FG_CACHE_LINE) Atomic<uint>		_hint		{0};	// chunk that probably has unassigned index
+		PageDir_t								_pages;		// pages are allocated on demand and never moved
+		ThreadCaches_t							_caches;
+		Allocator_t								_alloc;
+
+
+	// methods
+	public:
+		LfGrowableIndexedPool (const Self &) = delete;
+		LfGrowableIndexedPool (Self &&) = delete;
+
+		Self& operator = (const Self &) = delete;
+		Self& operator = (Self &&) = delete;
+
+
+		explicit LfGrowableIndexedPool (const Allocator_t &alloc = Allocator_t()) :
+			_alloc{ alloc }
+		{
+			for (auto& page : _pages) {
+				page.store( null, memory_order_relaxed );
+			}
+
+			// flush cache
+			std::atomic_thread_fence( memory_order_release );
+		}
+
+		~LfGrowableIndexedPool()
+		{
+			Release();
+		}
+
+
+		template <typename FN>
+		void Release (FN &&dtor)
+		{
+			// invalidate cache
+			std::atomic_thread_fence( memory_order_acquire );
+
+			_FlushCaches();
+
+			const uint	count = _chunkCount.load( memory_order_relaxed );
+
+			for (uint i = 0; i < count; ++i)
+			{
+				Chunk*		chunk		= _ChunkPtr( i ).exchange( null, memory_order_relaxed );
+				Bitfield_t	ctor_bits	= chunk->createdBits.load( memory_order_relaxed );
+				Bitfield_t	assigned	= chunk->assignedBits.load( memory_order_relaxed );
+
+				Unused( assigned );
+				ASSERT( assigned == UMax );
+
+				for (size_t j = 0; j < ChunkSize; ++j)
+				{
+					if ( ctor_bits & (Bitfield_t(1) << j) )
+						dtor( chunk->Data()[j] );
+				}
+
+				chunk->~Chunk();
+				_alloc.Deallocate( chunk, SizeOf<Chunk>, AlignOf<Chunk> );
+			}
+
+			for (uint p = 0; p < MaxPages; ++p)
+			{
+				if ( ChunkPtr_t*  page = _pages[p].exchange( null, memory_order_relaxed ))
+					_FreePage( p, page );
+			}
+
+			_chunkCount.store( 0, memory_order_relaxed );
+			_hint.store( 0, memory_order_relaxed );
+		}
+
+		void Release ()
+		{
+			return Release([] (Value_t& value) { value.~Value_t(); });
+		}
+
+
+		template <typename FN>
+		ND_ bool  Assign (OUT Index_t &outIndex, FN &&ctor)
+		{
+			// objects in thread cache are already constructed
+			if ( _PopFromCache( OUT outIndex ))
+				return true;
+
+			// search in allocated chunks starting from hint
+			const uint	count	= _chunkCount.load( memory_order_acquire );
+			const uint	hint	= _hint.load( memory_order_relaxed );
+
+			for (uint j = 0; j < count; ++j)
+			{
+				const uint	i = (hint + j < count ? hint + j : hint + j - count);
+
+				if ( _AssignInChunk( i, OUT outIndex, ctor ))
+					return true;
+			}
+
+			// grow
+			for (uint i = count; i < MaxChunks; ++i)
+			{
+				_AllocChunk( i );
+
+				if ( _AssignInChunk( i, OUT outIndex, ctor ))
+					return true;
+			}
+			return false;
+		}
+
+		ND_ bool  Assign (OUT Index_t &outIndex)
+		{
+			return Assign( OUT outIndex, [](Value_t* ptr, Index_t) { PlacementNew<Value_t>( ptr ); });
+		}
+
+
+		void  Unassign (Index_t index)
+		{
+			const uint	chunk_idx	= index >> ChunkSizePOT;
+			const uint	bit_idx		= index & (ChunkSize-1);
+			Bitfield_t	mask		= Bitfield_t(1) << bit_idx;
+			ASSERT( IsAssigned( index ));
+
+			if ( _PushToCache( index ))
+				return;
+
+			Chunk*		chunk		= _ChunkPtr( chunk_idx ).load( memory_order_relaxed );
+			Bitfield_t	old_bits	= chunk->assignedBits.fetch_or( mask, memory_order_release );	// 0 -> 1
+
+			Unused( old_bits );
+			ASSERT( !(old_bits & mask) );
+
+			_UpdateHint( chunk_idx );
+		}
+
+
+		ND_ bool  IsAssigned (Index_t index)
+		{
+			const uint	chunk_idx	= index >> ChunkSizePOT;
+			const uint	bit_idx		= index & (ChunkSize-1);
+			Bitfield_t	mask		= Bitfield_t(1) << bit_idx;
+
+			if ( chunk_idx >= MaxChunks )
+				return false;
+
+			uint		page_idx, offset;
+			_Locate( chunk_idx, OUT page_idx, OUT offset );
+
+			ChunkPtr_t*	page	= _pages[page_idx].load( memory_order_acquire );
+			Chunk*		chunk	= page ? page[offset].load( memory_order_acquire ) : null;
+
+			return chunk and !(chunk->assignedBits.load( memory_order_relaxed ) & mask);
+		}
+
+
+		ND_ Value_t&  operator [] (Index_t index)
+		{
+			ASSERT( IsAssigned( index ));
+
+			const uint	chunk_idx	= index >> ChunkSizePOT;
+			const uint	bit_idx		= index & (ChunkSize-1);
+			Chunk*		chunk		= _ChunkPtr( chunk_idx ).load( memory_order_acquire );
+
+			ASSERT( chunk );
+			return chunk->Data()[ bit_idx ];
+		}
+
+
+		ND_ size_t  AssignedBitsCount ()
+		{
+			const uint	count	= _chunkCount.load( memory_order_acquire );
+			size_t		result	= 0;
+
+			for (uint i = 0; i < count; ++i)
+			{
+				Bitfield_t	bits = _ChunkPtr( i ).load( memory_order_relaxed )->assignedBits.load( memory_order_relaxed );
+
+				result += BitCount( Bitfield_t(~bits) );	// count of zeros
+			}
+
+			for (auto& cache : _caches) {
+				result -= cache.count.load( memory_order_relaxed );
+			}
+			return result;
+		}
+
+		ND_ size_t  CreatedObjectsCount ()
+		{
+			const uint	count	= _chunkCount.load( memory_order_acquire );
+			size_t		result	= 0;
+
+			for (uint i = 0; i < count; ++i)
+			{
+				Bitfield_t	bits = _ChunkPtr( i ).load( memory_order_relaxed )->createdBits.load( memory_order_relaxed );
+
+				result += BitCount( bits );
+			}
+			return result;
+		}
+
+		ND_ size_t  CurrentCapacity () const
+		{
+			return _chunkCount.load( memory_order_relaxed ) * ChunkSize;
+		}
+
+		ND_ static constexpr size_t  MaxCapacity ()
+		{
+			return size_t(ChunkSize) * MaxChunks;
+		}
+
+
+	private:
+		template <typename FN>
+		ND_ bool  _AssignInChunk (uint chunkIdx, OUT Index_t &outIndex, FN &&ctor)
+		{
+			Chunk*		chunk	= _ChunkPtr( chunkIdx ).load( memory_order_relaxed );
+			Bitfield_t	bits	= chunk->assignedBits.load( memory_order_relaxed );
+
+			for (int index = BitScanForward( bits ); index >= 0;)
+			{
+				const Bitfield_t	mask = Bitfield_t(1) << index;
+
+				if ( chunk->assignedBits.compare_exchange_weak( INOUT bits, bits ^ mask, memory_order_acquire, memory_order_relaxed ))
+				{
+					outIndex = Index_t(index) | (Index_t(chunkIdx) << ChunkSizePOT);
+
+					if ( not (chunk->createdBits.fetch_or( mask, memory_order_relaxed ) & mask) )
+					{
+						ctor( chunk->Data() + index, outIndex );
+					}
+
+					if ( (bits ^ mask) != 0 )
+						_UpdateHint( chunkIdx );
+
+					return true;
+				}
+
+				index = BitScanForward( bits );
+			}
+			return false;
+		}
+
+
+		void  _AllocChunk (uint chunkIdx)
+		{
+			uint	page_idx, offset;
+			_Locate( chunkIdx, OUT page_idx, OUT offset );
+
+			ChunkPtr_t*	page = _pages[page_idx].load( memory_order_acquire );
+
+			if ( page == null )
+			{
+				page = _AllocPage( page_idx );
+
+				// another thread has been allocated this page
+				ChunkPtr_t*	expected = null;
+				if ( not _pages[page_idx].compare_exchange_strong( INOUT expected, page, memory_order_release, memory_order_acquire ))
+				{
+					_FreePage( page_idx, page );
+					page = expected;
+				}
+			}
+
+			if ( page[offset].load( memory_order_acquire ) == null )
+			{
+				Chunk*	ptr = Cast<Chunk>( _alloc.Allocate( SizeOf<Chunk>, AlignOf<Chunk> ));
+				PlacementNew<Chunk>( ptr );
+
+				// another thread has been allocated this chunk
+				Chunk*	expected = null;
+				if ( not page[offset].compare_exchange_strong( INOUT expected, ptr, memory_order_release, memory_order_acquire ))
+				{
+					ptr->~Chunk();
+					_alloc.Deallocate( ptr, SizeOf<Chunk>, AlignOf<Chunk> );
+				}
+			}
+
+			// chunks are allocated in order, so the count can't decrease
+			for (uint expected = _chunkCount.load( memory_order_relaxed ); expected < chunkIdx+1;)
+			{
+				if ( _chunkCount.compare_exchange_weak( INOUT expected, chunkIdx+1, memory_order_release, memory_order_relaxed ))
+					break;
+			}
+		}
+
+
+		// page 'p' contains chunks in range [DirPageSize * (2^p - 1), DirPageSize * (2^(p+1) - 1))
+		static void  _Locate (uint chunkIdx, OUT uint &pageIdx, OUT uint &offset)
+		{
+			pageIdx	= uint(IntLog2( (chunkIdx >> DirPagePOT) + 1 ));
+			offset	= chunkIdx - (((1u << pageIdx) - 1) << DirPagePOT);
+		}
+
+		ND_ static uint  _PageSize (uint pageIdx)
+		{
+			const uint	first = ((1u << pageIdx) - 1) << DirPagePOT;
+			return uint(Min( uint64_t(DirPageSize) << pageIdx, uint64_t(MaxChunks - first) ));
+		}
+
+		ND_ ChunkPtr_t&  _ChunkPtr (uint chunkIdx)
+		{
+			uint	page_idx, offset;
+			_Locate( chunkIdx, OUT page_idx, OUT offset );
+
+			ChunkPtr_t*	page = _pages[page_idx].load( memory_order_acquire );
+			ASSERT( page );
+			return page[offset];
+		}
+
+		ND_ ChunkPtr_t*  _AllocPage (uint pageIdx)
+		{
+			const uint	count	= _PageSize( pageIdx );
+			ChunkPtr_t*	page	= Cast<ChunkPtr_t>( _alloc.Allocate( SizeOf<ChunkPtr_t> * count, AlignOf<ChunkPtr_t> ));
+
+			for (uint i = 0; i < count; ++i) {
+				PlacementNew<ChunkPtr_t>( page + i, null );
+			}
+			return page;
+		}
+
+		void  _FreePage (uint pageIdx, ChunkPtr_t* page)
+		{
+			_alloc.Deallocate( page, SizeOf<ChunkPtr_t> * _PageSize( pageIdx ), AlignOf<ChunkPtr_t> );
+		}
+
+
+		void  _UpdateHint (uint chunkIdx)
+		{
+			// avoid writing to shared cache line
+			if ( _hint.load( memory_order_relaxed ) != chunkIdx )
+				_hint.store( chunkIdx, memory_order_relaxed );
+		}
+
+
+		void  _FlushCaches ()
+		{
+			for (auto& cache : _caches)
+			{
+				const uint	count = cache.count.exchange( 0, memory_order_relaxed );
+
+				for (uint i = 0; i < count; ++i)
+				{
+					const Index_t	index	= cache.indices[i];
+					Chunk*			chunk	= _ChunkPtr( index >> ChunkSizePOT ).load( memory_order_relaxed );
+
+					chunk->assignedBits.fetch_or( Bitfield_t(1) << (index & (ChunkSize-1)), memory_order_relaxed );
+				}
+			}
+		}
+
+
+		ND_ static uint  _ThreadIndex ()
+		{
+			static Atomic<uint>			counter {0};
+			static thread_local uint	index = UMax;	// constant initialization is faster
+
+			if ( index == UMax )
+				index = counter.fetch_add( 1, memory_order_relaxed ) & (ThreadCacheCount-1);
+
+			return index;
+		}
+
+
+		ND_ bool  _PushToCache (Index_t index)
+		{
+			if constexpr( ThreadCacheSize > 0 )
+			{
+				ThreadCache&	cache = _caches[ _ThreadIndex() ];
+
+				// cache is owned by another thread, don't wait
+				if ( cache.locked.exchange( true, memory_order_acquire ))
+					return false;
+
+				const uint	count	= cache.count.load( memory_order_relaxed );
+				const bool	pushed	= (count < ThreadCacheSize);
+
+				if ( pushed ) {
+					cache.indices[ count ] = index;
+					cache.count.store( count+1, memory_order_relaxed );
+				}
+
+				cache.locked.store( false, memory_order_release );
+				return pushed;
+			}
+			else
+				return false;
+		}
+
+		ND_ bool  _PopFromCache (OUT Index_t &outIndex)
+		{
+			if constexpr( ThreadCacheSize > 0 )
+			{
+				ThreadCache&	cache = _caches[ _ThreadIndex() ];
+
+				if ( cache.locked.exchange( true, memory_order_acquire ))
+					return false;
+
+				const uint	count	= cache.count.load( memory_order_relaxed );
+				const bool	popped	= (count > 0);
+
+				if ( popped ) {
+					outIndex = cache.indices[ count-1 ];
+					cache.count.store( count-1, memory_order_relaxed );
+				}
+
+				cache.locked.store( false, memory_order_release );
+				return popped;
+			}
+			else
+				return false;
+		}
+	};
+
+
+}	// FGC
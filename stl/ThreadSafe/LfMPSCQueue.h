@@ -0,0 +1,152 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Bounded multi-producer single-consumer ring buffer.
+	Each slot has a sequence number, producer reserves the slot with a single CAS on the tail
+	and publishes the value by updating the sequence, so producers never wait for the consumer.
+
+	'Push' can be called from any thread.
+	'Pop' and 'Clear' must be externally synchronized, only one thread can consume at a time.
+*/
+
+#pragma once
+
+#include "stl/CompileTime/TypeTraits.h"
+#include "stl/Memory/MemUtils.h"
+#include "stl/Math/BitMath.h"
+#include <atomic>
+
+namespace FGC
+{
+
+	//
+	// Lock-free Multi-Producer Single-Consumer Queue
+	//
+
+	template <typename ValueType, size_t Capacity>
+	struct LfMPSCQueue final
+	{
+		STATIC_ASSERT( Capacity > 1 );
+		STATIC_ASSERT( IsPowerOfTwo( Capacity ));	// must be power of 2 to increase performance
+
+	// types
+	public:
+		using Self		= LfMPSCQueue< ValueType, Capacity >;
+		using Value_t	= ValueType;
+
+	private:
+		static constexpr size_t	Mask = Capacity - 1;
+
+		struct Slot
+		{
+			Atomic<size_t>				seq;		// 'pos' - empty slot, 'pos + 1' - value is published
+			alignas(Value_t) uint8_t	data [sizeof(Value_t)];
+
+			ND_ Value_t&  Value ()		{ return *Cast<Value_t>( &data[0] ); }
+		};
+		using Slots_t	= StaticArray< Slot, Capacity >;
+
+		STATIC_ASSERT( Atomic<size_t>::is_always_lock_free );
+
+
+	// variables
+	private:
+		alignas(FG_CACHE_LINE) Atomic<size_t>	_tail	{0};	// producers
+		alignas(FG_CACHE_LINE) size_t			_head	= 0;	// consumer
+		alignas(FG_CACHE_LINE) Slots_t			_slots;
+
+
+	// methods
+	public:
+		LfMPSCQueue ()
+		{
+			for (size_t i = 0; i < Capacity; ++i) {
+				_slots[i].seq.store( i, memory_order_relaxed );
+			}
+			std::atomic_thread_fence( memory_order_release );
+		}
+
+		LfMPSCQueue (const Self &) = delete;
+		LfMPSCQueue (Self &&) = delete;
+
+		Self& operator = (const Self &) = delete;
+		Self& operator = (Self &&) = delete;
+
+		~LfMPSCQueue ()
+		{
+			Clear();
+		}
+
+
+		// returns 'false' if queue is full
+		template <typename T>
+		ND_ bool  Push (T &&value)
+		{
+			size_t	pos = _tail.load( memory_order_relaxed );
+
+			for (;;)
+			{
+				Slot&		slot	= _slots[ pos & Mask ];
+				size_t		seq		= slot.seq.load( memory_order_acquire );
+				intptr_t	diff	= intptr_t(seq) - intptr_t(pos);
+
+				if ( diff == 0 )
+				{
+					// try to reserve slot
+					if ( _tail.compare_exchange_weak( INOUT pos, pos + 1, memory_order_relaxed ))
+					{
+						PlacementNew<Value_t>( &slot.Value(), std::forward<T>(value) );
+						slot.seq.store( pos + 1, memory_order_release );
+						return true;
+					}
+				}
+				else
+				if ( diff < 0 )
+				{
+					// slot is not consumed yet
+					return false;
+				}
+				else
+					pos = _tail.load( memory_order_relaxed );
+			}
+		}
+
+
+		// returns 'false' if queue is empty or the next value is not published yet
+		ND_ bool  Pop (OUT Value_t &value)
+		{
+			Slot&	slot	= _slots[ _head & Mask ];
+			size_t	seq		= slot.seq.load( memory_order_acquire );
+
+			if ( seq != _head + 1 )
+				return false;
+
+			value = std::move( slot.Value() );
+			slot.Value().~Value_t();
+
+			slot.seq.store( _head + Capacity, memory_order_release );
+			++_head;
+			return true;
+		}
+
+
+		void  Clear ()
+		{
+			Value_t	tmp;
+			while ( Pop( OUT tmp )) {}
+		}
+
+
+		// approximate value, only consumer thread can rely on 'Empty() == false'
+		ND_ bool  Empty () const
+		{
+			return _tail.load( memory_order_acquire ) == _head;
+		}
+
+		ND_ static constexpr size_t  GetCapacity ()
+		{
+			return Capacity;
+		}
+	};
+
+
+}	// FGC
@@ -0,0 +1,193 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/WorkerPool.h"
+#include "stl/Platforms/ThreadName.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "stl/Math/Math.h"
+
+namespace FGC
+{
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	WorkerPool::~WorkerPool ()
+	{
+		Stop();
+	}
+
+/*
+=================================================
+	Start
+=================================================
+*/
+	bool  WorkerPool::Start (uint threadCount, NtStringView name)
+	{
+		std::unique_lock	lock{ _mutex };
+
+		CHECK_ERR( _threads.empty() );
+		_looping = true;
+
+		const String	base_name { name.c_str() };
+		for (uint i = 0; i < threadCount; ++i)
+		{
+			_threads.emplace_back( [this, thread_name = base_name + "_" + ToString(i)] ()
+								   {
+										SetCurrentThreadName( thread_name );
+										_Loop();
+								   });
+		}
+		return true;
+	}
+
+/*
+=================================================
+	Stop
+=================================================
+*/
+	void  WorkerPool::Stop ()
+	{
+		Threads_t	threads;
+		{
+			std::unique_lock	lock{ _mutex };
+			_looping = false;
+			std::swap( threads, _threads );
+		}
+		_cv.notify_all();
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		// process remaining jobs on current thread
+		for (; _ProcessOne();) {}
+	}
+
+/*
+=================================================
+	Enqueue
+=================================================
+*/
+	bool  WorkerPool::Enqueue (Job_t &&job)
+	{
+		{
+			std::unique_lock	lock{ _mutex };
+			CHECK_ERR( _looping );
+
+			_queue.push_back( std::move(job) );
+		}
+		_cv.notify_one();
+		return true;
+	}
+
+/*
+=================================================
+	ThreadCount
+=================================================
+*/
+	uint  WorkerPool::ThreadCount ()
+	{
+		std::unique_lock	lock{ _mutex };
+		return uint(_threads.size());
+	}
+
+/*
+=================================================
+	ParallelFor
+=================================================
+*/
+	void  WorkerPool::ParallelFor (size_t count, const IndexedJob_t &fn)
+	{
+		struct SharedState
+		{
+			Atomic<size_t>			next	{0};
+			uint					active	= 0;
+			Mutex					mutex;
+			std::condition_variable	cv;
+		};
+
+		SharedState		state;
+		const auto		Process = [&state, &fn, count] ()
+								  {
+									  for (size_t i = state.next.fetch_add( 1, memory_order_relaxed ); i < count;
+										   i = state.next.fetch_add( 1, memory_order_relaxed ))
+									  {
+										  fn( i );
+									  }
+								  };
+
+		const uint	helpers = uint(Min( count > 0 ? count-1 : 0, size_t(ThreadCount()) ));
+
+		state.active = helpers;
+
+		for (uint i = 0; i < helpers; ++i)
+		{
+			bool	ok = Enqueue( [&state, &Process] ()
+								  {
+									  Process();
+
+									  std::unique_lock	lock{ state.mutex };
+									  if ( --state.active == 0 )
+										  state.cv.notify_all();
+								  });
+			if ( not ok )
+			{
+				std::unique_lock	lock{ state.mutex };
+				--state.active;
+			}
+		}
+
+		Process();
+
+		// wait for helpers, they reference stack variables
+		std::unique_lock	lock{ state.mutex };
+		state.cv.wait( lock, [&state] () { return state.active == 0; });
+	}
+
+/*
+=================================================
+	_ProcessOne
+=================================================
+*/
+	bool  WorkerPool::_ProcessOne ()
+	{
+		Job_t	job;
+		{
+			std::unique_lock	lock{ _mutex };
+			if ( _queue.empty() )
+				return false;
+
+			job = std::move( _queue.front() );
+			_queue.pop_front();
+		}
+		job();
+		return true;
+	}
+
+/*
+=================================================
+	_Loop
+=================================================
+*/
+	void  WorkerPool::_Loop ()
+	{
+		for (;;)
+		{
+			Job_t	job;
+			{
+				std::unique_lock	lock{ _mutex };
+				_cv.wait( lock, [this] () { return not _queue.empty() or not _looping; });
+
+				if ( _queue.empty() )
+					return;
+
+				job = std::move( _queue.front() );
+				_queue.pop_front();
+			}
+			job();
+		}
+	}
+
+}	// FGC
@@ -0,0 +1,72 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Simple fixed-size thread pool.
+	Used for parallel command recording and other short-living CPU jobs.
+*/
+
+#pragma once
+
+#include "stl/Containers/NtStringView.h"
+#include "stl/Containers/ArrayView.h"
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <condition_variable>
+
+namespace FGC
+{
+
+	//
+	// Worker Pool
+	//
+
+	class WorkerPool final
+	{
+	// types
+	public:
+		using Job_t			= Function< void () >;
+		using IndexedJob_t	= Function< void (size_t index) >;
+
+	private:
+		using Threads_t		= Array< std::thread >;
+		using Queue_t		= std::deque< Job_t >;
+
+
+	// variables
+	private:
+		Mutex					_mutex;
+		std::condition_variable	_cv;
+		Queue_t					_queue;
+		Threads_t				_threads;
+		bool					_looping	= false;
+
+
+	// methods
+	public:
+		WorkerPool () {}
+		~WorkerPool ();
+
+		WorkerPool (const WorkerPool &) = delete;
+		WorkerPool (WorkerPool &&) = delete;
+
+		WorkerPool&  operator = (const WorkerPool &) = delete;
+		WorkerPool&  operator = (WorkerPool &&) = delete;
+
+		bool  Start (uint threadCount, NtStringView name = "WorkerPool");
+		void  Stop ();
+
+		bool  Enqueue (Job_t &&job);
+
+		// Calls 'fn' for each index in [0, count), current thread is used too.
+		// Returns when all jobs are complete.
+		void  ParallelFor (size_t count, const IndexedJob_t &fn);
+
+		ND_ uint  ThreadCount ();
+
+	private:
+		void  _Loop ();
+		ND_ bool  _ProcessOne ();
+	};
+
+
+}	// FGC
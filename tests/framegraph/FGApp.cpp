@@ -17,6 +17,7 @@
 #endif
 
 extern void UnitTest_VResourceManager (const FG::FrameGraph &fg);
+extern void UnitTest_VCommandPoolManager (const FG::FrameGraph &fg);
 
 namespace FG
 {
@@ -62,6 +63,19 @@ namespace {
 		_tests.push_back({ &FGApp::ImplTest_Multithreading2, 1 });
 		_tests.push_back({ &FGApp::ImplTest_Multithreading3, 1 });
 		_tests.push_back({ &FGApp::ImplTest_Multithreading4, 1 });
+		_tests.push_back({ &FGApp::ImplTest_Multithreading5, 1 });
+		_tests.push_back({ &FGApp::ImplTest_SecondaryCmdBuf1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_PipelineCache1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_PipelinePrewarm1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_DescriptorUpdate1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_TransientResources1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_MemoryPool1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_BarrierOptimizer1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_TaskReorder1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_StagingUpload1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_Streaming1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_ReadbackFuture1, 1 });
+		_tests.push_back({ &FGApp::ImplTest_CompletionThread1, 1 });
 		
 		// RTX only
 		_tests.push_back({ &FGApp::Test_DrawMeshes1,		1 });
@@ -214,6 +228,7 @@ namespace {
 		#endif	// FG_ENABLE_GLSLANG
 		
 		UnitTest_VResourceManager( _frameGraph );
+		UnitTest_VCommandPoolManager( _frameGraph );
 		return true;
 	}
 #endif	// FG_ENABLE_VULKAN
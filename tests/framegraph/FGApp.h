@@ -89,6 +89,19 @@ namespace FG
 		bool ImplTest_Multithreading2 ();
 		bool ImplTest_Multithreading3 ();
 		bool ImplTest_Multithreading4 ();
+		bool ImplTest_Multithreading5 ();
+		bool ImplTest_SecondaryCmdBuf1 ();
+		bool ImplTest_PipelineCache1 ();
+		bool ImplTest_PipelinePrewarm1 ();
+		bool ImplTest_DescriptorUpdate1 ();
+		bool ImplTest_TransientResources1 ();
+		bool ImplTest_MemoryPool1 ();
+		bool ImplTest_BarrierOptimizer1 ();
+		bool ImplTest_TaskReorder1 ();
+		bool ImplTest_StagingUpload1 ();
+		bool ImplTest_Streaming1 ();
+		bool ImplTest_ReadbackFuture1 ();
+		bool ImplTest_CompletionThread1 ();
 
 
 	// drawing tests
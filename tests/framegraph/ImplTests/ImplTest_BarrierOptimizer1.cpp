@@ -0,0 +1,102 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Many small copy tasks are recorded with and without barrier optimization,
+	content must be the same and optimized command buffer must not contain more barriers.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_BarrierOptimizer1 ()
+	{
+		static constexpr uint	count		= 8;
+		const BytesU			buf_size	= 256_b;
+
+		BufferID	src_buffers [count];
+		BufferID	dst_buffers [count];
+
+		for (uint i = 0; i < count; ++i)
+		{
+			src_buffers[i] = _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "SrcBuffer" );
+			dst_buffers[i] = _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "DstBuffer" );
+			CHECK_ERR( src_buffers[i] and dst_buffers[i] );
+		}
+
+		Array<uint8_t>	src_data;
+		src_data.resize( size_t(buf_size) * count );
+
+		for (size_t i = 0; i < src_data.size(); ++i) {
+			src_data[i] = uint8_t(i * 3);
+		}
+
+		uint	loaded_count	= 0;
+		bool	data_is_correct	= true;
+
+		const auto	Run = [&] (bool optimize, OUT IFrameGraph::Statistics &stat) -> bool
+		{
+			loaded_count = 0;
+			_frameGraph->GetStatistics( OUT stat );	// reset statistic
+
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ).SetOptimizeBarriers( optimize ));
+			CHECK_ERR( cmd );
+
+			Task	updates [count];
+			Task	copies [count];
+
+			for (uint i = 0; i < count; ++i)
+			{
+				updates[i] = cmd->AddTask( UpdateBuffer{}.SetBuffer( src_buffers[i] ).AddData( src_data.data() + size_t(buf_size) * i, size_t(buf_size) ));
+			}
+
+			for (uint i = 0; i < count; ++i)
+			{
+				copies[i] = cmd->AddTask( CopyBuffer{}.From( src_buffers[i] ).To( dst_buffers[i] ).AddRegion( 0_b, 0_b, buf_size ).DependsOn( updates[i] ));
+			}
+
+			for (uint i = 0; i < count; ++i)
+			{
+				const auto	OnLoaded = [&, i] (BufferView data)
+				{
+					bool	equal = (data.size() == buf_size);
+
+					for (size_t j = 0; equal and j < size_t(buf_size); ++j) {
+						equal = (data[j] == src_data[ size_t(buf_size) * i + j ]);
+					}
+					ASSERT( equal );
+					data_is_correct &= equal;
+					++loaded_count;
+				};
+
+				Unused( cmd->AddTask( ReadBuffer{}.SetBuffer( dst_buffers[i], 0_b, buf_size ).SetCallback( OnLoaded ).DependsOn( copies[i] )));
+			}
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+			return true;
+		};
+
+		IFrameGraph::Statistics		default_stat;
+		IFrameGraph::Statistics		optimized_stat;
+
+		CHECK_ERR( Run( false, OUT default_stat ));
+		CHECK_ERR( loaded_count == count );
+
+		CHECK_ERR( Run( true, OUT optimized_stat ));
+		CHECK_ERR( loaded_count == count );
+		CHECK_ERR( data_is_correct );
+
+		CHECK_ERR( default_stat.renderer.transferOps == optimized_stat.renderer.transferOps );
+		CHECK_ERR( optimized_stat.renderer.pipelineBarriers <= default_stat.renderer.pipelineBarriers );
+
+		for (uint i = 0; i < count; ++i) {
+			DeleteResources( src_buffers[i], dst_buffers[i] );
+		}
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,121 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Creates frame graph with completion thread and custom callback executor,
+	readback callbacks must be called on executor thread before 'Wait' returns.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_CompletionThread1 ()
+	{
+		Mutex					exec_guard;
+		Array<std::thread>		exec_threads;
+		Atomic<uint>			exec_count		{0};
+
+		VulkanDeviceInfo	vulkan_info;
+		{
+			vulkan_info.instance		= BitCast<InstanceVk_t>( _vulkan.GetVkInstance() );
+			vulkan_info.physicalDevice	= BitCast<PhysicalDeviceVk_t>( _vulkan.GetVkPhysicalDevice() );
+			vulkan_info.device			= BitCast<DeviceVk_t>( _vulkan.GetVkDevice() );
+
+			for (auto& q : _vulkan.GetVkQueues())
+			{
+				VulkanDeviceInfo::QueueInfo	qi;
+				qi.handle		= BitCast<QueueVk_t>( q.handle );
+				qi.familyFlags	= BitCast<QueueFlagsVk_t>( q.familyFlags );
+				qi.familyIndex	= q.familyIndex;
+				qi.priority		= q.priority;
+				qi.debugName	= q.debugName;
+
+				vulkan_info.queues.push_back( qi );
+			}
+
+			vulkan_info.useCompletionThread	= true;
+			vulkan_info.callbackExecutor	= [&exec_guard, &exec_threads, &exec_count] (std::function<void ()> &&fn)
+											{
+												exec_count.fetch_add( 1, memory_order_relaxed );
+
+												EXLOCK( exec_guard );
+												exec_threads.emplace_back( std::move(fn) );
+											};
+		}
+
+		// previous tests must not use queues while second frame graph exists
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		FrameGraph	fg = IFrameGraph::CreateFrameGraph( vulkan_info );
+		CHECK_ERR( fg );
+
+		const BytesU		buf_size	= 4_Kb;
+		const auto			this_thread	= std::this_thread::get_id();
+		BufferID			buffer		= fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" );
+		CHECK_ERR( buffer );
+
+		Array<uint8_t>	buffer_data;
+		buffer_data.resize( size_t(buf_size) );
+
+		for (size_t i = 0; i < buffer_data.size(); ++i) {
+			buffer_data[i] = uint8_t(i * 7);
+		}
+
+		for (uint i = 0; i < 4; ++i)
+		{
+			bool				cb_called		= false;
+			std::thread::id		cb_thread;
+			bool				data_is_correct	= false;
+
+			const auto	OnLoaded = [&] (const BufferView &view)
+			{
+				cb_thread		= std::this_thread::get_id();
+				data_is_correct	= (view.size() == buffer_data.size());
+
+				size_t	offset = 0;
+				for (auto& part : view.Parts())
+				{
+					data_is_correct &= (std::memcmp( part.data(), buffer_data.data() + offset, part.size() ) == 0);
+					offset += part.size();
+				}
+				cb_called		= true;
+			};
+
+			CommandBuffer	cmd = fg->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			Task	t_update	= cmd->AddTask( UpdateBuffer{}.SetBuffer( buffer ).AddData( buffer_data ));
+			Task	t_read		= cmd->AddTask( ReadBuffer{}.SetBuffer( buffer, 0_b, buf_size ).DependsOn( t_update ).SetCallback( OnLoaded ));
+			Unused( t_read );
+
+			CHECK_ERR( fg->Execute( cmd ));
+
+			// odd frames are released in 'WaitIdle'
+			if ( i & 1 ) {
+				CHECK_ERR( fg->WaitIdle() );
+			} else {
+				CHECK_ERR( fg->Wait({ cmd }));
+			}
+
+			// callback must be called before 'Wait' returns
+			CHECK_ERR( cb_called );
+			CHECK_ERR( data_is_correct );
+			CHECK_ERR( cb_thread != this_thread );
+		}
+
+		CHECK_ERR( exec_count.load() > 0 );
+
+		CHECK_ERR( fg->ReleaseResource( buffer ));
+		fg->Deinitialize();
+		fg = null;
+
+		// all callbacks are complete, threads can be joined without lock
+		for (auto& t : exec_threads) {
+			t.join();
+		}
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
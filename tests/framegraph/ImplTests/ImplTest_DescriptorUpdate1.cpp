@@ -0,0 +1,128 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Measures how many descriptor sets per second can be created:
+	- one by one with 'CachePipelineResources', each set is updated immediately;
+	- inside command buffer, all sets are updated in single batch before compilation.
+*/
+
+#include "../FGApp.h"
+#include <chrono>
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_DescriptorUpdate1 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		using Clock_t = std::chrono::high_resolution_clock;
+
+		ComputePipelineDesc	ppln;
+
+		ppln.AddShader( EShaderLangFormat::VKSL_100, "main", R"#(
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+
+layout (binding=0, std140) uniform UB {
+	vec4	data;
+} ub;
+
+layout (binding=1, std430) writeonly buffer SSB {
+	vec4	data;
+} ssb;
+
+void main ()
+{
+	ssb.data = ub.data;
+}
+)#" );
+
+		constexpr uint	set_count	= 512;
+		const BytesU	align		= Max( _properties.minStorageBufferOffsetAlignment, _properties.minUniformBufferOffsetAlignment );
+		const BytesU	stride		= AlignToLarger( SizeOf<float4>, align );
+		BufferID		src_buffer	= _frameGraph->CreateBuffer( BufferDesc{ stride * set_count, EBufferUsage::Uniform }, Default, "SrcBuffer" );
+		BufferID		dst_buffer	= _frameGraph->CreateBuffer( BufferDesc{ stride * set_count, EBufferUsage::Storage }, Default, "DstBuffer" );
+		CPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( src_buffer and dst_buffer and pipeline );
+
+		Array<PipelineResources>	resources;
+		resources.resize( set_count );
+
+		// 'shift' makes descriptor sets unique for each measurement
+		const auto	InitResources = [&] (uint shift) -> bool
+		{
+			for (uint i = 0; i < set_count; ++i)
+			{
+				auto&	res = resources[i];
+				CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT res ));
+
+				res.BindBuffer( UniformID("UB"),  src_buffer, stride * ((i + shift) % set_count), SizeOf<float4> );
+				res.BindBuffer( UniformID("SSB"), dst_buffer, stride * i, SizeOf<float4> );
+			}
+			return true;
+		};
+
+		IFrameGraph::Statistics	stat;
+		_frameGraph->GetStatistics( OUT stat );	// reset statistic
+
+		// immediate update
+		double	immediate_rate = 0.0;
+		{
+			CHECK_ERR( InitResources( 1 ));
+
+			const auto	start = Clock_t::now();
+
+			for (auto& res : resources) {
+				CHECK_ERR( _frameGraph->CachePipelineResources( INOUT res ));
+			}
+
+			const auto	dt = std::chrono::duration_cast<std::chrono::duration<double>>( Clock_t::now() - start ).count();
+			immediate_rate = set_count / Max( dt, 1.0e-9 );
+
+			for (auto& res : resources) {
+				_frameGraph->ReleaseResource( INOUT res );
+			}
+		}
+
+		// deferred update
+		double	batched_rate = 0.0;
+		{
+			CHECK_ERR( InitResources( 2 ));
+
+			const auto		start	= Clock_t::now();
+			CommandBuffer	cmd		= _frameGraph->Begin( CommandBufferDesc{} );
+			CHECK_ERR( cmd );
+
+			// each descriptor set is used twice, but must be updated only once
+			for (uint j = 0; j < 2; ++j)
+			for (auto& res : resources) {
+				cmd->AddTask( DispatchCompute{}.SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), res ).Dispatch({ 1, 1 }));
+			}
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+
+			const auto	dt = std::chrono::duration_cast<std::chrono::duration<double>>( Clock_t::now() - start ).count();
+			batched_rate = set_count / Max( dt, 1.0e-9 );
+
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.deferredDescriptorSets == set_count );
+		CHECK_ERR( stat.renderer.dispatchCalls == set_count * 2 );
+
+		FG_LOGI( "descriptor sets per second, immediate: "s << ToString( uint64_t(immediate_rate) )
+				 << ", batched (including task recording): " << ToString( uint64_t(batched_rate) ));
+
+		resources.clear();
+		DeleteResources( src_buffer, dst_buffer, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,86 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Resources are allocated from named memory pools,
+	pool usage and heap budget must be reported in statistics.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_MemoryPool1 ()
+	{
+		const MemPoolID		rt_pool		{"RenderTargets"};
+		const MemPoolID		stream_pool	{"Streaming"};
+		const BytesU		buf_size	= 4_Kb;
+
+		CHECK_ERR( _frameGraph->CreateMemoryPool( rt_pool, MemoryPoolDesc{ EMemoryType::Default, EMemoryPoolAlgorithm::Default, 16_Mb } ));
+		CHECK_ERR( _frameGraph->CreateMemoryPool( stream_pool, MemoryPoolDesc{ EMemoryType::Default, EMemoryPoolAlgorithm::Buddy, 8_Mb, 0, 4_Mb } ));
+
+		ImageID		image	= _frameGraph->CreateImage( ImageDesc{}.SetDimension({ 256, 256 }).SetFormat( EPixelFormat::RGBA8_UNorm ).SetUsage( EImageUsage::ColorAttachment | EImageUsage::Transfer ),
+														MemoryDesc{ EMemoryType::Default, rt_pool }, "RenderTarget" );
+		BufferID	buffer	= _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, MemoryDesc{ EMemoryType::Default, stream_pool }, "StreamingBuffer" );
+		CHECK_ERR( image and buffer );
+
+		Array<uint8_t>	src_data;
+		src_data.resize( size_t(buf_size) );
+
+		for (size_t i = 0; i < src_data.size(); ++i) {
+			src_data[i] = uint8_t(i * 7);
+		}
+
+		bool	cb_was_called	= false;
+		bool	data_is_correct	= false;
+
+		const auto	OnLoaded = [&src_data, OUT &cb_was_called, OUT &data_is_correct] (BufferView data)
+		{
+			cb_was_called	= true;
+			data_is_correct	= (data.size() == src_data.size());
+
+			for (size_t i = 0; data_is_correct and i < src_data.size(); ++i)
+			{
+				data_is_correct &= (data[i] == src_data[i]);
+			}
+			ASSERT( data_is_correct );
+		};
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		Task	t_update	= cmd->AddTask( UpdateBuffer{}.SetBuffer( buffer ).AddData( src_data ));
+		Task	t_clear		= cmd->AddTask( ClearColorImage{}.SetImage( image ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{0.0f} ));
+		Task	t_read		= cmd->AddTask( ReadBuffer{}.SetBuffer( buffer, 0_b, buf_size ).SetCallback( OnLoaded ).DependsOn( t_update, t_clear ));
+		Unused( t_read );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( cb_was_called );
+		CHECK_ERR( data_is_correct );
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+
+		CHECK_ERR( stat.memory.heaps.size() );
+		CHECK_ERR( stat.memory.pools.size() == 2 );
+
+		for (auto& heap : stat.memory.heaps) {
+			CHECK_ERR( heap.budget > 0 and heap.budget <= heap.size );
+		}
+
+		for (auto& pool : stat.memory.pools)
+		{
+			CHECK_ERR( pool.id == rt_pool or pool.id == stream_pool );
+			CHECK_ERR( pool.allocationCount == 1 );
+			CHECK_ERR( pool.used > 0 and pool.used <= pool.allocated );
+			CHECK_ERR( pool.id == rt_pool or pool.budget == 4_Mb );
+		}
+
+		DeleteResources( image, buffer );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,134 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Contention benchmark: many threads record and execute small command buffers
+	while another thread continuously flushes, 'Execute' must not wait for 'Flush'.
+*/
+
+#include "../FGApp.h"
+#include "stl/ThreadSafe/Barrier.h"
+#include <thread>
+
+namespace FG
+{
+	static constexpr uint		max_count		= 1000;
+	static constexpr uint		thread_count	= 8;
+	static constexpr uint		wait_interval	= 16;
+	static Barrier				sync			{thread_count + 1};
+	static Atomic<uint>			executed		{0};
+
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	struct ExecuteTime
+	{
+		Nanoseconds		total	{0};
+		Nanoseconds		max		{0};
+	};
+
+
+	static bool RecordThread (const FrameGraph &fg, uint index, OUT ExecuteTime &time)
+	{
+		BufferID	buffer = fg->CreateBuffer( BufferDesc{ 256_b, EBufferUsage::Transfer }, Default, "Buffer" );
+		CHECK_ERR( buffer );
+
+		// (0) wait until all threads has been initialized
+		sync.wait();
+
+		for (uint i = 0; i < max_count; ++i)
+		{
+			CommandBuffer cmd = fg->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			Task	t_fill = cmd->AddTask( FillBuffer{}.SetBuffer( buffer, 0_b, 256_b ).SetPattern( index * max_count + i ));
+			Unused( t_fill );
+
+			const auto	start = Clock_t::now();
+			CHECK_ERR( fg->Execute( cmd ));
+			const auto	dt = std::chrono::duration_cast<Nanoseconds>( Clock_t::now() - start );
+
+			time.total	+= dt;
+			time.max	 = Max( time.max, dt );
+			executed.fetch_add( 1, memory_order_relaxed );
+
+			// (1) wait until all threads complete command buffer recording
+			sync.wait();
+		}
+
+		fg->ReleaseResource( buffer );
+		return true;
+	}
+
+
+	static bool FlushThread (const FrameGraph &fg, OUT uint &flushCount)
+	{
+		// (0) wait until all threads has been initialized
+		sync.wait();
+
+		for (uint i = 0; i < max_count; ++i)
+		{
+			// flush while other threads are executing command buffers
+			for (; executed.load( memory_order_relaxed ) < (i+1) * thread_count; ++flushCount)
+			{
+				CHECK_ERR( fg->Flush() );
+			}
+
+			// (1) wait until all threads complete command buffer recording
+			sync.wait();
+
+			// limit number of batches in flight
+			if ( (i+1) % wait_interval == 0 )
+				CHECK_ERR( fg->WaitIdle() );
+		}
+		return true;
+	}
+
+
+	bool FGApp::ImplTest_Multithreading5 ()
+	{
+		StaticArray< ExecuteTime, thread_count >	times;
+		StaticArray< bool, thread_count >			results;
+		Array< std::thread >						threads;
+		uint										flush_count		= 0;
+		bool										flush_result	= false;
+
+		executed.store( 0 );
+
+		const auto	start = Clock_t::now();
+
+		for (uint i = 0; i < thread_count; ++i)
+		{
+			threads.emplace_back( [this, i, &times, &results] () { results[i] = RecordThread( _frameGraph, i, OUT times[i] ); });
+		}
+		threads.emplace_back( [this, &flush_result, &flush_count] () { flush_result = FlushThread( _frameGraph, OUT flush_count ); });
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		const auto	total_time = std::chrono::duration_cast<Nanoseconds>( Clock_t::now() - start );
+
+		CHECK_ERR( flush_result );
+		for (auto& res : results) {
+			CHECK_ERR( res );
+		}
+
+		Nanoseconds	exec_total {0};
+		Nanoseconds	exec_max   {0};
+		for (auto& t : times)
+		{
+			exec_total	+= t.total;
+			exec_max	 = Max( exec_max, t.max );
+		}
+
+		FG_LOGI( "threads: "s << ToString( thread_count ) << ", command buffers: " << ToString( max_count * thread_count )
+				 << ", flushes: " << ToString( flush_count )
+				 << ", total: " << ToString( total_time )
+				 << ", avg execute: " << ToString( exec_total / (max_count * thread_count) )
+				 << ", max execute: " << ToString( exec_max ));
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,86 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Serializes pipeline cache after pipeline creation,
+	loads it back and checks that corrupted or empty cache is rejected
+	and that serialized data is deterministic.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_PipelineCache1 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		ComputePipelineDesc	ppln;
+
+		ppln.AddShader( EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(set=0, binding=0, rgba8) writeonly uniform image2D  un_OutImage;
+
+void main ()
+{
+	imageStore( un_OutImage, ivec2(gl_GlobalInvocationID.xy), vec4(gl_LocalInvocationID.xyxy) / 8.0 );
+}
+)#" );
+
+		const uint2		image_dim	= { 16, 16 };
+
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( image_dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::Storage ),
+															    Default, "MyImage_0" );
+
+		CPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( image and pipeline );
+
+		PipelineResources	resources;
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources ));
+
+		resources.BindImage( UniformID("un_OutImage"), image );
+
+		// pipeline instance is created in command buffer local cache and merged into global cache
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{} );
+		CHECK_ERR( cmd );
+
+		cmd->AddTask( DispatchCompute().SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), resources ).Dispatch({ 2, 2 }) );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		Array<uint8_t>	data;
+		CHECK_ERR( _frameGraph->SerializePipelineCache( OUT data ));
+		CHECK_ERR( not data.empty() );
+
+		// serialized data must be deterministic
+		Array<uint8_t>	data2;
+		CHECK_ERR( _frameGraph->SerializePipelineCache( OUT data2 ));
+		CHECK_ERR( data == data2 );
+
+		CHECK_ERR( _frameGraph->DeserializePipelineCache( data ));
+
+		// header without cache data, 56 bytes is the header size
+		CHECK_ERR( not _frameGraph->DeserializePipelineCache( ArrayView<uint8_t>{ data }.section( 0, 56 )));
+
+		// corrupted data must not be passed to the driver
+		CHECK_ERR( not _frameGraph->DeserializePipelineCache( ArrayView<uint8_t>{ data }.section( 0, data.size()/2 )));
+
+		data.back() ^= 0xFF;
+		CHECK_ERR( not _frameGraph->DeserializePipelineCache( data ));
+
+		DeleteResources( pipeline, image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,118 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Prewarms graphics pipeline on background thread and checks that
+	draw task uses prewarmed pipeline instead of creating new one.
+	Then draws into render pass with different load op using 'Compatible' miss policy.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_PipelinePrewarm1 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		GraphicsPipelineDesc	ppln;
+
+		ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(vertex)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+const vec2	g_Positions[3] = vec2[]( vec2(0.0, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5) );
+
+void main() {
+	gl_Position	= vec4( g_Positions[gl_VertexIndex], 0.0, 1.0 );
+}
+)#" );
+
+		ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(fragment)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec4  out_Color;
+
+void main() {
+	out_Color = vec4(1.0);
+}
+)#" );
+
+		const uint2		view_size	= {256, 256};
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::ColorAttachment | EImageUsage::TransferSrc ),
+															    Default, "RenderTarget" );
+
+		GPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( image and pipeline );
+
+		RenderState		render_state;
+		render_state.inputAssembly.topology = EPrimitive::TriangleList;
+
+		IFrameGraph::Statistics	stat;
+		_frameGraph->GetStatistics( OUT stat );	// reset statistic
+
+		// prewarm
+		{
+			RenderPassDesc	rp_desc{ view_size };
+			rp_desc.AddTarget( RenderTargetID::Color_0, image, EAttachmentLoadOp::Load, EAttachmentStoreOp::Store )
+				   .AddViewport( view_size );
+
+			CHECK_ERR( _frameGraph->PrewarmPipeline( pipeline, rp_desc, render_state, VertexInputState{} ));
+
+			// must be ignored
+			CHECK_ERR( _frameGraph->PrewarmPipeline( pipeline, rp_desc, render_state, VertexInputState{} ));
+		}
+
+		// draw with the same render pass, 'Block' policy waits for prewarmed pipeline
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetPipelineMissPolicy( EPipelineMissPolicy::Block ));
+			CHECK_ERR( cmd );
+
+			LogicalPassID	render_pass	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+												.AddTarget( RenderTargetID::Color_0, image, EAttachmentLoadOp::Load, EAttachmentStoreOp::Store )
+												.AddViewport( view_size ));
+
+			cmd->AddTask( render_pass, DrawVertices().Draw( 3 ).SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList ));
+			cmd->AddTask( SubmitRenderPass{ render_pass });
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		// draw into compatible render pass
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetPipelineMissPolicy( EPipelineMissPolicy::Compatible ));
+			CHECK_ERR( cmd );
+
+			LogicalPassID	render_pass	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+												.AddTarget( RenderTargetID::Color_0, image, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+												.AddViewport( view_size ));
+
+			cmd->AddTask( render_pass, DrawVertices().Draw( 3 ).SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList ));
+			cmd->AddTask( SubmitRenderPass{ render_pass });
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.renderer.drawCalls == 2 );
+		CHECK_ERR( stat.renderer.skippedDrawCalls == 0 );
+		CHECK_ERR( stat.resources.prewarmedPipelineCount == 1 );
+		CHECK_ERR( stat.resources.newGraphicsPipelineCount == 1 );
+		CHECK_ERR( stat.resources.compatiblePipelineHits == 1 );
+
+		DeleteResources( image, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,121 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Reads buffer and image into the readback futures,
+	data must stay valid after other batches are completed.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_ReadbackFuture1 ()
+	{
+		const uint2		img_dim		= {128, 128};
+		const BytesU	img_size	= 4_b * img_dim.x * img_dim.y;
+		const BytesU	buf_size	= 256_Kb;
+
+		ImageID		image	= _frameGraph->CreateImage( ImageDesc{}.SetDimension( img_dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																.SetUsage( EImageUsage::Transfer ),
+														Default, "Image" );
+		BufferID	buffer	= _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" );
+		CHECK_ERR( image and buffer );
+
+		Array<uint8_t>	buffer_data;
+		buffer_data.resize( size_t(buf_size) );
+
+		for (size_t i = 0; i < buffer_data.size(); ++i) {
+			buffer_data[i] = uint8_t((i * 13) ^ (i >> 8));
+		}
+
+		Array<uint8_t>	image_data;
+		image_data.resize( size_t(img_size) );
+
+		for (size_t i = 0; i < image_data.size(); ++i) {
+			image_data[i] = uint8_t(i * 5);
+		}
+
+		ReadbackFuture	buf_future;
+		ReadbackFuture	img_future;
+		bool			cb_called	= false;
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			Task	t_update1	= cmd->AddTask( UpdateBuffer{}.SetBuffer( buffer ).AddData( buffer_data ));
+			Task	t_update2	= cmd->AddTask( UpdateImage{}.SetImage( image ).SetData( image_data, img_dim ));
+			Task	t_read1		= cmd->AddTask( ReadBuffer{}.SetBuffer( buffer, 0_b, buf_size ).DependsOn( t_update1 )
+													.SetCallback( [&cb_called] (BufferView) { cb_called = true; }),
+												OUT buf_future );
+			Task	t_read2		= cmd->AddTask( ReadImage{}.SetImage( image, int2(), img_dim ).DependsOn( t_update2 ), OUT img_future );
+			CHECK_ERR( t_read1 and t_read2 );
+			CHECK_ERR( buf_future and img_future );
+
+			// data is not available until the command buffer is executed
+			CHECK_ERR( not buf_future->IsReady() );
+			CHECK_ERR( buf_future->GetBuffer().empty() );
+			CHECK_ERR( not buf_future->Wait( Nanoseconds{0} ));
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+		}
+
+		// blocking wait submits the command buffer
+		CHECK_ERR( buf_future->Wait( IFrameGraph::MaxTimeout ));
+		CHECK_ERR( img_future->Wait( IFrameGraph::MaxTimeout ));
+		CHECK_ERR( buf_future->IsReady() and img_future->IsReady() );
+		CHECK_ERR( cb_called );
+
+		// read and complete other batches to check that readback memory is not recycled
+		for (uint i = 0; i < 4; ++i)
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			Task	t_update	= cmd->AddTask( FillBuffer{}.SetBuffer( buffer, 0_b, buf_size ).SetPattern( i ));
+			Task	t_read		= cmd->AddTask( ReadBuffer{}.SetBuffer( buffer, 0_b, buf_size ).DependsOn( t_update ).SetCallback( [] (BufferView) {} ));
+			Unused( t_read );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		// check buffer data
+		{
+			BufferView	view = buf_future->GetBuffer();
+			CHECK_ERR( view.size() == buffer_data.size() );
+			CHECK_ERR( img_future->GetBuffer().empty() );
+
+			size_t	offset = 0;
+			for (auto& part : view.Parts())
+			{
+				CHECK_ERR( std::memcmp( part.data(), buffer_data.data() + offset, part.size() ) == 0 );
+				offset += part.size();
+			}
+		}
+
+		// check image data
+		{
+			ImageView	view = img_future->GetImage();
+			CHECK_ERR( All( view.Dimension() == uint3(img_dim.x, img_dim.y, 1) ));
+			CHECK_ERR( buf_future->GetImage().empty() );
+
+			const BytesU	row_pitch = 4_b * img_dim.x;
+
+			for (uint y = 0; y < img_dim.y; ++y)
+			{
+				ArrayView<uint8_t>	row = view.GetRow( y );
+				CHECK_ERR( std::memcmp( row.data(), image_data.data() + size_t(row_pitch * y), size_t(row_pitch) ) == 0 );
+			}
+		}
+
+		// readback memory is released here
+		buf_future.reset();
+		img_future.reset();
+
+		DeleteResources( image, buffer );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
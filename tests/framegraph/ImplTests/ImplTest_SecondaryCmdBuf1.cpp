@@ -0,0 +1,136 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compares render pass with many draw tasks recorded inline
+	and recorded into secondary command buffers on multiple threads.
+*/
+
+#include "../FGApp.h"
+#include <chrono>
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_SecondaryCmdBuf1 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		GraphicsPipelineDesc	ppln;
+
+		ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(vertex)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec3  v_Color;
+
+const vec2	g_Positions[3] = vec2[](
+	vec2(0.0, 0.1),
+	vec2(0.9, 0.9),
+	vec2(0.1, 0.9)
+);
+
+void main() {
+	const vec2	cell_count	= vec2(64.0, 32.0);
+	vec2		cell		= vec2( gl_InstanceIndex % 64, gl_InstanceIndex / 64 );
+	vec2		pos			= (cell + g_Positions[gl_VertexIndex]) / cell_count;
+
+	gl_Position	= vec4( pos * 2.0 - 1.0, 0.0, 1.0 );
+	v_Color		= vec3( cell / cell_count, float(gl_InstanceIndex & 1) );
+}
+)#" );
+
+		ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(fragment)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec4  out_Color;
+
+layout(location=0) in  vec3  v_Color;
+
+void main() {
+	out_Color = vec4(v_Color, 1.0);
+}
+)#" );
+
+		using TimePoint_t = std::chrono::high_resolution_clock::time_point;
+
+		const uint		draw_count	= 64 * 32;
+		const uint2		view_size	= {512, 256};
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::ColorAttachment | EImageUsage::TransferSrc ),
+															    Default, "RenderTarget" );
+
+		GPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( image and pipeline );
+
+
+		Array<uint8_t>	pixels[2];
+		Nanoseconds		cpu_time[2];
+		uint			secondary_count = 0;
+
+		for (uint mode = 0; mode < 2; ++mode)
+		{
+			const auto	OnLoaded = [&dst = pixels[mode]] (const ImageView &imageData)
+			{
+				for (uint y = 0; y < imageData.Dimension().y; ++y)
+				{
+					auto	row = imageData.GetRow( y );
+					dst.insert( dst.end(), row.begin(), row.end() );
+				}
+			};
+
+			IFrameGraph::Statistics	stat;
+			_frameGraph->GetStatistics( OUT stat );	// reset statistic
+
+			const TimePoint_t	start = std::chrono::high_resolution_clock::now();
+
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+			CHECK_ERR( cmd );
+
+			LogicalPassID	render_pass	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+												.AddTarget( RenderTargetID::Color_0, image, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+												.AddViewport( view_size )
+												.SetSecondaryCmdbufEnabled( mode == 1 ));
+
+			for (uint i = 0; i < draw_count; ++i)
+			{
+				cmd->AddTask( render_pass, DrawVertices().Draw( 3, 1, 0, i ).SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList ));
+			}
+
+			Task	t_draw	= cmd->AddTask( SubmitRenderPass{ render_pass });
+			Task	t_read	= cmd->AddTask( ReadImage().SetImage( image, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_draw ));
+			Unused( t_read );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+
+			cpu_time[mode] = std::chrono::duration_cast<Nanoseconds>( std::chrono::high_resolution_clock::now() - start );
+
+			CHECK_ERR( _frameGraph->WaitIdle() );
+
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+			CHECK_ERR( stat.renderer.drawCalls == draw_count );
+
+			if ( mode == 1 )
+				secondary_count = stat.renderer.secondaryCmdBuffers;
+			else
+				CHECK_ERR( stat.renderer.secondaryCmdBuffers == 0 );
+		}
+
+		FG_LOGI( "Inline recording: "s << ToString( cpu_time[0] ) << ", secondary recording: " << ToString( cpu_time[1] )
+				 << " with " << ToString( secondary_count ) << " command buffers" );
+
+		CHECK_ERR( pixels[0].size() == pixels[1].size() );
+		CHECK_ERR( pixels[0] == pixels[1] );
+
+		DeleteResources( image, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
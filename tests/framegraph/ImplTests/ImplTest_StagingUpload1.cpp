@@ -0,0 +1,128 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Measures CPU-side upload throughput: 'UpdateImage::SetData' with data that was decoded to temporary array
+	against 'UpdateImage::SetWriter' that decodes directly to the staging memory.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	// emulates texture decoding, each byte depends only on its offset
+	static void  DecodeTexels (OUT void *dst, BytesU offset, BytesU size)
+	{
+		uint8_t*	ptr = Cast<uint8_t>( dst );
+
+		for (size_t i = 0, off = size_t(offset); i < size_t(size); ++i, ++off)
+		{
+			ptr[i] = uint8_t((off * 7) ^ (off >> 10));
+		}
+	}
+
+
+	bool FGApp::ImplTest_StagingUpload1 ()
+	{
+		const uint2		dim			= {1024, 1024};
+		const BytesU	bpp			= 4_b;
+		const BytesU	row_pitch	= dim.x * bpp;
+		const BytesU	data_size	= row_pitch * dim.y;
+		const uint		max_iter	= 32;
+		
+		ImageID		image = _frameGraph->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm ).SetUsage( EImageUsage::Transfer ), Default, "Image" );
+		CHECK_ERR( image );
+
+		Array<uint8_t>	temp;
+		Nanoseconds		copy_time	{0};
+		Nanoseconds		writer_time	{0};
+
+		for (uint i = 0; i < max_iter; ++i)
+		{
+			// decode to temporary array and copy to staging buffer
+			{
+				CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+				CHECK_ERR( cmd );
+
+				const auto	start = Clock_t::now();
+
+				temp.resize( size_t(data_size) );
+				DecodeTexels( OUT temp.data(), 0_b, data_size );
+
+				Task	t_update = cmd->AddTask( UpdateImage{}.SetImage( image ).SetData( temp, dim ));
+				CHECK_ERR( t_update );
+
+				copy_time += std::chrono::duration_cast<Nanoseconds>( Clock_t::now() - start );
+				
+				CHECK_ERR( _frameGraph->Execute( cmd ));
+				CHECK_ERR( _frameGraph->WaitIdle() );
+			}
+
+			// decode directly to staging buffer
+			{
+				CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+				CHECK_ERR( cmd );
+
+				const auto	start = Clock_t::now();
+
+				Task	t_update = cmd->AddTask( UpdateImage{}.SetImage( image ).SetWriter( DecodeTexels, dim ));
+				CHECK_ERR( t_update );
+
+				writer_time += std::chrono::duration_cast<Nanoseconds>( Clock_t::now() - start );
+				
+				CHECK_ERR( _frameGraph->Execute( cmd ));
+				CHECK_ERR( _frameGraph->WaitIdle() );
+			}
+		}
+
+		// check uploaded data
+		bool	cb_was_called	= false;
+		bool	data_is_correct	= false;
+
+		const auto	OnLoaded =	[dim, row_pitch, OUT &cb_was_called, OUT &data_is_correct] (const ImageView &imageData)
+		{
+			cb_was_called	= true;
+			data_is_correct	= true;
+
+			Array<uint8_t>	expected;
+			expected.resize( size_t(row_pitch) );
+
+			for (uint y = 0; y < dim.y; ++y)
+			{
+				ArrayView<uint8_t>	row = imageData.GetRow( y );
+				DecodeTexels( OUT expected.data(), y * row_pitch, row_pitch );
+
+				const bool	is_equal = (std::memcmp( row.data(), expected.data(), expected.size() ) == 0);
+				ASSERT( is_equal );
+				data_is_correct &= is_equal;
+			}
+		};
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			Task	t_read = cmd->AddTask( ReadImage{}.SetImage( image, int2(), dim ).SetCallback( OnLoaded ));
+			Unused( t_read );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		CHECK_ERR( cb_was_called );
+		CHECK_ERR( data_is_correct );
+
+		const auto	ToMbPerSec = [total = double(uint64_t(data_size)) * max_iter] (Nanoseconds t) {
+			return uint64_t( total / (1024.0 * 1024.0) / (double(t.count()) * 1.0e-9) );
+		};
+
+		FG_LOGI( "uploaded: "s << ToString( data_size * max_iter )
+				 << ", SetData: " << ToString( ToMbPerSec( copy_time )) << " Mb/s"
+				 << ", SetWriter: " << ToString( ToMbPerSec( writer_time )) << " Mb/s" );
+
+		DeleteResources( image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
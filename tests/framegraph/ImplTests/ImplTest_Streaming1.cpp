@@ -0,0 +1,144 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Streams image with mipmaps on the transfer queue and buffer on the graphics queue
+	with a small per-frame budget, then reads back the data.
+*/
+
+#include "framegraph/Public/StreamingManager.h"
+#include "../FGApp.h"
+
+namespace FG
+{
+	static uint8_t  TexelValue (size_t offset)
+	{
+		return uint8_t((offset * 7) ^ (offset >> 10));
+	}
+
+
+	bool FGApp::ImplTest_Streaming1 ()
+	{
+		const uint2		dim			= {512, 512};
+		const uint		mip_count	= 3;
+		const BytesU	bpp			= 4_b;
+		const BytesU	buf_size	= 2_Mb;
+		const uint		max_frames	= 1000;
+
+		StreamingManager::Config	cfg;
+		cfg.budgetPerFrame	= 256_Kb;
+		cfg.maxChunkSize	= 64_Kb;
+
+		StreamingManager	streaming{ _frameGraph, cfg };
+
+		ImageID		image	= _frameGraph->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																.SetUsage( EImageUsage::Transfer ).SetMaxMipmaps( mip_count )
+																.SetQueues( EQueueUsage::Graphics | EQueueUsage::AsyncTransfer ),
+														Default, "Image" );
+		BufferID	buffer	= _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" );
+		CHECK_ERR( image and buffer );
+
+		Array<uint8_t>	image_data;
+		BytesU			mip1_offset;
+
+		for (uint mip = 0; mip < mip_count; ++mip)
+		{
+			if ( mip == 1 )
+				mip1_offset = ArraySizeOf(image_data);
+
+			image_data.resize( image_data.size() + size_t(bpp * (dim.x >> mip) * (dim.y >> mip)) );
+		}
+		for (size_t i = 0; i < image_data.size(); ++i) {
+			image_data[i] = TexelValue( i );
+		}
+
+		Array<uint8_t>	buffer_data;
+		buffer_data.resize( size_t(buf_size) );
+
+		for (size_t i = 0; i < buffer_data.size(); ++i) {
+			buffer_data[i] = TexelValue( i * 3 );
+		}
+
+		const BytesU	total_size		= ArraySizeOf(image_data) + ArraySizeOf(buffer_data);
+		bool			image_loaded	= false;
+		bool			buffer_loaded	= false;
+
+		auto	image_req = streaming.Upload( StreamingManager::ImageRequest{ image, 0_mipmap, mip_count, Array<uint8_t>{image_data} }
+												.SetPriority( 1 ).SetCallback( [&image_loaded] () { image_loaded = true; }));
+		auto	buffer_req = streaming.Upload( StreamingManager::BufferRequest{ buffer, 0_b, Array<uint8_t>{buffer_data} }
+												.SetCallback( [&buffer_loaded] () { buffer_loaded = true; }));
+		CHECK_ERR( image_req != Default and buffer_req != Default );
+		CHECK_ERR( streaming.PendingSize() == total_size );
+
+		// render loop
+		uint	frame = 0;
+		for (; frame < max_frames and not (image_loaded and buffer_loaded); ++frame)
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			CHECK_ERR( streaming.Update( cmd ));
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->Flush() );
+		}
+
+		CHECK_ERR( image_loaded and buffer_loaded );
+		CHECK_ERR( streaming.PendingSize() == 0_b );
+
+		// upload must be spread across frames
+		CHECK_ERR( frame >= uint(total_size / cfg.budgetPerFrame) );
+
+		// check uploaded data
+		bool	image_is_correct	= false;
+		bool	buffer_is_correct	= false;
+
+		const auto	OnImageLoaded =	[&] (const ImageView &imageData)
+		{
+			const uint2		mip_dim		= dim / 2u;
+			const BytesU	row_pitch	= mip_dim.x * bpp;
+
+			image_is_correct = true;
+			for (uint y = 0; y < mip_dim.y; ++y)
+			{
+				ArrayView<uint8_t>	row		= imageData.GetRow( y );
+				const uint8_t*		expected = image_data.data() + size_t(mip1_offset + row_pitch * y);
+
+				image_is_correct &= (std::memcmp( row.data(), expected, size_t(row_pitch) ) == 0);
+			}
+		};
+
+		const auto	OnBufferLoaded = [&] (BufferView data)
+		{
+			buffer_is_correct = (data.size() == buffer_data.size());
+
+			size_t	offset = 0;
+			for (auto& part : data.Parts())
+			{
+				buffer_is_correct &= (std::memcmp( part.data(), buffer_data.data() + offset, part.size() ) == 0);
+				offset += part.size();
+			}
+		};
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK_ERR( cmd );
+
+			Task	t_read1 = cmd->AddTask( ReadImage{}.SetImage( image, int2(), dim / 2u, 1_mipmap ).SetCallback( OnImageLoaded ));
+			Task	t_read2 = cmd->AddTask( ReadBuffer{}.SetBuffer( buffer, 0_b, buf_size ).SetCallback( OnBufferLoaded ));
+			Unused( t_read1, t_read2 );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		CHECK_ERR( image_is_correct );
+		CHECK_ERR( buffer_is_correct );
+
+		FG_LOGI( "streamed: "s << ToString( total_size ) << " in " << ToString( frame ) << " frames" );
+
+		streaming.Release();
+		DeleteResources( image, buffer );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
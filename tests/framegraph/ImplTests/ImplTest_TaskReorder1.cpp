@@ -0,0 +1,91 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Independent copy and fill tasks use the same buffer in different states,
+	with reordering all copies are recorded together, so fewer transitions are required.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_TaskReorder1 ()
+	{
+		const BytesU	part_size	= 64_b;
+		const BytesU	buf_size	= part_size * 4;
+
+		BufferID	src_buffer	= _frameGraph->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "SrcBuffer" );
+		BufferID	dst_buffer0	= _frameGraph->CreateBuffer( BufferDesc{ part_size, EBufferUsage::Transfer }, Default, "DstBuffer0" );
+		BufferID	dst_buffer1	= _frameGraph->CreateBuffer( BufferDesc{ part_size, EBufferUsage::Transfer }, Default, "DstBuffer1" );
+		CHECK_ERR( src_buffer and dst_buffer0 and dst_buffer1 );
+
+		Array<uint8_t>	src_data;
+		src_data.resize( size_t(buf_size) );
+
+		for (size_t i = 0; i < src_data.size(); ++i) {
+			src_data[i] = uint8_t(i * 5);
+		}
+
+		uint	loaded_count	= 0;
+		bool	data_is_correct	= true;
+
+		const auto	Run = [&] (bool reorder, OUT IFrameGraph::Statistics &stat) -> bool
+		{
+			loaded_count = 0;
+			_frameGraph->GetStatistics( OUT stat );	// reset statistic
+
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default | EDebugFlags::ReorderStatistic ).SetReorderTasks( reorder ));
+			CHECK_ERR( cmd );
+
+			// copies read first half of the buffer, fills write second half
+			Task	t_update	= cmd->AddTask( UpdateBuffer{}.SetBuffer( src_buffer ).AddData( src_data ));
+			Task	t_copy0		= cmd->AddTask( CopyBuffer{}.From( src_buffer ).To( dst_buffer0 ).AddRegion( 0_b, 0_b, part_size ).DependsOn( t_update ));
+			Task	t_fill0		= cmd->AddTask( FillBuffer{}.SetBuffer( src_buffer, part_size * 2, part_size ).SetPattern( 0u ).DependsOn( t_update ));
+			Task	t_copy1		= cmd->AddTask( CopyBuffer{}.From( src_buffer ).To( dst_buffer1 ).AddRegion( part_size, 0_b, part_size ).DependsOn( t_update ));
+			Task	t_fill1		= cmd->AddTask( FillBuffer{}.SetBuffer( src_buffer, part_size * 3, part_size ).SetPattern( 0u ).DependsOn( t_update ));
+			Unused( t_fill0, t_fill1 );
+
+			const auto	Check = [&] (BufferView data, size_t offset)
+			{
+				bool	equal = (data.size() == part_size);
+
+				for (size_t j = 0; equal and j < size_t(part_size); ++j) {
+					equal = (data[j] == src_data[ offset + j ]);
+				}
+				ASSERT( equal );
+				data_is_correct &= equal;
+				++loaded_count;
+			};
+
+			Unused( cmd->AddTask( ReadBuffer{}.SetBuffer( dst_buffer0, 0_b, part_size ).SetCallback( [&] (BufferView data) { Check( data, 0 ); }).DependsOn( t_copy0 )));
+			Unused( cmd->AddTask( ReadBuffer{}.SetBuffer( dst_buffer1, 0_b, part_size ).SetCallback( [&] (BufferView data) { Check( data, size_t(part_size) ); }).DependsOn( t_copy1 )));
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+			return true;
+		};
+
+		IFrameGraph::Statistics		default_stat;
+		IFrameGraph::Statistics		reordered_stat;
+
+		CHECK_ERR( Run( false, OUT default_stat ));
+		CHECK_ERR( loaded_count == 2 );
+
+		CHECK_ERR( Run( true, OUT reordered_stat ));
+		CHECK_ERR( loaded_count == 2 );
+		CHECK_ERR( data_is_correct );
+
+		CHECK_ERR( default_stat.renderer.reorderedTasks == 0 );
+		CHECK_ERR( reordered_stat.renderer.reorderedTasks > 0 );
+		CHECK_ERR( reordered_stat.renderer.barriersSavedByReorder > 0 );
+		CHECK_ERR( default_stat.renderer.transferOps == reordered_stat.renderer.transferOps );
+		CHECK_ERR( reordered_stat.renderer.pipelineBarriers <= default_stat.renderer.pipelineBarriers );
+
+		DeleteResources( src_buffer, dst_buffer0, dst_buffer1 );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,101 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Two transient images are used one after another,
+	so they must share the same memory and content of the second image must not be corrupted.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_TransientResources1 ()
+	{
+		const uint2		src_dim		= {64, 64};
+		const uint2		dst_dim		= {128, 64};
+		const BytesU	bpp			= 4_b;
+		const auto		src_desc	= ImageDesc{}.SetDimension( src_dim ).SetFormat( EPixelFormat::RGBA8_UNorm ).SetUsage( EImageUsage::Transfer );
+
+		ImageID		dst_image	= _frameGraph->CreateImage( ImageDesc{}.SetDimension( dst_dim ).SetFormat( EPixelFormat::RGBA8_UNorm ).SetUsage( EImageUsage::Transfer ), Default, "DstImage" );
+		CHECK_ERR( dst_image );
+
+		bool	cb_was_called	= false;
+		bool	data_is_correct	= false;
+
+		const auto	OnLoaded =	[bpp, src_dim, dst_dim, OUT &cb_was_called, OUT &data_is_correct] (const ImageView &imageData)
+		{
+			cb_was_called	= true;
+			data_is_correct	= true;
+
+			for (uint y = 0; y < dst_dim.y; ++y)
+			{
+				ArrayView<uint8_t>	row = imageData.GetRow( y );
+
+				for (uint x = 0; x < dst_dim.x; ++x)
+				{
+					uint8_t const*	ptr			= &row[ size_t(x * bpp) ];
+					const bool		left		= x < src_dim.x;
+					const bool		is_equal	= (ptr[0] == (left ? 0xFF : 0)	and
+												   ptr[1] == (left ? 0 : 0xFF)	and
+												   ptr[2] == 0					and
+												   ptr[3] == 0xFF);
+					ASSERT( is_equal );
+					data_is_correct &= is_equal;
+				}
+			}
+		};
+
+		IFrameGraph::Statistics	stat;
+		_frameGraph->GetStatistics( OUT stat );	// reset statistic
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		RawImageID	image_a	= cmd->CreateTransientImage( src_desc, "TransientA" );
+		RawImageID	image_b	= cmd->CreateTransientImage( src_desc, "TransientB" );
+		CHECK_ERR( image_a and image_b );
+
+		Task	t_clear_a	= cmd->AddTask( ClearColorImage{}.SetImage( image_a ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{1.0f, 0.0f, 0.0f, 1.0f} ));
+		Task	t_copy_a	= cmd->AddTask( CopyImage{}.From( image_a ).To( dst_image ).AddRegion( {}, int2(), {}, int2(), src_dim ).DependsOn( t_clear_a ));
+		Task	t_clear_b	= cmd->AddTask( ClearColorImage{}.SetImage( image_b ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{0.0f, 1.0f, 0.0f, 1.0f} ).DependsOn( t_copy_a ));
+		Task	t_copy_b	= cmd->AddTask( CopyImage{}.From( image_b ).To( dst_image ).AddRegion( {}, int2(), {}, int2(src_dim.x, 0), src_dim ).DependsOn( t_clear_b ));
+		Task	t_read		= cmd->AddTask( ReadImage{}.SetImage( dst_image, int2(), dst_dim ).SetCallback( OnLoaded ).DependsOn( t_copy_b ));
+		Unused( t_read );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( cb_was_called );
+		CHECK_ERR( data_is_correct );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.transientResources == 2 );
+		CHECK_ERR( stat.resources.transientMemoryAllocated < stat.resources.transientMemoryRequired );
+
+		// heap of the completed batch must be reused
+		{
+			CommandBuffer	cmd2 = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+			CHECK_ERR( cmd2 );
+
+			RawImageID	image_c	= cmd2->CreateTransientImage( src_desc, "TransientC" );
+			CHECK_ERR( image_c );
+
+			Task	t_clear_c	= cmd2->AddTask( ClearColorImage{}.SetImage( image_c ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{0.0f, 0.0f, 1.0f, 1.0f} ));
+			Task	t_copy_c	= cmd2->AddTask( CopyImage{}.From( image_c ).To( dst_image ).AddRegion( {}, int2(), {}, int2(), src_dim ).DependsOn( t_clear_c ));
+			Unused( t_copy_c );
+
+			CHECK_ERR( _frameGraph->Execute( cmd2 ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+
+			CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+			CHECK_ERR( stat.resources.transientResources == 1 );
+			CHECK_ERR( stat.resources.transientHeapAllocations == 0 );
+		}
+
+		DeleteResources( dst_image );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
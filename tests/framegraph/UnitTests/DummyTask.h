@@ -12,6 +12,13 @@ namespace FG
 	//
 	class VFgDummyTask final : public VFrameGraphTask
 	{
+	public:
+		void DependsOn (VFgDummyTask *input)
+		{
+			_inputs.push_back( input );
+			_inDegree = uint(_inputs.size());
+			input->Attach( this );
+		}
 	};
 
 
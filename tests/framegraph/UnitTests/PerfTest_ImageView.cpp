@@ -0,0 +1,101 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compares per-pixel 'ImageView::Load' with row decoding ('LoadRow') and
+	region conversion to RGBA8 ('ConvertRegion') on full HD image.
+*/
+
+#include "framegraph/Public/ImageView.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "UnitTest_Common.h"
+#include <random>
+#include <chrono>
+
+namespace
+{
+	using Clock_t	= std::chrono::high_resolution_clock;
+
+/*
+=================================================
+	Measure
+=================================================
+*/
+	template <typename Fn>
+	static double  Measure (Fn &&fn)
+	{
+		double	min_time = 1.0e+10;
+
+		for (uint i = 0; i < 8; ++i)
+		{
+			const auto	t_start = Clock_t::now();
+			fn();
+			const auto	dt = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>( Clock_t::now() - t_start );
+
+			min_time = Min( min_time, dt.count() );
+		}
+		return min_time;
+	}
+
+/*
+=================================================
+	MeasureFormat
+=================================================
+*/
+	static void  MeasureFormat (EPixelFormat fmt, EImageAspect aspect, BytesU bytesPerPixel, StringView name)
+	{
+		const uint3		dim			{ 1920, 1080, 1 };
+		const BytesU	row_pitch	= bytesPerPixel * dim.x;
+		const BytesU	slice_pitch	= row_pitch * dim.y;
+
+		Array<uint8_t>	data;
+		data.resize( size_t(slice_pitch) );
+
+		std::mt19937	gen{ 1234 };
+		for (auto& b : data) {
+			b = uint8_t(gen());
+		}
+
+		ArrayView<uint8_t>	part{ data };
+		ImageView			view{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, dim, row_pitch, slice_pitch, fmt, aspect };
+
+		Array<RGBA32f>		dst_f;
+		Array<RGBA8u>		dst_u8;
+		float				checksum[2] = {};
+
+		dst_f.resize( size_t(dim.x) * dim.y );
+
+		const double	per_pixel	= Measure( [&] () {
+										for (uint y = 0; y < dim.y; ++y)
+										for (uint x = 0; x < dim.x; ++x) {
+											view.Load( uint3{x, y, 0}, OUT dst_f[x + y * dim.x] );
+										}
+										checksum[0] += dst_f.back().r;
+									});
+		const double	row			= Measure( [&] () {
+										for (uint y = 0; y < dim.y; ++y) {
+											TEST( view.LoadRow( y, 0, OUT dst_f.data() + size_t(y) * dim.x ));
+										}
+										checksum[1] += dst_f.back().r;
+									});
+		const double	region_u8	= Measure( [&] () {
+										TEST( view.ConvertRegion( uint3{}, dim, OUT dst_u8 ));
+									});
+
+		TEST( std::memcmp( &checksum[0], &checksum[1], sizeof(float) ) == 0 );
+
+		FG_LOGI( "format: "s << name
+				 << ", Load: " << ToString( uint64_t(per_pixel) ) << " us"
+				 << ", LoadRow: " << ToString( uint64_t(row) ) << " us"
+				 << ", ConvertRegion to RGBA8: " << ToString( uint64_t(region_u8) ) << " us" );
+	}
+}
+
+
+extern void PerfTest_ImageView ()
+{
+	MeasureFormat( EPixelFormat::RGBA8_UNorm,	EImageAspect::Color, 4_b, "RGBA8_UNorm" );
+	MeasureFormat( EPixelFormat::RGBA16F,		EImageAspect::Color, 8_b, "RGBA16F" );
+	MeasureFormat( EPixelFormat::RGB_11_11_10F,	EImageAspect::Color, 4_b, "RGB_11_11_10F" );
+	MeasureFormat( EPixelFormat::Depth32F,		EImageAspect::Depth, 4_b, "Depth32F" );
+
+	FG_LOGI( "PerfTest_ImageView - passed" );
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "framegraph/Public/ImageView.h"
+#include "UnitTest_Common.h"
+#include <random>
+
+
+namespace
+{
+	struct TestImage
+	{
+		Array<uint8_t>		data;
+		ArrayView<uint8_t>	part;
+		ImageView			view;
+
+		TestImage (EPixelFormat fmt, EImageAspect aspect, const uint3 &dim, BytesU bytesPerPixel)
+		{
+			// row pitch is not a multiple of the pixel size to check unaligned access
+			const BytesU	row_pitch	= bytesPerPixel * dim.x + 3_b;
+			const BytesU	slice_pitch	= row_pitch * dim.y;
+
+			std::mt19937	gen{ uint(fmt) };
+			data.resize( size_t(slice_pitch * dim.z) );
+
+			for (auto& b : data) {
+				b = uint8_t(gen());
+			}
+
+			part = ArrayView<uint8_t>{ data };
+			view = ImageView{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, dim, row_pitch, slice_pitch, fmt, aspect };
+		}
+	};
+
+
+	// same as conversion in 'ImageView::LoadRow'
+	uint8_t  ToUNorm8 (float value)
+	{
+		const float	v = value * 256.0f;
+		return uint8_t( v > 0.0f ? (v < 255.0f ? v : 255.0f) : 0.0f );
+	}
+
+
+	void  CheckFormat (EPixelFormat fmt, EImageAspect aspect, BytesU bytesPerPixel)
+	{
+		// width is not a multiple of the vector size to check scalar tail
+		const uint3		dim	{ 37, 5, 2 };
+		TestImage		img	{ fmt, aspect, dim, bytesPerPixel };
+
+		Array<RGBA32f>	row_f;
+		Array<RGBA8u>	row_u8;
+		row_f.resize( dim.x );
+		row_u8.resize( dim.x );
+
+		for (uint z = 0; z < dim.z; ++z)
+		for (uint y = 0; y < dim.y; ++y)
+		{
+			TEST( img.view.LoadRow( y, z, OUT row_f.data() ));
+			TEST( img.view.LoadRow( y, z, OUT row_u8.data() ));
+
+			for (uint x = 0; x < dim.x; ++x)
+			{
+				RGBA32f		ref;
+				img.view.Load( uint3{x, y, z}, OUT ref );
+
+				// must be bit-exact
+				TEST( std::memcmp( &ref, &row_f[x], sizeof(ref) ) == 0 );
+
+				TEST( row_u8[x].r == ToUNorm8( ref.r ));
+				TEST( row_u8[x].g == ToUNorm8( ref.g ));
+				TEST( row_u8[x].b == ToUNorm8( ref.b ));
+				TEST( row_u8[x].a == ToUNorm8( ref.a ));
+			}
+		}
+
+		// region
+		const uint3		offset	{ 3, 1, 1 };
+		const uint3		size	{ 29, 3, 1 };
+		Array<RGBA32f>	region_f;
+		Array<RGBA8u>	region_u8;
+
+		TEST( img.view.ConvertRegion( offset, size, OUT region_f ));
+		TEST( img.view.ConvertRegion( offset, size, OUT region_u8 ));
+		TEST( region_f.size() == size_t(size.x * size.y * size.z) );
+		TEST( region_u8.size() == region_f.size() );
+
+		for (uint y = 0; y < size.y; ++y)
+		for (uint x = 0; x < size.x; ++x)
+		{
+			const size_t	i = x + y * size.x;
+			RGBA32f			ref;
+			img.view.Load( offset + uint3{x, y, 0}, OUT ref );
+
+			TEST( std::memcmp( &ref, &region_f[i], sizeof(ref) ) == 0 );
+			TEST( region_u8[i].r == ToUNorm8( ref.r ));
+			TEST( region_u8[i].a == ToUNorm8( ref.a ));
+		}
+	}
+}
+
+
+static void ImageView_Test1 ()
+{
+	// vectorized formats
+	CheckFormat( EPixelFormat::RGBA8_UNorm, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::BGRA8_UNorm, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::sRGB8_A8, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::RGBA16F, EImageAspect::Color, 8_b );
+	CheckFormat( EPixelFormat::RGB_11_11_10F, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::R32F, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::R16_UNorm, EImageAspect::Color, 2_b );
+	CheckFormat( EPixelFormat::Depth16, EImageAspect::Depth, 2_b );
+	CheckFormat( EPixelFormat::Depth24, EImageAspect::Depth, 4_b );
+	CheckFormat( EPixelFormat::Depth32F, EImageAspect::Depth, 4_b );
+	CheckFormat( EPixelFormat::Depth24_Stencil8, EImageAspect::Depth, 4_b );
+	CheckFormat( EPixelFormat::Depth32F_Stencil8, EImageAspect::Depth, 4_b );
+}
+
+
+static void ImageView_Test2 ()
+{
+	// scalar fallback
+	CheckFormat( EPixelFormat::RGBA8_SNorm, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::RGB8_UNorm, EImageAspect::Color, 3_b );
+	CheckFormat( EPixelFormat::RG16F, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::RGB10_A2_UNorm, EImageAspect::Color, 4_b );
+	CheckFormat( EPixelFormat::RGBA32F, EImageAspect::Color, 16_b );
+}
+
+
+static void ImageView_Test3 ()
+{
+	// special values
+	const uint16_t	halfs[]		= { 0x0000, 0x8000, 0x3C00, 0xBC00, 0x7BFF, 0x7C00, 0xFC00, 0x7E00, 0x0001, 0x03FF, 0x3555, 0x4900 };
+	const float		floats[]	= { 0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 0.99f, 1.5f, 255.0f, 1.0e+30f, -1.0e+30f,
+									std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+									std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::denorm_min() };
+	{
+		ArrayView<uint8_t>	part{ reinterpret_cast<const uint8_t *>(halfs), sizeof(halfs) };
+		ImageView			view{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{3, 1, 1}, 24_b, 24_b, EPixelFormat::RGBA16F, EImageAspect::Color };
+		RGBA32f				row[3];
+		RGBA8u				row_u8[3];
+
+		TEST( view.LoadRow( 0, 0, OUT row ));
+		TEST( view.LoadRow( 0, 0, OUT row_u8 ));
+
+		for (uint x = 0; x < 3; ++x)
+		{
+			RGBA32f		ref;
+			view.Load( uint3{x, 0, 0}, OUT ref );
+			TEST( std::memcmp( &ref, &row[x], sizeof(ref) ) == 0 );
+
+			for (uint c = 0; c < 4; ++c) {
+				TEST( row_u8[x][c] == ToUNorm8( ref[c] ));
+			}
+		}
+	}{
+		ArrayView<uint8_t>	part{ reinterpret_cast<const uint8_t *>(floats), sizeof(floats) };
+		const uint			count = uint(CountOf(floats));
+		ImageView			view{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{count, 1, 1}, BytesU{sizeof(floats)}, BytesU{sizeof(floats)},
+								  EPixelFormat::R32F, EImageAspect::Color };
+		RGBA32f				row[count];
+		RGBA8u				row_u8[count];
+
+		TEST( view.LoadRow( 0, 0, OUT row ));
+		TEST( view.LoadRow( 0, 0, OUT row_u8 ));
+
+		for (uint x = 0; x < count; ++x)
+		{
+			TEST( std::memcmp( &floats[x], &row[x].r, sizeof(float) ) == 0 );
+			TEST( row[x].g == 0.0f and row[x].b == 0.0f and row[x].a == 0.0f );
+			TEST( row_u8[x].r == ToUNorm8( floats[x] ));
+			TEST( row_u8[x].g == 0 and row_u8[x].b == 0 and row_u8[x].a == 0 );
+		}
+		TEST( row_u8[10].r == 255 );	// +inf
+		TEST( row_u8[11].r == 0 );		// -inf
+		TEST( row_u8[12].r == 0 );		// NaN
+	}
+}
+
+
+extern void UnitTest_ImageView ()
+{
+	ImageView_Test1();
+	ImageView_Test2();
+	ImageView_Test3();
+	FG_LOGI( "UnitTest_ImageView - passed" );
+}
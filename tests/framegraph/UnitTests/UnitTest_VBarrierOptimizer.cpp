@@ -0,0 +1,233 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VBarrierOptimizer.h"
+#include "UnitTest_Common.h"
+#include <random>
+
+using BarrierTask	= VBarrierOptimizer::Task;
+using BarrierUsage	= VBarrierOptimizer::Usage;
+using BarrierPlan	= VBarrierOptimizer::Result;
+
+namespace
+{
+	enum EState : uint64_t
+	{
+		Read	= 1,
+		Write	= 2,
+		Uniform	= 3,
+	};
+
+	struct Graph
+	{
+		Array<BarrierTask>		tasks;
+		Array<BarrierUsage>		usages;
+
+		Graph&  Task (std::initializer_list<Pair<void const*, EState>> list)
+		{
+			BarrierTask	task;
+			task.firstUsage	= uint(usages.size());
+			task.usageCount	= uint(list.size());
+
+			for (auto& item : list) {
+				usages.push_back({ item.first, item.second, item.second == Write });
+			}
+			tasks.push_back( task );
+			return *this;
+		}
+
+		Graph&  Opaque ()
+		{
+			tasks.push_back({});
+			tasks.back().opaque = true;
+			return *this;
+		}
+
+		Graph&  Fence ()
+		{
+			tasks.back().fence = true;
+			return *this;
+		}
+	};
+}
+
+
+static void VBarrierOptimizer_Test1 ()
+{
+	// independent writes are merged into one barrier, then all reads are merged into another barrier
+	int		a, b, c, d;
+	Graph	graph;
+	graph.Task({ {&a, Write} }).Task({ {&b, Write} }).Task({ {&c, Write} }).Task({ {&d, Write} })
+		 .Task({ {&a, Read} }).Task({ {&b, Read} }).Task({ {&c, Read} }).Task({ {&d, Read} });
+
+	BarrierPlan	plan;
+	TEST( VBarrierOptimizer::Optimize( graph.tasks, graph.usages, true, OUT plan ));
+
+	String	str;
+	VBarrierOptimizer::DumpToString( graph.tasks, plan, OUT str );
+
+	TEST( str ==
+		"barriers: 8 -> 2, split: 0\n"
+		"  [0] barrier: 0, 1, 2, 3\n"
+		"  [4] barrier: 4, 5, 6, 7\n" );
+}
+
+
+static void VBarrierOptimizer_Test2 ()
+{
+	// producer and consumer are too far, split barrier is used
+	int		a, b, c, d, e;
+	Graph	graph;
+	graph.Task({ {&a, Write} }).Task({ {&b, Write} }).Task({ {&c, Write} }).Task({ {&d, Write} }).Task({ {&e, Write} })
+		 .Task({ {&a, Read} });
+
+	BarrierPlan	plan;
+	String		str;
+	TEST( VBarrierOptimizer::Optimize( graph.tasks, graph.usages, true, OUT plan ));
+	VBarrierOptimizer::DumpToString( graph.tasks, plan, OUT str );
+
+	TEST( str ==
+		"barriers: 6 -> 1, split: 1\n"
+		"  [0] barrier: 0, 1, 2, 3, 4 signal: 5\n"
+		"  [5] wait: 5\n" );
+
+	// split barriers are not supported
+	TEST( VBarrierOptimizer::Optimize( graph.tasks, graph.usages, false, OUT plan ));
+	VBarrierOptimizer::DumpToString( graph.tasks, plan, OUT str );
+
+	TEST( str ==
+		"barriers: 6 -> 2, split: 0\n"
+		"  [0] barrier: 0, 1, 2, 3, 4\n"
+		"  [5] barrier: 5\n" );
+}
+
+
+static void VBarrierOptimizer_Test3 ()
+{
+	// transitions can't be moved across opaque task and above memory aliasing barrier,
+	// resource that is used in different states in single task can't be moved
+	int		a, b, c;
+	Graph	graph;
+	graph.Task({ {&a, Write} })
+		 .Opaque()
+		 .Task({ {&b, Write} })
+		 .Task({ {&a, Read} })
+		 .Task({ {&b, Read} }).Fence()
+		 .Task({ {&c, Read}, {&c, Write} });
+
+	BarrierPlan	plan;
+	String		str;
+	TEST( VBarrierOptimizer::Optimize( graph.tasks, graph.usages, true, OUT plan ));
+	VBarrierOptimizer::DumpToString( graph.tasks, plan, OUT str );
+
+	TEST( str ==
+		"barriers: 5 -> 4, split: 0\n"
+		"  [0] barrier: 0\n"
+		"  [1] opaque\n"
+		"  [2] barrier: 1, 2\n"
+		"  [4] fence barrier: 3\n"
+		"  [5] barrier: 4, 5\n" );
+}
+
+
+static void VBarrierOptimizer_Test4 ()
+{
+	// read after read in the same state doesn't require transition
+	int		a;
+	Graph	graph;
+	graph.Task({ {&a, Write} }).Task({ {&a, Read} }).Task({ {&a, Read} }).Task({ {&a, Uniform} });
+
+	BarrierPlan	plan;
+	String		str;
+	TEST( VBarrierOptimizer::Optimize( graph.tasks, graph.usages, true, OUT plan ));
+	VBarrierOptimizer::DumpToString( graph.tasks, plan, OUT str );
+
+	TEST( plan.barrierPoint[2] == UMax );
+	TEST( str ==
+		"barriers: 3 -> 3, split: 0\n"
+		"  [0] barrier: 0\n"
+		"  [1] barrier: 1\n"
+		"  [3] barrier: 3\n" );
+}
+
+
+static void VBarrierOptimizer_Test5 ()
+{
+	// random graphs, transitions must be recorded between producer and consumer
+	std::mt19937	gen{ 1234 };
+	int				resources[16];
+
+	for (uint iter = 0; iter < 100; ++iter)
+	{
+		Graph	graph;
+
+		for (uint i = 0, cnt = gen() % 64 + 1; i < cnt; ++i)
+		{
+			if ( gen() % 10 == 0 ) {
+				graph.Opaque();
+				continue;
+			}
+
+			BarrierTask	task;
+			task.firstUsage	= uint(graph.usages.size());
+			task.usageCount	= gen() % 4 + 1;
+			task.fence		= (gen() % 10 == 0);
+
+			for (uint j = 0; j < task.usageCount; ++j)
+			{
+				const EState	state = EState(gen() % 3 + 1);
+				graph.usages.push_back({ &resources[ gen() % CountOf(resources) ], state, state == Write });
+			}
+			graph.tasks.push_back( task );
+		}
+
+		BarrierPlan	plan;
+		TEST( VBarrierOptimizer::Optimize( graph.tasks, graph.usages, true, OUT plan ));
+		TEST( plan.barriersAfter + plan.splitBarriers <= plan.barriersBefore );
+
+		for (uint t = 0; t < graph.tasks.size(); ++t)
+		{
+			auto&	task = graph.tasks[t];
+
+			for (uint u = task.firstUsage; u < task.firstUsage + task.usageCount; ++u)
+			{
+				const uint	point = plan.barrierPoint[u];
+				if ( point == UMax )
+					continue;
+
+				TEST( point <= t );
+
+				for (uint k = point; k < t; ++k)
+				{
+					auto&	other = graph.tasks[k];
+					TEST( not other.opaque );
+					TEST( not other.fence or k == point );
+
+					// resource must not be used between barrier and consumer
+					for (uint j = other.firstUsage; j < other.firstUsage + other.usageCount; ++j) {
+						TEST( graph.usages[j].resource != graph.usages[u].resource );
+					}
+				}
+
+				if ( plan.splitProducer[u] != UMax ) {
+					TEST( plan.splitProducer[u] + VBarrierOptimizer::SplitDistance <= t );
+				}
+			}
+		}
+	}
+}
+
+
+extern void UnitTest_VBarrierOptimizer ()
+{
+	VBarrierOptimizer_Test1();
+	VBarrierOptimizer_Test2();
+	VBarrierOptimizer_Test3();
+	VBarrierOptimizer_Test4();
+	VBarrierOptimizer_Test5();
+
+	FG_LOGI( "UnitTest_VBarrierOptimizer - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
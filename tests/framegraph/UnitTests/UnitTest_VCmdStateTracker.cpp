@@ -0,0 +1,236 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VCmdStateTracker.h"
+#include "UnitTest_Common.h"
+
+namespace
+{
+	struct MockCommands
+	{
+		uint	bindPipeline		= 0;
+		uint	bindDescriptorSets	= 0;
+		uint	bindVertexBuffers	= 0;
+		uint	bindIndexBuffer		= 0;
+		uint	setViewport			= 0;
+		uint	setScissor			= 0;
+		uint	setStencil			= 0;
+
+		ND_ uint  Total () const	{ return bindPipeline + bindDescriptorSets + bindVertexBuffers + bindIndexBuffer + setViewport + setScissor + setStencil; }
+	};
+
+	static MockCommands		s_Commands;
+
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdBindPipeline (VkCommandBuffer, VkPipelineBindPoint, VkPipeline)	{ ++s_Commands.bindPipeline; }
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdBindDescriptorSets (VkCommandBuffer, VkPipelineBindPoint, VkPipelineLayout, uint, uint, const VkDescriptorSet*, uint, const uint*)	{ ++s_Commands.bindDescriptorSets; }
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdBindVertexBuffers (VkCommandBuffer, uint, uint, const VkBuffer*, const VkDeviceSize*)	{ ++s_Commands.bindVertexBuffers; }
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdBindIndexBuffer (VkCommandBuffer, VkBuffer, VkDeviceSize, VkIndexType)	{ ++s_Commands.bindIndexBuffer; }
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdSetViewport (VkCommandBuffer, uint, uint, const VkViewport*)	{ ++s_Commands.setViewport; }
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdSetScissor (VkCommandBuffer, uint, uint, const VkRect2D*)	{ ++s_Commands.setScissor; }
+	static VKAPI_ATTR void VKAPI_CALL Mock_vkCmdSetStencilValue (VkCommandBuffer, VkStencilFaceFlags, uint)	{ ++s_Commands.setStencil; }
+
+	static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL Mock_vkGetDeviceProcAddr (VkDevice, const char* name)
+	{
+		const StringView	fn{ name };
+
+		if ( fn == "vkCmdBindPipeline" )			return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdBindPipeline );
+		if ( fn == "vkCmdBindDescriptorSets" )		return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdBindDescriptorSets );
+		if ( fn == "vkCmdBindVertexBuffers" )		return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdBindVertexBuffers );
+		if ( fn == "vkCmdBindIndexBuffer" )			return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdBindIndexBuffer );
+		if ( fn == "vkCmdSetViewport" )				return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdSetViewport );
+		if ( fn == "vkCmdSetScissor" )				return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdSetScissor );
+		if ( fn == "vkCmdSetStencilCompareMask" or
+			 fn == "vkCmdSetStencilWriteMask"	or
+			 fn == "vkCmdSetStencilReference" )		return BitCast<PFN_vkVoidFunction>( &Mock_vkCmdSetStencilValue );
+		return null;
+	}
+
+	template <typename T>
+	ND_ static T  MakeHandle (uint64_t id)
+	{
+		return BitCast<T>( id );
+	}
+}
+
+
+static void VCmdStateTracker_Test1 (VCmdStateTracker &tracker, IFrameGraph::RenderingStatistics &stat)
+{
+	// pipelines are tracked per bind point
+	const VkPipeline	p1	= MakeHandle<VkPipeline>( 1 );
+	const VkPipeline	p2	= MakeHandle<VkPipeline>( 2 );
+
+	s_Commands	= {};
+	stat		= {};
+
+	TEST( tracker.BindPipeline( VK_PIPELINE_BIND_POINT_GRAPHICS, p1 ));
+	TEST( not tracker.BindPipeline( VK_PIPELINE_BIND_POINT_GRAPHICS, p1 ));
+	TEST( tracker.BindPipeline( VK_PIPELINE_BIND_POINT_COMPUTE, p1 ));
+	TEST( tracker.BindPipeline( VK_PIPELINE_BIND_POINT_GRAPHICS, p2 ));
+	TEST( not tracker.BindPipeline( VK_PIPELINE_BIND_POINT_COMPUTE, p1 ));
+
+	TEST( s_Commands.bindPipeline == 3 );
+	TEST( stat.graphicsPipelineBindings == 2 );
+	TEST( stat.computePipelineBindings == 1 );
+	TEST( stat.skippedBindings == 2 );
+}
+
+
+static void VCmdStateTracker_Test2 (VCmdStateTracker &tracker, IFrameGraph::RenderingStatistics &stat)
+{
+	// descriptor sets are skipped only if bound by the same command
+	const VkPipelineLayout	l1	= MakeHandle<VkPipelineLayout>( 1 );
+	const VkPipelineLayout	l2	= MakeHandle<VkPipelineLayout>( 2 );
+	const VkDescriptorSet	a	= MakeHandle<VkDescriptorSet>( 10 );
+	const VkDescriptorSet	b	= MakeHandle<VkDescriptorSet>( 11 );
+	const VkDescriptorSet	dbg	= MakeHandle<VkDescriptorSet>( 12 );
+	const auto				gfx	= VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+	s_Commands	= {};
+	stat		= {};
+
+	TEST( tracker.BindDescriptorSets( gfx, l1, 0, {a, b}, {0, 16} ));
+	TEST( not tracker.BindDescriptorSets( gfx, l1, 0, {a, b}, {0, 16} ));
+	TEST( tracker.BindDescriptorSets( gfx, l1, 0, {a, b}, {0, 32} ));		// dynamic offset changed
+	TEST( tracker.BindDescriptorSets( gfx, l1, 1, {b}, {32} ));			// same set, but offsets are distributed in a different way
+	TEST( not tracker.BindDescriptorSets( gfx, l1, 1, {b}, {32} ));
+	TEST( tracker.BindDescriptorSets( gfx, l1, 0, {a, b}, {0, 32} ));
+	TEST( tracker.BindDescriptorSets( gfx, l1, 1, {dbg}, {0} ));			// debug set replaces one of the sets
+	TEST( tracker.BindDescriptorSets( gfx, l1, 0, {a, b}, {0, 32} ));
+	TEST( not tracker.BindDescriptorSets( gfx, l1, 0, {a, b}, {0, 32} ));
+	TEST( tracker.BindDescriptorSets( VK_PIPELINE_BIND_POINT_COMPUTE, l1, 0, {a, b}, {0, 32} ));
+	TEST( tracker.BindDescriptorSets( gfx, l2, 0, {a, b}, {0, 32} ));		// layout changed
+	TEST( not tracker.BindDescriptorSets( gfx, l2, 0, {}, {} ));			// nothing to bind
+
+	TEST( s_Commands.bindDescriptorSets == 8 );
+	TEST( stat.descriptorBinds == 8 );
+	TEST( stat.skippedBindings == 3 );
+}
+
+
+static void VCmdStateTracker_Test3 (VCmdStateTracker &tracker, IFrameGraph::RenderingStatistics &stat)
+{
+	// vertex and index buffers
+	const VkBuffer	b1	= MakeHandle<VkBuffer>( 1 );
+	const VkBuffer	b2	= MakeHandle<VkBuffer>( 2 );
+
+	s_Commands	= {};
+	stat		= {};
+
+	TEST( tracker.BindVertexBuffers( 0, {b1, b2}, {0, 0} ));
+	TEST( not tracker.BindVertexBuffers( 0, {b1, b2}, {0, 0} ));
+	TEST( not tracker.BindVertexBuffers( 1, {b2}, {0} ));
+	TEST( tracker.BindVertexBuffers( 1, {b2}, {64} ));
+	TEST( tracker.BindVertexBuffers( 2, {b1}, {0} ));
+
+	TEST( tracker.BindIndexBuffer( b1, 0, VK_INDEX_TYPE_UINT16 ));
+	TEST( not tracker.BindIndexBuffer( b1, 0, VK_INDEX_TYPE_UINT16 ));
+	TEST( tracker.BindIndexBuffer( b1, 0, VK_INDEX_TYPE_UINT32 ));
+	TEST( tracker.BindIndexBuffer( b1, 128, VK_INDEX_TYPE_UINT32 ));
+
+	TEST( s_Commands.bindVertexBuffers == 3 );
+	TEST( s_Commands.bindIndexBuffer == 3 );
+	TEST( stat.vertexBufferBindings == 3 );
+	TEST( stat.indexBufferBindings == 3 );
+	TEST( stat.skippedBindings == 3 );
+}
+
+
+static void VCmdStateTracker_Test4 (VCmdStateTracker &tracker, IFrameGraph::RenderingStatistics &stat)
+{
+	// viewports, scissors and stencil values
+	const VkViewport	vp1	= { 0.0f, 0.0f, 800.0f, 600.0f, 0.0f, 1.0f };
+	const VkViewport	vp2	= { 0.0f, 0.0f, 400.0f, 300.0f, 0.0f, 1.0f };
+	const VkRect2D		sc1	= { {0, 0}, {800, 600} };
+	const VkRect2D		sc2	= { {10, 10}, {100, 100} };
+
+	s_Commands	= {};
+	stat		= {};
+
+	TEST( tracker.SetViewports( 0, {vp1} ));
+	TEST( not tracker.SetViewports( 0, {vp1} ));
+	TEST( tracker.SetViewports( 0, {vp2} ));
+
+	TEST( tracker.SetScissors( 0, {sc1} ));
+	TEST( not tracker.SetScissors( 0, {sc1} ));
+	TEST( tracker.SetScissors( 0, {sc2} ));
+	TEST( tracker.SetScissors( 0, {sc1} ));
+
+	TEST( tracker.SetStencilReference( VK_STENCIL_FRONT_AND_BACK, 1 ));
+	TEST( not tracker.SetStencilReference( VK_STENCIL_FRONT_AND_BACK, 1 ));
+	TEST( not tracker.SetStencilReference( VK_STENCIL_FACE_FRONT_BIT, 1 ));
+	TEST( tracker.SetStencilReference( VK_STENCIL_FACE_BACK_BIT, 2 ));
+	TEST( tracker.SetStencilReference( VK_STENCIL_FRONT_AND_BACK, 2 ));		// front face is changed
+	TEST( tracker.SetStencilWriteMask( VK_STENCIL_FRONT_AND_BACK, 2 ));		// other state
+	TEST( tracker.SetStencilCompareMask( VK_STENCIL_FRONT_AND_BACK, 0xFF ));
+	TEST( not tracker.SetStencilCompareMask( VK_STENCIL_FRONT_AND_BACK, 0xFF ));
+
+	// stencil states must be invalidated by graphics pipeline
+	TEST( tracker.BindPipeline( VK_PIPELINE_BIND_POINT_GRAPHICS, MakeHandle<VkPipeline>( 100 )));
+	TEST( tracker.SetStencilCompareMask( VK_STENCIL_FRONT_AND_BACK, 0xFF ));
+	TEST( not tracker.SetScissors( 0, {sc1} ));
+
+	TEST( s_Commands.setViewport == 2 );
+	TEST( s_Commands.setScissor == 3 );
+	TEST( s_Commands.setStencil == 6 );
+	TEST( stat.dynamicStateChanges == 11 );
+	TEST( stat.skippedBindings == 6 );
+}
+
+
+static void VCmdStateTracker_Test5 (VCmdStateTracker &tracker, IFrameGraph::RenderingStatistics &stat)
+{
+	// all states must be recorded after invalidation
+	const VkPipeline		ppln	= MakeHandle<VkPipeline>( 1 );
+	const VkPipelineLayout	layout	= MakeHandle<VkPipelineLayout>( 1 );
+	const VkDescriptorSet	ds		= MakeHandle<VkDescriptorSet>( 1 );
+	const VkBuffer			buf		= MakeHandle<VkBuffer>( 1 );
+	const VkViewport		vp		= { 0.0f, 0.0f, 800.0f, 600.0f, 0.0f, 1.0f };
+	const VkRect2D			sc		= { {0, 0}, {800, 600} };
+
+	const auto	Record = [&] ()
+	{
+		tracker.BindPipeline( VK_PIPELINE_BIND_POINT_GRAPHICS, ppln );
+		tracker.BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, {ds}, {} );
+		tracker.BindVertexBuffers( 0, {buf}, {0} );
+		tracker.BindIndexBuffer( buf, 0, VK_INDEX_TYPE_UINT16 );
+		tracker.SetViewports( 0, {vp} );
+		tracker.SetScissors( 0, {sc} );
+		tracker.SetStencilReference( VK_STENCIL_FRONT_AND_BACK, 0 );
+	};
+
+	tracker.Invalidate();
+	Record();
+
+	s_Commands	= {};
+	stat		= {};
+
+	Record();
+	TEST( s_Commands.Total() == 0 );
+	TEST( stat.skippedBindings == 7 );
+
+	tracker.Invalidate();
+	Record();
+	TEST( s_Commands.Total() == 7 );
+	TEST( stat.skippedBindings == 7 );
+}
+
+
+extern void UnitTest_VCmdStateTracker ()
+{
+	VulkanDeviceFnTable		table;
+	TEST( VulkanLoader::LoadDevice( MakeHandle<VkDevice>( 1 ), &Mock_vkGetDeviceProcAddr, OUT table ));
+
+	IFrameGraph::RenderingStatistics	stat;
+	VCmdStateTracker					tracker{ VulkanDeviceFn{ &table }, MakeHandle<VkCommandBuffer>( 1 ), stat };
+
+	VCmdStateTracker_Test1( tracker, stat );
+	VCmdStateTracker_Test2( tracker, stat );
+	VCmdStateTracker_Test3( tracker, stat );
+	VCmdStateTracker_Test4( tracker, stat );
+	VCmdStateTracker_Test5( tracker, stat );
+
+	FG_LOGI( "UnitTest_VCmdStateTracker - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
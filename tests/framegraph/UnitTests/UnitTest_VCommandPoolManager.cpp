@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VFrameGraph.h"
+#include "UnitTest_Common.h"
+
+
+static void CommandPoolManager_Test1 (const FrameGraph &fg)
+{
+	auto				vfg		= Cast<VFrameGraph>( fg );
+	auto&				mngr	= vfg->GetCommandPoolManager();
+	VDevice const&		dev		= vfg->GetDevice();
+	VDeviceQueueInfoPtr	queue	= &dev.GetVkQueues()[0];
+
+	using Pool_t = VCommandPoolManager::Pool;
+
+	StaticArray< Pool_t*, 2 >			pools	= {};
+	StaticArray< VkCommandBuffer, 2 >	cmds	= {};
+
+	// frame graph must not use pools concurrently
+	TEST( fg->WaitIdle() );
+
+	for (uint frame = 0; frame < 4; ++frame)
+	{
+		StaticArray< Pool_t*, 2 >	frame_pools = {};
+
+		for (size_t i = 0; i < frame_pools.size(); ++i)
+		{
+			frame_pools[i] = mngr.Acquire( queue );
+			TEST( frame_pools[i] and frame_pools[i]->IsCreated() );
+		}
+		TEST( frame_pools[0] != frame_pools[1] );
+
+		// released pools are reused in reverse order
+		if ( frame > 0 )
+		{
+			TEST( frame_pools[0] == pools[1] );
+			TEST( frame_pools[1] == pools[0] );
+			std::swap( cmds[0], cmds[1] );
+		}
+
+		for (size_t i = 0; i < frame_pools.size(); ++i)
+		{
+			VkCommandBuffer	cmd = frame_pools[i]->AllocPrimary( dev );
+			TEST( cmd != VK_NULL_HANDLE );
+
+			// recycled primary command buffer is reused after pool reset
+			if ( frame > 0 )
+				TEST( cmd == cmds[i] );
+
+			cmds[i] = cmd;
+		}
+
+		// same as 'VCmdBatch' when batch is complete
+		for (size_t i = 0; i < frame_pools.size(); ++i)
+		{
+			frame_pools[i]->RecyclePrimary( cmds[i] );
+			mngr.Release( frame_pools[i] );
+		}
+		pools = frame_pools;
+	}
+}
+
+
+extern void UnitTest_VCommandPoolManager (const FrameGraph &fg)
+{
+	CommandPoolManager_Test1( fg );
+
+	FG_LOGI( "UnitTest_VCommandPoolManager - passed" );
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VStagingBufferManager.h"
+#include "UnitTest_Common.h"
+
+
+static void VStagingRingAllocator_Test1 ()
+{
+	// allocate, shrink, release in order
+	VStagingRingAllocator	ring{ 1_Kb, 64_b };
+	BytesU					off, size;
+	uint					id0, id1;
+
+	TEST( ring.Allocate( 256_b, 256_b, OUT off, OUT size, OUT id0 ));
+	TEST( off == 0_b and size == 256_b );
+
+	TEST( ring.Allocate( 300_b, 1_b, OUT off, OUT size, OUT id1 ));
+	TEST( off == 256_b and size == 320_b );
+	TEST( ring.Used() == 576_b );
+
+	// only the last allocation can be shrinked
+	TEST( ring.Shrink( id0, 64_b ) == 256_b );
+	TEST( ring.Shrink( id1, 100_b ) == 128_b );
+	TEST( ring.Used() == 384_b );
+
+	ring.Release( id0 );
+	ring.Release( id1 );
+	TEST( ring.Empty() );
+	TEST( ring.Used() == 0_b );
+
+	// ring is reset when all allocations are released
+	TEST( ring.Allocate( 1_Kb, 1_Kb, OUT off, OUT size, OUT id0 ));
+	TEST( off == 0_b and size == 1_Kb );
+	ring.Release( id0 );
+}
+
+
+static void VStagingRingAllocator_Test2 ()
+{
+	// wrap around and out of order release
+	VStagingRingAllocator	ring{ 1_Kb, 64_b };
+	BytesU					off, size;
+	uint					id0, id1, id2, id3;
+
+	TEST( ring.Allocate( 384_b, 384_b, OUT off, OUT size, OUT id0 ));
+	TEST( ring.Allocate( 384_b, 384_b, OUT off, OUT size, OUT id1 ));
+	TEST( off == 384_b );
+
+	// 256 bytes at the end, not enough for min size
+	TEST( not ring.Allocate( 384_b, 384_b, OUT off, OUT size, OUT id2 ));
+
+	// memory is not reused until the oldest allocation is released
+	ring.Release( id1 );
+	TEST( not ring.Allocate( 384_b, 384_b, OUT off, OUT size, OUT id2 ));
+
+	// partial allocation at the end of the ring
+	TEST( ring.Allocate( 384_b, 128_b, OUT off, OUT size, OUT id2 ));
+	TEST( off == 768_b and size == 256_b );
+
+	ring.Release( id0 );
+
+	// wrap around
+	TEST( ring.Allocate( 512_b, 512_b, OUT off, OUT size, OUT id3 ));
+	TEST( off == 0_b and size == 512_b );
+
+	ring.Release( id2 );
+	ring.Release( id3 );
+	TEST( ring.Empty() );
+}
+
+
+static void VStagingRingAllocator_Test3 ()
+{
+	// full ring
+	VStagingRingAllocator	ring{ 1_Kb, 256_b };
+	BytesU					off, size;
+	uint					ids[4];
+
+	for (uint i = 0; i < CountOf(ids); ++i)
+	{
+		TEST( ring.Allocate( 256_b, 256_b, OUT off, OUT size, OUT ids[i] ));
+		TEST( off == 256_b * i );
+	}
+
+	uint	id;
+	TEST( not ring.Allocate( 1_b, 1_b, OUT off, OUT size, OUT id ));
+	TEST( ring.Used() == ring.Capacity() );
+
+	ring.Release( ids[0] );
+	ring.Release( ids[1] );
+
+	TEST( ring.Allocate( 512_b, 512_b, OUT off, OUT size, OUT id ));
+	TEST( off == 0_b );
+
+	ring.Release( ids[2] );
+	ring.Release( ids[3] );
+	ring.Release( id );
+	TEST( ring.Empty() );
+}
+
+
+extern void UnitTest_VStagingRingAllocator ()
+{
+	VStagingRingAllocator_Test1();
+	VStagingRingAllocator_Test2();
+	VStagingRingAllocator_Test3();
+
+	FG_LOGI( "UnitTest_VStagingRingAllocator - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -0,0 +1,200 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VSubpassMerger.h"
+#include "UnitTest_Common.h"
+
+namespace
+{
+	using Merger_t		= VSubpassMerger;
+	using Pass			= VSubpassMerger::Pass;
+	using Attachment	= VSubpassMerger::Attachment;
+	using ImageAccess	= VSubpassMerger::ImageAccess;
+	using Subpass		= VSubpassMerger::Subpass;
+	using SubpassUsage	= VSubpassMerger::SubpassUsage;
+
+	// fake image pointers
+	ND_ static void const*  Img (uint id)	{ return BitCast<void const*>( size_t(id) * 16 ); }
+
+	ND_ static Attachment  Att (uint img, uint slot, bool load = true)
+	{
+		return Attachment{ Img(img), HashVal{img}, slot, load };
+	}
+
+	ND_ static Pass  MakePass (std::initializer_list<Attachment> attachments, ArrayView<ImageAccess> images = Default)
+	{
+		Pass	pass;
+		pass.area	= RectI{ 0, 0, 800, 600 };
+		pass.images	= images;
+
+		for (auto& att : attachments) {
+			pass.attachments.push_back( att );
+		}
+		return pass;
+	}
+}
+
+
+static void VSubpassMerger_Test1 ()
+{
+	// G-buffer and lighting
+	const uint			albedo = 1, normal = 2, depth = 3, color = 4;
+	const ImageAccess	gbuffer_read[] = { {Img(albedo), true}, {Img(normal), true}, {Img(depth), true} };
+
+	Array<Pass>		passes;
+	passes.push_back( MakePass({ Att( albedo, 0, false ), Att( normal, 1, false ), Att( depth, Merger_t::DepthSlot, false ) }));
+	passes.push_back( MakePass({ Att( color, 2, false ) }, gbuffer_read ));
+
+	Array<Subpass>	subpasses;
+	Merger_t::Merge( passes, OUT subpasses );
+
+	TEST( subpasses.size() == 2 );
+	TEST( subpasses[0].index == 0 );
+	TEST( subpasses[0].inputMask == 0 );
+	TEST( subpasses[1].index == 1 );
+	TEST( subpasses[1].inputMask == (1u | 2u | (1u << Merger_t::DepthSlot)) );
+
+	const SubpassUsage	usages[] = { {1u | 2u | (1u << Merger_t::DepthSlot), 0},
+									 {4u, subpasses[1].inputMask} };
+
+	Merger_t::Dependencies_t	deps;
+	Merger_t::GetDependencies( usages, OUT deps );
+
+	TEST( deps.size() == 1 );
+	TEST( deps[0].srcSubpass == 0 );
+	TEST( deps[0].dstSubpass == 1 );
+	TEST( deps[0].dependencyFlags == VK_DEPENDENCY_BY_REGION_BIT );
+	TEST( deps[0].srcStageMask == (VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) );
+	TEST( deps[0].srcAccessMask == (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT) );
+	TEST( deps[0].dstStageMask == VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT );
+	TEST( deps[0].dstAccessMask == VK_ACCESS_INPUT_ATTACHMENT_READ_BIT );
+}
+
+
+static void VSubpassMerger_Test2 ()
+{
+	// passes that can not be merged
+	const ImageAccess	sampled[]	= { {Img(1), false} };
+	const ImageAccess	input[]		= { {Img(1), true} };
+
+	Array<Subpass>	subpasses;
+	Array<Pass>		passes;
+
+	// different render area
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 2, 0, false ) }, input ));
+	passes.back().area = RectI{ 0, 0, 400, 300 };
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[1].index == 0 );
+
+	// render target is sampled as texture
+	passes.clear();
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 2, 1, false ) }, sampled ));
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[1].index == 0 );
+
+	// existing attachment is cleared
+	passes.clear();
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[1].index == 0 );
+
+	// same image is bound to another slot
+	passes.clear();
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 1, 1 ) }));
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[1].index == 0 );
+
+	// input attachment is also a render target
+	passes.clear();
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 1, 0 ) }, input ));
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[1].index == 0 );
+
+	// texture is used as render target in next pass
+	passes.clear();
+	passes.push_back( MakePass({ Att( 2, 0, false ) }, sampled ));
+	passes.push_back( MakePass({ Att( 1, 1, false ) }));
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[1].index == 0 );
+
+	// memory aliasing barrier and unmergeable passes
+	passes.clear();
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 1, 0 ) }));
+	passes.push_back( MakePass({ Att( 1, 0 ) }));
+	passes.push_back( MakePass({ Att( 1, 0 ) }));
+	passes[1].fence		= true;
+	passes[2].mergeable	= false;
+	Merger_t::Merge( passes, OUT subpasses );
+	TEST( subpasses[0].index == 0 );
+	TEST( subpasses[1].index == 0 );
+	TEST( subpasses[2].index == 0 );
+	TEST( subpasses[3].index == 0 );
+}
+
+
+static void VSubpassMerger_Test3 ()
+{
+	// clear of a new attachment doesn't break merging, number of subpasses is limited
+	Array<Subpass>	subpasses;
+	Array<Pass>		passes;
+
+	passes.push_back( MakePass({ Att( 1, 0, false ) }));
+	passes.push_back( MakePass({ Att( 1, 0 ), Att( 2, 1, false ) }));
+
+	for (uint i = 0; i < Merger_t::MaxSubpasses; ++i) {
+		passes.push_back( MakePass({ Att( 1, 0 ) }));
+	}
+	Merger_t::Merge( passes, OUT subpasses );
+
+	TEST( subpasses.size() == passes.size() );
+	for (uint i = 0; i < Merger_t::MaxSubpasses; ++i) {
+		TEST( subpasses[i].index == i );
+	}
+	TEST( subpasses[Merger_t::MaxSubpasses].index == 0 );
+	TEST( subpasses[Merger_t::MaxSubpasses+1].index == 1 );
+}
+
+
+static void VSubpassMerger_Test4 ()
+{
+	// attachment is preserved in subpass that doesn't use it,
+	// dependency is added from the last subpass that used attachment
+	const SubpassUsage	usages[] = { {1u | 2u, 0},
+									 {4u, 1u},
+									 {4u, 2u} };
+
+	TEST( Merger_t::GetPreserveMask( usages, 0 ) == 0 );
+	TEST( Merger_t::GetPreserveMask( usages, 1 ) == 2u );
+	TEST( Merger_t::GetPreserveMask( usages, 2 ) == 0 );
+
+	Merger_t::Dependencies_t	deps;
+	Merger_t::GetDependencies( usages, OUT deps );
+
+	TEST( deps.size() == 3 );
+	TEST( deps[0].srcSubpass == 0 and deps[0].dstSubpass == 1 );
+	TEST( deps[1].srcSubpass == 1 and deps[1].dstSubpass == 2 );
+	TEST( deps[1].srcStageMask == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT );
+	TEST( deps[1].dstAccessMask == (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT) );
+	TEST( deps[2].srcSubpass == 0 and deps[2].dstSubpass == 2 );
+	TEST( deps[2].dstAccessMask == VK_ACCESS_INPUT_ATTACHMENT_READ_BIT );
+}
+
+
+extern void UnitTest_VSubpassMerger ()
+{
+	VSubpassMerger_Test1();
+	VSubpassMerger_Test2();
+	VSubpassMerger_Test3();
+	VSubpassMerger_Test4();
+
+	FG_LOGI( "UnitTest_VSubpassMerger - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -0,0 +1,206 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VTaskGraph.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "UnitTest_Common.h"
+#include "DummyTask.h"
+#include <random>
+#include <chrono>
+
+
+static void VTaskScheduler_Test1 ()
+{
+	LinearAllocator<>	allocator;
+	auto				tasks	= GenDummyTasks( 6 );
+
+	// 0 -> 1 -> 3 -> 5
+	//   -> 2 -> 4 ->
+	tasks[1]->DependsOn( tasks[0].get() );
+	tasks[2]->DependsOn( tasks[0].get() );
+	tasks[3]->DependsOn( tasks[1].get() );
+	tasks[4]->DependsOn( tasks[2].get() );
+	tasks[5]->DependsOn( tasks[3].get() );
+	tasks[5]->DependsOn( tasks[4].get() );
+
+	const VTask		entries[] = { tasks[0].get() };
+	Array<VTask>	order;
+
+	TEST( VTaskScheduler::Run( entries, tasks.size(), allocator, [&order] (VTask node) { order.push_back( node ); }));
+	
+	TEST( order.size() == tasks.size() );
+	TEST( order[0] == tasks[0].get() );
+	TEST( order[1] == tasks[1].get() );
+	TEST( order[2] == tasks[2].get() );
+	TEST( order[3] == tasks[3].get() );
+	TEST( order[4] == tasks[4].get() );
+	TEST( order[5] == tasks[5].get() );
+}
+
+
+static void VTaskScheduler_Test2 ()
+{
+	// deep dependency chain
+	LinearAllocator<>	allocator;
+	auto				tasks	= GenDummyTasks( 1000 );
+
+	for (size_t i = 1; i < tasks.size(); ++i) {
+		tasks[i]->DependsOn( tasks[i-1].get() );
+	}
+
+	const VTask		entries[]	= { tasks[0].get() };
+	size_t			counter		= 0;
+
+	TEST( VTaskScheduler::Run( entries, tasks.size(), allocator,
+							   [&] (VTask node) { TEST( node == tasks[counter++].get() ); }));
+	TEST( counter == tasks.size() );
+
+	// in-degree must be restored
+	counter = 0;
+	TEST( VTaskScheduler::Run( entries, tasks.size(), allocator,
+							   [&] (VTask node) { TEST( node == tasks[counter++].get() ); }));
+	TEST( counter == tasks.size() );
+}
+
+
+static void VTaskScheduler_Test3 ()
+{
+	// performance test, time must grow linearly with graph size
+	using TimePoint_t = std::chrono::high_resolution_clock::time_point;
+
+	std::mt19937	gen{ 1234 };
+
+	for (size_t count : {1'000, 10'000, 100'000})
+	{
+		LinearAllocator<>	allocator;
+		auto				tasks	= GenDummyTasks( count );
+		Array<VTask>		entries;
+		size_t				edges	= 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t	num_deps = Min( i, size_t(gen() % 4) );
+
+			for (size_t j = 0; j < num_deps; ++j)
+			{
+				auto&	input = tasks[ i - 1 - gen() % Min( i, size_t(64) )];
+				
+				if ( input->Outputs().size() == FG_MaxTaskDependencies )
+					continue;
+
+				tasks[i]->DependsOn( input.get() );
+				++edges;
+			}
+
+			if ( tasks[i]->Inputs().empty() )
+				entries.push_back( tasks[i].get() );
+		}
+
+		size_t						counter		= 0;
+		VTaskScheduler::Statistic	stat;
+		const auto					start_time	= TimePoint_t::clock::now();
+
+		TEST( VTaskScheduler::Run( entries, count, allocator, [&counter] (VTask) { ++counter; }, OUT &stat ));
+		
+		const auto	dt = TimePoint_t::clock::now() - start_time;
+		TEST( counter == count );
+
+		// each task is pushed once and each edge is released once, so scheduler work is O(N+E)
+		TEST( stat.queuePushes == count );
+		TEST( stat.queuePushes + stat.inputReleases <= count + edges );
+
+		// each node must be visited once and after all its inputs
+		const auto		IndexOf		= [] (VTask node) { return size_t(node->ExecutionOrder()) - size_t(ExeOrderIndex::First); };
+		Array<bool>		visited;	visited.resize( count, false );
+
+		TEST( VTaskScheduler::Run( entries, count, allocator,
+				[&] (VTask node)
+				{
+					const size_t	idx = IndexOf( node );
+					TEST( not visited[idx] );
+
+					for (auto in_node : node->Inputs()) {
+						TEST( visited[ IndexOf( in_node )]);
+					}
+					visited[idx] = true;
+				}));
+
+		FG_LOGI( "VTaskScheduler: "s << ToString(count) << " nodes, " << ToString(edges) << " edges, time: " << ToString( dt )
+				 << ", per node: " << ToString( std::chrono::duration_cast<std::chrono::nanoseconds>( dt ).count() / count ) << " ns" );
+	}
+}
+
+
+static void VTaskScheduler_Test4 ()
+{
+	// with constant cost the order must be the same as without cost
+	LinearAllocator<>	allocator;
+	auto				tasks	= GenDummyTasks( 6 );
+
+	tasks[1]->DependsOn( tasks[0].get() );
+	tasks[2]->DependsOn( tasks[0].get() );
+	tasks[3]->DependsOn( tasks[1].get() );
+	tasks[4]->DependsOn( tasks[2].get() );
+	tasks[5]->DependsOn( tasks[3].get() );
+	tasks[5]->DependsOn( tasks[4].get() );
+
+	const VTask		entries[] = { tasks[0].get() };
+	Array<VTask>	order1;
+	Array<VTask>	order2;
+
+	TEST( VTaskScheduler::Run( entries, tasks.size(), allocator, [&order1] (VTask node) { order1.push_back( node ); }));
+	TEST( VTaskScheduler::RunWithCost( entries, tasks.size(), allocator, [] (VTask) { return 1u; },
+									   [&order2] (VTask node) { order2.push_back( node ); }));
+	TEST( order1 == order2 );
+}
+
+
+static void VTaskScheduler_Test5 ()
+{
+	// tasks with the same key are grouped, dependencies must be preserved
+	LinearAllocator<>	allocator;
+	auto				tasks	= GenDummyTasks( 7 );
+	const uint			keys[]	= { 0, 1, 2, 1, 2, 1, 2 };
+
+	// 0 -> 1, 2, 3, 4, 5
+	//   -> 6 (depends on 5)
+	for (size_t i = 1; i < tasks.size(); ++i) {
+		tasks[i]->DependsOn( tasks[ i == 6 ? 5 : 0 ].get() );
+	}
+
+	const auto	IndexOf	= [&tasks] (VTask node) {
+		return size_t(std::find_if( tasks.begin(), tasks.end(), [node] (auto& t) { return node == t.get(); }) - tasks.begin());
+	};
+
+	const VTask		entries[]	= { tasks[0].get() };
+	uint			cur_key		= 0;
+	Array<size_t>	order;
+
+	TEST( VTaskScheduler::RunWithCost( entries, tasks.size(), allocator,
+				[&] (VTask node) { return uint(keys[ IndexOf( node )] != cur_key); },
+				[&] (VTask node) { order.push_back( IndexOf( node ));  cur_key = keys[ order.back() ]; }));
+
+	TEST( order.size() == tasks.size() );
+	TEST( order[0] == 0 );
+	TEST( order[1] == 1 );	// first ready task, all have same cost
+	TEST( order[2] == 3 );
+	TEST( order[3] == 5 );
+	TEST( order[4] == 2 );
+	TEST( order[5] == 4 );
+	TEST( order[6] == 6 );
+}
+
+
+extern void UnitTest_VTaskGraph ()
+{
+	VTaskScheduler_Test1();
+	VTaskScheduler_Test2();
+	VTaskScheduler_Test3();
+	VTaskScheduler_Test4();
+	VTaskScheduler_Test5();
+
+	FG_LOGI( "UnitTest_VTaskGraph - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -0,0 +1,164 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VTransientMemoryAllocator.h"
+#include "UnitTest_Common.h"
+#include <random>
+
+using TransientRes		= VTransientMemoryAllocator::Resource;
+using TransientPlace	= VTransientMemoryAllocator::Placement;
+
+
+static bool IsMemoryOverlapped (const TransientRes &lhsRes, const TransientPlace &lhs, const TransientRes &rhsRes, const TransientPlace &rhs)
+{
+	return	lhs.heapIndex == rhs.heapIndex and
+			lhs.offset < rhs.offset + rhsRes.size and
+			rhs.offset < lhs.offset + lhsRes.size;
+}
+
+
+static void CheckPlacements (ArrayView<TransientRes> resources, ArrayView<TransientPlace> placements, ArrayView<VTransientMemoryAllocator::Heap> heaps)
+{
+	TEST( resources.size() == placements.size() );
+
+	for (size_t i = 0; i < resources.size(); ++i)
+	{
+		auto&	res		= resources[i];
+		auto&	place	= placements[i];
+
+		TEST( place.heapIndex < heaps.size() );
+		TEST( heaps[place.heapIndex].memTypeIndex == res.memTypeIndex );
+		TEST( place.offset + res.size <= heaps[place.heapIndex].size );
+		TEST( place.offset % res.align == 0 );
+
+		// resources that are alive at the same time must not share memory
+		for (size_t j = 0; j < i; ++j)
+		{
+			auto&	other = resources[j];
+
+			if ( res.firstUse <= other.lastUse and other.firstUse <= res.lastUse )
+				TEST( not IsMemoryOverlapped( res, place, other, placements[j] ));
+		}
+	}
+}
+
+
+static void VTransientMemoryAllocator_Test1 ()
+{
+	// A: [1, 2], B: [3, 4], C: [2, 3]
+	const TransientRes	resources[] = {
+		{ 1_Mb, 256_b, 0, 1, 2 },
+		{ 1_Mb, 256_b, 0, 3, 4 },
+		{ 512_Kb, 256_b, 0, 2, 3 }
+	};
+	VTransientMemoryAllocator::Placements_t	placements;
+	VTransientMemoryAllocator::Heaps_t		heaps;
+
+	TEST( VTransientMemoryAllocator::Allocate( resources, 1_b, OUT placements, OUT heaps ));
+	CheckPlacements( resources, placements, heaps );
+
+	TEST( heaps.size() == 1 );
+	TEST( heaps[0].size == 1_Mb + 512_Kb );
+
+	// A and B share memory
+	TEST( placements[0].offset == placements[1].offset );
+	TEST( not placements[0].aliased );
+	TEST( placements[1].aliased );
+	TEST( not placements[2].aliased );
+}
+
+
+static void VTransientMemoryAllocator_Test2 ()
+{
+	// different memory types must not be mixed
+	const TransientRes	resources[] = {
+		{ 1_Mb, 256_b, 0, 1, 1 },
+		{ 1_Mb, 256_b, 1, 2, 2 },
+		{ 1_Mb, 256_b, 0, 3, 3 }
+	};
+	VTransientMemoryAllocator::Placements_t	placements;
+	VTransientMemoryAllocator::Heaps_t		heaps;
+
+	TEST( VTransientMemoryAllocator::Allocate( resources, 1_b, OUT placements, OUT heaps ));
+	CheckPlacements( resources, placements, heaps );
+
+	TEST( heaps.size() == 2 );
+	TEST( heaps[0].size == 1_Mb );
+	TEST( heaps[1].size == 1_Mb );
+	TEST( placements[0].heapIndex == placements[2].heapIndex );
+	TEST( placements[0].heapIndex != placements[1].heapIndex );
+	TEST( placements[2].aliased );
+	TEST( not placements[1].aliased );
+}
+
+
+static void VTransientMemoryAllocator_Test3 ()
+{
+	// granularity and alignment, all resources are alive at the same time
+	const TransientRes	resources[] = {
+		{ 100_b, 4_b,   0, 1, 2 },
+		{ 100_b, 256_b, 0, 1, 2 },
+		{ 100_b, 16_b,  0, 2, 3 }
+	};
+	VTransientMemoryAllocator::Placements_t	placements;
+	VTransientMemoryAllocator::Heaps_t		heaps;
+
+	TEST( VTransientMemoryAllocator::Allocate( resources, 1_Kb, OUT placements, OUT heaps ));
+	CheckPlacements( resources, placements, heaps );
+
+	for (auto& place : placements) {
+		TEST( place.offset % 1_Kb == 0 );
+		TEST( not place.aliased );
+	}
+	TEST( heaps.size() == 1 );
+	TEST( heaps[0].size == 2_Kb + 100_b );
+}
+
+
+static void VTransientMemoryAllocator_Test4 ()
+{
+	// random lifetimes, memory must be reused
+	std::mt19937	gen{ 4321 };
+
+	Array<TransientRes>		resources;
+	BytesU					total;
+
+	for (uint i = 0; i < 200; ++i)
+	{
+		TransientRes	res;
+		res.size			= BytesU{ (gen() % 64 + 1) * 4096 };
+		res.align			= BytesU{ 1u << (gen() % 12) };
+		res.memTypeIndex	= gen() % 3;
+		res.firstUse		= gen() % 100 + 1;
+		res.lastUse			= res.firstUse + gen() % 10;
+
+		total += res.size;
+		resources.push_back( res );
+	}
+	
+	VTransientMemoryAllocator::Placements_t	placements;
+	VTransientMemoryAllocator::Heaps_t		heaps;
+
+	TEST( VTransientMemoryAllocator::Allocate( resources, 64_b, OUT placements, OUT heaps ));
+	CheckPlacements( resources, placements, heaps );
+
+	BytesU	allocated;
+	for (auto& heap : heaps) {
+		allocated += heap.size;
+	}
+	TEST( allocated < total );
+}
+
+
+extern void UnitTest_VTransientMemoryAllocator ()
+{
+	VTransientMemoryAllocator_Test1();
+	VTransientMemoryAllocator_Test2();
+	VTransientMemoryAllocator_Test3();
+	VTransientMemoryAllocator_Test4();
+
+	FG_LOGI( "UnitTest_VTransientMemoryAllocator - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
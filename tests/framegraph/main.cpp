@@ -11,6 +11,14 @@ extern void UnitTest_ID ();
 extern void UnitTest_VBuffer ();
 extern void UnitTest_VImage ();
 extern void UnitTest_ImageDesc ();
+extern void UnitTest_ImageView ();
+extern void PerfTest_ImageView ();
+extern void UnitTest_VTaskGraph ();
+extern void UnitTest_VTransientMemoryAllocator ();
+extern void UnitTest_VStagingRingAllocator ();
+extern void UnitTest_VBarrierOptimizer ();
+extern void UnitTest_VCmdStateTracker ();
+extern void UnitTest_VSubpassMerger ();
 
 
 #ifdef PLATFORM_ANDROID
@@ -29,10 +37,21 @@ int main () {
 		UnitTest_PixelFormat();
 		UnitTest_ID();
 		UnitTest_ImageDesc();
+		UnitTest_ImageView();
+
+		#ifdef FG_ENABLE_PERF_TESTS
+		PerfTest_ImageView();
+		#endif
 
 		#ifdef FG_ENABLE_VULKAN
 		UnitTest_VBuffer();
 		UnitTest_VImage();
+		UnitTest_VTaskGraph();
+		UnitTest_VTransientMemoryAllocator();
+		UnitTest_VStagingRingAllocator();
+		UnitTest_VBarrierOptimizer();
+		UnitTest_VCmdStateTracker();
+		UnitTest_VSubpassMerger();
 		#endif
 	}
 
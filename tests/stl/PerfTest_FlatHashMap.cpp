@@ -0,0 +1,119 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compares 'FlatHashMap' with 'std::unordered_map' on packed 64-bit keys that are used for resource IDs:
+	index in low bits, generation and resource type in high bits.
+	Each iteration emulates a command buffer: map is filled from scratch and then queried.
+*/
+
+#include "stl/Containers/FlatHashMap.h"
+#include "stl/Memory/LinearAllocator.h"
+#include "UnitTest_Common.h"
+#include <unordered_map>
+#include <random>
+#include <chrono>
+
+namespace
+{
+	using Clock_t	= std::chrono::high_resolution_clock;
+	using Key_t		= uint64_t;
+
+/*
+=================================================
+	GenResourceKeys
+=================================================
+*/
+	static void  GenResourceKeys (size_t count, OUT Array<Key_t> &result)
+	{
+		std::mt19937	gen{ 1234 };
+
+		result.resize( count );
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint64_t	index	= gen() % (count / 2 + 1);	// about half of accesses hit existing key
+			const uint64_t	gener	= gen() % 4;
+			const uint64_t	type	= gen() % 8;
+
+			result[i] = (type << 48) | (gener << 32) | index;
+		}
+	}
+	
+/*
+=================================================
+	Measure
+=================================================
+*/
+	template <typename Fn>
+	static double  Measure (const Array<Key_t> &keys, Fn &&fn)
+	{
+		double	min_time = 1.0e+10;
+
+		for (uint i = 0; i < 8; ++i)
+		{
+			const auto	t_start = Clock_t::now();
+			fn( keys );
+			const auto	dt = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>( Clock_t::now() - t_start );
+
+			min_time = Min( min_time, dt.count() );
+		}
+		return min_time;
+	}
+	
+/*
+=================================================
+	FillAndQuery
+=================================================
+*/
+	template <typename MapType>
+	static void  FillAndQuery (MapType &map, const Array<Key_t> &keys, INOUT uint64_t &checksum)
+	{
+		for (auto& key : keys) {
+			map.insert({ key, 0u }).first->second++;
+		}
+		for (auto& key : keys) {
+			checksum += map.find( key )->second;
+		}
+		checksum += map.size();
+	}
+}
+
+
+extern void PerfTest_FlatHashMap ()
+{
+	using LinearAlloc_t = StdLinearAllocator< Pair< const Key_t, uint >>;
+
+	for (size_t count : {100, 1'000, 10'000, 100'000})
+	{
+		Array<Key_t>	keys;
+		GenResourceKeys( count, OUT keys );
+
+		uint64_t		checksum[3] = {};
+		LinearAllocator<>	linear;
+
+		const double	std_map	= Measure( keys, [&checksum] (const Array<Key_t> &src) {
+										std::unordered_map< Key_t, uint >	map;
+										FillAndQuery( map, src, INOUT checksum[0] );
+									});
+		const double	flat	= Measure( keys, [&checksum] (const Array<Key_t> &src) {
+										FlatHashMap< Key_t, uint >	map;
+										FillAndQuery( map, src, INOUT checksum[1] );
+									});
+		const double	flat_la	= Measure( keys, [&checksum, &linear] (const Array<Key_t> &src) {
+										{
+											FlatHashMap< Key_t, uint, std::hash<Key_t>, std::equal_to<Key_t>, LinearAlloc_t >	map{ LinearAlloc_t{linear} };
+											FillAndQuery( map, src, INOUT checksum[2] );
+										}
+										linear.Discard();
+									});
+
+		TEST( checksum[0] == checksum[1] );
+		TEST( checksum[0] == checksum[2] );
+
+		FG_LOGI( "keys: "s << ToString( count )
+				 << ", std::unordered_map: " << ToString( uint64_t(std_map) ) << " us"
+				 << ", FlatHashMap: " << ToString( uint64_t(flat) ) << " us"
+				 << ", FlatHashMap + LinearAllocator: " << ToString( uint64_t(flat_la) ) << " us" );
+	}
+
+	FG_LOGI( "PerfTest_FlatHashMap - passed" );
+}
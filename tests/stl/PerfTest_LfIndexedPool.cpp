@@ -0,0 +1,104 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compares throughput of 'LfIndexedPool' and 'LfGrowableIndexedPool'
+	when many threads assign and unassign indices at the same time.
+	Pools are almost full, so 'LfIndexedPool' scans many full chunks on each 'Assign'.
+*/
+
+#include "stl/ThreadSafe/LfIndexedPool.h"
+#include "stl/ThreadSafe/LfGrowableIndexedPool.h"
+#include "UnitTest_Common.h"
+#include <thread>
+#include <chrono>
+
+namespace
+{
+	using Clock_t = std::chrono::high_resolution_clock;
+
+	static constexpr uint	OpsPerThread	= 100'000;
+	static constexpr uint	IndicesPerThread= 4;
+	static constexpr uint	PoolCapacity	= 32 * 64;
+
+/*
+=================================================
+	MeasurePool
+----
+	returns number of assign + unassign pairs per second
+=================================================
+*/
+	template <typename PoolType>
+	static double  MeasurePool (uint threadCount)
+	{
+		PoolType			pool;
+		Array<std::thread>	threads;
+		Atomic<uint>		failed	{0};
+		Atomic<bool>		start	{false};
+		Array<uint>			occupied;
+
+		// leave free space only for the working set of all threads
+		occupied.resize( PoolCapacity - threadCount * IndicesPerThread );
+		for (auto& idx : occupied) {
+			TEST( pool.Assign( OUT idx ));
+		}
+
+		for (uint t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back( [&pool, &failed, &start] ()
+			{
+				StaticArray< uint, IndicesPerThread >	indices;
+
+				while ( not start.load( memory_order_acquire )) {
+					std::this_thread::yield();
+				}
+
+				for (uint i = 0; i < OpsPerThread; i += IndicesPerThread)
+				{
+					for (auto& idx : indices) {
+						if ( not pool.Assign( OUT idx ))
+							++failed;
+					}
+					for (auto& idx : indices) {
+						pool.Unassign( idx );
+					}
+				}
+			});
+		}
+
+		const auto	t_start = Clock_t::now();
+		start.store( true, memory_order_release );
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		const auto	dt = std::chrono::duration_cast<std::chrono::duration<double>>( Clock_t::now() - t_start );
+
+		for (auto& idx : occupied) {
+			pool.Unassign( idx );
+		}
+
+		TEST( failed == 0 );
+		TEST( pool.AssignedBitsCount() == 0 );
+
+		return double(OpsPerThread) * threadCount / Max( dt.count(), 1.0e-9 );
+	}
+}
+
+
+extern void PerfTest_LfIndexedPool ()
+{
+	using FixedPool_t		= LfIndexedPool< int, uint, 32, PoolCapacity/32 >;
+	using GrowablePool_t	= LfGrowableIndexedPool< int, uint, 32, 16 >;
+
+	for (uint threads : {1u, 4u, 16u, 64u})
+	{
+		const double	fixed		= MeasurePool< FixedPool_t >( threads );
+		const double	growable	= MeasurePool< GrowablePool_t >( threads );
+
+		FG_LOGI( "threads: "s << ToString( threads ) << ", occupied: " << ToString( PoolCapacity - threads * IndicesPerThread ) << "/" << ToString( PoolCapacity )
+				 << ", LfIndexedPool: " << ToString( uint64_t(fixed / 1000.0) ) << " Kop/s"
+				 << ", LfGrowableIndexedPool: " << ToString( uint64_t(growable / 1000.0) ) << " Kop/s" );
+	}
+
+	FG_LOGI( "PerfTest_LfIndexedPool - passed" );
+}
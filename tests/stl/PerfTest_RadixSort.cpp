@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compares 'RadixSort' with 'std::stable_sort' on keys that are used for draw call sorting:
+	few layers, some pipelines, many resource sets and random depth.
+*/
+
+#include "stl/Algorithms/RadixSort.h"
+#include "UnitTest_Common.h"
+#include <random>
+#include <chrono>
+
+namespace
+{
+	using Clock_t	= std::chrono::high_resolution_clock;
+	using Item		= Pair< uint64_t, uint >;
+
+/*
+=================================================
+	GenDrawKeys
+=================================================
+*/
+	static void  GenDrawKeys (size_t count, OUT Array<Item> &result)
+	{
+		std::mt19937	gen{ 4321 };
+
+		result.resize( count );
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint64_t	layer		= gen() % 4;
+			const uint64_t	pipeline	= gen() % 32;
+			const uint64_t	resources	= gen() % 1024;
+			const uint64_t	depth		= gen() & 0xFFFF;
+
+			result[i] = { (layer << 56) | (pipeline << 40) | (resources << 16) | depth, uint(i) };
+		}
+	}
+	
+/*
+=================================================
+	Measure
+=================================================
+*/
+	template <typename Fn>
+	static double  Measure (const Array<Item> &src, Fn &&fn)
+	{
+		Array<Item>		arr;
+		double			min_time = 1.0e+10;
+
+		for (uint i = 0; i < 8; ++i)
+		{
+			arr = src;
+
+			const auto	t_start = Clock_t::now();
+			fn( arr );
+			const auto	dt = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>( Clock_t::now() - t_start );
+
+			min_time = Min( min_time, dt.count() );
+		}
+		return min_time;
+	}
+}
+
+
+extern void PerfTest_RadixSort ()
+{
+	for (size_t count : {1'000, 10'000, 100'000})
+	{
+		Array<Item>		src;
+		GenDrawKeys( count, OUT src );
+
+		const double	radix	= Measure( src, [] (Array<Item> &arr) { RadixSort( arr, [] (const Item &x) { return x.first; }); });
+		const double	stable	= Measure( src, [] (Array<Item> &arr) {
+										std::stable_sort( arr.begin(), arr.end(), [] (auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+									});
+
+		FG_LOGI( "keys: "s << ToString( count )
+				 << ", RadixSort: " << ToString( uint64_t(radix) ) << " us"
+				 << ", std::stable_sort: " << ToString( uint64_t(stable) ) << " us" );
+	}
+
+	FG_LOGI( "PerfTest_RadixSort - passed" );
+}
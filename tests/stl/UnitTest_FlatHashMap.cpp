@@ -0,0 +1,131 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Containers/FlatHashMap.h"
+#include "stl/Memory/LinearAllocator.h"
+#include "UnitTest_Common.h"
+#include <unordered_map>
+
+
+static void FlatHashMap_Test1 ()
+{
+	FlatHashMap< uint64_t, uint >	map;
+
+	TEST( map.empty() );
+	TEST( map.find( 1 ) == map.end() );
+
+	for (uint i = 0; i < 1000; ++i)
+	{
+		auto[iter, inserted] = map.insert({ uint64_t(i) << 32, i });
+		TEST( inserted );
+		TEST( iter->first == (uint64_t(i) << 32) );
+		TEST( iter->second == i );
+	}
+	TEST( map.size() == 1000 );
+
+	// insert existing key
+	auto[iter, inserted] = map.insert({ uint64_t(10) << 32, 0u });
+	TEST( not inserted );
+	TEST( iter->second == 10 );
+
+	map.insert({ uint64_t(10) << 32, 0u }).first->second++;
+	TEST( map.find( uint64_t(10) << 32 )->second == 11 );
+
+	for (uint i = 0; i < 1000; ++i)
+	{
+		TEST( map.count( uint64_t(i) << 32 ) == 1 );
+		TEST( map.count( (uint64_t(i) << 32) + 1 ) == 0 );
+	}
+
+	// iteration
+	uint64_t	sum = 0;
+	size_t		cnt = 0;
+	for (auto[key, value] : map) {
+		sum += (key >> 32);
+		++cnt;
+	}
+	TEST( cnt == 1000 );
+	TEST( sum == 999 * 1000 / 2 );
+
+	map.clear();
+	TEST( map.empty() );
+	TEST( map.begin() == map.end() );
+	TEST( map.count( 0 ) == 0 );
+}
+
+
+static void FlatHashMap_Test2 ()
+{
+	using T = DebugInstanceCounter< int, 1 >;
+
+	T::ClearStatistic();
+	{
+		FlatHashMap< int, T >	map;
+
+		for (int i = 0; i < 100; ++i) {
+			map.emplace( i, T{i} );
+		}
+		TEST( map.size() == 100 );
+		TEST( map.find( 50 )->second == T{50} );
+
+		map.clear();
+
+		for (int i = 0; i < 10; ++i) {
+			map.emplace( i, T{i} );
+		}
+	}
+	TEST( T::CheckStatistic() );
+}
+
+
+static void FlatHashMap_Test3 ()
+{
+	// with linear allocator, compare with std::unordered_map
+	using Alloc_t = StdLinearAllocator< Pair< const uint64_t, uint >>;
+
+	LinearAllocator<>						linear;
+	FlatHashMap< uint64_t, uint, std::hash<uint64_t>, std::equal_to<uint64_t>, Alloc_t >	map{ Alloc_t{linear} };
+	std::unordered_map< uint64_t, uint >	ref;
+
+	uint64_t	key = 1;
+	for (uint i = 0; i < 10000; ++i)
+	{
+		key = key * 6364136223846793005ull + 1442695040888963407ull;
+		const uint64_t	k = key & 0xFFFF'00FF'FFFFull;
+
+		map.insert({ k, 0u }).first->second++;
+		ref.insert({ k, 0u }).first->second++;
+	}
+
+	TEST( map.size() == ref.size() );
+	for (auto& item : ref)
+	{
+		auto	iter = map.find( item.first );
+		TEST( iter != map.end() );
+		TEST( iter->second == item.second );
+	}
+}
+
+
+static void FlatHashSet_Test1 ()
+{
+	FlatHashSet< void const* >	set;
+
+	for (size_t i = 1; i <= 100; ++i) {
+		TEST( set.insert( reinterpret_cast<void const*>( i * 64 )));
+	}
+	TEST( not set.insert( reinterpret_cast<void const*>( size_t(64) )));
+	TEST( set.size() == 100 );
+	TEST( set.count( reinterpret_cast<void const*>( size_t(128) )) == 1 );
+	TEST( set.count( reinterpret_cast<void const*>( size_t(129) )) == 0 );
+}
+
+
+extern void UnitTest_FlatHashMap ()
+{
+	FlatHashMap_Test1();
+	FlatHashMap_Test2();
+	FlatHashMap_Test3();
+	FlatHashSet_Test1();
+
+	FG_LOGI( "UnitTest_FlatHashMap - passed" );
+}
@@ -65,6 +65,43 @@ static void ChunkedIndexedPool_Test3 ()
 }
 
 
+static void ChunkedIndexedPool_Test4 ()
+{
+	ChunkedIndexedPool< int, uint, 16, 16 >	pool;
+	FixedArray< uint, 16 >					arr;
+
+	TEST( pool.capacity() == 16*16 );
+	TEST( pool.MaxCapacity() == 16*16 );
+
+	pool.SetCapacity( 40 );
+	TEST( pool.capacity() == 16*3 );
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		TEST( pool.Assign( 16, INOUT arr ) == 16 );
+		arr.clear();
+	}
+	TEST( pool.size() == 16*3 );
+
+	// limit is reached
+	TEST( pool.Assign( 16, INOUT arr ) == 0 );
+
+	// pool can grow after limit is increased
+	pool.SetCapacity( 16*4 );
+	TEST( pool.Assign( 16, INOUT arr ) == 16 );
+
+	// free index in the first chunk must be found
+	pool.Unassign( 5 );
+	arr.clear();
+	TEST( pool.Assign( 1, INOUT arr ) == 1 );
+	TEST( arr[0] == 5 );
+
+	// capacity can't be less than size
+	pool.SetCapacity( 0 );
+	TEST( pool.capacity() == 16*4 );
+}
+
+
 static void CachedIndexedPool_Test1 ()
 {
 	CachedIndexedPool<uint, uint, 16, 16>	pool;
@@ -89,6 +126,7 @@ extern void UnitTest_IndexedPool ()
 	ChunkedIndexedPool_Test1();
 	ChunkedIndexedPool_Test2();
 	ChunkedIndexedPool_Test3();
+	ChunkedIndexedPool_Test4();
 	CachedIndexedPool_Test1();
 
 	FG_LOGI( "UnitTest_IndexedPool - passed" );
@@ -1,7 +1,9 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "stl/ThreadSafe/LfIndexedPool.h"
+#include "stl/ThreadSafe/LfGrowableIndexedPool.h"
 #include "UnitTest_Common.h"
+#include <thread>
 
 
 static void LfIndexedPool_Test1 ()
@@ -67,11 +69,172 @@ static void LfIndexedPool_Test3 ()
 }
 
 
+static void LfGrowableIndexedPool_Test1 ()
+{
+	using T = DebugInstanceCounter< int, 3 >;
+	
+	T::ClearStatistic();
+	{
+		LfGrowableIndexedPool< T, uint, 32, 16 >	pool;
+		TEST( pool.CurrentCapacity() == 0 );
+	
+		for (uint i = 0; i < 32*16*10; ++i)
+		{
+			uint	index;
+			TEST( pool.Assign( OUT index ));
+			TEST( pool.IsAssigned( index ));
+
+			pool.Unassign( index );
+		}
+
+		// index is reused from thread cache
+		TEST( pool.CurrentCapacity() == 32 );
+		TEST( pool.CreatedObjectsCount() == 1 );
+		TEST( pool.AssignedBitsCount() == 0 );
+	}
+	TEST( T::CheckStatistic() );
+}
+
+
+static void LfGrowableIndexedPool_Test2 ()
+{
+	using T = DebugInstanceCounter< int, 4 >;
+	
+	T::ClearStatistic();
+	{
+		// directory grows far beyond the first page
+		constexpr uint							count = 32*16*20;
+		LfGrowableIndexedPool< T, uint, 32, 16 >	pool;
+		HashSet<uint>							indices;
+	
+		for (uint i = 0; i < count; ++i)
+		{
+			uint	index;
+			TEST( pool.Assign( OUT index ));
+			TEST( indices.insert( index ).second );
+		}
+		TEST( pool.CurrentCapacity() == count );
+		TEST( pool.AssignedBitsCount() == count );
+		
+		// unassigned indices must be reused
+		for (uint i = 0; i < count; i += 2) {
+			pool.Unassign( i );
+		}
+		for (uint i = 0; i < count; i += 2)
+		{
+			uint	index;
+			TEST( pool.Assign( OUT index ));
+			TEST( index % 2 == 0 );
+		}
+		TEST( pool.CurrentCapacity() == count );
+		
+		for (uint i = 0; i < count; ++i) {
+			pool.Unassign( i );
+		}
+	}
+	TEST( T::CheckStatistic() );
+	
+	T::ClearStatistic();
+	{
+		// capacity is limited only by index type
+		using Pool_t = LfGrowableIndexedPool< T, uint16_t, 32, 16 >;
+		
+		constexpr uint	count = 1u << 16;
+		Pool_t			pool;
+		STATIC_ASSERT( Pool_t::MaxCapacity() == count );
+
+		for (uint i = 0; i < count+1; ++i)
+		{
+			uint16_t	index;
+			bool		res = pool.Assign( OUT index );
+
+			if ( i < count ) {
+				TEST( res );
+				TEST( index == i );
+			}else
+				TEST( not res );
+		}
+		TEST( pool.CurrentCapacity() == count );
+
+		for (uint i = 0; i < count; ++i) {
+			pool.Unassign( uint16_t(i) );
+		}
+	}
+	TEST( T::CheckStatistic() );
+}
+
+
+static void LfGrowableIndexedPool_Test3 ()
+{
+	using T = DebugInstanceCounter< int, 5 >;
+	
+	T::ClearStatistic();
+	{
+		LfGrowableIndexedPool< T, uint, 32, 64 >	pool;
+		StaticArray< std::thread, 8 >			threads;
+		Atomic<uint>							errors	{0};
+
+		for (auto& t : threads)
+		{
+			t = std::thread{ [&pool, &errors] ()
+			{
+				FixedArray< uint, 16 >	indices;
+
+				for (uint i = 0; i < 10'000; ++i)
+				{
+					if ( indices.size() == indices.capacity() or (i % 3 == 2 and indices.size()) )
+					{
+						uint	index = indices.back();
+						indices.pop_back();
+
+						if ( pool[index].value != int(index) )
+							++errors;
+
+						pool[index].value = -1;
+						pool.Unassign( index );
+					}
+					else
+					{
+						uint	index;
+						if ( not pool.Assign( OUT index, [] (T* ptr, uint) { PlacementNew<T>( ptr, -1 ); }))
+						{
+							++errors;
+							continue;
+						}
+						if ( pool[index].value != -1 )
+							++errors;
+
+						pool[index].value = int(index);
+						indices.push_back( index );
+					}
+				}
+
+				for (uint index : indices) {
+					pool[index].value = -1;
+					pool.Unassign( index );
+				}
+			}};
+		}
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		TEST( errors == 0 );
+		TEST( pool.AssignedBitsCount() == 0 );
+	}
+	TEST( T::CheckStatistic() );
+}
+
+
 extern void UnitTest_LfIndexedPool ()
 {
 	LfIndexedPool_Test1();
 	LfIndexedPool_Test2();
 	LfIndexedPool_Test3();
+	LfGrowableIndexedPool_Test1();
+	LfGrowableIndexedPool_Test2();
+	LfGrowableIndexedPool_Test3();
 
 	FG_LOGI( "UnitTest_LfIndexedPool - passed" );
 }
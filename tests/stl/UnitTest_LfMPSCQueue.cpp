@@ -0,0 +1,124 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/LfMPSCQueue.h"
+#include "UnitTest_Common.h"
+#include <thread>
+
+
+static void LfMPSCQueue_Test1 ()
+{
+	LfMPSCQueue< uint, 8 >	queue;
+	uint					value;
+
+	TEST( queue.Empty() );
+	TEST( not queue.Pop( OUT value ));
+
+	// wrap around several times
+	for (uint i = 0; i < 100; ++i)
+	{
+		TEST( queue.Push( i ));
+		TEST( queue.Push( i + 1000 ));
+		TEST( not queue.Empty() );
+
+		TEST( queue.Pop( OUT value ));
+		TEST( value == i );
+		TEST( queue.Pop( OUT value ));
+		TEST( value == i + 1000 );
+		TEST( queue.Empty() );
+	}
+
+	// overflow
+	for (uint i = 0; i < 8; ++i) {
+		TEST( queue.Push( i ));
+	}
+	TEST( not queue.Push( 8u ));
+
+	for (uint i = 0; i < 8; ++i) {
+		TEST( queue.Pop( OUT value ));
+		TEST( value == i );
+	}
+	TEST( queue.Empty() );
+}
+
+
+static void LfMPSCQueue_Test2 ()
+{
+	using T = DebugInstanceCounter< int, 1 >;
+
+	T::ClearStatistic();
+	{
+		LfMPSCQueue< T, 16 >	queue;
+		T						value;
+
+		for (uint i = 0; i < 10; ++i) {
+			TEST( queue.Push( T{int(i)} ));
+		}
+		TEST( queue.Pop( OUT value ));
+		TEST( value == T{0} );
+	}
+	TEST( T::CheckStatistic() );
+}
+
+
+static void LfMPSCQueue_Test3 ()
+{
+	// values from each producer must be received in order
+	static constexpr uint	thread_count	= 8;
+	static constexpr uint	count			= 100'000;
+
+	LfMPSCQueue< uint, 64 >	queue;
+	Array<std::thread>		threads;
+	StaticArray< uint, thread_count >	last_values;
+
+	for (uint t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back( [&queue, t] ()
+		{
+			for (uint i = 1; i <= count;)
+			{
+				if ( queue.Push( (t << 24) | i ))
+					++i;
+				else
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	last_values.fill( 0 );
+
+	bool	in_order = true;
+	for (uint received = 0; received < thread_count * count;)
+	{
+		uint	value;
+		if ( not queue.Pop( OUT value )) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		auto&	last = last_values[ value >> 24 ];
+		in_order &= ((value & 0xFFFFFF) == last + 1);
+		last = (value & 0xFFFFFF);
+		++received;
+	}
+
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	TEST( in_order );
+	TEST( queue.Empty() );
+
+	for (auto& last : last_values) {
+		TEST( last == count );
+	}
+}
+
+
+extern void UnitTest_LfMPSCQueue ()
+{
+	LfMPSCQueue_Test1();
+	LfMPSCQueue_Test2();
+	LfMPSCQueue_Test3();
+
+	FG_LOGI( "UnitTest_LfMPSCQueue - passed" );
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Algorithms/RadixSort.h"
+#include "UnitTest_Common.h"
+#include <random>
+
+
+static void RadixSort_Test1 ()
+{
+	Array<uint64_t>	arr = { 5, 0x100, 3, 0xFFFF'FFFF'FFFF'FFFF, 0, 7, 0x1'0000'0000, 3, 1 };
+	Array<uint64_t>	ref = arr;
+
+	RadixSort( arr, [] (uint64_t x) { return x; });
+	std::sort( ref.begin(), ref.end() );
+
+	TEST( arr == ref );
+}
+
+
+static void RadixSort_Test2 ()
+{
+	// sort must be stable
+	using Item = Pair< uint64_t, uint >;
+
+	std::mt19937	gen{ 1234 };
+	Array<Item>		arr;
+	
+	for (uint i = 0; i < 10'000; ++i) {
+		arr.emplace_back( (uint64_t(gen() % 16) << 40) | (gen() % 4), i );
+	}
+
+	Array<Item>		ref = arr;
+
+	RadixSort( arr, [] (const Item &x) { return x.first; });
+	std::stable_sort( ref.begin(), ref.end(), [] (auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+	TEST( arr == ref );
+}
+
+
+static void RadixSort_Test3 ()
+{
+	// all keys are equal, order must not be changed
+	Array<Pair<uint64_t, uint>>	arr;
+
+	for (uint i = 0; i < 100; ++i) {
+		arr.emplace_back( 0x1234'5678'9ABC'DEF0ull, i );
+	}
+
+	RadixSort( arr, [] (auto& x) { return x.first; });
+
+	for (uint i = 0; i < arr.size(); ++i) {
+		TEST( arr[i].second == i );
+	}
+}
+
+
+extern void UnitTest_RadixSort ()
+{
+	RadixSort_Test1();
+	RadixSort_Test2();
+	RadixSort_Test3();
+
+	FG_LOGI( "UnitTest_RadixSort - passed" );
+}
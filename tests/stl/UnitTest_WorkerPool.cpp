@@ -0,0 +1,63 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/WorkerPool.h"
+#include "UnitTest_Common.h"
+
+
+static void WorkerPool_Test1 ()
+{
+	WorkerPool	pool;
+	TEST( pool.Start( 3 ));
+	TEST( pool.ThreadCount() == 3 );
+
+	Array<uint>	values;		values.resize( 1000 );
+
+	for (uint iter = 0; iter < 10; ++iter)
+	{
+		pool.ParallelFor( values.size(), [&values] (size_t i) { values[i] += uint(i); });
+	}
+
+	for (size_t i = 0; i < values.size(); ++i) {
+		TEST( values[i] == uint(i) * 10 );
+	}
+	pool.Stop();
+}
+
+
+static void WorkerPool_Test2 ()
+{
+	WorkerPool		pool;
+	Atomic<uint>	counter {0};
+
+	TEST( pool.Start( 2 ));
+
+	for (uint i = 0; i < 100; ++i) {
+		TEST( pool.Enqueue( [&counter] () { ++counter; }));
+	}
+	pool.Stop();
+
+	TEST( counter == 100 );
+}
+
+
+static void WorkerPool_Test3 ()
+{
+	// without threads all jobs are executed on current thread
+	WorkerPool	pool;
+	uint		sum = 0;
+
+	pool.ParallelFor( 10, [&sum] (size_t i) { sum += uint(i); });
+	TEST( sum == 45 );
+
+	pool.ParallelFor( 0, [] (size_t) { TEST( false ); });
+}
+
+
+extern void UnitTest_WorkerPool ()
+{
+	WorkerPool_Test1();
+	WorkerPool_Test2();
+	WorkerPool_Test3();
+
+	FG_LOGI( "UnitTest_WorkerPool - passed" );
+}
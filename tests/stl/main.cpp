@@ -19,6 +19,13 @@ extern void UnitTest_LfIndexedPool ();
 extern void UnitTest_Rectangle ();
 extern void UnitTest_NtStringView ();
 extern void UnitTest_TypeList ();
+extern void UnitTest_WorkerPool ();
+extern void UnitTest_RadixSort ();
+extern void UnitTest_LfMPSCQueue ();
+extern void UnitTest_FlatHashMap ();
+extern void PerfTest_LfIndexedPool ();
+extern void PerfTest_RadixSort ();
+extern void PerfTest_FlatHashMap ();
 
 
 #ifdef PLATFORM_ANDROID
@@ -44,6 +51,16 @@ int main ()
 	UnitTest_Rectangle();
 	UnitTest_NtStringView();
 	UnitTest_TypeList();
+	UnitTest_WorkerPool();
+	UnitTest_RadixSort();
+	UnitTest_LfMPSCQueue();
+	UnitTest_FlatHashMap();
+
+	#ifdef FG_ENABLE_PERF_TESTS
+	PerfTest_LfIndexedPool();
+	PerfTest_RadixSort();
+	PerfTest_FlatHashMap();
+	#endif
 	
 	CHECK_FATAL( FG_DUMP_MEMLEAKS() );
 